@@ -132,6 +132,34 @@ VL53LX_Error VL53LX_SetDeviceAddress(VL53LX_DEV Dev,
  */
 VL53LX_Error VL53LX_DataInit(VL53LX_DEV Dev);
 
+/**
+ *
+ * @brief One time device initialization using an NVM cache
+ *
+ * @par Function Description
+ * Same as @a VL53LX_DataInit() but the factory calibration blocks read from
+ * the device NVM (optical centre, peak rate map, additional offset data and
+ * the dark range results) are taken from pNvmCache when it is valid for
+ * this driver version and was filled from the same part: the registers
+ * the firmware copies from the NVM at boot, which DataInit reads anyway,
+ * must match the cached fingerprint, and the UID read back from the NVM
+ * must match the cached one. With verify_words > 0 that many cached NVM
+ * words, starting at verify_seed, are also read back. Any mismatch falls
+ * back to a full read.\n
+ * On a full read the cache is refilled and its updated flag is set, so the
+ * application can persist it. hit reports whether the cache was used.
+ * The cache is only accessed during this call.
+ *
+ * @note This function Access to the device
+ *
+ * @param   Dev                   Device Handle
+ * @param   pNvmCache             NVM cache, NULL behaves as VL53LX_DataInit()
+ * @return  VL53LX_ERROR_NONE     Success
+ * @return  "Other error code"    See ::VL53LX_Error
+ */
+VL53LX_Error VL53LX_DataInitWithNvmCache(VL53LX_DEV Dev,
+	VL53LX_nvm_cache_t *pNvmCache);
+
 /**
  * @brief Wait for device booted after chip enable (hardware standby)
  *
@@ -410,9 +438,12 @@ VL53LX_Error VL53LX_GetAdditionalData(VL53LX_DEV Dev,
  * This function is used to improve the performance of the device. It permit to
  * change a particular value used for a timeout or a threshold or a constant
  * in an algorithm. The function will change the value of the parameter
- * identified by an unique ID.
+ * identified by an unique ID. IDs below VL53LX_TUNING_MAX_TUNABLE_KEY
+ * change the bare driver settings of this device only.
  *
  * @note This function doesn't Access to the device
+ * @note VL53LX_DataInit() reloads the default bare driver settings, so
+ * set them after VL53LX_DataInit()
  *
  * @param   Dev                          Device Handle
  * @param   TuningParameterId            Tuning Parameter ID
@@ -442,6 +473,26 @@ VL53LX_Error VL53LX_SetTuningParameter(VL53LX_DEV Dev,
 VL53LX_Error VL53LX_GetTuningParameter(VL53LX_DEV Dev,
 		uint16_t TuningParameterId, int32_t *pTuningParameterValue);
 
+/**
+ * @brief Load a complete bare driver tuning profile
+ *
+ * @par Function Description
+ * Copies the VL53LX_TUNING_MAX_TUNABLE_KEY values pointed to by
+ * pTuningProfile, indexed by ::VL53LX_Tuning_t, into the tuning settings of
+ * this device only. Other devices keep their own settings.
+ * Passing NULL restores the default profile.
+ *
+ * @note This function doesn't Access to the device
+ * @note VL53LX_DataInit() reloads the default profile
+ *
+ * @param   Dev                          Device Handle
+ * @param   pTuningProfile               Pointer to the tuning profile or NULL
+ * @return  VL53LX_ERROR_NONE        Success
+ * @return  "Other error code"       See ::VL53LX_Error
+ */
+VL53LX_Error VL53LX_LoadTuningProfile(VL53LX_DEV Dev,
+		const int32_t *pTuningProfile);
+
 /**
  * @brief Performs Reference Spad Management
  *
@@ -529,6 +580,38 @@ VL53LX_Error VL53LX_GetXTalkCompensationEnable(VL53LX_DEV Dev,
  */
 VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev);
 
+/**
+ * @brief Perform XTalk Calibration, stopping once the estimate converges
+ *
+ * @details Same as @a VL53LX_PerformXTalkCalibration() but the crosstalk
+ * plane offset and shape are re-estimated after every histogram. Sampling
+ * stops once min_samples were taken and both estimates stayed within
+ * tolerance of a reference estimate for stable_pairs consecutive timing
+ * A/B histogram pairs. The reference restarts from the current estimate
+ * whenever it leaves the tolerance. The plane offset tolerance is the
+ * larger of plane_offset_tolerance_kcps and plane_offset_tolerance_pct
+ * percent of the reference; the shape tolerance applies to every bin of
+ * the shape normalised to 1024.
+ * When histogram merge is enabled the rule applies to each of the two
+ * passes. Without convergence max_samples histograms are used
+ * (0 keeps VL53LX_TUNINGPARM_XTALK_EXTRACT_NUM_OF_SAMPLES).
+ * progress_cb, when set, is called after every histogram with the running
+ * estimate; it must not access the device.
+ *
+ * @warning This function is a blocking function
+ *
+ * @note This function Access to the device
+ *
+ * @param   Dev                  Device Handle
+ * @param   pStreamConfig        Stop rule and progress callback, NULL uses
+ * @a VL53LX_get_xtalk_stream_default_config()
+ *
+ * @return  VL53LX_ERROR_NONE    Success
+ * @return  "Other error code"   See ::VL53LX_Error
+ */
+VL53LX_Error VL53LX_PerformXTalkStreamingCalibration(VL53LX_DEV Dev,
+	const VL53LX_xtalk_stream_config_t *pStreamConfig);
+
 
 /**
  * @brief Define the mode to be used for the offset correction
@@ -599,6 +682,60 @@ VL53LX_Error VL53LX_PerformOffsetSimpleCalibration(VL53LX_DEV Dev,
  */
 VL53LX_Error VL53LX_PerformOffsetZeroDistanceCalibration(VL53LX_DEV Dev);
 
+/**
+ * @brief Perform Offset simple Calibration, stopping at a precision
+ *
+ * @details Same measurement as VL53LX_PerformOffsetSimpleCalibration() in
+ * a single ranging session. A running mean and variance of the valid ranges
+ * is kept and the calibration stops as soon as the 95% confidence interval
+ * half width of the mean is at or below pCal->ToleranceMilliMeter, or when
+ * the valid sample budget is spent. The preset mode and the distance mode
+ * MUST be set by the application before to call this function.
+ *
+ * @warning This function is a blocking function
+ *
+ * @note This function Access to the device
+ *
+ * @param   Dev                    Device Handle
+ * @param   CalDistanceMilliMeter  Calibration distance value used for the
+ * offset compensation.
+ * @param   pCal                   Stop rule (input) and achieved precision,
+ * sample counts and offset (output)
+ *
+ * @return  VL53LX_ERROR_NONE      The tolerance was reached and the offset
+ * applied
+ * @return  VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH the sample budget was
+ * spent before the tolerance was reached. The offset is reported in pCal
+ * but not applied
+ * @return  VL53LX_ERROR_OFFSET_CAL_NO_SAMPLE_FAIL the calibration failed by
+ * lack of valid measurements
+ * @return  VL53LX_ERROR_INVALID_PARAMS MaxSamples is below MinSamples
+ * @return  "Other error code"   See ::VL53LX_Error
+ */
+VL53LX_Error VL53LX_PerformOffsetAdaptiveCalibration(VL53LX_DEV Dev,
+		int32_t CalDistanceMilliMeter, VL53LX_AdaptiveOffsetCal_t *pCal);
+
+/**
+ * @brief Perform Offset "zero distance" Calibration, stopping at a precision
+ *
+ * @details Adaptive counterpart of
+ * VL53LX_PerformOffsetZeroDistanceCalibration(), with the stop rule of
+ * VL53LX_PerformOffsetAdaptiveCalibration().
+ * A target must be place very close to the device.
+ *
+ * @warning This function is a blocking function
+ *
+ * @note This function Access to the device
+ *
+ * @param   Dev                    Device Handle
+ * @param   pCal                   Stop rule (input) and achieved precision,
+ * sample counts and offset (output)
+ *
+ * @return  See VL53LX_PerformOffsetAdaptiveCalibration()
+ */
+VL53LX_Error VL53LX_PerformOffsetZeroDistanceAdaptiveCalibration(
+		VL53LX_DEV Dev, VL53LX_AdaptiveOffsetCal_t *pCal);
+
 
 /**
  * @brief Perform Offset per Vcsel Calibration. i.e. per distance mode
@@ -94,6 +94,21 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 	VL53LX_Error                 *pcal_status);
 
 
+
+
+void VL53LX_get_xtalk_stream_default_config(
+	VL53LX_xtalk_stream_config_t       *pstream);
+
+
+
+
+VL53LX_Error   VL53LX_run_hist_xtalk_extraction_streaming(
+	VL53LX_DEV	                        Dev,
+	int16_t                             cal_distance_mm,
+	const VL53LX_xtalk_stream_config_t *pstream,
+	VL53LX_Error                       *pcal_status);
+
+
 #ifdef __cplusplus
 }
 #endif
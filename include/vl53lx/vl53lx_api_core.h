@@ -225,6 +225,81 @@ VL53LX_Error VL53LX_set_dmax_mode(
 
 
 
+
+VL53LX_Error VL53LX_set_dmax_cache_config(
+	VL53LX_DEV              Dev,
+	uint8_t                 reflectance_mask,
+	uint8_t                 cache_enable,
+	uint8_t                 ambient_quant_shift,
+	uint8_t                 refresh_period);
+
+
+
+
+VL53LX_Error VL53LX_get_dmax_cache_stats(
+	VL53LX_DEV              Dev,
+	uint32_t               *phit_count,
+	uint32_t               *pmiss_count);
+
+
+
+
+VL53LX_Error VL53LX_set_hist_gate(
+	VL53LX_DEV              Dev,
+	uint8_t                 gate_enable,
+	int16_t                 min_range_mm,
+	int16_t                 max_range_mm,
+	uint8_t                 margin_bins);
+
+
+
+
+VL53LX_Error VL53LX_get_hist_gate_stats(
+	VL53LX_DEV              Dev,
+	VL53LX_hist_gate_t     *pgate);
+
+
+
+
+VL53LX_Error VL53LX_set_uwr_zones(
+	VL53LX_DEV                Dev,
+	VL53LX_DevicePresetModes  preset_mode,
+	const VL53LX_uwr_rule_t  *prules,
+	uint8_t                   rule_count,
+	uint8_t                   sequence_count);
+
+
+
+
+VL53LX_Error VL53LX_set_uwr_confirmation(
+	VL53LX_DEV              Dev,
+	uint8_t                 confirm_depth,
+	int16_t                 hysteresis_mm);
+
+
+
+
+VL53LX_scratch_t *VL53LX_get_scratch(
+	VL53LX_DEV              Dev);
+
+
+
+
+VL53LX_Error VL53LX_set_scratch_arena(
+	VL53LX_DEV              Dev,
+	VL53LX_scratch_t       *pscratch);
+
+
+
+
+VL53LX_Error VL53LX_get_scratch_usage(
+	VL53LX_DEV              Dev,
+	uint16_t               *psize_bytes,
+	uint16_t               *ppeak_bytes,
+	uint16_t               *pfail_count);
+
+
+
 VL53LX_Error VL53LX_get_dmax_mode(
 	VL53LX_DEV               Dev,
 	VL53LX_DeviceDmaxMode   *pdmax_mode);
@@ -268,6 +343,22 @@ VL53LX_Error VL53LX_set_tuning_parm(
 
 
 
+VL53LX_Error VL53LX_get_tuning_parm_profile(
+	VL53LX_DEV                     Dev,
+	const VL53LX_TuningParms      *ptuning_parm_keys,
+	int32_t                       *ptuning_parm_values,
+	uint16_t                       count);
+
+
+
+VL53LX_Error VL53LX_set_tuning_parm_profile(
+	VL53LX_DEV                     Dev,
+	const VL53LX_TuningParms      *ptuning_parm_keys,
+	const int32_t                 *ptuning_parm_values,
+	uint16_t                       count);
+
+
+
 VL53LX_Error VL53LX_dynamic_xtalk_correction_enable(
 	VL53LX_DEV                     Dev
 	);
@@ -54,6 +54,21 @@ uint32_t VL53LX_isqrt(
 
 
 
+#define VL53LX_PACK_VERSION(major, minor, sub, revision) \
+	(((uint32_t)(major) << 24) | ((uint32_t)(minor) << 16) | \
+	 ((uint32_t)(sub) << 8) | ((uint32_t)(revision) & 0xFF))
+
+
+
+
+uint32_t VL53LX_crc32(
+	uint32_t        crc,
+	const uint8_t  *pdata,
+	uint32_t        size);
+
+
+
+
 void VL53LX_hist_calc_zero_distance_phase(
 	VL53LX_histogram_bin_data_t    *pdata);
 
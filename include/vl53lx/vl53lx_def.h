@@ -20,6 +20,7 @@
 #define _VL53LX_DEF_H_
 
 #include "vl53lx_ll_def.h"
+#include "vl53lx_preset_setup.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -219,6 +220,37 @@ typedef struct {
 } VL53LX_UserRoi_t;
 
 
+/**
+ * @struct  VL53LX_AdaptiveOffsetCal_t
+ * @brief   Stop rule and outcome of an adaptive offset calibration
+ *
+ */
+typedef struct {
+	FixPoint1616_t ToleranceMilliMeter;
+		/*!< Input: stop as soon as the 95% confidence interval half
+		 * width of the mean range is at or below this value.
+		 */
+	uint16_t MinSamples;
+		/*!< Input: valid samples taken before the stop rule is
+		 * checked, at least 2.
+		 */
+	uint16_t MaxSamples;
+		/*!< Input: valid sample budget. 0 uses the sample number
+		 * times the repeat count of the fixed length calibration.
+		 */
+	FixPoint1616_t PrecisionMilliMeter;
+		/*!< Output: achieved 95% confidence interval half width. */
+	uint16_t SampleCount;
+		/*!< Output: valid samples averaged. */
+	uint16_t MeasurementCount;
+		/*!< Output: ranging measurements read, valid or not. */
+	int16_t OffsetMilliMeter;
+		/*!< Output: computed offset, written to the device only when
+		 * the tolerance was reached.
+		 */
+} VL53LX_AdaptiveOffsetCal_t;
+
+
 /**
  * @struct VL53LX_CustomerNvmManaged_t
  *
@@ -334,6 +366,9 @@ typedef struct {
 	VL53LX_DeviceParameters_t CurrentParameters;
 	/*!< Current Device Parameter */
 
+	int32_t BDTable[VL53LX_TUNING_MAX_TUNABLE_KEY];
+	/*!< Bare driver tuning settings, see ::VL53LX_Tuning_t */
+
 } VL53LX_DevData_t;
 
 
@@ -48,6 +48,42 @@ VL53LX_Error VL53LX_f_001(
 
 
 
+void VL53LX_dmax_calc_ambient_terms(
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata);
+
+
+
+
+int16_t VL53LX_dmax_calc_reflectance(
+	uint16_t                              target_reflectance,
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata);
+
+
+
+
+VL53LX_Error VL53LX_dmax_calc_cached(
+	VL53LX_dmax_cache_t                  *pcache,
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata,
+	int16_t                              *pambient_dmax_mm);
+
+
+
+
+void VL53LX_dmax_cache_invalidate(
+	VL53LX_dmax_cache_t                  *pcache);
+
+
+
+
 uint32_t VL53LX_f_002(
 	uint32_t     events_threshold,
 	uint32_t     ref_signal_events,
@@ -78,6 +78,9 @@ typedef struct {
 	int16_t    VL53LX_p_022;
 
 
+	uint32_t   ambient_thresh_events;
+
+
 } VL53LX_hist_gen3_dmax_private_data_t;
 
 
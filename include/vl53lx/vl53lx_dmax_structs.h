@@ -84,6 +84,39 @@ typedef struct {
 } VL53LX_hist_gen3_dmax_config_t;
 
 
+
+#define VL53LX_DMAX_CACHE_ENTRIES             2
+#define VL53LX_DMAX_REFLECTANCE_MASK_ALL      0x1F
+
+
+typedef struct {
+	uint8_t   valid;
+	uint16_t  VL53LX_p_015;
+	uint8_t   VL53LX_p_005;
+	uint16_t  vcsel_width;
+	uint32_t  total_periods_elapsed;
+	uint16_t  effective_spads;
+	uint32_t  ambient_key;
+	uint8_t   reflectance_mask;
+	uint8_t   age;
+	VL53LX_dmax_calibration_data_t  cal;
+	VL53LX_hist_gen3_dmax_config_t  cfg;
+	int16_t   ambient_dmax_mm[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+} VL53LX_dmax_cache_entry_t;
+
+
+typedef struct {
+	uint8_t   reflectance_mask;
+	uint8_t   cache_enable;
+	uint8_t   ambient_quant_shift;
+	uint8_t   refresh_period;
+	uint8_t   next_entry;
+	uint32_t  hit_count;
+	uint32_t  miss_count;
+	VL53LX_dmax_cache_entry_t  entry[VL53LX_DMAX_CACHE_ENTRIES];
+} VL53LX_dmax_cache_t;
+
+
 #ifdef __cplusplus
 }
 #endif
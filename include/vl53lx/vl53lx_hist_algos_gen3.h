@@ -62,6 +62,20 @@ VL53LX_Error VL53LX_f_006(
 
 
 
+VL53LX_Error VL53LX_hist_gate_pulses(
+	VL53LX_hist_gate_t                    *pgate,
+	uint16_t                               gain_factor,
+	int16_t                                range_offset_mm,
+	VL53LX_histogram_bin_data_t           *pbins,
+	VL53LX_hist_gen3_algo_private_data_t  *palgo);
+
+
+
+uint8_t VL53LX_hist_gate_restore(
+	VL53LX_hist_gen3_algo_private_data_t  *palgo);
+
+
+
 VL53LX_Error VL53LX_f_007(
 	VL53LX_hist_gen3_algo_private_data_t  *palgo);
 
@@ -50,6 +50,8 @@ VL53LX_Error VL53LX_f_025(
 	VL53LX_hist_gen3_algo_private_data_t   *palgo,
 	VL53LX_hist_gen4_algo_filtered_data_t  *pfiltered,
 	VL53LX_hist_gen3_dmax_private_data_t   *pdmax_algo,
+	VL53LX_dmax_cache_t                    *pdmax_cache,
+	VL53LX_hist_gate_t                     *phist_gate,
 	VL53LX_range_results_t                 *presults,
 	uint8_t                                histo_merge_nb);
 
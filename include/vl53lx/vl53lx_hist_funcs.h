@@ -43,6 +43,9 @@ VL53LX_Error VL53LX_hist_process_data(
 	VL53LX_hist_post_process_config_t *ppost_cfg,
 	VL53LX_histogram_bin_data_t       *pbins,
 	VL53LX_xtalk_histogram_data_t     *pxtalk,
+	VL53LX_dmax_cache_t               *pdmax_cache,
+	VL53LX_hist_gate_t                *phist_gate,
+	VL53LX_hist_gen3_dmax_private_data_t *pdmax_algo,
 	uint8_t                           *pArea1,
 	uint8_t                           *pArea2,
 	VL53LX_range_results_t            *presults,
@@ -291,6 +291,34 @@ typedef struct {
 
 
 
+typedef struct {
+
+	uint8_t   gate_enable;
+
+	uint8_t   margin_bins;
+
+	int16_t   min_range_mm;
+
+	int16_t   max_range_mm;
+
+
+	uint32_t  pass_count;
+
+	uint32_t  fallback_count;
+
+	uint32_t  pulses_found;
+
+	uint32_t  pulses_skipped;
+
+	uint32_t  rerun_count;
+
+	uint32_t  pulses_characterised;
+
+} VL53LX_hist_gate_t;
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
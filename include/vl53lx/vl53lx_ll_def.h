@@ -22,6 +22,8 @@
 #include "vl53lx_register_structs.h"
 #include "vl53lx_hist_structs.h"
 #include "vl53lx_dmax_structs.h"
+#include "vl53lx_hist_private_structs.h"
+#include "vl53lx_dmax_private_structs.h"
 #include "vl53lx_error_exceptions.h"
 
 #ifdef __cplusplus
@@ -1256,6 +1258,61 @@ typedef struct {
 
 
 
+typedef struct {
+
+	uint8_t   pass;
+
+	uint8_t   sample_count;
+
+	uint8_t   max_samples;
+
+	uint8_t   stable_count;
+
+	uint8_t   converged;
+
+	uint32_t  plane_offset_kcps;
+
+	uint32_t  plane_offset_delta_kcps;
+
+	uint16_t  shape_delta;
+
+	const VL53LX_xtalk_histogram_shape_t   *pxtalk_shape;
+
+} VL53LX_xtalk_stream_progress_t;
+
+
+
+
+typedef void (*VL53LX_xtalk_stream_cb_t)(
+	void                                *pctx,
+	const VL53LX_xtalk_stream_progress_t *pprogress);
+
+
+
+
+typedef struct {
+
+	uint8_t   max_samples;
+
+	uint8_t   min_samples;
+
+	uint8_t   stable_pairs;
+
+	uint32_t  plane_offset_tolerance_kcps;
+
+	uint8_t   plane_offset_tolerance_pct;
+
+	uint16_t  shape_tolerance;
+
+	VL53LX_xtalk_stream_cb_t   progress_cb;
+
+	void     *progress_ctx;
+
+} VL53LX_xtalk_stream_config_t;
+
+
+
+
 typedef struct {
 
 	uint16_t   standard_ranging_gain_factor;
@@ -1305,6 +1362,196 @@ typedef struct {
 
 
 
+#define VL53LX_UWR_MAX_SEQUENCES             4
+#define VL53LX_UWR_MAX_ZONES                 10
+#define VL53LX_UWR_MAX_RULES                 16
+#define VL53LX_UWR_SEQUENCE_ANY              0xFF
+
+#define VL53LX_UWR_MODE_SHORT                0
+#define VL53LX_UWR_MODE_MEDIUM               1
+#define VL53LX_UWR_MODE_LONG                 2
+#define VL53LX_UWR_MODE_COUNT                3
+
+
+
+
+typedef struct {
+
+	int16_t   range_diff_min_mm;
+
+	int16_t   range_diff_max_mm;
+
+	int16_t   offset_mm;
+
+	uint8_t   sequence;
+
+} VL53LX_uwr_rule_t;
+
+
+
+
+typedef struct {
+
+	int16_t   range_diff_lo_mm;
+
+	int16_t   range_diff_hi_mm;
+
+	int16_t   offset_mm;
+
+} VL53LX_uwr_zone_t;
+
+
+
+
+typedef struct {
+
+	uint8_t             zone_count;
+
+	VL53LX_uwr_zone_t   zones[VL53LX_UWR_MAX_ZONES];
+
+} VL53LX_uwr_sequence_table_t;
+
+
+
+
+typedef struct {
+
+	uint8_t                       custom;
+
+	uint8_t                       sequence_count;
+
+	VL53LX_uwr_sequence_table_t   sequence[VL53LX_UWR_MAX_SEQUENCES];
+
+} VL53LX_uwr_mode_table_t;
+
+
+
+
+typedef struct {
+
+	uint8_t                   tables_stale;
+
+	uint8_t                   confirm_depth;
+
+	int16_t                   hysteresis_mm;
+
+	uint8_t                   confirm_count[VL53LX_MAX_RANGE_RESULTS];
+
+	VL53LX_uwr_mode_table_t   mode[VL53LX_UWR_MODE_COUNT];
+
+} VL53LX_uwr_config_t;
+
+
+
+#define VL53LX_NVM_CACHE_STRUCT_VERSION       0xECAF0102
+#define VL53LX_NVM_CACHE_RAW_SIZE_BYTES       84
+#define VL53LX_NVM_CACHE_RAW_WORDS            (VL53LX_NVM_CACHE_RAW_SIZE_BYTES >> 2)
+
+
+typedef struct {
+
+	uint32_t  struct_version;
+
+	uint32_t  ll_driver_version;
+
+	uint64_t  uid;
+
+	uint32_t  nvm_copy_fingerprint;
+
+	uint8_t   nvm_raw[VL53LX_NVM_CACHE_RAW_SIZE_BYTES];
+
+	VL53LX_optical_centre_t              optical_centre;
+
+	VL53LX_cal_peak_rate_map_t           cal_peak_rate_map;
+
+	VL53LX_additional_offset_cal_data_t  add_off_cal_data;
+
+	uint16_t  fmt_dark__actual_effective_rtn_spads;
+
+	uint16_t  fmt_dark__peak_signal_count_rate_rtn_mcps;
+
+	uint16_t  fmt_dark__measured_distance_mm;
+
+} VL53LX_nvm_cache_data_t;
+
+
+
+
+typedef struct {
+
+	uint8_t                   valid;
+
+	uint8_t                   verify_words;
+
+	uint32_t                  verify_seed;
+
+	uint8_t                   hit;
+
+	uint8_t                   updated;
+
+	VL53LX_nvm_cache_data_t   data;
+
+} VL53LX_nvm_cache_t;
+
+
+
+
+#define VL53LX_SCRATCH_ALIGN                 8
+#define VL53LX_SCRATCH_MAX_ALLOCS            8
+
+
+
+
+typedef struct {
+
+	VL53LX_range_results_t                  range_results;
+
+	VL53LX_dmax_calibration_data_t          dmax_cal;
+
+	VL53LX_hist_gen3_algo_private_data_t    algo_gen3;
+
+	VL53LX_hist_gen4_algo_filtered_data_t   filtered_gen4;
+
+	VL53LX_hist_gen3_dmax_private_data_t    dmax_algo_gen3;
+
+} VL53LX_scratch_frame_t;
+
+
+
+
+#define VL53LX_SCRATCH_SIZE_BYTES \
+	(sizeof(VL53LX_scratch_frame_t) + \
+	VL53LX_SCRATCH_ALIGN * VL53LX_SCRATCH_MAX_ALLOCS)
+
+
+
+
+typedef struct {
+
+	uint64_t  words[(VL53LX_SCRATCH_SIZE_BYTES + 7) / 8];
+
+} VL53LX_scratch_buffer_t;
+
+
+
+
+typedef struct {
+
+	uint8_t   *pbuffer;
+
+	uint16_t   size_bytes;
+
+	uint16_t   used_bytes;
+
+	uint16_t   peak_bytes;
+
+	uint16_t   fail_count;
+
+} VL53LX_scratch_t;
+
+
+
+
 typedef struct {
 
 	uint8_t   wait_method;
@@ -1369,6 +1616,9 @@ typedef struct {
 	VL53LX_ssc_config_t                 ssc_cfg;
 	VL53LX_hist_post_process_config_t   histpostprocess;
 	VL53LX_hist_gen3_dmax_config_t      dmax_cfg;
+	VL53LX_dmax_cache_t                 dmax_cache;
+	VL53LX_hist_gate_t                  hist_gate;
+	VL53LX_uwr_config_t                 uwr;
 	VL53LX_xtalkextract_config_t        xtalk_extract_cfg;
 	VL53LX_xtalk_config_t               xtalk_cfg;
 	VL53LX_offsetcal_config_t           offsetcal_cfg;
@@ -1411,8 +1661,15 @@ typedef struct {
 
 	VL53LX_low_power_auto_data_t		low_power_auto_data;
 
-	uint8_t  wArea1[1536];
-	uint8_t  wArea2[512];
+	VL53LX_nvm_cache_t                 *pnvm_cache;
+
+	uint64_t                            nvm_uid;
+
+	VL53LX_scratch_t                   *pscratch;
+	VL53LX_scratch_t                    scratch;
+#ifndef VL53LX_SCRATCH_SHARED
+	VL53LX_scratch_buffer_t             scratch_buffer;
+#endif
 	VL53LX_per_vcsel_period_offset_cal_data_t per_vcsel_cal_data;
 
 	uint8_t bin_rec_pos;
@@ -1422,6 +1679,14 @@ typedef struct {
 	int32_t  multi_bins_rec[VL53LX_BIN_REC_SIZE]
 		[VL53LX_TIMING_CONF_A_B_SIZE][VL53LX_HISTOGRAM_BUFFER_SIZE];
 
+	int32_t  multi_bins_sum[VL53LX_TIMING_CONF_A_B_SIZE]
+		[VL53LX_HISTOGRAM_BUFFER_SIZE];
+
+	int32_t  multi_bins_rec_total[VL53LX_BIN_REC_SIZE]
+		[VL53LX_TIMING_CONF_A_B_SIZE];
+
+	uint8_t  multi_bins_sum_size;
+
 	int16_t PreviousRangeMilliMeter[VL53LX_MAX_RANGE_RESULTS];
 	uint8_t PreviousRangeStatus[VL53LX_MAX_RANGE_RESULTS];
 	uint8_t PreviousExtendedRange[VL53LX_MAX_RANGE_RESULTS];
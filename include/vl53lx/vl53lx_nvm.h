@@ -29,6 +29,11 @@ extern "C"
 #define VL53LX_NVM_POWER_UP_DELAY_US             50
 #define VL53LX_NVM_READ_TRIGGER_DELAY_US          5
 
+#define VL53LX_NVM_UID_INDEX                 0x01F8
+#define VL53LX_NVM_UID_SIZE                       8
+
+#define VL53LX_NVM_CACHE_VERIFY_STRIDE            8
+
 
 
 VL53LX_Error VL53LX_nvm_enable(
@@ -161,6 +166,14 @@ VL53LX_Error VL53LX_read_nvm_fmt_range_results_data(
 	VL53LX_decoded_nvm_fmt_range_data_t *prange_data);
 
 
+
+
+VL53LX_Error VL53LX_read_nvm_p2p_cal_data(
+	VL53LX_DEV                           Dev,
+	VL53LX_nvm_cache_t                  *pcache,
+	VL53LX_nvm_cache_data_t             *pdata);
+
+
 #ifdef __cplusplus
 }
 #endif
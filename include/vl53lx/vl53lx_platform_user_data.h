@@ -37,7 +37,13 @@
 
 
 // ESP-IDF platform includes
+#ifdef ESP_PLATFORM
 #include "driver/i2c_master.h"
+#else
+// Host builds (no ESP-IDF): the handles are opaque to the core driver
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+#endif
 
 
 
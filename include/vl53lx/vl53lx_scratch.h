@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_scratch.h
+ * @brief Per-frame scratch arena for the VL53LX histogram processing chain
+ *
+ * Replaces the fixed wArea1/wArea2 work buffers and the large stack locals
+ * of the ranging path with stack-like allocations from one arena. Callers
+ * take a mark, allocate typed blocks and release back to the mark before
+ * returning, so every stage of a frame reuses the same memory.
+ */
+
+#ifndef _VL53LX_SCRATCH_H_
+#define _VL53LX_SCRATCH_H_
+
+#include "vl53lx_ll_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocate a block sized for @p type from @p pscratch
+ */
+#define VL53LX_SCRATCH_ALLOC(pscratch, type) \
+	((type *)VL53LX_scratch_alloc((pscratch), (uint16_t)sizeof(type)))
+
+/**
+ * @brief Compile-time check, fails to build with a negative array size
+ */
+#define VL53LX_SCRATCH_STATIC_CHECK(cond, name) \
+	typedef char VL53LX_scratch_check_##name[(cond) ? 1 : -1]
+
+/**
+ * @brief Attach @p pbuffer of @p size_bytes to an arena and clear its counters
+ */
+void VL53LX_scratch_init(
+	VL53LX_scratch_t   *pscratch,
+	void               *pbuffer,
+	uint16_t            size_bytes);
+
+/**
+ * @brief Allocate @p size_bytes, rounded up to VL53LX_SCRATCH_ALIGN
+ *
+ * @return Pointer to the block, or NULL if the arena is missing or full
+ */
+void *VL53LX_scratch_alloc(
+	VL53LX_scratch_t   *pscratch,
+	uint16_t            size_bytes);
+
+/**
+ * @brief Current fill level, to be passed back to VL53LX_scratch_release()
+ */
+uint16_t VL53LX_scratch_mark(
+	VL53LX_scratch_t   *pscratch);
+
+/**
+ * @brief Free every block allocated since @p mark was taken
+ */
+void VL53LX_scratch_release(
+	VL53LX_scratch_t   *pscratch,
+	uint16_t            mark);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VL53LX_SCRATCH_H_ */
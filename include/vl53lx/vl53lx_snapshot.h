@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_snapshot.h
+ * @brief Driver state snapshot for warm restart without VL53LX_DataInit()
+ *
+ * A snapshot holds the configuration part of VL53LX_DevData_t: decoded
+ * NVM, tuning, calibration, preset and zone configuration, and the dmax
+ * cache, distance gate and UWR settings. Results, histograms, merge
+ * history, dmax cache entries, gate statistics, UWR confirmation counts
+ * and the scratch arena are left out and are rebuilt by the RAM-only part
+ * of the data init. The blob is versioned against the driver and the
+ * structure layout and protected by a CRC-32.
+ */
+
+#ifndef _VL53LX_SNAPSHOT_H_
+#define _VL53LX_SNAPSHOT_H_
+
+#include "vl53lx_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VL53LX_SNAPSHOT_MAGIC            0x53535856u  /* "VXSS" */
+#define VL53LX_SNAPSHOT_FORMAT_VERSION   1
+
+/**
+ * @brief Snapshot header, followed by the payload
+ */
+typedef struct {
+	uint32_t  magic;
+	/*!< VL53LX_SNAPSHOT_MAGIC */
+	uint16_t  format_version;
+	/*!< VL53LX_SNAPSHOT_FORMAT_VERSION */
+	uint16_t  header_size;
+	/*!< sizeof(VL53LX_snapshot_header_t) */
+	uint32_t  ll_driver_version;
+	/*!< LL driver major.minor.sub.revision, packed */
+	uint32_t  layout;
+	/*!< CRC-32 of the offsets and sizes of the saved fields */
+	uint32_t  payload_size;
+	/*!< Payload size in bytes */
+	uint32_t  crc32;
+	/*!< CRC-32 of header (this field zero) and payload */
+} VL53LX_snapshot_header_t;
+
+/**
+ * @brief Size of a snapshot in bytes, header included
+ */
+uint32_t VL53LX_GetStateSnapshotSize(void);
+
+/**
+ * @brief Serialise the driver state of a device
+ *
+ * Take the snapshot once the device is configured: after
+ * VL53LX_DataInit(), the distance mode, timing budget and calibration.
+ * No device access.
+ *
+ * @param   Dev               Device Handle
+ * @param   pbuffer           Output buffer
+ * @param   buffer_size       Size of @a pbuffer
+ * @param   psnapshot_size    Pointer to the written size
+ * @return  VL53LX_ERROR_NONE             Success
+ * @return  VL53LX_ERROR_BUFFER_TOO_SMALL @a buffer_size below
+ *          VL53LX_GetStateSnapshotSize()
+ */
+VL53LX_Error VL53LX_GetStateSnapshot(VL53LX_DEV Dev,
+	uint8_t *pbuffer, uint32_t buffer_size, uint32_t *psnapshot_size);
+
+/**
+ * @brief Restore the driver state of a device instead of VL53LX_DataInit()
+ *
+ * The device must be booted (VL53LX_WaitDeviceBooted()) and be the sensor
+ * the snapshot was taken from. Reinitialises the runtime state in RAM,
+ * loads the snapshot, keeps the I2C address currently set in the device
+ * and writes the configuration registers from the static NVM managed
+ * block up to the dynamic configuration. Ranging resumes with
+ * VL53LX_StartMeasurement().
+ *
+ * @param   Dev               Device Handle
+ * @param   pbuffer           Snapshot from VL53LX_GetStateSnapshot()
+ * @param   snapshot_size     Snapshot size
+ * @return  VL53LX_ERROR_NONE             Success
+ * @return  VL53LX_ERROR_INVALID_PARAMS   Bad magic, size or CRC
+ * @return  VL53LX_ERROR_NOT_SUPPORTED    Taken by another driver version
+ *          or structure layout
+ * @return  "Other error code"            See ::VL53LX_Error
+ */
+VL53LX_Error VL53LX_RestoreStateSnapshot(VL53LX_DEV Dev,
+	const uint8_t *pbuffer, uint32_t snapshot_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VL53LX_SNAPSHOT_H_ */
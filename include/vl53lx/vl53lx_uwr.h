@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_uwr.h
+ * @brief Table-driven ultra wide range (wrap around) resolution
+ *
+ * A wrapped histogram target is unwrapped from the range difference to the
+ * previous frame. Each preset mode owns a list of rules (range difference
+ * window, timing sequence, offset). The rules are compiled into one sorted,
+ * non-overlapping zone table per timing sequence so a frame resolves its
+ * offset with a binary search. Where rules overlap, the earlier rule wins,
+ * as in the original if/else chain.
+ */
+
+#ifndef _VL53LX_UWR_H_
+#define _VL53LX_UWR_H_
+
+#include "vl53lx_ll_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reset @p puwr to the tuning derived tables, depth 1, no hysteresis
+ */
+void VL53LX_uwr_init(
+	VL53LX_uwr_config_t                 *puwr);
+
+/**
+ * @brief Map a device preset mode to a VL53LX_UWR_MODE_* table index
+ *
+ * @return VL53LX_UWR_MODE_COUNT for preset modes without wrap resolution
+ */
+uint8_t VL53LX_uwr_mode_index(
+	VL53LX_DevicePresetModes             preset_mode);
+
+/**
+ * @brief Fill the rules the tuning parameters define for @p uwr_mode
+ *
+ * Short range has no tuning parameters and yields no rules.
+ * @p prules must hold VL53LX_UWR_MAX_RULES entries.
+ */
+void VL53LX_uwr_tuning_rules(
+	const VL53LX_tuning_parm_storage_t  *ptp,
+	uint8_t                              uwr_mode,
+	VL53LX_uwr_rule_t                   *prules,
+	uint8_t                             *prule_count);
+
+/**
+ * @brief Compile prioritised rules into per sequence sorted zone tables
+ *
+ * @param sequence_count  1, 2 or 4 timing sequences
+ *
+ * @return VL53LX_ERROR_INVALID_PARAMS for a bad sequence count, too many
+ *         rules or more zones than VL53LX_UWR_MAX_ZONES in one sequence
+ */
+VL53LX_Error VL53LX_uwr_build_table(
+	const VL53LX_uwr_rule_t             *prules,
+	uint8_t                              rule_count,
+	uint8_t                              sequence_count,
+	VL53LX_uwr_mode_table_t             *ptable);
+
+/**
+ * @brief Binary search the zone holding @p range_diff_mm
+ *
+ * A miss is widened by @p margin_mm towards the nearest zone.
+ *
+ * @return 1 and the zone offset in @p poffset_mm on a hit, otherwise 0
+ */
+uint8_t VL53LX_uwr_find_zone(
+	const VL53LX_uwr_sequence_table_t   *pseq,
+	int16_t                              range_diff_mm,
+	int16_t                              margin_mm,
+	int16_t                             *poffset_mm);
+
+/**
+ * @brief Resolve the wrap offset for one target of one frame
+ *
+ * Rebuilds stale tuning derived tables first. The offset is only reported
+ * once the same target matched a zone for confirm_depth frames in a row;
+ * while the target is already extended, zones are widened by hysteresis_mm.
+ *
+ * @return 1 when @p poffset_mm should be applied, otherwise 0
+ */
+uint8_t VL53LX_uwr_resolve(
+	VL53LX_uwr_config_t                 *puwr,
+	const VL53LX_tuning_parm_storage_t  *ptp,
+	VL53LX_DevicePresetModes             preset_mode,
+	uint8_t                              stream_count,
+	uint8_t                              target,
+	int16_t                              range_diff_mm,
+	uint8_t                              previous_extended,
+	int16_t                             *poffset_mm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VL53LX_UWR_H_ */
@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_align.h
+ * @brief VL53LX Multi-Sensor Time Alignment
+ *
+ * Turns samples that arrive at independent times (e.g. front and bottom
+ * sensor) into snapshots of all sensors at one common timestamp:
+ * - Fixed output rate, output times do not drift
+ * - Per sensor: linear interpolation between the samples around the
+ *   snapshot time, or the last sample held
+ * - Per sensor age of the newest sample at or before the snapshot time
+ * - Lock-free producer side: one single-producer queue per sensor, push
+ *   from the sensor's task or callback while another task takes snapshots
+ * - Fixed memory, a full queue drops the new sample and counts it
+ *
+ * A snapshot lags the output tick by delay_us. With a delay of about one
+ * sample period most values are interpolated; with no delay they are held.
+ */
+
+#ifndef VL53LX_ALIGN_H
+#define VL53LX_ALIGN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_ALIGN_MAX_SENSORS
+#define VL53LX_ALIGN_MAX_SENSORS        8       ///< Sensors per alignment stage
+#endif
+
+#ifndef VL53LX_ALIGN_QUEUE_LENGTH
+#define VL53LX_ALIGN_QUEUE_LENGTH       8       ///< Producer queue per sensor, power of two
+#endif
+
+#ifndef VL53LX_ALIGN_HISTORY_LENGTH
+#define VL53LX_ALIGN_HISTORY_LENGTH     4       ///< Valid samples kept per sensor for interpolation
+#endif
+
+/**
+ * @brief One timestamped sample
+ */
+typedef struct {
+    uint32_t timestamp_us;               ///< Measurement time
+    uint16_t distance_mm;                ///< Distance
+    uint8_t range_status;                ///< Range status, only 0 (valid) is used for values
+} vl53lx_align_sample_t;
+
+/**
+ * @brief How a snapshot value was obtained
+ */
+typedef enum {
+    VL53LX_ALIGN_NONE = 0,               ///< No valid sample at or before the snapshot time
+    VL53LX_ALIGN_INTERPOLATED,           ///< Between the samples around the snapshot time
+    VL53LX_ALIGN_HELD,                   ///< Last sample at or before the snapshot time
+    VL53LX_ALIGN_STALE,                  ///< Held, but older than max_age_us
+} vl53lx_align_source_t;
+
+/**
+ * @brief One sensor in a snapshot
+ */
+typedef struct {
+    uint16_t distance_mm;                ///< Aligned distance, 0 if VL53LX_ALIGN_NONE
+    uint32_t age_us;                     ///< Snapshot time minus the newest sample at or before it
+    vl53lx_align_source_t source;        ///< How distance_mm was obtained
+} vl53lx_align_value_t;
+
+/**
+ * @brief Snapshot of all sensors at one timestamp
+ */
+typedef struct {
+    uint32_t timestamp_us;               ///< Common timestamp of all values
+    uint32_t sequence;                   ///< Snapshot number
+    uint8_t count;                       ///< Number of sensors
+    vl53lx_align_value_t values[VL53LX_ALIGN_MAX_SENSORS];  ///< Values in AddSensor order
+} vl53lx_align_snapshot_t;
+
+/**
+ * @brief Alignment configuration
+ */
+typedef struct {
+    uint32_t output_period_us;           ///< Snapshot period (default: 20000, 50 Hz)
+    uint32_t delay_us;                   ///< Snapshot time before the output tick (default: 0)
+    uint32_t max_gap_us;                 ///< Wider sample gaps are held, not interpolated (default: 100000)
+    uint32_t max_age_us;                 ///< Older held values are marked stale (default: 100000)
+    bool interpolate;                    ///< Interpolate when possible, else always hold (default: true)
+} vl53lx_align_config_t;
+
+/**
+ * @brief One sensor's queue and history
+ *
+ * head is written only by the producer, tail only by the consumer.
+ */
+typedef struct {
+    vl53lx_align_sample_t queue[VL53LX_ALIGN_QUEUE_LENGTH];  ///< Producer queue
+    volatile uint32_t head;              ///< Next slot to write (producer)
+    volatile uint32_t tail;              ///< Next slot to read (consumer)
+    volatile uint32_t dropped;           ///< Samples dropped on a full queue (producer)
+
+    vl53lx_align_sample_t history[VL53LX_ALIGN_HISTORY_LENGTH];  ///< Valid samples, oldest first
+    uint8_t history_count;               ///< Samples in history
+    uint32_t received;                   ///< Samples taken from the queue
+    uint32_t invalid;                    ///< Of those, with a non-zero range status
+    uint32_t out_of_order;               ///< Of those, older than the newest in history (ignored)
+} vl53lx_align_channel_t;
+
+/**
+ * @brief Alignment state structure
+ */
+typedef struct {
+    vl53lx_align_config_t config;        ///< Alignment configuration
+    vl53lx_align_channel_t channels[VL53LX_ALIGN_MAX_SENSORS];  ///< Sensors in AddSensor order
+    uint8_t count;                       ///< Number of sensors
+    uint32_t next_output_us;             ///< Next output tick
+    uint32_t sequence;                   ///< Snapshots produced
+    uint32_t skipped;                    ///< Output ticks passed over because the poll came late
+    bool started;                        ///< First output tick set
+    bool initialized;                    ///< Alignment initialized flag
+} vl53lx_align_t;
+
+/**
+ * @brief Get default alignment configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_align_config_t VL53LX_AlignGetDefaultConfig(void);
+
+/**
+ * @brief Initialize alignment with default configuration
+ *
+ * @param align Pointer to alignment structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_AlignInit(vl53lx_align_t *align);
+
+/**
+ * @brief Initialize alignment with custom configuration
+ *
+ * @param align Pointer to alignment structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_AlignInitWithConfig(vl53lx_align_t *align, const vl53lx_align_config_t *config);
+
+/**
+ * @brief Add a sensor, before any push
+ *
+ * @param align Pointer to alignment structure
+ * @return Sensor index, or -1 if full
+ */
+int VL53LX_AlignAddSensor(vl53lx_align_t *align);
+
+/**
+ * @brief Queue a sample (producer side, lock-free)
+ *
+ * Each sensor must have a single producer. Different sensors may be
+ * pushed from different tasks or cores. For the time of the measurement
+ * rather than of its readout, pass the interrupt time minus half the
+ * timing budget.
+ *
+ * @param align Pointer to alignment structure
+ * @param index Sensor index
+ * @param timestamp_us Measurement time in microseconds
+ * @param distance_mm Distance in millimeters
+ * @param range_status Range status
+ * @return true if queued, false if the queue is full (sample dropped)
+ */
+bool VL53LX_AlignPush(vl53lx_align_t *align, uint8_t index, uint32_t timestamp_us, uint16_t distance_mm,
+                      uint8_t range_status);
+
+/**
+ * @brief Take the snapshot of the output tick that has come (consumer side)
+ *
+ * The first call sets the first output tick to @p now_us. Output ticks
+ * advance by output_period_us from the previous tick; ticks more than one
+ * period in the past are skipped and counted.
+ *
+ * @param align Pointer to alignment structure
+ * @param now_us Current time in microseconds
+ * @param snapshot Output snapshot, at tick - delay_us
+ * @return true if a snapshot was produced, false if the next tick has not come
+ */
+bool VL53LX_AlignPoll(vl53lx_align_t *align, uint32_t now_us, vl53lx_align_snapshot_t *snapshot);
+
+/**
+ * @brief Take a snapshot at an arbitrary time (consumer side)
+ *
+ * @param align Pointer to alignment structure
+ * @param timestamp_us Snapshot time in microseconds
+ * @param snapshot Output snapshot
+ */
+void VL53LX_AlignSnapshot(vl53lx_align_t *align, uint32_t timestamp_us, vl53lx_align_snapshot_t *snapshot);
+
+/**
+ * @brief Time until the next output tick
+ *
+ * @param align Pointer to alignment structure
+ * @param now_us Current time in microseconds
+ * @return Microseconds, 0 if a tick is due or the first tick is not set
+ */
+uint32_t VL53LX_AlignUntilNext(const vl53lx_align_t *align, uint32_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_ALIGN_H
@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_bringup.h
+ * @brief VL53LX Parallel Multi-Sensor Bring-Up
+ *
+ * Brings up N sensors that share one I2C bus and all boot at the default
+ * address, as one cooperative state machine instead of one sensor after
+ * the other:
+ * - Only one sensor is out of reset at the default address at a time
+ * - The next XSHUT is released as soon as the previous sensor has its
+ *   address, so its firmware boots while the bus runs DataInit
+ * - Boot completion is polled instead of waited for with a fixed delay
+ * - Optional NVM cache per sensor (VL53LX_DataInitWithNvmCache())
+ * - Optional stored calibration applied after DataInit (VL53LX_CalStoreApply())
+ * - Per-phase timing of every sensor
+ *
+ * The bus work of DataInit itself cannot overlap, so the total time is the
+ * first boot plus the sum of the per-sensor bus time; all waits are hidden.
+ */
+
+#ifndef VL53LX_BRINGUP_H
+#define VL53LX_BRINGUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vl53lx_api.h"
+#include "vl53lx_cal_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_BRINGUP_MAX_DEVICES
+#define VL53LX_BRINGUP_MAX_DEVICES      8       ///< Sensors per bring-up
+#endif
+
+#define VL53LX_BRINGUP_DEFAULT_ADDRESS  0x29        ///< 7-bit address after reset
+#define VL53LX_BRINGUP_DONE             UINT32_MAX  ///< VL53LX_BringupStep(): nothing left to do
+
+/**
+ * @brief Sensor bring-up state
+ */
+typedef enum {
+    VL53LX_BRINGUP_PENDING = 0,          ///< Held in reset, waiting for the default address
+    VL53LX_BRINGUP_BOOTING,              ///< XSHUT released, firmware booting at the default address
+    VL53LX_BRINGUP_ADDRESSED,            ///< Final address assigned, waiting for DataInit
+    VL53LX_BRINGUP_READY,                ///< DataInit done
+    VL53LX_BRINGUP_FAILED,               ///< Failed, held in reset again
+} vl53lx_bringup_state_t;
+
+/**
+ * @brief Board hooks
+ *
+ * Each callback returns true on success.
+ */
+typedef struct {
+    /** Drive the XSHUT pin of sensor @p index (true = released) */
+    bool (*set_xshut)(void *ctx, uint8_t index, bool release);
+    /**
+     * Point the platform handle of @p dev at 7-bit @p address. Called with
+     * the default address before the first boot poll and with the final
+     * address after the address change. On ESP-IDF this is
+     * VL53LX_PlatformDeinit() followed by VL53LX_PlatformInit().
+     */
+    bool (*bind)(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address);
+    /**
+     * Optional, may be NULL. Called at the final address right before
+     * DataInit. Returning false fails the sensor.
+     */
+    bool (*before_init)(void *ctx, uint8_t index, VL53LX_DEV dev);
+    void *ctx;                           ///< Board context passed to every callback
+} vl53lx_bringup_hal_t;
+
+/**
+ * @brief Bring-up configuration
+ */
+typedef struct {
+    uint32_t reset_hold_us;              ///< XSHUT low time before the first release (default: 1000)
+    uint32_t boot_time_us;               ///< Wait after release before the first boot poll (default: 1200)
+    uint32_t poll_interval_us;           ///< Boot poll interval (default: 500)
+    uint32_t boot_timeout_us;            ///< Release to boot complete limit (default: 500000)
+    bool data_init;                      ///< Run DataInit, false marks sensors READY once addressed (default: true)
+    VL53LX_DistanceModes distance_mode;  ///< Set after DataInit, 0 keeps the DataInit default (default: 0)
+    /**
+     * Apply the stored calibration of each sensor after DataInit and
+     * distance_mode, NULL to skip (default: NULL). The record must have
+     * been saved in the same distance mode. A missing, corrupt or stale
+     * record leaves the sensor READY with its cal_status set, so the
+     * application can calibrate it and call VL53LX_CalStoreSave().
+     */
+    const vl53lx_cal_storage_t *cal_storage;
+} vl53lx_bringup_config_t;
+
+/**
+ * @brief Phase timestamps of one sensor, microseconds from VL53LX_BringupStart()
+ */
+typedef struct {
+    uint32_t release_us;                 ///< XSHUT released
+    uint32_t booted_us;                  ///< Boot completion seen
+    uint32_t addressed_us;               ///< Final address assigned
+    uint32_t init_start_us;              ///< DataInit started
+    uint32_t ready_us;                   ///< DataInit (and the stored calibration) finished
+    uint16_t boot_polls;                 ///< Boot status reads
+} vl53lx_bringup_timing_t;
+
+/**
+ * @brief One sensor
+ */
+typedef struct {
+    VL53LX_DEV dev;                      ///< Device handle
+    VL53LX_nvm_cache_t *nvm_cache;       ///< Optional NVM cache for DataInit, may be NULL
+    uint8_t address;                     ///< Final 7-bit address
+    vl53lx_bringup_state_t state;        ///< Current state
+    VL53LX_Error error;                  ///< Driver error of a FAILED sensor
+    vl53lx_cal_store_status_t cal_status;  ///< VL53LX_CalStoreApply() result, only with cal_storage
+    uint32_t next_poll_us;               ///< Next boot poll, BOOTING only
+    vl53lx_bringup_timing_t timing;      ///< Phase timestamps
+} vl53lx_bringup_device_t;
+
+/**
+ * @brief Bring-up state structure
+ */
+typedef struct {
+    vl53lx_bringup_config_t config;      ///< Bring-up configuration
+    vl53lx_bringup_hal_t hal;            ///< Board hooks
+    vl53lx_bringup_device_t devices[VL53LX_BRINGUP_MAX_DEVICES];  ///< Sensors in AddDevice order
+    uint8_t count;                       ///< Number of sensors
+    uint8_t order[VL53LX_BRINGUP_MAX_DEVICES];  ///< Release order, default address last
+    uint8_t next_release;                ///< Position in order[] of the next release
+    int8_t booting;                      ///< Sensor at the default address, -1 if none
+    uint32_t start_us;                   ///< Timer value at VL53LX_BringupStart()
+    uint32_t total_us;                   ///< Start to last sensor finished
+    bool started;                        ///< VL53LX_BringupStart() called
+    bool initialized;                    ///< Bring-up initialized flag
+} vl53lx_bringup_t;
+
+/**
+ * @brief Get default bring-up configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_bringup_config_t VL53LX_BringupGetDefaultConfig(void);
+
+/**
+ * @brief Initialize bring-up with default configuration
+ *
+ * @param bringup Pointer to bring-up structure
+ * @param hal Board hooks, set_xshut and bind are required
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_BringupInit(vl53lx_bringup_t *bringup, const vl53lx_bringup_hal_t *hal);
+
+/**
+ * @brief Initialize bring-up with custom configuration
+ *
+ * @param bringup Pointer to bring-up structure
+ * @param hal Board hooks, set_xshut and bind are required
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_BringupInitWithConfig(vl53lx_bringup_t *bringup, const vl53lx_bringup_hal_t *hal,
+                                  const vl53lx_bringup_config_t *config);
+
+/**
+ * @brief Add a sensor
+ *
+ * The sensor index passed to the hooks is the order of the calls. At most
+ * one sensor may keep VL53LX_BRINGUP_DEFAULT_ADDRESS; it is released last.
+ *
+ * @param bringup Pointer to bring-up structure
+ * @param dev Device handle
+ * @param address Final 7-bit address
+ * @param nvm_cache Optional NVM cache, see VL53LX_DataInitWithNvmCache()
+ * @return true if successful, false if full, started or the address is taken
+ */
+bool VL53LX_BringupAddDevice(vl53lx_bringup_t *bringup, VL53LX_DEV dev, uint8_t address,
+                             VL53LX_nvm_cache_t *nvm_cache);
+
+/**
+ * @brief Put every sensor in reset
+ *
+ * Drives all XSHUT pins low and waits reset_hold_us. Timestamps are
+ * relative to the end of this call.
+ *
+ * @param bringup Pointer to bring-up structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_BringupStart(vl53lx_bringup_t *bringup);
+
+/**
+ * @brief Run the next due action
+ *
+ * Actions by priority: release the next sensor when the default address
+ * is free, poll the booting sensor, run DataInit of an addressed sensor.
+ * Only DataInit blocks, for its bus transfers and short NVM waits; the
+ * step itself never sleeps.
+ *
+ * @param bringup Pointer to bring-up structure, started
+ * @return 0 to call again at once, the microseconds until the next action
+ *         is due, or VL53LX_BRINGUP_DONE
+ */
+uint32_t VL53LX_BringupStep(vl53lx_bringup_t *bringup);
+
+/**
+ * @brief Start and step until done, waiting with VL53LX_WaitUs()
+ *
+ * @param bringup Pointer to bring-up structure
+ * @return Number of READY sensors
+ */
+uint8_t VL53LX_BringupRun(vl53lx_bringup_t *bringup);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_BRINGUP_H
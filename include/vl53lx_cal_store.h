@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_cal_store.h
+ * @brief VL53LX Persistent Calibration Store
+ *
+ * Keeps the VL53LX_CalibrationData_t of each sensor in non-volatile
+ * storage so that calibration runs once instead of at every boot:
+ * - One record per sensor, keyed by the UID from VL53LX_GetUID()
+ * - Versioned header and CRC-32 over the whole record
+ * - Invalidated when the driver version, calibration structure or
+ *   device preset mode differs from the running driver
+ * - Abstract key-value storage with ESP-IDF NVS and file backends
+ * - The same record format caches the factory NVM data read by
+ *   VL53LX_DataInitWithNvmCache(), one record per board slot
+ */
+
+#ifndef VL53LX_CAL_STORE_H
+#define VL53LX_CAL_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "vl53lx_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VL53LX_CAL_STORE_MAGIC          0x42435856u  ///< "VXCB"
+#define VL53LX_NVM_CACHE_STORE_MAGIC    0x434E5856u  ///< "VXNC"
+#define VL53LX_CAL_STORE_FORMAT_VERSION 1            ///< Record layout version
+#define VL53LX_CAL_STORE_KEY_SIZE       16           ///< Key buffer size, fits an NVS key
+
+/**
+ * @brief Key-value storage backend
+ *
+ * Each callback returns true on success. read() must return false if
+ * @p key does not exist and report the stored length in @p out_len; a
+ * record longer than @p size may be truncated.
+ */
+typedef struct {
+    bool (*read)(void *ctx, const char *key, void *buf, size_t size, size_t *out_len);
+    bool (*write)(void *ctx, const char *key, const void *buf, size_t size);
+    bool (*erase)(void *ctx, const char *key);
+    void *ctx;                           ///< Backend context passed to every callback
+} vl53lx_cal_storage_t;
+
+/**
+ * @brief Result of loading a stored record
+ */
+typedef enum {
+    VL53LX_CAL_STORE_OK = 0,             ///< Record valid (and applied)
+    VL53LX_CAL_STORE_NOT_FOUND,          ///< No record for this sensor
+    VL53LX_CAL_STORE_CORRUPT,            ///< Bad magic, size or CRC
+    VL53LX_CAL_STORE_STALE,              ///< Driver version, structure or preset changed
+    VL53LX_CAL_STORE_UID_MISMATCH,       ///< Record belongs to another sensor
+    VL53LX_CAL_STORE_STORAGE_ERROR,      ///< Backend read, write or erase failed
+    VL53LX_CAL_STORE_DEVICE_ERROR,       ///< Driver call failed
+} vl53lx_cal_store_status_t;
+
+/**
+ * @brief Record header, followed by VL53LX_CalibrationData_t or VL53LX_nvm_cache_data_t
+ */
+typedef struct {
+    uint32_t magic;                      ///< Record type, e.g. VL53LX_CAL_STORE_MAGIC
+    uint16_t format_version;             ///< VL53LX_CAL_STORE_FORMAT_VERSION
+    uint16_t payload_size;               ///< Payload size in bytes
+    uint32_t driver_version;             ///< Implementation major.minor.sub.revision, packed
+    uint32_t struct_version;             ///< Payload struct_version
+    uint64_t uid;                        ///< Sensor UID
+    uint8_t preset_mode;                 ///< Device preset mode at save time (0 for the NVM cache)
+    uint8_t reserved[3];
+    uint32_t crc32;                      ///< CRC-32 of header (this field zero) and payload
+} vl53lx_cal_record_header_t;
+
+/**
+ * @brief Build the calibration storage key of a sensor
+ *
+ * The key is "cal" followed by 12 hex digits of the folded UID. The full
+ * UID is kept in the record and checked on load. After DataInit the UID
+ * read with the factory calibration is used, so no NVM session is needed.
+ *
+ * @param uid Sensor UID from VL53LX_GetUID()
+ * @param key Output buffer of VL53LX_CAL_STORE_KEY_SIZE bytes
+ */
+void VL53LX_CalStoreMakeKey(uint64_t uid, char key[VL53LX_CAL_STORE_KEY_SIZE]);
+
+/**
+ * @brief Read the device calibration and store it
+ *
+ * Call after the offset and crosstalk calibrations, in the preset mode
+ * the record should be valid for.
+ *
+ * @param Dev Device handle
+ * @param storage Storage backend
+ * @return VL53LX_CAL_STORE_OK, _DEVICE_ERROR or _STORAGE_ERROR
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreSave(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage);
+
+/**
+ * @brief Load and validate the record of a sensor without applying it
+ *
+ * @param Dev Device handle
+ * @param storage Storage backend
+ * @param cal Output calibration data, valid only on VL53LX_CAL_STORE_OK
+ * @return Load status
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreLoad(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage,
+                                              VL53LX_CalibrationData_t *cal);
+
+/**
+ * @brief Apply the stored calibration on init
+ *
+ * Call after VL53LX_DataInit() and VL53LX_SetDistanceMode(). A valid
+ * record is written with VL53LX_SetCalibrationData(). Corrupt and stale
+ * records are erased, so the caller can run its calibration and
+ * VL53LX_CalStoreSave() whenever the result is not VL53LX_CAL_STORE_OK.
+ *
+ * @param Dev Device handle
+ * @param storage Storage backend
+ * @return Load status
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreApply(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage);
+
+/**
+ * @brief Erase the record of a sensor
+ *
+ * @param Dev Device handle
+ * @param storage Storage backend
+ * @return VL53LX_CAL_STORE_OK, _DEVICE_ERROR or _STORAGE_ERROR
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreErase(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage);
+
+/**
+ * @brief Load the NVM cache of a board slot
+ *
+ * Call before VL53LX_DataInitWithNvmCache(). The UID of the sensor is not
+ * known before DataInit without an NVM session of its own, so records are
+ * keyed by the board slot ("nvm" + 2 hex digits) and the sensor is not
+ * accessed. DataInit uses the cache only if it matches the factory data
+ * the firmware copied into registers at boot and the UID in the NVM, so a
+ * replaced sensor falls back to a full read. Sets cache->valid when an intact record for this
+ * driver version was found; verify_words and verify_seed are left to the
+ * caller.
+ *
+ * @param storage Storage backend
+ * @param slot Board position of the sensor, e.g. its bring-up index
+ * @param cache NVM cache to fill
+ * @return Load status
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreLoadNvmCache(const vl53lx_cal_storage_t *storage, uint8_t slot,
+                                                      VL53LX_nvm_cache_t *cache);
+
+/**
+ * @brief Store the NVM cache of a board slot
+ *
+ * Call after VL53LX_DataInitWithNvmCache() when cache->updated is set.
+ *
+ * @param storage Storage backend
+ * @param slot Board position of the sensor, as for VL53LX_CalStoreLoadNvmCache()
+ * @param cache NVM cache filled by VL53LX_DataInitWithNvmCache()
+ * @return VL53LX_CAL_STORE_OK or _STORAGE_ERROR
+ */
+vl53lx_cal_store_status_t VL53LX_CalStoreSaveNvmCache(const vl53lx_cal_storage_t *storage, uint8_t slot,
+                                                      const VL53LX_nvm_cache_t *cache);
+
+/**
+ * @brief Set up a file backend
+ *
+ * Records are stored as @p directory/<key>.bin and replaced atomically
+ * through a temporary file. Intended for host tests and VFS mounted
+ * file systems.
+ *
+ * @param storage Storage structure to fill
+ * @param directory Existing directory, must outlive @p storage
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_CalStorageInitFile(vl53lx_cal_storage_t *storage, const char *directory);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Set up an ESP-IDF NVS backend
+ *
+ * nvs_flash_init() must have been called.
+ *
+ * @param storage Storage structure to fill
+ * @param nvs_namespace NVS namespace (max 15 characters), must outlive @p storage
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_CalStorageInitNvs(vl53lx_cal_storage_t *storage, const char *nvs_namespace);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_CAL_STORE_H
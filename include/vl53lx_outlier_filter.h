@@ -11,6 +11,13 @@
  * - Prediction-only mode for invalid observations
  * - Range status validation
  * - Rate-of-change limiter
+ * - Optional fixed-point state (distance Q16.16, variances Q12.20): no
+ *   floating point per sample, for ISRs and cores without an FPU
+ * - Batch update of a sample array, and a structure-of-arrays bank that
+ *   steps K filters per call; both give the same results as
+ *   VL53LX_FilterUpdate()
+ * - Adaptive update: measurement noise from each sample's sigma and
+ *   signal rate, rate limit scaled by the time between samples
  */
 
 #ifndef VL53LX_OUTLIER_FILTER_H
@@ -18,11 +25,16 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef VL53LX_FILTER_BANK_MAX_CHANNELS
+#define VL53LX_FILTER_BANK_MAX_CHANNELS 8       ///< Channels per filter bank
+#endif
+
 /**
  * @brief Kalman filter configuration
  */
@@ -35,6 +47,14 @@ typedef struct {
     // Kalman filter parameters
     float kalman_process_noise;          ///< Process noise covariance Q (default: 1.0)
     float kalman_measurement_noise;      ///< Measurement noise covariance R (default: 4.0)
+    bool fixed_point;                    ///< Fixed-point state, no floating point in VL53LX_FilterUpdate() (default: false)
+
+    // VL53LX_FilterUpdateAdaptive() only: R = (scale * sigma)^2 + signal_noise / signal rate, clamped
+    float adaptive_sigma_scale;          ///< Factor on SigmaMilliMeter (default: 1.0)
+    float adaptive_signal_noise;         ///< R term in mm^2 * Mcps over SignalRateRtnMegaCps, 0 = unused (default: 0.0)
+    float adaptive_noise_min;            ///< Lower R limit (default: 1.0)
+    float adaptive_noise_max;            ///< Upper R limit, below 4096 with fixed_point (default: 2500.0)
+    uint32_t max_change_rate_mm_s;       ///< Rate limit per second since the last accepted sample, 0 = max_change_rate_mm (default: 15000)
 } vl53lx_filter_config_t;
 
 /**
@@ -51,9 +71,48 @@ typedef struct {
     float kalman_p;                      ///< Estimation error covariance
     bool kalman_initialized;             ///< Kalman filter initialized flag
 
+    // Fixed-point Kalman state, fixed_point only
+    uint32_t kalman_x_q16;               ///< Estimated state (distance in mm), Q16.16
+    uint32_t kalman_p_q20;               ///< Estimation error covariance, Q12.20
+    uint32_t kalman_q_q20;               ///< Process noise Q, Q12.20, converted at init
+    uint32_t kalman_r_q20;               ///< Measurement noise R, Q12.20, converted at init
+
+    // Adaptive update state
+    uint32_t adaptive_sigma_scale_q20;   ///< adaptive_sigma_scale, Q12.20, fixed_point only
+    uint32_t adaptive_signal_noise_q20;  ///< adaptive_signal_noise, Q12.20, fixed_point only
+    uint32_t adaptive_noise_min_q20;     ///< adaptive_noise_min, Q12.20, fixed_point only
+    uint32_t adaptive_noise_max_q20;     ///< adaptive_noise_max, Q12.20, fixed_point only
+    uint32_t last_accept_us;             ///< Timestamp of the last accepted sample
+    bool has_accept_time;                ///< last_accept_us is set
+
     bool initialized;                    ///< Filter initialized flag
 } vl53lx_filter_t;
 
+/**
+ * @brief K filters with one configuration, state as structure of arrays
+ *
+ * Channel c behaves exactly like its own vl53lx_filter_t.
+ */
+typedef struct {
+    vl53lx_filter_config_t config;       ///< Configuration of every channel
+    uint8_t channels;                    ///< Number of channels
+
+    uint16_t last_output[VL53LX_FILTER_BANK_MAX_CHANNELS];          ///< Last filtered output value
+    uint8_t rejected_count[VL53LX_FILTER_BANK_MAX_CHANNELS];        ///< Consecutive rejected samples count
+    uint8_t samples_since_reset[VL53LX_FILTER_BANK_MAX_CHANNELS];   ///< Samples accepted since last reset
+    uint8_t kalman_initialized[VL53LX_FILTER_BANK_MAX_CHANNELS];    ///< Kalman filter initialized flag, 0/1 (bool stops vectorisation)
+
+    float kalman_x[VL53LX_FILTER_BANK_MAX_CHANNELS];                ///< Estimated state (distance in mm)
+    float kalman_p[VL53LX_FILTER_BANK_MAX_CHANNELS];                ///< Estimation error covariance
+
+    uint32_t kalman_x_q16[VL53LX_FILTER_BANK_MAX_CHANNELS];         ///< Estimated state, fixed_point only
+    uint32_t kalman_p_q20[VL53LX_FILTER_BANK_MAX_CHANNELS];         ///< Covariance, fixed_point only
+    uint32_t kalman_q_q20;               ///< Process noise Q, fixed_point only
+    uint32_t kalman_r_q20;               ///< Measurement noise R, fixed_point only
+
+    bool initialized;                    ///< Bank initialized flag
+} vl53lx_filter_bank_t;
+
 /**
  * @brief Initialize Kalman filter with default configuration
  *
@@ -88,7 +147,9 @@ void VL53LX_FilterReset(vl53lx_filter_t *filter);
 /**
  * @brief Process new measurement through Kalman filter
  *
- * Uses prediction-only mode for invalid observations.
+ * Uses prediction-only mode for invalid observations. With
+ * config.fixed_point the update uses integer arithmetic only. Variances
+ * saturate at 4096 mm^2, so Q and R must stay below that.
  *
  * @param filter Pointer to filter structure
  * @param distance_mm Raw distance measurement (mm)
@@ -98,6 +159,78 @@ void VL53LX_FilterReset(vl53lx_filter_t *filter);
  */
 bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status, uint16_t *output_mm);
 
+/**
+ * @brief Process an array of measurements through the filter
+ *
+ * Same results as calling VL53LX_FilterUpdate() for each sample, with
+ * the argument checks done once.
+ *
+ * @param filter Pointer to filter structure
+ * @param distance_mm Raw distance measurements (mm), @p count entries
+ * @param range_status Range statuses, @p count entries
+ * @param count Number of samples
+ * @param output_mm Filtered outputs, left unchanged where not valid
+ * @param output_valid Per-sample return value of VL53LX_FilterUpdate(), may be NULL
+ * @return Number of valid outputs
+ */
+size_t VL53LX_FilterUpdateBatch(vl53lx_filter_t *filter, const uint16_t *distance_mm, const uint8_t *range_status,
+                                size_t count, uint16_t *output_mm, bool *output_valid);
+
+/**
+ * @brief Process a new measurement with its own measurement noise
+ *
+ * As VL53LX_FilterUpdate(), except that R is derived from the sample's
+ * sigma and signal rate, and the rate limit is max_change_rate_mm_s times
+ * the time since the last accepted sample, rounded up and at least 1 mm
+ * (max_change_rate_mm until one was accepted through this call). A long gap therefore allows a larger
+ * change instead of rejecting the new distance five times.
+ *
+ * @param filter Pointer to filter structure
+ * @param distance_mm Raw distance measurement (mm)
+ * @param range_status Range status from sensor
+ * @param sigma_mm SigmaMilliMeter of the target, Q16.16 (FixPoint1616_t)
+ * @param signal_rate_mcps SignalRateRtnMegaCps of the target, Q16.16 (FixPoint1616_t)
+ * @param timestamp_us Measurement time in microseconds
+ * @param output_mm Filtered output distance (mm)
+ * @return true if output is valid, false if filter not yet initialized
+ */
+bool VL53LX_FilterUpdateAdaptive(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status,
+                                 uint32_t sigma_mm, uint32_t signal_rate_mcps, uint32_t timestamp_us,
+                                 uint16_t *output_mm);
+
+/**
+ * @brief Initialize a filter bank
+ *
+ * @param bank Pointer to bank structure
+ * @param config Configuration of every channel
+ * @param channels Number of channels, 1 to VL53LX_FILTER_BANK_MAX_CHANNELS
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_FilterBankInit(vl53lx_filter_bank_t *bank, const vl53lx_filter_config_t *config, uint8_t channels);
+
+/**
+ * @brief Reset every channel of a filter bank
+ *
+ * @param bank Pointer to bank structure
+ */
+void VL53LX_FilterBankReset(vl53lx_filter_bank_t *bank);
+
+/**
+ * @brief Process one measurement per channel
+ *
+ * Same results as VL53LX_FilterUpdate() on each channel's own filter. The
+ * float Kalman step runs over all channels without branches.
+ *
+ * @param bank Pointer to bank structure
+ * @param distance_mm Raw distance measurement (mm) per channel
+ * @param range_status Range status per channel
+ * @param output_mm Filtered output per channel, left unchanged where not valid
+ * @param output_valid Per-channel return value of VL53LX_FilterUpdate(), may be NULL
+ * @return Number of valid outputs
+ */
+uint8_t VL53LX_FilterBankUpdate(vl53lx_filter_bank_t *bank, const uint16_t *distance_mm,
+                                const uint8_t *range_status, uint16_t *output_mm, bool *output_valid);
+
 /**
  * @brief Get default Kalman filter configuration (Q=1.0, R=4.0)
  *
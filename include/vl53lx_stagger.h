@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_stagger.h
+ * @brief VL53LX Phase-Staggered Ranging Schedule
+ *
+ * Spreads the measurements of N sensors over a common frame period:
+ * - Sensor i starts at phase i * period / N of every frame
+ * - Automatic period: the shortest one without overlapping VCSEL emission
+ *   or overlapping bus transfers
+ * - Planned emission margin and bus-idle margin
+ * - Achieved phase error and skipped frames per sensor
+ *
+ * The L3CX driver always ranges back-to-back, so the phase is set by when
+ * the next measurement is started (VL53LX_ClearInterruptAndStartMeasurement()),
+ * not by the inter-measurement period. The schedule does no device access;
+ * the caller starts the sensors it reports as due.
+ */
+
+#ifndef VL53LX_STAGGER_H
+#define VL53LX_STAGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_STAGGER_MAX_SENSORS
+#define VL53LX_STAGGER_MAX_SENSORS      8       ///< Sensors per schedule
+#endif
+
+#define VL53LX_STAGGER_NONE             UINT32_MAX  ///< VL53LX_StaggerUntilNext(): nothing pending
+
+/**
+ * @brief Schedule configuration
+ */
+typedef struct {
+    uint32_t frame_period_us;            ///< Frame period, 0 for the automatic period (default: 0)
+    uint32_t guard_us;                   ///< Minimum gap between windows (default: 1000)
+    uint32_t start_bus_us;               ///< Bus time of a measurement start (default: 1700)
+    uint32_t readout_bus_us;             ///< Bus time of a result readout (default: 2100)
+} vl53lx_stagger_config_t;
+
+/**
+ * @brief One sensor in the schedule
+ */
+typedef struct {
+    uint32_t measure_us;                 ///< Measurement time, start to data ready
+    uint32_t phase_us;                   ///< Start phase within the frame
+    uint32_t next_start_us;              ///< Target time of the next start
+    uint32_t last_start_us;              ///< Time of the last start
+    bool pending;                        ///< Waiting for next_start_us
+
+    // Achieved timing
+    uint32_t starts;                     ///< Measurements started
+    uint32_t skipped_frames;             ///< Frames missed because the readout came too late
+    int32_t phase_error_us;              ///< Last start minus its target
+    uint32_t phase_error_max_us;         ///< Worst absolute phase error
+    uint64_t phase_error_sum_us;         ///< Sum of absolute phase errors, for the mean
+} vl53lx_stagger_slot_t;
+
+/**
+ * @brief Schedule state structure
+ */
+typedef struct {
+    vl53lx_stagger_config_t config;      ///< Schedule configuration
+    vl53lx_stagger_slot_t slots[VL53LX_STAGGER_MAX_SENSORS];  ///< Sensors in AddSensor order
+    uint8_t count;                       ///< Number of sensors
+    uint32_t period_us;                  ///< Frame period in use
+    int32_t emission_margin_us;          ///< Smallest gap between emission windows, negative if they overlap
+    int32_t bus_idle_margin_us;          ///< Smallest idle gap between bus windows, negative if they overlap
+    uint32_t epoch_us;                   ///< Start of frame 0
+    bool planned;                        ///< VL53LX_StaggerPlan() done
+    bool initialized;                    ///< Schedule initialized flag
+} vl53lx_stagger_t;
+
+/**
+ * @brief Get default schedule configuration
+ *
+ * The bus times are those of one VL53L3CX in histogram mode at 400 kHz.
+ *
+ * @return Default configuration structure
+ */
+vl53lx_stagger_config_t VL53LX_StaggerGetDefaultConfig(void);
+
+/**
+ * @brief Initialize schedule with default configuration
+ *
+ * @param stagger Pointer to schedule structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_StaggerInit(vl53lx_stagger_t *stagger);
+
+/**
+ * @brief Initialize schedule with custom configuration
+ *
+ * @param stagger Pointer to schedule structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_StaggerInitWithConfig(vl53lx_stagger_t *stagger, const vl53lx_stagger_config_t *config);
+
+/**
+ * @brief Add a sensor
+ *
+ * @param stagger Pointer to schedule structure
+ * @param measure_us Measurement time from start to data ready, about the timing budget
+ * @return Sensor index, or -1 if full or already planned
+ */
+int VL53LX_StaggerAddSensor(vl53lx_stagger_t *stagger, uint32_t measure_us);
+
+/**
+ * @brief Assign the phases and compute the margins
+ *
+ * @param stagger Pointer to schedule structure
+ * @return true if successful, false without sensors
+ */
+bool VL53LX_StaggerPlan(vl53lx_stagger_t *stagger);
+
+/**
+ * @brief Start frame 0 at @p now_us and make every first start pending
+ *
+ * @param stagger Pointer to schedule structure, planned
+ * @param now_us Current time in microseconds
+ */
+void VL53LX_StaggerBegin(vl53lx_stagger_t *stagger, uint32_t now_us);
+
+/**
+ * @brief Sensors whose start is due
+ *
+ * @param stagger Pointer to schedule structure
+ * @param now_us Current time in microseconds
+ * @return Bit mask of due sensors
+ */
+uint32_t VL53LX_StaggerDue(const vl53lx_stagger_t *stagger, uint32_t now_us);
+
+/**
+ * @brief Time until the next pending start
+ *
+ * @param stagger Pointer to schedule structure
+ * @param now_us Current time in microseconds
+ * @return Microseconds, 0 if a start is due, or VL53LX_STAGGER_NONE
+ */
+uint32_t VL53LX_StaggerUntilNext(const vl53lx_stagger_t *stagger, uint32_t now_us);
+
+/**
+ * @brief Record that sensor @p index was started at @p now_us
+ *
+ * @param stagger Pointer to schedule structure
+ * @param index Sensor index
+ * @param now_us Start time in microseconds
+ */
+void VL53LX_StaggerStarted(vl53lx_stagger_t *stagger, uint8_t index, uint32_t now_us);
+
+/**
+ * @brief Schedule the next start of sensor @p index after its readout
+ *
+ * The next start is the sensor's phase in the first frame that has not
+ * begun yet; frames passed over are counted as skipped.
+ *
+ * @param stagger Pointer to schedule structure
+ * @param index Sensor index
+ * @param now_us Current time in microseconds
+ */
+void VL53LX_StaggerRearm(vl53lx_stagger_t *stagger, uint8_t index, uint32_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_STAGGER_H
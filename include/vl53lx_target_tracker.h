@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_target_tracker.h
+ * @brief VL53LX Frame-to-Frame Multi-Target Tracker
+ *
+ * Associates the up to VL53LX_MAX_RANGE_RESULTS targets of each
+ * VL53LX_MultiRangingData_t frame with persistent tracks:
+ * - Nearest-neighbour or range/signal gated association
+ * - Stable track IDs with an alpha-beta range and velocity estimate
+ * - Birth (tentative -> confirmed) and death (missed frames) rules
+ * - Fixed-size state, no dynamic allocation
+ */
+
+#ifndef VL53LX_TARGET_TRACKER_H
+#define VL53LX_TARGET_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vl53lx_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_TRACKER_MAX_TRACKS
+#define VL53LX_TRACKER_MAX_TRACKS   8   ///< Track slots per tracker
+#endif
+
+/**
+ * @brief Association method
+ */
+typedef enum {
+    VL53LX_TRACKER_ASSOC_NEAREST = 0,    ///< Nearest predicted range within the range gate
+    VL53LX_TRACKER_ASSOC_GATED,          ///< Range and signal gates, cost includes the signal ratio
+} vl53lx_tracker_assoc_t;
+
+/**
+ * @brief Track life cycle state
+ */
+typedef enum {
+    VL53LX_TRACK_FREE = 0,               ///< Slot unused
+    VL53LX_TRACK_TENTATIVE,              ///< Born, not yet confirmed
+    VL53LX_TRACK_CONFIRMED,              ///< Confirmed, reported to the application
+} vl53lx_track_state_t;
+
+/**
+ * @brief Tracker configuration
+ */
+typedef struct {
+    vl53lx_tracker_assoc_t association;  ///< Association method (default: GATED)
+    uint16_t gate_range_mm;              ///< Max |predicted - measured| range (default: 300)
+    float gate_signal_ratio;             ///< Max signal ratio track/target, GATED only (default: 4.0)
+    float signal_cost_mm;                ///< Cost in mm per unit of signal ratio above 1, GATED only (default: 50.0)
+    uint32_t valid_status_mask;          ///< Bitmask of RangeStatus values used as detections (default: 0x01)
+    uint8_t confirm_hits;                ///< Associated frames before a track is confirmed (default: 3)
+    uint8_t max_misses;                  ///< Missed frames before a confirmed track is deleted (default: 5)
+    float alpha;                         ///< Range correction gain, 0..1 (default: 0.5)
+    float beta;                          ///< Velocity correction gain, 0..1 (default: 0.2)
+} vl53lx_tracker_config_t;
+
+/**
+ * @brief One track
+ */
+typedef struct {
+    uint16_t id;                         ///< Stable track ID, never 0 for a live track
+    vl53lx_track_state_t state;          ///< Life cycle state
+    float range_mm;                      ///< Estimated range (mm)
+    float velocity_mm_s;                 ///< Estimated range rate (mm/s, negative = approaching)
+    float signal_mcps;                   ///< Smoothed signal rate (Mcps)
+    uint8_t hits;                        ///< Associated frames since birth (saturates at 255)
+    uint8_t misses;                      ///< Consecutive frames without association
+    uint8_t target_index;                ///< RangeData index used this frame, 0xFF if coasting
+} vl53lx_track_t;
+
+/**
+ * @brief Tracker state structure
+ */
+typedef struct {
+    vl53lx_tracker_config_t config;      ///< Tracker configuration
+    vl53lx_track_t tracks[VL53LX_TRACKER_MAX_TRACKS];  ///< Track slots
+    uint16_t next_id;                    ///< Next track ID to assign
+    uint32_t last_timestamp_ms;          ///< Timestamp of the previous frame
+    bool has_timestamp;                  ///< last_timestamp_ms is valid
+    bool initialized;                    ///< Tracker initialized flag
+} vl53lx_tracker_t;
+
+/**
+ * @brief Get default tracker configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_tracker_config_t VL53LX_TrackerGetDefaultConfig(void);
+
+/**
+ * @brief Initialize tracker with default configuration
+ *
+ * @param tracker Pointer to tracker structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TrackerInit(vl53lx_tracker_t *tracker);
+
+/**
+ * @brief Initialize tracker with custom configuration
+ *
+ * @param tracker Pointer to tracker structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TrackerInitWithConfig(vl53lx_tracker_t *tracker, const vl53lx_tracker_config_t *config);
+
+/**
+ * @brief Drop all tracks (track IDs keep counting)
+ *
+ * @param tracker Pointer to tracker structure
+ */
+void VL53LX_TrackerReset(vl53lx_tracker_t *tracker);
+
+/**
+ * @brief Process one ranging frame
+ *
+ * Predicts every track to @p timestamp_ms, associates the valid targets of
+ * @p data, updates matched tracks, ages unmatched ones and starts tentative
+ * tracks for unmatched targets. Tentative tracks are dropped on their first
+ * miss; confirmed tracks after max_misses consecutive misses.
+ *
+ * @param tracker Pointer to tracker structure
+ * @param data Ranging frame from VL53LX_GetMultiRangingData()
+ * @param timestamp_ms Frame time in milliseconds (e.g. esp_timer_get_time() / 1000)
+ * @return Number of confirmed tracks after the update
+ */
+uint8_t VL53LX_TrackerUpdate(vl53lx_tracker_t *tracker, const VL53LX_MultiRangingData_t *data,
+                             uint32_t timestamp_ms);
+
+/**
+ * @brief Copy confirmed tracks, nearest first
+ *
+ * @param tracker Pointer to tracker structure
+ * @param tracks Output array
+ * @param max_tracks Size of @p tracks
+ * @return Number of tracks copied
+ */
+uint8_t VL53LX_TrackerGetTracks(const vl53lx_tracker_t *tracker, vl53lx_track_t *tracks, uint8_t max_tracks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_TARGET_TRACKER_H
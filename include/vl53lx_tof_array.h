@@ -0,0 +1,305 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_tof_array.h
+ * @brief VL53LX N-Sensor Array Manager
+ *
+ * Owns any number of sensors on one I2C bus and serves them all from a
+ * single task:
+ * - Per-sensor XSHUT, INT, address, distance mode and timing budget
+ * - Bring-up through VL53LX_Bringup (one XSHUT release at a time)
+ * - One shared ISR, data-ready sensors collected in a bit mask
+ * - One service task reads the ready sensors and publishes samples
+ * - Per-sensor sample count, errors and interrupt-to-publish latency
+ * - Optional phase-staggered starts (VL53LX_Stagger) so that emission and
+ *   readouts of different sensors do not coincide
+ *
+ * The VL53LX_Dev_t of each sensor (about 12 KB, 10 KB with
+ * VL53LX_SCRATCH_SHARED) belongs to the caller and is passed to
+ * VL53LX_TofArrayAddSensor(); the array itself holds a vl53lx_tof_sensor_t
+ * per slot (under 100 bytes) and one read buffer. A sensor costs no task,
+ * stack or semaphore.
+ */
+
+#ifndef VL53LX_TOF_ARRAY_H
+#define VL53LX_TOF_ARRAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vl53lx_api.h"
+#include "vl53lx_bringup.h"
+#include "vl53lx_stagger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_TOF_ARRAY_MAX_SENSORS
+#define VL53LX_TOF_ARRAY_MAX_SENSORS    VL53LX_BRINGUP_MAX_DEVICES  ///< Sensors per array, at most 30
+#endif
+
+#define VL53LX_TOF_ARRAY_NO_GPIO        (-1)    ///< Pin not connected
+
+/**
+ * @brief Sensor configuration
+ */
+typedef struct {
+    const char *name;                    ///< Name for logs, may be NULL
+    int xshut_gpio;                      ///< XSHUT pin, VL53LX_TOF_ARRAY_NO_GPIO if hard-wired
+    int int_gpio;                        ///< GPIO1 (INT) pin, VL53LX_TOF_ARRAY_NO_GPIO to poll
+    uint8_t address;                     ///< Final 7-bit I2C address
+    VL53LX_DistanceModes distance_mode;  ///< VL53LX_DISTANCEMODE_SHORT/MEDIUM/LONG
+    uint32_t timing_budget_us;           ///< Timing budget, 0 keeps the driver default
+} vl53lx_tof_sensor_config_t;
+
+/**
+ * @brief Published sample
+ *
+ * Only valid during the callback; copy what must be kept.
+ */
+typedef struct {
+    uint8_t index;                       ///< Sensor index (AddSensor order)
+    const char *name;                    ///< Sensor name
+    uint32_t ready_us;                   ///< Interrupt (or poll) timestamp
+    uint32_t latency_us;                 ///< From ready_us to publish
+    const VL53LX_MultiRangingData_t *data;  ///< Ranging data
+} vl53lx_tof_sample_t;
+
+/**
+ * @brief Sample callback, runs in the service task
+ */
+typedef void (*vl53lx_tof_sample_cb_t)(void *ctx, const vl53lx_tof_sample_t *sample);
+
+/**
+ * @brief Per-sensor statistics
+ */
+typedef struct {
+    uint32_t samples;                    ///< Published samples
+    uint32_t errors;                     ///< Failed reads or restarts
+    uint32_t latency_max_us;             ///< Worst ready-to-publish latency
+    uint64_t latency_sum_us;             ///< Sum of latencies, for the mean
+} vl53lx_tof_sensor_stats_t;
+
+struct vl53lx_tof_array;
+
+/**
+ * @brief One sensor
+ */
+typedef struct {
+    vl53lx_tof_sensor_config_t config;   ///< Sensor configuration
+    VL53LX_Dev_t *dev;                   ///< Device, owned by the caller
+    vl53lx_tof_sensor_stats_t stats;     ///< Statistics
+    volatile uint32_t ready_us;          ///< Last interrupt timestamp, written by the ISR
+    struct vl53lx_tof_array *array;      ///< Owner, for the ISR
+    uint8_t index;                       ///< Index in the array
+    int8_t slot;                         ///< Index in the stagger schedule, -1 if not scheduled
+    bool ready;                          ///< Brought up and configured
+    bool running;                        ///< Ranging started
+    bool waiting;                        ///< Read, next start waits for its phase (staggered only)
+} vl53lx_tof_sensor_t;
+
+/**
+ * @brief Array configuration
+ */
+typedef struct {
+    vl53lx_tof_sample_cb_t on_sample;    ///< Sample callback (default: NULL)
+    void *ctx;                           ///< Callback context (default: NULL)
+    uint32_t task_stack_size;            ///< Service task stack in bytes (default: 4096)
+    uint8_t task_priority;               ///< Service task priority (default: 5)
+    uint32_t poll_timeout_ms;            ///< Without an interrupt for this long, poll data ready (default: 200)
+    uint32_t poll_interval_us;           ///< Data ready poll period of sensors without an INT pin (default: 2000)
+    bool staggered;                      ///< Start sensors at staggered phases (default: false)
+    vl53lx_stagger_config_t stagger;     ///< Schedule configuration, staggered only
+} vl53lx_tof_array_config_t;
+
+/**
+ * @brief Array state structure
+ */
+typedef struct vl53lx_tof_array {
+    vl53lx_tof_array_config_t config;    ///< Array configuration
+    vl53lx_tof_sensor_t sensors[VL53LX_TOF_ARRAY_MAX_SENSORS];  ///< Sensors in AddSensor order
+    uint8_t count;                       ///< Number of sensors
+    uint32_t poll_mask;                  ///< Sensors without an INT pin
+    uint32_t poll_us;                    ///< Last poll of the sensors without an INT pin
+    uint32_t event_us;                   ///< Last interrupt, or last poll of all sensors
+    VL53LX_MultiRangingData_t data;      ///< Read buffer, shared by all sensors
+    vl53lx_stagger_t stagger;            ///< Start schedule, staggered only
+#ifdef VL53LX_SCRATCH_SHARED
+    VL53LX_scratch_t scratch;            ///< Scratch arena shared by all sensors
+    VL53LX_scratch_buffer_t scratch_buffer;  ///< Scratch arena storage
+#endif
+    void *task;                          ///< Service task handle (ESP-IDF)
+    void *timer;                         ///< Start timer handle, staggered only (ESP-IDF)
+    volatile bool stop;                  ///< Service task stop request
+    bool initialized;                    ///< Array initialized flag
+} vl53lx_tof_array_t;
+
+/**
+ * @brief Get default array configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_tof_array_config_t VL53LX_TofArrayGetDefaultConfig(void);
+
+/**
+ * @brief Get default sensor configuration
+ *
+ * No pins, default address, medium distance mode and a 33 ms timing budget.
+ *
+ * @return Default sensor configuration
+ */
+vl53lx_tof_sensor_config_t VL53LX_TofArrayGetDefaultSensorConfig(void);
+
+/**
+ * @brief Initialize array with default configuration
+ *
+ * @param array Pointer to array structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofArrayInit(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Initialize array with custom configuration
+ *
+ * @param array Pointer to array structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofArrayInitWithConfig(vl53lx_tof_array_t *array, const vl53lx_tof_array_config_t *config);
+
+/**
+ * @brief Add a sensor
+ *
+ * @param array Pointer to array structure
+ * @param config Sensor configuration
+ * @param dev Device of the sensor, must stay valid as long as the array is used
+ * @return Sensor index, or -1 if full, @p dev is NULL or the address is taken
+ */
+int VL53LX_TofArrayAddSensor(vl53lx_tof_array_t *array, const vl53lx_tof_sensor_config_t *config,
+                             VL53LX_DEV dev);
+
+/**
+ * @brief Bring up and configure all sensors through board hooks
+ *
+ * Runs VL53LX_BringupRun() over the sensors, then sets the distance mode
+ * and timing budget of every sensor that came up. With
+ * VL53LX_SCRATCH_SHARED all sensors use one scratch arena, which is safe
+ * because only the service task calls into the driver.
+ *
+ * @param array Pointer to array structure
+ * @param hal Board hooks, the sensor index is the array index
+ * @return Number of ready sensors
+ */
+uint8_t VL53LX_TofArrayBringupWithHal(vl53lx_tof_array_t *array, const vl53lx_bringup_hal_t *hal);
+
+/**
+ * @brief Start ranging on every ready sensor
+ *
+ * When staggered, plans the schedule over the ready sensors, with the
+ * timing budget as measurement time, and starts only the sensors due now;
+ * the others are started by VL53LX_TofArrayRunDue().
+ *
+ * @param array Pointer to array structure
+ * @return Number of running (or scheduled) sensors
+ */
+uint8_t VL53LX_TofArrayStartRanging(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Stop ranging on every running sensor
+ *
+ * @param array Pointer to array structure
+ */
+void VL53LX_TofArrayStopRanging(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Find running sensors with data ready by polling the devices
+ *
+ * Fallback for sensors without an INT pin and for lost edges. Sets
+ * ready_us of each ready sensor to now.
+ *
+ * @param array Pointer to array structure
+ * @return Bit mask of ready sensors
+ */
+uint32_t VL53LX_TofArrayPollReady(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Ready mask for VL53LX_TofArrayService() after the service task woke up
+ *
+ * The sensors in @p notified (interrupts), plus the sensors without an INT
+ * pin when their poll_interval_us has elapsed, whatever woke the task,
+ * plus every running sensor when no interrupt came for poll_timeout_ms
+ * (missed edge).
+ *
+ * @param array Pointer to array structure
+ * @param notified Sensor bits set by the ISR, other bits are ignored
+ * @return Bit mask of ready sensors
+ */
+uint32_t VL53LX_TofArrayCollectReady(vl53lx_tof_array_t *array, uint32_t notified);
+
+/**
+ * @brief Start the staggered sensors whose phase has come
+ *
+ * @param array Pointer to array structure
+ * @return Microseconds until the next start, or VL53LX_STAGGER_NONE
+ */
+uint32_t VL53LX_TofArrayRunDue(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Read and publish the sensors in @p ready_mask
+ *
+ * For each sensor: VL53LX_GetMultiRangingData(), the sample callback,
+ * VL53LX_ClearInterruptAndStartMeasurement(). When staggered the restart
+ * is left to VL53LX_TofArrayRunDue() at the sensor's next phase. Sensors
+ * are served in index order, so the latency of a sensor grows with the
+ * number of sensors ready before it.
+ *
+ * @param array Pointer to array structure
+ * @param ready_mask Bit i set if sensor i has data ready
+ * @return Number of published samples
+ */
+uint8_t VL53LX_TofArrayService(vl53lx_tof_array_t *array, uint32_t ready_mask);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Bring up all sensors on an ESP-IDF I2C bus
+ *
+ * Configures the XSHUT pins as outputs and calls
+ * VL53LX_TofArrayBringupWithHal() with hooks that drive them and bind
+ * each device to @p bus.
+ *
+ * @param array Pointer to array structure
+ * @param bus I2C master bus handle
+ * @return Number of ready sensors
+ */
+uint8_t VL53LX_TofArrayBringup(vl53lx_tof_array_t *array, i2c_master_bus_handle_t bus);
+
+/**
+ * @brief Start ranging and the service task
+ *
+ * Installs one ISR for all INT pins (falling edge). The ISR stores the
+ * timestamp and sets the sensor bit in the task notification value; the
+ * task serves all set bits at once. With sensors without an INT pin the
+ * task also wakes every poll_interval_us to poll them. When staggered, a
+ * one-shot esp_timer wakes the task at the next start.
+ *
+ * @param array Pointer to array structure, brought up
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofArrayStart(vl53lx_tof_array_t *array);
+
+/**
+ * @brief Stop the service task and ranging, remove the ISR
+ *
+ * @param array Pointer to array structure
+ */
+void VL53LX_TofArrayStop(vl53lx_tof_array_t *array);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_TOF_ARRAY_H
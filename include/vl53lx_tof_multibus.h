@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_tof_multibus.h
+ * @brief VL53LX Multi-Bus ToF Array
+ *
+ * Spreads sensors over several I2C buses (the ESP32-S3 has two
+ * controllers), one VL53LX_TofArray per bus:
+ * - One worker context per bus: its own sensors, ISR bits and service task
+ * - Bus assignment that balances the expected bytes per second
+ * - Sensors pinned to a bus by wiring, auto-assigned ones fill the rest
+ * - The same address may be used once per bus
+ * - Per-bus and aggregate throughput
+ *
+ * Bus transfers of different buses overlap, so the sample throughput grows
+ * with the number of buses until the CPU becomes the limit. The sample
+ * callback is called from every bus task, possibly at the same time; the
+ * sample index is the multi-bus index (AddSensor order).
+ *
+ * The devices belong to the caller, as with VL53LX_TofArray: the multi-bus
+ * state is the per-bus arrays and the sensor table, about 3.3 KB for two
+ * buses of eight sensors, plus one VL53LX_Dev_t per sensor added.
+ */
+
+#ifndef VL53LX_TOF_MULTIBUS_H
+#define VL53LX_TOF_MULTIBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vl53lx_tof_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VL53LX_TOF_MULTIBUS_MAX_BUSES
+#define VL53LX_TOF_MULTIBUS_MAX_BUSES   2       ///< I2C controllers of the ESP32-S3
+#endif
+
+#define VL53LX_TOF_MULTIBUS_MAX_SENSORS (VL53LX_TOF_MULTIBUS_MAX_BUSES * VL53LX_TOF_ARRAY_MAX_SENSORS)
+#define VL53LX_TOF_MULTIBUS_AUTO        (-1)    ///< Let VL53LX_TofMultiBusAssign() choose the bus
+
+/**
+ * @brief Multi-bus configuration
+ */
+typedef struct {
+    uint8_t bus_count;                   ///< Buses in use (default: VL53LX_TOF_MULTIBUS_MAX_BUSES)
+    uint32_t scl_hz;                     ///< SCL frequency of every bus, for the capacity (default: 400000)
+    vl53lx_tof_array_config_t array;     ///< Configuration of each per-bus array, on_sample gets multi-bus indices
+} vl53lx_tof_multibus_config_t;
+
+/**
+ * @brief One sensor before and after assignment
+ */
+typedef struct {
+    vl53lx_tof_sensor_config_t config;   ///< Sensor configuration
+    VL53LX_Dev_t *dev;                   ///< Device, owned by the caller
+    int8_t requested_bus;                ///< Bus from the wiring, or VL53LX_TOF_MULTIBUS_AUTO
+    uint32_t bytes_per_second;           ///< Expected bus load
+    int8_t bus;                          ///< Assigned bus, -1 before assignment or if none fits
+    int8_t index;                        ///< Index in the bus array
+} vl53lx_tof_multibus_sensor_t;
+
+struct vl53lx_tof_multibus;
+
+/**
+ * @brief Worker context of one bus
+ */
+typedef struct {
+    vl53lx_tof_array_t array;            ///< Sensors and service task of this bus
+    struct vl53lx_tof_multibus *owner;   ///< Owner, for the sample callback
+    uint8_t sensor_index[VL53LX_TOF_ARRAY_MAX_SENSORS];  ///< Multi-bus index of each array index
+    uint32_t load_bytes_per_second;      ///< Expected load of the assigned sensors
+} vl53lx_tof_multibus_bus_t;
+
+/**
+ * @brief Throughput of one bus
+ */
+typedef struct {
+    uint32_t samples;                    ///< Published samples
+    uint32_t errors;                     ///< Read or restart errors
+    uint32_t samples_per_second;         ///< Over the elapsed time given
+    uint32_t load_bytes_per_second;      ///< Expected load
+    uint16_t load_permille;              ///< Expected load relative to the bus capacity (scl_hz / 9 bytes/s)
+} vl53lx_tof_multibus_bus_stats_t;
+
+/**
+ * @brief Per-bus and aggregate throughput
+ */
+typedef struct {
+    vl53lx_tof_multibus_bus_stats_t bus[VL53LX_TOF_MULTIBUS_MAX_BUSES];  ///< Per bus
+    uint32_t samples;                    ///< All buses
+    uint32_t errors;                     ///< All buses
+    uint32_t samples_per_second;         ///< All buses
+} vl53lx_tof_multibus_stats_t;
+
+/**
+ * @brief Multi-bus state structure
+ */
+typedef struct vl53lx_tof_multibus {
+    vl53lx_tof_multibus_config_t config; ///< Multi-bus configuration
+    vl53lx_tof_multibus_bus_t buses[VL53LX_TOF_MULTIBUS_MAX_BUSES];  ///< Per-bus worker contexts
+    vl53lx_tof_multibus_sensor_t sensors[VL53LX_TOF_MULTIBUS_MAX_SENSORS];  ///< Sensors in AddSensor order
+    uint8_t count;                       ///< Number of sensors
+    bool assigned;                       ///< VL53LX_TofMultiBusAssign() done
+    bool initialized;                    ///< Multi-bus initialized flag
+} vl53lx_tof_multibus_t;
+
+/**
+ * @brief Get default multi-bus configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_tof_multibus_config_t VL53LX_TofMultiBusGetDefaultConfig(void);
+
+/**
+ * @brief Initialize multi-bus with default configuration
+ *
+ * @param multibus Pointer to multi-bus structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofMultiBusInit(vl53lx_tof_multibus_t *multibus);
+
+/**
+ * @brief Initialize multi-bus with custom configuration
+ *
+ * @param multibus Pointer to multi-bus structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofMultiBusInitWithConfig(vl53lx_tof_multibus_t *multibus,
+                                      const vl53lx_tof_multibus_config_t *config);
+
+/**
+ * @brief Expected bus load of a sensor ranging back-to-back
+ *
+ * One sample is the histogram readout of VL53LX_GetMultiRangingData() plus
+ * the configuration written by VL53LX_ClearInterruptAndStartMeasurement(),
+ * each with its 7-bit address and 16-bit register index; one sample per
+ * timing budget.
+ *
+ * @param config Sensor configuration, a timing budget of 0 counts as 33 ms
+ * @return Bytes per second
+ */
+uint32_t VL53LX_TofMultiBusBytesPerSecond(const vl53lx_tof_sensor_config_t *config);
+
+/**
+ * @brief Add a sensor
+ *
+ * @param multibus Pointer to multi-bus structure
+ * @param config Sensor configuration
+ * @param dev Device of the sensor, must stay valid as long as the multi-bus is used
+ * @param bus Bus the sensor is wired to, or VL53LX_TOF_MULTIBUS_AUTO
+ * @return Sensor index, or -1 if full, assigned, @p dev is NULL or @p bus is out of range
+ */
+int VL53LX_TofMultiBusAddSensor(vl53lx_tof_multibus_t *multibus, const vl53lx_tof_sensor_config_t *config,
+                                VL53LX_DEV dev, int bus);
+
+/**
+ * @brief Assign the sensors to buses and fill the per-bus arrays
+ *
+ * Pinned sensors go to their bus. The others, heaviest first, go to the
+ * bus with the lowest expected load that has a free slot and does not
+ * use their address yet.
+ *
+ * @param multibus Pointer to multi-bus structure
+ * @return true if every sensor has a bus, false otherwise
+ */
+bool VL53LX_TofMultiBusAssign(vl53lx_tof_multibus_t *multibus);
+
+/**
+ * @brief Bring up the sensors of every bus through board hooks
+ *
+ * @param multibus Pointer to multi-bus structure, assigned
+ * @param hals Board hooks per bus, the sensor index is the index in the bus array
+ * @return Number of ready sensors on all buses
+ */
+uint8_t VL53LX_TofMultiBusBringupWithHal(vl53lx_tof_multibus_t *multibus, const vl53lx_bringup_hal_t *hals);
+
+/**
+ * @brief Get the per-bus and aggregate throughput
+ *
+ * @param multibus Pointer to multi-bus structure
+ * @param elapsed_us Time over which the samples were counted, for the rates
+ * @param stats Output statistics
+ */
+void VL53LX_TofMultiBusGetStats(const vl53lx_tof_multibus_t *multibus, uint32_t elapsed_us,
+                                vl53lx_tof_multibus_stats_t *stats);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Bring up the sensors of every bus
+ *
+ * @param multibus Pointer to multi-bus structure, assigned
+ * @param buses I2C master bus handle per bus, bus_count entries
+ * @return Number of ready sensors on all buses
+ */
+uint8_t VL53LX_TofMultiBusBringup(vl53lx_tof_multibus_t *multibus, const i2c_master_bus_handle_t *buses);
+
+/**
+ * @brief Start the service task of every bus
+ *
+ * @param multibus Pointer to multi-bus structure, brought up
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_TofMultiBusStart(vl53lx_tof_multibus_t *multibus);
+
+/**
+ * @brief Stop the service task of every bus
+ *
+ * @param multibus Pointer to multi-bus structure
+ */
+void VL53LX_TofMultiBusStop(vl53lx_tof_multibus_t *multibus);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_TOF_MULTIBUS_H
@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_velocity_filter.h
+ * @brief VL53LX Constant-Velocity Kalman Filter for ToF Measurements
+ *
+ * 2-state (range, range rate) Kalman filter for climbs and descents,
+ * where the stationary 1D filter (vl53lx_outlier_filter.h) lags:
+ * - Time step from the sample timestamps, so jitter and missed samples
+ *   are handled without a fixed rate
+ * - Prediction-only mode for invalid observations, and prediction to any
+ *   time without a sample
+ * - Range status validation and an innovation gate
+ * - Velocity output
+ * - Bounded-time update: straight-line code, no loops or iterations that
+ *   depend on the time step
+ */
+
+#ifndef VL53LX_VELOCITY_FILTER_H
+#define VL53LX_VELOCITY_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Velocity filter configuration
+ */
+typedef struct {
+    bool enable_status_check;            ///< Enable range status validation
+    uint8_t valid_status_mask;           ///< Bitmask of valid range statuses (default: 0x01 for status 0 only)
+    float process_noise;                 ///< Acceleration noise (mm/s^2)^2 of the white-noise acceleration model (default: 4.0e6)
+    float measurement_noise;             ///< Measurement noise covariance R, mm^2 (default: 4.0)
+    float initial_velocity_noise;        ///< Velocity variance at the first sample, (mm/s)^2 (default: 1.0e6)
+    float gate_sigma;                    ///< Reject innovations above this many standard deviations, 0 = off (default: 5.0)
+    uint32_t max_dt_us;                  ///< Longer gaps and older timestamps restart the filter at the next valid sample (default: 500000)
+} vl53lx_velocity_filter_config_t;
+
+/**
+ * @brief Velocity filter state structure
+ */
+typedef struct {
+    vl53lx_velocity_filter_config_t config;  ///< Filter configuration
+    float range_mm;                      ///< Estimated range (mm)
+    float velocity_mm_s;                 ///< Estimated range rate (mm/s, negative = approaching)
+    float p00;                           ///< Range variance
+    float p01;                           ///< Range / velocity covariance
+    float p11;                           ///< Velocity variance
+    uint32_t last_timestamp_us;          ///< Time of the state
+    uint8_t rejected_count;              ///< Consecutive gated samples count
+    uint8_t rejected_run;                ///< Of those, latest on the same side of the prediction, up to 2
+    float rejected_innovation;           ///< Innovation of the last gated sample (mm)
+    uint16_t rejected_distance_mm;       ///< Distance of the last gated sample
+    uint32_t rejected_timestamp_us;      ///< Time of the last gated sample
+    uint16_t rejected_prev_distance_mm;  ///< Distance of the gated sample before, same side
+    uint32_t rejected_prev_timestamp_us; ///< Time of the gated sample before, same side
+    bool state_initialized;              ///< A valid sample has set the state
+    bool initialized;                    ///< Filter initialized flag
+} vl53lx_velocity_filter_t;
+
+/**
+ * @brief Get default velocity filter configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_velocity_filter_config_t VL53LX_VelocityFilterGetDefaultConfig(void);
+
+/**
+ * @brief Initialize velocity filter with default configuration
+ *
+ * @param filter Pointer to filter structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_VelocityFilterInit(vl53lx_velocity_filter_t *filter);
+
+/**
+ * @brief Initialize velocity filter with custom configuration
+ *
+ * @param filter Pointer to filter structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_VelocityFilterInitWithConfig(vl53lx_velocity_filter_t *filter,
+                                         const vl53lx_velocity_filter_config_t *config);
+
+/**
+ * @brief Reset filter state (keeps configuration)
+ *
+ * @param filter Pointer to filter structure
+ */
+void VL53LX_VelocityFilterReset(vl53lx_velocity_filter_t *filter);
+
+/**
+ * @brief Process new measurement through filter
+ *
+ * Predicts from the previous sample to @p timestamp_us, then corrects
+ * with the measurement if its status is valid and it passes the gate.
+ * Otherwise the prediction is the output. Three gated samples in a row on
+ * the same side of the prediction that lie on one line within the gate (a
+ * step or a sudden change of speed) restart the filter from the first and
+ * last of them, with the velocity between them; five gated samples in a
+ * row restart it at the new distance. A timestamp more than max_dt_us
+ * after the state, or older than it, restarts the filter at the next valid
+ * sample. The same timestamp as the state only corrects.
+ *
+ * @param filter Pointer to filter structure
+ * @param distance_mm Raw distance measurement (mm)
+ * @param range_status Range status from sensor
+ * @param timestamp_us Measurement time in microseconds
+ * @param output_mm Filtered output distance (mm)
+ * @param velocity_mm_s Filtered range rate (mm/s), may be NULL
+ * @return true if output is valid, false if filter not yet initialized
+ */
+bool VL53LX_VelocityFilterUpdate(vl53lx_velocity_filter_t *filter, uint16_t distance_mm, uint8_t range_status,
+                                 uint32_t timestamp_us, uint16_t *output_mm, float *velocity_mm_s);
+
+/**
+ * @brief Advance the filter to a time without a measurement
+ *
+ * For a sample that never arrived (e.g. a failed read). Same as an
+ * update with an invalid status.
+ *
+ * @param filter Pointer to filter structure
+ * @param timestamp_us Time in microseconds
+ * @param output_mm Predicted distance (mm)
+ * @param velocity_mm_s Predicted range rate (mm/s), may be NULL
+ * @return true if output is valid, false if filter not yet initialized
+ */
+bool VL53LX_VelocityFilterPredict(vl53lx_velocity_filter_t *filter, uint32_t timestamp_us, uint16_t *output_mm,
+                                  float *velocity_mm_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_VELOCITY_FILTER_H
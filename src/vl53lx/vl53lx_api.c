@@ -24,6 +24,8 @@
 #include "vl53lx_api_debug.h"
 #include "vl53lx_api_core.h"
 #include "vl53lx_nvm.h"
+#include "vl53lx_scratch.h"
+#include "vl53lx_uwr.h"
 
 
 #define ZONE_CHECK 5
@@ -60,12 +62,15 @@
 #define FDA_MAX_TIMING_BUDGET_US 550000
 #define L4_FDA_MAX_TIMING_BUDGET_US 200000
 
+#define VL53LX_OFFSET_CAL_CONFIDENCE_Z 196
+#define VL53LX_OFFSET_CAL_ZERO_START_OFFSET 50
 
 
 
 
 
-static int32_t BDTable[VL53LX_TUNING_MAX_TUNABLE_KEY] = {
+
+static const int32_t BDTableDefault[VL53LX_TUNING_MAX_TUNABLE_KEY] = {
 		TUNING_VERSION,
 		TUNING_PROXY_MIN,
 		TUNING_SINGLE_TARGET_XTALK_TARGET_DISTANCE_MM,
@@ -187,13 +192,24 @@ VL53LX_Error VL53LX_SetDeviceAddress(VL53LX_DEV Dev, uint8_t DeviceAddress)
 
 
 VL53LX_Error VL53LX_DataInit(VL53LX_DEV Dev)
+{
+	return VL53LX_DataInitWithNvmCache(Dev, NULL);
+}
+
+
+VL53LX_Error VL53LX_DataInitWithNvmCache(VL53LX_DEV Dev,
+	VL53LX_nvm_cache_t *pNvmCache)
 {
 	VL53LX_Error Status = VL53LX_ERROR_NONE;
-	VL53LX_LLDriverData_t *pdev;
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
 	uint8_t  measurement_mode;
 
 	LOG_FUNCTION_START("");
 
+	memcpy(VL53LXDevDataGet(Dev, BDTable), BDTableDefault,
+		sizeof(BDTableDefault));
+
+	pdev->pnvm_cache = pNvmCache;
 
 #ifdef USE_I2C_2V8
 	Status = VL53LX_RdByte(Dev, VL53LX_PAD_I2C_HV__EXTSUP_CONFIG, &i);
@@ -207,6 +223,8 @@ VL53LX_Error VL53LX_DataInit(VL53LX_DEV Dev)
 	if (Status == VL53LX_ERROR_NONE)
 		Status = VL53LX_data_init(Dev, 1);
 
+	pdev->pnvm_cache = NULL;
+
 	if (Status == VL53LX_ERROR_NONE)
 		Status = SetPresetModeL3CX(Dev,
 			VL53LX_DISTANCEMODE_MEDIUM,
@@ -218,7 +236,6 @@ VL53LX_Error VL53LX_DataInit(VL53LX_DEV Dev)
 				33333);
 
 	if (Status == VL53LX_ERROR_NONE) {
-		pdev = VL53LXDevStructGetLLDriverHandle(Dev);
 		memset(&pdev->per_vcsel_cal_data, 0,
 				sizeof(pdev->per_vcsel_cal_data));
 	}
@@ -604,6 +621,7 @@ VL53LX_Error VL53LX_StartMeasurement(VL53LX_DEV Dev)
 		pdev->PreviousRangeMilliMeter[i] = 0;
 		pdev->PreviousRangeStatus[i] = 255;
 		pdev->PreviousExtendedRange[i] = 0;
+		pdev->uwr.confirm_count[i] = 0;
 	}
 	pdev->PreviousStreamCount = 0;
 	pdev->PreviousRangeActiveResults = 0;
@@ -727,7 +745,6 @@ static VL53LX_Error SetTargetData(VL53LX_DEV Dev,
 			VL53LXDevStructGetLLDriverHandle(Dev);
 	VL53LX_tuning_parm_storage_t *tp =
 			&(pdev->tuning_parms);
-	uint8_t sequency;
 	uint8_t FilteredRangeStatus;
 	FixPoint1616_t AmbientRate;
 	FixPoint1616_t SignalRate;
@@ -796,7 +813,6 @@ static VL53LX_Error SetTargetData(VL53LX_DEV Dev,
 	VL53LX_get_tuning_parm(Dev, VL53LX_TUNINGPARM_UWR_ENABLE,
 			&ExtendedRangeEnabled);
 
-	sequency = streamcount % 2;
 	uwr_status = 0;
 	RangeMillimeterInit = pRangeData->RangeMilliMeter;
 	AddOffset = 0;
@@ -830,121 +846,11 @@ static VL53LX_Error SetTargetData(VL53LX_DEV Dev,
 		RangeDiff = pRangeData->RangeMilliMeter -
 			pdev->PreviousRangeMilliMeter[iteration];
 
-		uwr_status = 1;
-		switch (pdev->preset_mode) {
-			case VL53LX_DEVICEPRESETMODE_HISTOGRAM_SHORT_RANGE:
-
-				uwr_status = 0;
-				break;
-
-			case VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE:
-				if (RangeDiff > tp->tp_uwr_med_z_1_min &&
-					RangeDiff < tp->tp_uwr_med_z_1_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_1_rangeb;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_med_z_1_min &&
-					RangeDiff > -tp->tp_uwr_med_z_1_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_1_rangea;
-				}
-				else
-				if (RangeDiff > tp->tp_uwr_med_z_2_min &&
-					RangeDiff < tp->tp_uwr_med_z_2_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_2_rangea;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_med_z_2_min &&
-					RangeDiff > -tp->tp_uwr_med_z_2_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_2_rangeb;
-				}
-				else
-				if (RangeDiff > tp->tp_uwr_med_z_3_min &&
-					RangeDiff < tp->tp_uwr_med_z_3_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_3_rangeb;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_med_z_3_min &&
-					RangeDiff > -tp->tp_uwr_med_z_3_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_3_rangea;
-				}
-				else
-				if (RangeDiff > tp->tp_uwr_med_z_4_min &&
-					RangeDiff < tp->tp_uwr_med_z_4_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_4_rangea;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_med_z_4_min &&
-					RangeDiff > -tp->tp_uwr_med_z_4_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_4_rangeb;
-				}
-				else
-				if (RangeDiff < tp->tp_uwr_med_z_5_max &&
-					RangeDiff > tp->tp_uwr_med_z_5_min) {
-					AddOffset =
-					tp->tp_uwr_med_corr_z_5_rangea;
-				} else
-					uwr_status = 0;
-				break;
-
-			case VL53LX_DEVICEPRESETMODE_HISTOGRAM_LONG_RANGE:
-				if (RangeDiff > tp->tp_uwr_lng_z_1_min &&
-					RangeDiff < tp->tp_uwr_lng_z_1_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_lng_corr_z_1_rangea;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_lng_z_1_min &&
-					RangeDiff > -tp->tp_uwr_lng_z_1_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_lng_corr_z_1_rangeb;
-				}
-				else
-				if (RangeDiff > tp->tp_uwr_lng_z_2_min &&
-					RangeDiff < tp->tp_uwr_lng_z_2_max &&
-					sequency == 1) {
-					AddOffset =
-					tp->tp_uwr_lng_corr_z_2_rangeb;
-				}
-				else
-				if (RangeDiff < -tp->tp_uwr_lng_z_2_min &&
-					RangeDiff > -tp->tp_uwr_lng_z_2_max &&
-					sequency == 0) {
-					AddOffset =
-					tp->tp_uwr_lng_corr_z_2_rangea;
-				}
-				else
-				if (RangeDiff < tp->tp_uwr_lng_z_3_max &&
-					RangeDiff > tp->tp_uwr_lng_z_3_min) {
-					AddOffset =
-					tp->tp_uwr_lng_corr_z_3_rangea;
-				}
-				else
-					uwr_status = 0;
-				break;
-
-			default:
-				uwr_status = 0;
-				break;
-			}
-		}
+		uwr_status = VL53LX_uwr_resolve(&(pdev->uwr), tp,
+			pdev->preset_mode, streamcount, iteration, RangeDiff,
+			pdev->PreviousExtendedRange[iteration], &AddOffset);
+		} else
+			pdev->uwr.confirm_count[iteration] = 0;
 
 		if (uwr_status) {
 			pRangeData->RangeMilliMeter += AddOffset;
@@ -954,7 +860,8 @@ static VL53LX_Error SetTargetData(VL53LX_DEV Dev,
 			pRangeData->RangeStatus = 0;
 		}
 
-	}
+	} else
+		pdev->uwr.confirm_count[iteration] = 0;
 
 	pdev->PreviousRangeMilliMeter[iteration] = RangeMillimeterInit;
 	pdev->PreviousRangeStatus[iteration] = pRangeData->RangeStatus;
@@ -964,7 +871,8 @@ static VL53LX_Error SetTargetData(VL53LX_DEV Dev,
 	Range = pRangeData->RangeMilliMeter;
 	if ((pRangeData->RangeStatus ==  VL53LX_RANGESTATUS_RANGE_VALID) &&
 		(Range < 0)) {
-		if (Range < BDTable[VL53LX_TUNING_PROXY_MIN])
+		if (Range <
+			VL53LXDevDataGet(Dev, BDTable[VL53LX_TUNING_PROXY_MIN]))
 			pRangeData->RangeStatus =
 					 VL53LX_RANGESTATUS_RANGE_INVALID;
 		else
@@ -1023,6 +931,7 @@ static VL53LX_Error SetMeasurementData(VL53LX_DEV Dev,
 		pdev->PreviousRangeMilliMeter[i] = 0;
 		pdev->PreviousRangeStatus[i] = 255;
 		pdev->PreviousExtendedRange[i] = 0;
+		pdev->uwr.confirm_count[i] = 0;
 	}
 
 	return Status;
@@ -1033,10 +942,10 @@ VL53LX_Error VL53LX_GetMultiRangingData(VL53LX_DEV Dev,
 		VL53LX_MultiRangingData_t *pMultiRangingData)
 {
 	VL53LX_Error Status = VL53LX_ERROR_NONE;
-	VL53LX_LLDriverData_t *pdev =
-			VL53LXDevStructGetLLDriverHandle(Dev);
+	VL53LX_scratch_t *pscratch = VL53LX_get_scratch(Dev);
+	uint16_t scratch_mark = VL53LX_scratch_mark(pscratch);
 	VL53LX_range_results_t *presults =
-			(VL53LX_range_results_t *) pdev->wArea1;
+			VL53LX_SCRATCH_ALLOC(pscratch, VL53LX_range_results_t);
 
 	LOG_FUNCTION_START("");
 
@@ -1044,16 +953,24 @@ VL53LX_Error VL53LX_GetMultiRangingData(VL53LX_DEV Dev,
 	memset(pMultiRangingData, 0xFF,
 		sizeof(VL53LX_MultiRangingData_t));
 
+	if (presults == NULL) {
+		Status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+		LOG_FUNCTION_END(Status);
+		return Status;
+	}
 
 	Status = VL53LX_get_device_results(
 				Dev,
 				VL53LX_DEVICERESULTSLEVEL_FULL,
 				presults);
 
-	Status = SetMeasurementData(Dev,
+	if (Status == VL53LX_ERROR_NONE)
+		Status = SetMeasurementData(Dev,
 					presults,
 					pMultiRangingData);
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
+
 	LOG_FUNCTION_END(Status);
 	return Status;
 }
@@ -1093,7 +1010,8 @@ VL53LX_Error VL53LX_SetTuningParameter(VL53LX_DEV Dev,
 			TuningParameterValue);
 	else {
 		if (TuningParameterId < VL53LX_TUNING_MAX_TUNABLE_KEY)
-			BDTable[TuningParameterId] = TuningParameterValue;
+			VL53LXDevDataSet(Dev, BDTable[TuningParameterId],
+				TuningParameterValue);
 		else
 			Status = VL53LX_ERROR_INVALID_PARAMS;
 	}
@@ -1115,7 +1033,8 @@ VL53LX_Error VL53LX_GetTuningParameter(VL53LX_DEV Dev,
 			pTuningParameterValue);
 	else {
 		if (TuningParameterId < VL53LX_TUNING_MAX_TUNABLE_KEY)
-			*pTuningParameterValue = BDTable[TuningParameterId];
+			*pTuningParameterValue = VL53LXDevDataGet(Dev,
+				BDTable[TuningParameterId]);
 		else
 			Status = VL53LX_ERROR_INVALID_PARAMS;
 	}
@@ -1124,6 +1043,23 @@ VL53LX_Error VL53LX_GetTuningParameter(VL53LX_DEV Dev,
 	return Status;
 }
 
+VL53LX_Error VL53LX_LoadTuningProfile(VL53LX_DEV Dev,
+		const int32_t *pTuningProfile)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+
+	LOG_FUNCTION_START("");
+
+	if (pTuningProfile == NULL)
+		pTuningProfile = BDTableDefault;
+
+	memcpy(VL53LXDevDataGet(Dev, BDTable), pTuningProfile,
+		sizeof(BDTableDefault));
+
+	LOG_FUNCTION_END(Status);
+	return Status;
+}
+
 
 VL53LX_Error VL53LX_PerformRefSpadManagement(VL53LX_DEV Dev)
 {
@@ -1273,7 +1209,8 @@ VL53LX_Error VL53LX_GetXTalkCompensationEnable(VL53LX_DEV Dev,
 	return Status;
 }
 
-VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev)
+static VL53LX_Error PerformXTalkCal(VL53LX_DEV Dev,
+	const VL53LX_xtalk_stream_config_t *pStream)
 {
 	VL53LX_Error Status = VL53LX_ERROR_NONE;
 	VL53LX_Error UStatus;
@@ -1285,9 +1222,11 @@ VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev)
 	int i;
 	uint32_t *pPlaneOffsetKcps;
 	uint32_t Margin =
-			BDTable[VL53LX_TUNING_XTALK_FULL_ROI_BIN_SUM_MARGIN];
+			VL53LXDevDataGet(Dev,
+			BDTable[VL53LX_TUNING_XTALK_FULL_ROI_BIN_SUM_MARGIN]);
 	uint32_t DefaultOffset =
-			BDTable[VL53LX_TUNING_XTALK_FULL_ROI_DEFAULT_OFFSET];
+			VL53LXDevDataGet(Dev,
+			BDTable[VL53LX_TUNING_XTALK_FULL_ROI_DEFAULT_OFFSET]);
 	uint32_t *pLLDataPlaneOffsetKcps;
 	uint32_t sum = 0;
 	uint8_t binok = 0;
@@ -1306,9 +1245,14 @@ VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev)
 	&pLLData->xtalk_cal.algo__crosstalk_compensation_plane_offset_kcps;
 
 	CalDistanceMm = (int16_t)
-	BDTable[VL53LX_TUNING_XTALK_FULL_ROI_TARGET_DISTANCE_MM];
-	Status = VL53LX_run_hist_xtalk_extraction(Dev, CalDistanceMm,
-			&UStatus);
+	VL53LXDevDataGet(Dev,
+		BDTable[VL53LX_TUNING_XTALK_FULL_ROI_TARGET_DISTANCE_MM]);
+	if (pStream == NULL)
+		Status = VL53LX_run_hist_xtalk_extraction(Dev, CalDistanceMm,
+				&UStatus);
+	else
+		Status = VL53LX_run_hist_xtalk_extraction_streaming(Dev,
+				CalDistanceMm, pStream, &UStatus);
 
 	VL53LX_GetCalibrationData(Dev, &caldata);
 	for (i = 0; i < VL53LX_XTALK_HISTO_BINS; i++) {
@@ -1348,6 +1292,24 @@ VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev)
 	return Status;
 }
 
+VL53LX_Error VL53LX_PerformXTalkCalibration(VL53LX_DEV Dev)
+{
+	return PerformXTalkCal(Dev, NULL);
+}
+
+VL53LX_Error VL53LX_PerformXTalkStreamingCalibration(VL53LX_DEV Dev,
+	const VL53LX_xtalk_stream_config_t *pStreamConfig)
+{
+	VL53LX_xtalk_stream_config_t StreamConfig;
+
+	if (pStreamConfig == NULL) {
+		VL53LX_get_xtalk_stream_default_config(&StreamConfig);
+		pStreamConfig = &StreamConfig;
+	}
+
+	return PerformXTalkCal(Dev, pStreamConfig);
+}
+
 
 VL53LX_Error VL53LX_SetOffsetCorrectionMode(VL53LX_DEV Dev,
 		VL53LX_OffsetCorrectionModes OffsetCorrectionMode)
@@ -1407,9 +1369,10 @@ VL53LX_Error VL53LX_PerformOffsetSimpleCalibration(VL53LX_DEV Dev,
 	pdev->customer.mm_config__inner_offset_mm = 0;
 	pdev->customer.mm_config__outer_offset_mm = 0;
 	memset(&pdev->per_vcsel_cal_data, 0, sizeof(pdev->per_vcsel_cal_data));
-	Repeat = BDTable[VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT];
-	Max = BDTable[
-		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER];
+	Repeat = VL53LXDevDataGet(Dev,
+		BDTable[VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT]);
+	Max = VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER]);
 	UnderMax = 1 + (Max / 2);
 	OverMax = Max + (Max / 2);
 	sum_ranging = 0;
@@ -1481,7 +1444,6 @@ VL53LX_Error VL53LX_PerformOffsetSimpleCalibration(VL53LX_DEV Dev,
 
 VL53LX_Error VL53LX_PerformOffsetZeroDistanceCalibration(VL53LX_DEV Dev)
 {
-	#define START_OFFSET 50
 	VL53LX_Error Status = VL53LX_ERROR_NONE;
 	int32_t sum_ranging;
 	uint8_t offset_meas;
@@ -1503,14 +1465,17 @@ VL53LX_Error VL53LX_PerformOffsetZeroDistanceCalibration(VL53LX_DEV Dev)
 	smudge_corr_en = pdev->smudge_correct_config.smudge_corr_enabled;
 	SmudgeStatus = VL53LX_dynamic_xtalk_correction_disable(Dev);
 	pdev->customer.algo__part_to_part_range_offset_mm = 0;
-	pdev->customer.mm_config__inner_offset_mm = START_OFFSET;
-	pdev->customer.mm_config__outer_offset_mm = START_OFFSET;
+	pdev->customer.mm_config__inner_offset_mm =
+		VL53LX_OFFSET_CAL_ZERO_START_OFFSET;
+	pdev->customer.mm_config__outer_offset_mm =
+		VL53LX_OFFSET_CAL_ZERO_START_OFFSET;
 	memset(&pdev->per_vcsel_cal_data, 0, sizeof(pdev->per_vcsel_cal_data));
-	ZeroDistanceOffset = BDTable[
-		VL53LX_TUNING_ZERO_DISTANCE_OFFSET_NON_LINEAR_FACTOR];
-	Repeat = BDTable[VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT];
-	Max =
-	BDTable[VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER];
+	ZeroDistanceOffset = VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_ZERO_DISTANCE_OFFSET_NON_LINEAR_FACTOR]);
+	Repeat = VL53LXDevDataGet(Dev,
+		BDTable[VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT]);
+	Max = VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER]);
 	UnderMax = 1 + (Max / 2);
 	OverMax = Max + (Max / 2);
 	sum_ranging = 0;
@@ -1559,7 +1524,8 @@ VL53LX_Error VL53LX_PerformOffsetZeroDistanceCalibration(VL53LX_DEV Dev)
 		IncRounding = total_count / 2;
 		meanDistance_mm = (int16_t)
 			((sum_ranging + IncRounding) / total_count);
-		offset = START_OFFSET - meanDistance_mm + ZeroDistanceOffset;
+		offset = VL53LX_OFFSET_CAL_ZERO_START_OFFSET - meanDistance_mm +
+			ZeroDistanceOffset;
 		pdev->customer.algo__part_to_part_range_offset_mm = 0;
 		pdev->customer.mm_config__inner_offset_mm = offset;
 		pdev->customer.mm_config__outer_offset_mm = offset;
@@ -1571,6 +1537,238 @@ VL53LX_Error VL53LX_PerformOffsetZeroDistanceCalibration(VL53LX_DEV Dev)
 	return Status;
 }
 
+static uint32_t OffsetCalIsqrt64(uint64_t num)
+{
+	uint64_t res = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > num)
+		bit >>= 2;
+
+	while (bit != 0) {
+		if (num >= res + bit) {
+			num -= res + bit;
+			res = (res >> 1) + bit;
+		} else
+			res >>= 1;
+		bit >>= 2;
+	}
+
+	return (uint32_t)res;
+}
+
+static FixPoint1616_t OffsetCalHalfWidth(uint32_t n, int64_t sum,
+	uint64_t sum_sq)
+{
+	uint64_t m2;
+	uint64_t var_mean;
+	uint64_t divisor;
+	uint64_t half_width;
+	uint8_t shift = 32;
+
+	if (n < 2)
+		return 0xFFFFFFFF;
+
+	/* n (n - 1) times the sample variance, exact */
+	m2 = (uint64_t)n * sum_sq - (uint64_t)(sum * sum);
+	divisor = (uint64_t)n * n * (n - 1);
+
+	/* variance of the mean in mm^2 as 32.32, keeping as many
+	 * fraction bits as the 64 bit division allows
+	 */
+	while ((shift > 0) && ((m2 >> (63 - shift)) != 0))
+		shift--;
+	var_mean = do_division_u(m2 << shift, divisor);
+	if ((shift < 32) && ((var_mean >> (32 + shift)) != 0))
+		return 0xFFFFFFFF;
+	var_mean <<= (32 - shift);
+
+	half_width = OffsetCalIsqrt64(var_mean);
+	half_width = do_division_u(half_width *
+		VL53LX_OFFSET_CAL_CONFIDENCE_Z, 100);
+
+	if (half_width > 0xFFFFFFFF)
+		half_width = 0xFFFFFFFF;
+
+	return (FixPoint1616_t)half_width;
+}
+
+static VL53LX_Error PerformOffsetAdaptive(VL53LX_DEV Dev,
+	int16_t StartOffset, VL53LX_AdaptiveOffsetCal_t *pCal,
+	int16_t *pMeanDistance)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+	VL53LX_MultiRangingData_t RangingMeasurementData;
+	VL53LX_LLDriverData_t *pdev;
+	VL53LX_Error SmudgeStatus = VL53LX_ERROR_NONE;
+	uint8_t smudge_corr_en;
+	VL53LX_TargetRangeData_t *pRange;
+	uint32_t MinSamples, MaxSamples, MaxMeas;
+	uint32_t count = 0;
+	uint32_t meas = 0;
+	int64_t sum = 0;
+	uint64_t sum_sq = 0;
+	FixPoint1616_t half_width = 0xFFFFFFFF;
+	int64_t mean;
+	VL53LX_customer_nvm_managed_t SavedCustomer;
+	VL53LX_per_vcsel_period_offset_cal_data_t SavedPerVcsel;
+
+	pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	MaxSamples = pCal->MaxSamples;
+	if (MaxSamples == 0)
+		MaxSamples = (uint32_t)VL53LXDevDataGet(Dev,
+			BDTable[VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT]) *
+			(uint32_t)VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER]);
+	MinSamples = MAX(pCal->MinSamples, 2);
+	if ((MaxSamples < MinSamples) || (MaxSamples > 0xFFFF))
+		return VL53LX_ERROR_INVALID_PARAMS;
+	MaxMeas = MaxSamples + (MaxSamples / 2);
+
+	smudge_corr_en = pdev->smudge_correct_config.smudge_corr_enabled;
+	SmudgeStatus = VL53LX_dynamic_xtalk_correction_disable(Dev);
+
+	SavedCustomer = pdev->customer;
+	SavedPerVcsel = pdev->per_vcsel_cal_data;
+	pdev->customer.algo__part_to_part_range_offset_mm = 0;
+	pdev->customer.mm_config__inner_offset_mm = StartOffset;
+	pdev->customer.mm_config__outer_offset_mm = StartOffset;
+	memset(&pdev->per_vcsel_cal_data, 0, sizeof(pdev->per_vcsel_cal_data));
+
+	Status = VL53LX_StartMeasurement(Dev);
+	if (Status == VL53LX_ERROR_NONE)
+		Status = VL53LX_WaitMeasurementDataReady(Dev);
+	if (Status == VL53LX_ERROR_NONE)
+		Status = VL53LX_GetMultiRangingData(Dev,
+				&RangingMeasurementData);
+	if (Status == VL53LX_ERROR_NONE)
+		Status = VL53LX_ClearInterruptAndStartMeasurement(Dev);
+
+	while ((Status == VL53LX_ERROR_NONE) && (count < MaxSamples) &&
+			(meas < MaxMeas)) {
+		Status = VL53LX_WaitMeasurementDataReady(Dev);
+		if (Status == VL53LX_ERROR_NONE)
+			Status = VL53LX_GetMultiRangingData(Dev,
+					&RangingMeasurementData);
+		pRange = &(RangingMeasurementData.RangeData[0]);
+		if ((Status == VL53LX_ERROR_NONE) &&
+			(pRange->RangeStatus == VL53LX_RANGESTATUS_RANGE_VALID)) {
+			sum += pRange->RangeMilliMeter;
+			sum_sq += (uint64_t)((int32_t)pRange->RangeMilliMeter *
+					pRange->RangeMilliMeter);
+			count++;
+		}
+		meas++;
+
+		if ((Status == VL53LX_ERROR_NONE) && (count >= MinSamples)) {
+			half_width = OffsetCalHalfWidth(count, sum, sum_sq);
+			if (half_width <= pCal->ToleranceMilliMeter)
+				break;
+		}
+
+		if (Status == VL53LX_ERROR_NONE)
+			Status = VL53LX_ClearInterruptAndStartMeasurement(Dev);
+	}
+
+	VL53LX_StopMeasurement(Dev);
+
+	if ((SmudgeStatus == VL53LX_ERROR_NONE) && (smudge_corr_en == 1))
+		SmudgeStatus = VL53LX_dynamic_xtalk_correction_enable(Dev);
+
+	pCal->SampleCount = (uint16_t)count;
+	pCal->MeasurementCount = (uint16_t)MIN(meas, 0xFFFF);
+	pCal->PrecisionMilliMeter = half_width;
+
+	if ((Status == VL53LX_ERROR_NONE) && (count < MinSamples))
+		Status = VL53LX_ERROR_OFFSET_CAL_NO_SAMPLE_FAIL;
+
+	if (Status == VL53LX_ERROR_NONE) {
+		mean = (sum >= 0) ? sum + count / 2 : sum - count / 2;
+		mean = do_division_s(mean, (int64_t)count);
+		*pMeanDistance = (int16_t)mean;
+		if (half_width > pCal->ToleranceMilliMeter)
+			Status = VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH;
+	}
+
+	/* the offsets in use before the calibration stay unless it succeeds */
+	if (Status != VL53LX_ERROR_NONE) {
+		pdev->customer = SavedCustomer;
+		pdev->per_vcsel_cal_data = SavedPerVcsel;
+	}
+
+	return Status;
+}
+
+VL53LX_Error VL53LX_PerformOffsetAdaptiveCalibration(VL53LX_DEV Dev,
+	int32_t CalDistanceMilliMeter, VL53LX_AdaptiveOffsetCal_t *pCal)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+	VL53LX_LLDriverData_t *pdev;
+	int16_t meanDistance_mm = 0;
+
+	LOG_FUNCTION_START("");
+
+	pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	Status = PerformOffsetAdaptive(Dev, 0, pCal, &meanDistance_mm);
+
+	if ((Status == VL53LX_ERROR_NONE) ||
+		(Status == VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH))
+		pCal->OffsetMilliMeter =
+			(int16_t)CalDistanceMilliMeter - meanDistance_mm;
+
+	if (Status == VL53LX_ERROR_NONE) {
+		pdev->customer.algo__part_to_part_range_offset_mm = 0;
+		pdev->customer.mm_config__inner_offset_mm =
+			pCal->OffsetMilliMeter;
+		pdev->customer.mm_config__outer_offset_mm =
+			pCal->OffsetMilliMeter;
+
+		Status = VL53LX_set_customer_nvm_managed(Dev,
+				&(pdev->customer));
+	}
+
+	LOG_FUNCTION_END(Status);
+	return Status;
+}
+
+VL53LX_Error VL53LX_PerformOffsetZeroDistanceAdaptiveCalibration(
+	VL53LX_DEV Dev, VL53LX_AdaptiveOffsetCal_t *pCal)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+	VL53LX_LLDriverData_t *pdev;
+	int16_t meanDistance_mm = 0;
+	int16_t ZeroDistanceOffset;
+
+	LOG_FUNCTION_START("");
+
+	pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	ZeroDistanceOffset = VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_ZERO_DISTANCE_OFFSET_NON_LINEAR_FACTOR]);
+
+	Status = PerformOffsetAdaptive(Dev, VL53LX_OFFSET_CAL_ZERO_START_OFFSET,
+			pCal, &meanDistance_mm);
+
+	if ((Status == VL53LX_ERROR_NONE) ||
+		(Status == VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH))
+		pCal->OffsetMilliMeter = VL53LX_OFFSET_CAL_ZERO_START_OFFSET -
+			meanDistance_mm + ZeroDistanceOffset;
+
+	if (Status == VL53LX_ERROR_NONE) {
+		pdev->customer.algo__part_to_part_range_offset_mm = 0;
+		pdev->customer.mm_config__inner_offset_mm =
+			pCal->OffsetMilliMeter;
+		pdev->customer.mm_config__outer_offset_mm =
+			pCal->OffsetMilliMeter;
+		Status = VL53LX_set_customer_nvm_managed(Dev,
+			&(pdev->customer));
+	}
+
+	LOG_FUNCTION_END(Status);
+	return Status;
+}
+
 VL53LX_Error VL53LX_SetCalibrationData(VL53LX_DEV Dev,
 		VL53LX_CalibrationData_t *pCalibrationData)
 {
@@ -1838,8 +2036,8 @@ VL53LX_Error VL53LX_PerformOffsetPerVcselCalibration(VL53LX_DEV Dev,
 	Repeat = 0;
 	if (IsL4(Dev))
 		Repeat = 1;
-	Max = 2 * BDTable[
-		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER];
+	Max = 2 * VL53LXDevDataGet(Dev, BDTable[
+		VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER]);
 	UnderMax = 1 + (Max / 2);
 	OverMax = Max + (Max / 2);
 
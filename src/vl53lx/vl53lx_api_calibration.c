@@ -28,6 +28,7 @@
 #include "vl53lx_silicon_core.h"
 #include "vl53lx_api_core.h"
 #include "vl53lx_api_calibration.h"
+#include "vl53lx_scratch.h"
 
 #ifdef VL53LX_LOG_ENABLE
   #include "vl53lx_api_debug.h"
@@ -47,6 +48,13 @@
 	level, VL53LX_TRACE_FUNCTION_NONE, ##__VA_ARGS__)
 
 
+#define VL53LX_XTALK_STREAM_MIN_SAMPLES_DEFAULT                 4
+#define VL53LX_XTALK_STREAM_STABLE_PAIRS_DEFAULT                3
+#define VL53LX_XTALK_STREAM_PLANE_OFFSET_TOLERANCE_KCPS_DEFAULT 8
+#define VL53LX_XTALK_STREAM_PLANE_OFFSET_TOLERANCE_PCT_DEFAULT  2
+#define VL53LX_XTALK_STREAM_SHAPE_TOLERANCE_DEFAULT             8
+
+
 VL53LX_Error VL53LX_run_ref_spad_char(
 	VL53LX_DEV        Dev,
 	VL53LX_Error     *pcal_status)
@@ -236,8 +244,12 @@ VL53LX_Error VL53LX_get_and_avg_xtalk_samples(
 		VL53LXDevStructGetLLResultsHandle(Dev);
 #endif
 
+	VL53LX_scratch_t            *pscratch =
+			VL53LX_get_scratch(Dev);
+	uint16_t                     scratch_mark =
+			VL53LX_scratch_mark(pscratch);
 	VL53LX_range_results_t      *prs =
-			(VL53LX_range_results_t *) pdev->wArea1;
+			VL53LX_SCRATCH_ALLOC(pscratch, VL53LX_range_results_t);
 
 	VL53LX_range_data_t         *prange_data;
 	VL53LX_xtalk_range_data_t   *pxtalk_range_data;
@@ -257,6 +269,9 @@ VL53LX_Error VL53LX_get_and_avg_xtalk_samples(
 
 	status = VL53LX_dynamic_xtalk_correction_disable(Dev);
 
+	if (prs == NULL)
+		status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+
 
 	VL53LX_load_patch(Dev);
 
@@ -467,6 +482,7 @@ VL53LX_Error VL53LX_get_and_avg_xtalk_samples(
 			status = VL53LX_dynamic_xtalk_correction_enable(Dev);
 	}
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
 
 	LOG_FUNCTION_END(status);
 
@@ -825,9 +841,133 @@ VL53LX_Error VL53LX_hist_xtalk_extract_fini(
 }
 
 
-VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
+void VL53LX_get_xtalk_stream_default_config(
+	VL53LX_xtalk_stream_config_t       *pstream)
+{
+
+
+	memset(pstream, 0, sizeof(*pstream));
+
+	pstream->max_samples = 0;
+	pstream->min_samples =
+		VL53LX_XTALK_STREAM_MIN_SAMPLES_DEFAULT;
+	pstream->stable_pairs =
+		VL53LX_XTALK_STREAM_STABLE_PAIRS_DEFAULT;
+	pstream->plane_offset_tolerance_kcps =
+		VL53LX_XTALK_STREAM_PLANE_OFFSET_TOLERANCE_KCPS_DEFAULT;
+	pstream->plane_offset_tolerance_pct =
+		VL53LX_XTALK_STREAM_PLANE_OFFSET_TOLERANCE_PCT_DEFAULT;
+	pstream->shape_tolerance =
+		VL53LX_XTALK_STREAM_SHAPE_TOLERANCE_DEFAULT;
+}
+
+
+static VL53LX_Error vl53lx_hist_xtalk_stream_update(
+	VL53LX_LLDriverData_t              *pdev,
+	const VL53LX_xtalk_stream_config_t *pstream,
+	VL53LX_xtalk_stream_progress_t     *pprogress,
+	uint32_t                           *panchor_offset_kcps,
+	uint32_t                           *panchor_bins)
+{
+
+
+	VL53LX_Error status = VL53LX_ERROR_NONE;
+	VL53LX_hist_xtalk_extract_data_t xtalk_data;
+	VL53LX_xtalk_histogram_shape_t *pshape =
+		&(pdev->xtalk_shapes.xtalk_shape);
+	uint32_t offset_kcps;
+	uint32_t delta_kcps = 0;
+	uint32_t tolerance_kcps;
+	uint32_t bin_delta;
+	uint16_t shape_delta = 0;
+	uint8_t  stable_pairs;
+	uint8_t  lb;
+
+
+
+	xtalk_data = pdev->xtalk_extract;
+	status =
+		VL53LX_hist_xtalk_extract_fini(
+			&(pdev->hist_data),
+			&xtalk_data,
+			&(pdev->xtalk_cal),
+			pshape);
+
+	if (status != VL53LX_ERROR_NONE)
+		return status;
+
+	offset_kcps =
+		pdev->xtalk_cal.algo__crosstalk_compensation_plane_offset_kcps;
+
+	/* there is no anchor to compare with before the first pair */
+	if (pprogress->stable_count > 0) {
+		delta_kcps = (offset_kcps > *panchor_offset_kcps) ?
+			offset_kcps - *panchor_offset_kcps :
+			*panchor_offset_kcps - offset_kcps;
+
+		for (lb = 0; lb < VL53LX_XTALK_HISTO_BINS; lb++) {
+			bin_delta =
+				(pshape->bin_data[lb] > panchor_bins[lb]) ?
+				pshape->bin_data[lb] - panchor_bins[lb] :
+				panchor_bins[lb] - pshape->bin_data[lb];
+			if (bin_delta > 0xFFFF)
+				bin_delta = 0xFFFF;
+			if (bin_delta > shape_delta)
+				shape_delta = (uint16_t)bin_delta;
+		}
+	}
+
+	tolerance_kcps = (uint32_t)do_division_u(
+		(uint64_t)*panchor_offset_kcps *
+		pstream->plane_offset_tolerance_pct, 100);
+	if (tolerance_kcps < pstream->plane_offset_tolerance_kcps)
+		tolerance_kcps = pstream->plane_offset_tolerance_kcps;
+
+
+
+	stable_pairs = pstream->stable_pairs;
+	if (stable_pairs < 2)
+		stable_pairs = 2;
+
+
+	/* the timing A and B histograms pull the estimate in opposite
+	 * directions, so only whole A/B pairs are compared
+	 */
+	if ((xtalk_data.sample_count & 1) == 0) {
+		if ((pprogress->stable_count > 0) &&
+			(delta_kcps <= tolerance_kcps) &&
+			(shape_delta <= pstream->shape_tolerance)) {
+			if (pprogress->stable_count < 0xFF)
+				pprogress->stable_count++;
+		} else {
+			*panchor_offset_kcps = offset_kcps;
+			for (lb = 0; lb < VL53LX_XTALK_HISTO_BINS; lb++)
+				panchor_bins[lb] = pshape->bin_data[lb];
+			pprogress->stable_count = 1;
+		}
+	}
+
+	pprogress->sample_count = (uint8_t)xtalk_data.sample_count;
+	pprogress->plane_offset_kcps = offset_kcps;
+	pprogress->plane_offset_delta_kcps = delta_kcps;
+	pprogress->shape_delta = shape_delta;
+	pprogress->pxtalk_shape = pshape;
+	pprogress->converged =
+		(((xtalk_data.sample_count & 1) == 0) &&
+		 (pprogress->sample_count >= pstream->min_samples) &&
+		 (pprogress->stable_count >= stable_pairs));
+
+	if (pstream->progress_cb != NULL)
+		pstream->progress_cb(pstream->progress_ctx, pprogress);
+
+	return status;
+}
+
+
+static VL53LX_Error   vl53lx_hist_xtalk_extraction(
 	VL53LX_DEV	                        Dev,
 	int16_t                             cal_distance_mm,
+	const VL53LX_xtalk_stream_config_t *pstream,
 	VL53LX_Error                       *pcal_status)
 {
 
@@ -855,8 +995,11 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 	int8_t MaxId;
 	uint8_t histo_merge_nb;
 	uint8_t wait_for_accumulation;
+	VL53LX_scratch_t           *pscratch = VL53LX_get_scratch(Dev);
+	uint16_t                    scratch_mark =
+		VL53LX_scratch_mark(pscratch);
 	VL53LX_range_results_t     *prange_results =
-		(VL53LX_range_results_t *) pdev->wArea1;
+		VL53LX_SCRATCH_ALLOC(pscratch, VL53LX_range_results_t);
 	uint8_t Very1stRange = 0;
 	VL53LX_DevicePresetModes current_device_preset_mode;
 	uint32_t inter_measurement_period_ms;
@@ -864,9 +1007,21 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 	uint32_t phasecal_config_timeout_us;
 	uint32_t mm_config_timeout_us;
 	uint32_t range_config_timeout_us;
+	uint8_t num_of_samples = pX->num_of_samples;
+	VL53LX_xtalk_stream_progress_t progress;
+	uint32_t anchor_offset_kcps = 0;
+	uint32_t anchor_bins[VL53LX_XTALK_HISTO_BINS];
 
 	LOG_FUNCTION_START("");
 
+	memset(anchor_bins, 0, sizeof(anchor_bins));
+
+	if (prange_results == NULL)
+		status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+
+	if ((pstream != NULL) && (pstream->max_samples > 0))
+		num_of_samples = pstream->max_samples;
+
 	current_device_preset_mode = pdev->preset_mode;
 	inter_measurement_period_ms = pdev->inter_measurement_period_ms;
 
@@ -918,7 +1073,11 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 				VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE,
 				k * MaxId + 1);
 
-		for (i = 0; i <= pX->num_of_samples; i++) {
+		memset(&progress, 0, sizeof(progress));
+		progress.pass = (uint8_t)k;
+		progress.max_samples = num_of_samples;
+
+		for (i = 0; i <= num_of_samples; i++) {
 			if (status == VL53LX_ERROR_NONE)
 				status = VL53LX_wait_for_range_completion(Dev);
 			if (status == VL53LX_ERROR_NONE)
@@ -946,6 +1105,16 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 						OVERSIZE,
 						&(pdev->hist_data),
 						&(pdev->xtalk_extract));
+
+					if ((status == VL53LX_ERROR_NONE) &&
+						(pstream != NULL))
+						status =
+						vl53lx_hist_xtalk_stream_update(
+							pdev,
+							pstream,
+							&progress,
+							&anchor_offset_kcps,
+							anchor_bins);
 				}
 			}
 
@@ -953,6 +1122,9 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 				status =
 				VL53LX_clear_interrupt_and_enable_next_range(
 					Dev, measurement_mode);
+
+			if (progress.converged)
+				break;
 		}
 
 		if (status == VL53LX_ERROR_NONE)
@@ -1047,8 +1219,44 @@ VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
 
 #endif
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
+
 	LOG_FUNCTION_END(status);
 
 	return status;
 }
 
+
+VL53LX_Error   VL53LX_run_hist_xtalk_extraction(
+	VL53LX_DEV	                  Dev,
+	int16_t                       cal_distance_mm,
+	VL53LX_Error                 *pcal_status)
+{
+
+
+	return vl53lx_hist_xtalk_extraction(
+			Dev,
+			cal_distance_mm,
+			NULL,
+			pcal_status);
+}
+
+
+VL53LX_Error   VL53LX_run_hist_xtalk_extraction_streaming(
+	VL53LX_DEV	                        Dev,
+	int16_t                             cal_distance_mm,
+	const VL53LX_xtalk_stream_config_t *pstream,
+	VL53LX_Error                       *pcal_status)
+{
+
+
+	if (pstream == NULL)
+		return VL53LX_ERROR_INVALID_PARAMS;
+
+	return vl53lx_hist_xtalk_extraction(
+			Dev,
+			cal_distance_mm,
+			pstream,
+			pcal_status);
+}
+
@@ -30,6 +30,9 @@
 #include "vl53lx_api_preset_modes.h"
 #include "vl53lx_silicon_core.h"
 #include "vl53lx_api_core.h"
+#include "vl53lx_dmax.h"
+#include "vl53lx_scratch.h"
+#include "vl53lx_uwr.h"
 #include "vl53lx_tuning_parm_defaults.h"
 
 #ifdef VL53LX_LOG_ENABLE
@@ -50,6 +53,13 @@
 
 #define VL53LX_MAX_I2C_XFER_SIZE 256
 
+VL53LX_SCRATCH_STATIC_CHECK(
+	sizeof(VL53LX_range_results_t) +
+	sizeof(VL53LX_dmax_calibration_data_t) +
+	VL53LX_MAX_I2C_XFER_SIZE +
+	3 * VL53LX_SCRATCH_ALIGN <= VL53LX_SCRATCH_SIZE_BYTES,
+	histogram_bin_read);
+
 static VL53LX_Error select_offset_per_vcsel(VL53LX_LLDriverData_t *pdev,
 		int16_t *poffset) {
 	VL53LX_Error status = VL53LX_ERROR_NONE;
@@ -84,23 +94,59 @@ static VL53LX_Error select_offset_per_vcsel(VL53LX_LLDriverData_t *pdev,
 	return status;
 }
 
+static void vl53lx_histo_merge_reset(VL53LX_LLDriverData_t *pdev,
+	uint8_t sum_size) {
+	memset(pdev->multi_bins_rec, 0, sizeof(pdev->multi_bins_rec));
+	memset(pdev->multi_bins_sum, 0, sizeof(pdev->multi_bins_sum));
+	memset(pdev->multi_bins_rec_total, 0,
+		sizeof(pdev->multi_bins_rec_total));
+	pdev->multi_bins_sum_size = sum_size;
+	pdev->bin_rec_pos = 0;
+}
+
+static void vl53lx_histo_merge_resum(VL53LX_LLDriverData_t *pdev,
+	int32_t TuningBinRecSize) {
+	uint16_t   bin                      = 0;
+	uint8_t    i                        = 0;
+	uint8_t    timing                   = 0;
+	uint8_t    BuffSize = VL53LX_HISTOGRAM_BUFFER_SIZE;
+
+	for (timing = 0; timing < VL53LX_TIMING_CONF_A_B_SIZE; timing++) {
+		for (bin = 0; bin < BuffSize; bin++) {
+			pdev->multi_bins_sum[timing][bin] = 0;
+			for (i = 0; i < TuningBinRecSize; i++)
+				pdev->multi_bins_sum[timing][bin] +=
+				pdev->multi_bins_rec[i][timing][bin];
+		}
+
+		for (i = 0; i < VL53LX_BIN_REC_SIZE; i++) {
+			pdev->multi_bins_rec_total[i][timing] = 0;
+			for (bin = timing * 4; bin < BuffSize - timing * 4; bin++)
+				pdev->multi_bins_rec_total[i][timing] +=
+				pdev->multi_bins_rec[i][timing][bin];
+		}
+	}
+
+	pdev->multi_bins_sum_size = (uint8_t)TuningBinRecSize;
+}
+
 static void vl53lx_diff_histo_stddev(VL53LX_LLDriverData_t *pdev,
 	VL53LX_histogram_bin_data_t *pdata, uint8_t timing, uint8_t HighIndex,
-	uint8_t prev_pos, int32_t *pdiff_histo_stddev) {
+	uint8_t prev_pos, int32_t reset_threshold,
+	int32_t *pdiff_histo_stddev) {
 	uint16_t   bin                      = 0;
 	int32_t    total_rate_pre = 0;
 	int32_t    total_rate_cur = 0;
 	int32_t    PrevBin, CurrBin;
 
-	total_rate_pre = 0;
+	total_rate_pre = pdev->multi_bins_rec_total[prev_pos][timing];
 	total_rate_cur = 0;
 
 
-	for (bin = timing * 4; bin < HighIndex; bin++) {
-		total_rate_pre +=
-		pdev->multi_bins_rec[prev_pos][timing][bin];
+	for (bin = timing * 4; bin < HighIndex; bin++)
 		total_rate_cur += pdata->bin_data[bin];
-	}
+
+
 
 	if ((total_rate_pre != 0) && (total_rate_cur != 0))
 		for (bin = timing * 4; bin < HighIndex; bin++) {
@@ -109,6 +155,8 @@ static void vl53lx_diff_histo_stddev(VL53LX_LLDriverData_t *pdev,
 			CurrBin = pdata->bin_data[bin] * 1000 / total_rate_cur;
 			*pdiff_histo_stddev += (PrevBin - CurrBin) *
 					(PrevBin - CurrBin);
+			if (*pdiff_histo_stddev >= reset_threshold)
+				break;
 	}
 }
 
@@ -123,6 +171,7 @@ static void vl53lx_histo_merge(VL53LX_DEV Dev,
 	uint8_t    timing					= 0;
 	int32_t    rmt  = 0;
 	int32_t    diff_histo_stddev		= 0;
+	int32_t    total_rate               = 0;
 	uint8_t    HighIndex, prev_pos;
 	uint8_t    BuffSize = VL53LX_HISTOGRAM_BUFFER_SIZE;
 	uint8_t    pos;
@@ -136,6 +185,9 @@ static void vl53lx_histo_merge(VL53LX_DEV Dev,
 
 	if (pdev->pos_before_next_recom == 0) {
 
+		if ((int32_t)pdev->multi_bins_sum_size != TuningBinRecSize)
+			vl53lx_histo_merge_resum(pdev, TuningBinRecSize);
+
 		timing = 1 - pdata->result__stream_count % 2;
 
 		diff_histo_stddev = 0;
@@ -147,13 +199,12 @@ static void vl53lx_histo_merge(VL53LX_DEV Dev,
 
 		if (pdev->multi_bins_rec[prev_pos][timing][4] > 0)
 			vl53lx_diff_histo_stddev(pdev, pdata,
-				timing, HighIndex, prev_pos,
+				timing, HighIndex, prev_pos, rmt,
 				&diff_histo_stddev);
 
 		if (diff_histo_stddev >= rmt) {
-			memset(pdev->multi_bins_rec, 0,
-				sizeof(pdev->multi_bins_rec));
-			pdev->bin_rec_pos = 0;
+			vl53lx_histo_merge_reset(pdev,
+				(uint8_t)TuningBinRecSize);
 
 			recom_been_reset = 1;
 
@@ -166,9 +217,18 @@ static void vl53lx_histo_merge(VL53LX_DEV Dev,
 		} else {
 
 			pos = pdev->bin_rec_pos;
-			for (i = 0; i < BuffSize; i++)
+			for (i = 0; i < BuffSize; i++) {
+				if (pos < TuningBinRecSize)
+					pdev->multi_bins_sum[timing][i] +=
+					pdata->bin_data[i] -
+					pdev->multi_bins_rec[pos][timing][i];
 				pdev->multi_bins_rec[pos][timing][i] =
 					pdata->bin_data[i];
+			}
+
+			for (bin = timing * 4; bin < HighIndex; bin++)
+				total_rate += pdata->bin_data[bin];
+			pdev->multi_bins_rec_total[pos][timing] = total_rate;
 		}
 
 		if (pdev->bin_rec_pos == (TuningBinRecSize - 1) && timing == 1)
@@ -180,12 +240,8 @@ static void vl53lx_histo_merge(VL53LX_DEV Dev,
 			 (pdev->pos_before_next_recom == 0)) {
 
 			for (bin = 0; bin < BuffSize; bin++)
-				pdata->bin_data[bin] = 0;
-
-			for (bin = 0; bin < BuffSize; bin++)
-				for (i = 0; i < TuningBinRecSize; i++)
-					pdata->bin_data[bin] +=
-					(pdev->multi_bins_rec[i][timing][bin]);
+				pdata->bin_data[bin] =
+					pdev->multi_bins_sum[timing][bin];
 		}
 	} else {
 
@@ -389,6 +445,22 @@ VL53LX_Error VL53LX_data_init(
 	pdev->dmax_mode  =
 		VL53LX_DEVICEDMAXMODE__FMT_CAL_DATA;
 
+	memset(&(pdev->dmax_cache), 0, sizeof(pdev->dmax_cache));
+	pdev->dmax_cache.reflectance_mask =
+		VL53LX_DMAX_REFLECTANCE_MASK_ALL;
+
+	memset(&(pdev->hist_gate), 0, sizeof(pdev->hist_gate));
+	VL53LX_uwr_init(&(pdev->uwr));
+
+#ifndef VL53LX_SCRATCH_SHARED
+	VL53LX_scratch_init(
+		&(pdev->scratch),
+		pdev->scratch_buffer.words,
+		(uint16_t)sizeof(pdev->scratch_buffer));
+#else
+	VL53LX_scratch_init(&(pdev->scratch), NULL, 0);
+#endif
+
 	pdev->phasecal_config_timeout_us  =  1000;
 	pdev->mm_config_timeout_us        =  2000;
 	pdev->range_config_timeout_us     = 13000;
@@ -410,8 +482,7 @@ VL53LX_Error VL53LX_data_init(
 	VL53LX_init_version(Dev);
 
 
-	memset(pdev->multi_bins_rec, 0, sizeof(pdev->multi_bins_rec));
-	pdev->bin_rec_pos = 0;
+	vl53lx_histo_merge_reset(pdev, 0);
 	pdev->pos_before_next_recom = 0;
 
 
@@ -582,7 +653,7 @@ VL53LX_Error VL53LX_read_p2p_data(
 	VL53LX_customer_nvm_managed_t *pN = &(pdev->customer);
 	VL53LX_additional_offset_cal_data_t *pCD = &(pdev->add_off_cal_data);
 
-	VL53LX_decoded_nvm_fmt_range_data_t fmt_rrd;
+	VL53LX_nvm_cache_data_t nvm_cal;
 
 	LOG_FUNCTION_START("");
 
@@ -623,26 +694,33 @@ VL53LX_Error VL53LX_read_p2p_data(
 
 	if (status == VL53LX_ERROR_NONE)
 		status =
-			VL53LX_read_nvm_optical_centre(
+			VL53LX_read_nvm_p2p_cal_data(
 				Dev,
-				&(pdev->optical_centre));
+				pdev->pnvm_cache,
+				&nvm_cal);
 
 
 
-	if (status == VL53LX_ERROR_NONE)
-		status =
-			VL53LX_read_nvm_cal_peak_rate_map(
-				Dev,
-				&(pdev->cal_peak_rate_map));
+	if (status == VL53LX_ERROR_NONE) {
+		pdev->nvm_uid = nvm_cal.uid;
+		memcpy(
+			&(pdev->optical_centre),
+			&(nvm_cal.optical_centre),
+			sizeof(VL53LX_optical_centre_t));
+		memcpy(
+			&(pdev->cal_peak_rate_map),
+			&(nvm_cal.cal_peak_rate_map),
+			sizeof(VL53LX_cal_peak_rate_map_t));
+	}
 
 
 
 	if (status == VL53LX_ERROR_NONE) {
 
-		status =
-			VL53LX_read_nvm_additional_offset_cal_data(
-				Dev,
-				&(pdev->add_off_cal_data));
+		memcpy(
+			&(pdev->add_off_cal_data),
+			&(nvm_cal.add_off_cal_data),
+			sizeof(VL53LX_additional_offset_cal_data_t));
 
 
 
@@ -671,31 +749,23 @@ VL53LX_Error VL53LX_read_p2p_data(
 
 	if (status == VL53LX_ERROR_NONE) {
 
-		status =
-			VL53LX_read_nvm_fmt_range_results_data(
-				Dev,
-				VL53LX_NVM__FMT__RANGE_RESULTS__140MM_DARK,
-				&fmt_rrd);
-
-		if (status == VL53LX_ERROR_NONE) {
-			pdev->fmt_dmax_cal.ref__actual_effective_spads =
-			fmt_rrd.result__actual_effective_rtn_spads;
-			pdev->fmt_dmax_cal.ref__peak_signal_count_rate_mcps =
-			fmt_rrd.result__peak_signal_count_rate_rtn_mcps;
-			pdev->fmt_dmax_cal.ref__distance_mm =
-			fmt_rrd.measured_distance_mm;
-
-
-			if (pdev->cal_peak_rate_map.cal_reflectance_pc != 0) {
-				pdev->fmt_dmax_cal.ref_reflectance_pc =
-				pdev->cal_peak_rate_map.cal_reflectance_pc;
-			} else {
-				pdev->fmt_dmax_cal.ref_reflectance_pc = 0x0014;
-			}
+		pdev->fmt_dmax_cal.ref__actual_effective_spads =
+		nvm_cal.fmt_dark__actual_effective_rtn_spads;
+		pdev->fmt_dmax_cal.ref__peak_signal_count_rate_mcps =
+		nvm_cal.fmt_dark__peak_signal_count_rate_rtn_mcps;
+		pdev->fmt_dmax_cal.ref__distance_mm =
+		nvm_cal.fmt_dark__measured_distance_mm;
 
 
-			pdev->fmt_dmax_cal.coverglass_transmission = 0x0100;
+		if (pdev->cal_peak_rate_map.cal_reflectance_pc != 0) {
+			pdev->fmt_dmax_cal.ref_reflectance_pc =
+			pdev->cal_peak_rate_map.cal_reflectance_pc;
+		} else {
+			pdev->fmt_dmax_cal.ref_reflectance_pc = 0x0014;
 		}
+
+
+		pdev->fmt_dmax_cal.coverglass_transmission = 0x0100;
 	}
 
 
@@ -2085,8 +2155,11 @@ VL53LX_Error VL53LX_get_device_results(
 	VL53LX_zone_hist_info_t  *phist_info =
 			&(pres->zone_hists.VL53LX_p_003[0]);
 
-	VL53LX_dmax_calibration_data_t   dmax_cal;
-	VL53LX_dmax_calibration_data_t *pdmax_cal = &dmax_cal;
+	VL53LX_scratch_t *pscratch = VL53LX_get_scratch(Dev);
+	uint16_t scratch_mark = VL53LX_scratch_mark(pscratch);
+	VL53LX_dmax_calibration_data_t *pdmax_cal = NULL;
+	uint8_t *pArea1 = NULL;
+	uint8_t *pArea2 = NULL;
 	VL53LX_hist_post_process_config_t *pHP = &(pdev->histpostprocess);
 	VL53LX_xtalk_config_t *pC = &(pdev->xtalk_cfg);
 	VL53LX_low_power_auto_data_t *pL = &(pdev->low_power_auto_data);
@@ -2219,6 +2292,18 @@ VL53LX_Error VL53LX_get_device_results(
 		(uint16_t)pdev->gen_cfg.dss_config__aperture_attenuation,
 		&(pdev->dmax_cfg.max_effective_spads));
 
+		pdmax_cal = VL53LX_SCRATCH_ALLOC(pscratch,
+				VL53LX_dmax_calibration_data_t);
+		pArea1 = (uint8_t *)VL53LX_SCRATCH_ALLOC(pscratch,
+				VL53LX_hist_gen3_algo_private_data_t);
+		pArea2 = (uint8_t *)VL53LX_SCRATCH_ALLOC(pscratch,
+				VL53LX_hist_gen4_algo_filtered_data_t);
+
+		if (pdmax_cal == NULL || pArea1 == NULL || pArea2 == NULL) {
+			status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+			goto UPDATE_DYNAMIC_CONFIG;
+		}
+
 		status =
 			VL53LX_get_dmax_calibration_data(
 				Dev,
@@ -2236,8 +2321,8 @@ VL53LX_Error VL53LX_get_device_results(
 				&(pdev->histpostprocess),
 				&(pdev->hist_data),
 				&(pdev->xtalk_shapes),
-				pdev->wArea1,
-				pdev->wArea2,
+				pArea1,
+				pArea2,
 				&histo_merge_nb,
 				presults);
 
@@ -2467,6 +2552,8 @@ UPDATE_DYNAMIC_CONFIG:
 
 
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
+
 	memcpy(
 		prange_results,
 		presults,
@@ -2543,8 +2630,10 @@ VL53LX_Error VL53LX_get_histogram_bin_data(
 	VL53LX_timing_config_t        *ptim_cfg  = &(pdev->tim_cfg);
 	VL53LX_range_results_t        *presults  = &(pres->range_results);
 
-	uint8_t    buffer[VL53LX_MAX_I2C_XFER_SIZE];
-	uint8_t   *pbuffer = &buffer[0];
+	VL53LX_scratch_t *pscratch = VL53LX_get_scratch(Dev);
+	uint16_t   scratch_mark = VL53LX_scratch_mark(pscratch);
+	uint8_t   *buffer = NULL;
+	uint8_t   *pbuffer = NULL;
 	uint8_t    bin_23_0 = 0x00;
 	uint16_t   bin                      = 0;
 	uint16_t   i2c_buffer_offset_bytes  = 0;
@@ -2559,6 +2648,15 @@ VL53LX_Error VL53LX_get_histogram_bin_data(
 
 	LOG_FUNCTION_START("");
 
+	buffer = (uint8_t *)VL53LX_scratch_alloc(pscratch,
+			VL53LX_MAX_I2C_XFER_SIZE);
+	if (buffer == NULL) {
+		status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+		LOG_FUNCTION_END(status);
+		return status;
+	}
+	pbuffer = &buffer[0];
+
 
 
 	if (status == VL53LX_ERROR_NONE)
@@ -2641,9 +2739,9 @@ VL53LX_Error VL53LX_get_histogram_bin_data(
 
 	if (pdata->result__stream_count == 0) {
 
-		memset(pdev->multi_bins_rec, 0, sizeof(pdev->multi_bins_rec));
-		pdev->bin_rec_pos = 0;
+		vl53lx_histo_merge_reset(pdev, 0);
 		pdev->pos_before_next_recom = 0;
+		VL53LX_dmax_cache_invalidate(&(pdev->dmax_cache));
 	}
 
 	if (hist_merge == 1)
@@ -2768,6 +2866,8 @@ VL53LX_Error VL53LX_get_histogram_bin_data(
 
 	}
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
+
 	LOG_FUNCTION_END(status);
 
 	return status;
@@ -3018,6 +3118,7 @@ VL53LX_Error VL53LX_set_dmax_mode(
 	LOG_FUNCTION_START("");
 
 	pdev->dmax_mode = dmax_mode;
+	VL53LX_dmax_cache_invalidate(&(pdev->dmax_cache));
 
 	LOG_FUNCTION_END(status);
 
@@ -3045,6 +3146,259 @@ VL53LX_Error VL53LX_get_dmax_mode(
 }
 
 
+VL53LX_Error VL53LX_set_dmax_cache_config(
+	VL53LX_DEV               Dev,
+	uint8_t                  reflectance_mask,
+	uint8_t                  cache_enable,
+	uint8_t                  ambient_quant_shift,
+	uint8_t                  refresh_period)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	VL53LX_dmax_cache_t   *pcache = &(pdev->dmax_cache);
+
+	LOG_FUNCTION_START("");
+
+	if ((reflectance_mask & ~VL53LX_DMAX_REFLECTANCE_MASK_ALL) != 0 ||
+		ambient_quant_shift > 15)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	if (status == VL53LX_ERROR_NONE) {
+		pcache->reflectance_mask    = reflectance_mask;
+		pcache->cache_enable        = cache_enable;
+		pcache->ambient_quant_shift = ambient_quant_shift;
+		pcache->refresh_period      = refresh_period;
+		pcache->hit_count           = 0;
+		pcache->miss_count          = 0;
+		VL53LX_dmax_cache_invalidate(pcache);
+	}
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_get_dmax_cache_stats(
+	VL53LX_DEV               Dev,
+	uint32_t                *phit_count,
+	uint32_t                *pmiss_count)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	LOG_FUNCTION_START("");
+
+	*phit_count  = pdev->dmax_cache.hit_count;
+	*pmiss_count = pdev->dmax_cache.miss_count;
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_set_hist_gate(
+	VL53LX_DEV               Dev,
+	uint8_t                  gate_enable,
+	int16_t                  min_range_mm,
+	int16_t                  max_range_mm,
+	uint8_t                  margin_bins)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	VL53LX_hist_gate_t    *pgate = &(pdev->hist_gate);
+
+	LOG_FUNCTION_START("");
+
+	if (gate_enable > 0 && min_range_mm > max_range_mm)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	if (status == VL53LX_ERROR_NONE) {
+		pgate->gate_enable  = gate_enable;
+		pgate->min_range_mm = min_range_mm;
+		pgate->max_range_mm = max_range_mm;
+		pgate->margin_bins  = margin_bins;
+	}
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_get_hist_gate_stats(
+	VL53LX_DEV               Dev,
+	VL53LX_hist_gate_t      *pgate)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	LOG_FUNCTION_START("");
+
+	memcpy(pgate, &(pdev->hist_gate), sizeof(VL53LX_hist_gate_t));
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_set_uwr_zones(
+	VL53LX_DEV                Dev,
+	VL53LX_DevicePresetModes  preset_mode,
+	const VL53LX_uwr_rule_t  *prules,
+	uint8_t                   rule_count,
+	uint8_t                   sequence_count)
+{
+
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	VL53LX_uwr_mode_table_t table;
+	uint8_t mode;
+
+	LOG_FUNCTION_START("");
+
+	mode = VL53LX_uwr_mode_index(preset_mode);
+	if (mode >= VL53LX_UWR_MODE_COUNT)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	if (status == VL53LX_ERROR_NONE && prules == NULL) {
+		pdev->uwr.mode[mode].custom = 0;
+		pdev->uwr.tables_stale = 1;
+	} else if (status == VL53LX_ERROR_NONE) {
+		status = VL53LX_uwr_build_table(
+			prules, rule_count, sequence_count, &table);
+		if (status == VL53LX_ERROR_NONE) {
+			table.custom = 1;
+			memcpy(&(pdev->uwr.mode[mode]), &table, sizeof(table));
+		}
+	}
+
+	if (status == VL53LX_ERROR_NONE)
+		memset(pdev->uwr.confirm_count, 0,
+			sizeof(pdev->uwr.confirm_count));
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_set_uwr_confirmation(
+	VL53LX_DEV               Dev,
+	uint8_t                  confirm_depth,
+	int16_t                  hysteresis_mm)
+{
+
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	LOG_FUNCTION_START("");
+
+	if (confirm_depth == 0 || hysteresis_mm < 0)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	if (status == VL53LX_ERROR_NONE) {
+		pdev->uwr.confirm_depth = confirm_depth;
+		pdev->uwr.hysteresis_mm = hysteresis_mm;
+		memset(pdev->uwr.confirm_count, 0,
+			sizeof(pdev->uwr.confirm_count));
+	}
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_scratch_t *VL53LX_get_scratch(
+	VL53LX_DEV               Dev)
+{
+
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	if (pdev->pscratch != NULL)
+		return pdev->pscratch;
+
+#ifndef VL53LX_SCRATCH_SHARED
+
+	pdev->scratch.pbuffer = (uint8_t *)pdev->scratch_buffer.words;
+#endif
+
+	return &(pdev->scratch);
+}
+
+
+VL53LX_Error VL53LX_set_scratch_arena(
+	VL53LX_DEV               Dev,
+	VL53LX_scratch_t        *pscratch)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	LOG_FUNCTION_START("");
+
+	if (pscratch != NULL &&
+		(pscratch->pbuffer == NULL ||
+		 pscratch->size_bytes < VL53LX_SCRATCH_SIZE_BYTES))
+		status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+
+	if (status == VL53LX_ERROR_NONE)
+		pdev->pscratch = pscratch;
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_get_scratch_usage(
+	VL53LX_DEV               Dev,
+	uint16_t                *psize_bytes,
+	uint16_t                *ppeak_bytes,
+	uint16_t                *pfail_count)
+{
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_scratch_t *pscratch = VL53LX_get_scratch(Dev);
+
+	LOG_FUNCTION_START("");
+
+	*psize_bytes = pscratch->size_bytes;
+	*ppeak_bytes = pscratch->peak_bytes;
+	*pfail_count = pscratch->fail_count;
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
 VL53LX_Error VL53LX_get_dmax_calibration_data(
 	VL53LX_DEV                      Dev,
 	VL53LX_DeviceDmaxMode           dmax_mode,
@@ -3578,775 +3932,553 @@ VL53LX_Error VL53LX_get_tuning_debug_data(
 
 
 
-VL53LX_Error VL53LX_get_tuning_parm(
-	VL53LX_DEV                     Dev,
-	VL53LX_TuningParms             tuning_parm_key,
-	int32_t                       *ptuning_parm_value)
+#define VL53LX_TP_TYPE_U8        0
+#define VL53LX_TP_TYPE_U16       1
+#define VL53LX_TP_TYPE_I16       2
+#define VL53LX_TP_TYPE_U32       3
+#define VL53LX_TP_TYPE_I32       4
+#define VL53LX_TP_TYPE_U32_U16   5
+
+#define VL53LX_TP_SIZE_U8        1
+#define VL53LX_TP_SIZE_U16       2
+#define VL53LX_TP_SIZE_I16       2
+#define VL53LX_TP_SIZE_U32       4
+#define VL53LX_TP_SIZE_I32       4
+#define VL53LX_TP_SIZE_U32_U16   4
+
+#define VL53LX_TUNINGPARM_TABLE_SIZE \
+	(VL53LX_TUNINGPARMS_LLD_PUBLIC_MAX_ADDRESS - \
+	VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS + 1)
+
+/* valid is 1; the array size is negative when the member size does
+ * not match the type code, which stops the build at that entry */
+#define VL53LX_TP_ENTRY(key, member, type) \
+	[(key) - VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS] = { \
+		(uint16_t)offsetof(VL53LX_LLDriverData_t, member), \
+		VL53LX_TP_TYPE_##type, \
+		(uint8_t)sizeof(char[ \
+			sizeof(((VL53LX_LLDriverData_t *)0)->member) == \
+			VL53LX_TP_SIZE_##type ? 1 : -1]) }
+
+typedef struct {
+	uint16_t offset;
+	uint8_t  type;
+	uint8_t  valid;
+} VL53LX_tuning_parm_field_t;
+
+VL53LX_SCRATCH_STATIC_CHECK(
+	sizeof(VL53LX_LLDriverData_t) <= 0xFFFF,
+	tuning_parm_offset_fits_uint16);
+
+
+static const VL53LX_tuning_parm_field_t
+	VL53LX_tuning_parm_fields[VL53LX_TUNINGPARM_TABLE_SIZE] = {
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_VERSION,
+		tuning_parms.tp_tuning_parm_version, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_KEY_TABLE_VERSION,
+		tuning_parms.tp_tuning_parm_key_table_version, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LLD_VERSION,
+		tuning_parms.tp_tuning_parm_lld_version, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_ALGO_SELECT,
+		histpostprocess.hist_algo_select, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_TARGET_ORDER,
+		histpostprocess.hist_target_order, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_FILTER_WOI_0,
+		histpostprocess.filter_woi0, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_FILTER_WOI_1,
+		histpostprocess.filter_woi1, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_AMB_EST_METHOD,
+		histpostprocess.hist_amb_est_method, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_0,
+		histpostprocess.ambient_thresh_sigma0, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_1,
+		histpostprocess.ambient_thresh_sigma1, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_MIN_AMB_THRESH_EVENTS,
+		histpostprocess.min_ambient_thresh_events, I32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_AMB_EVENTS_SCALER,
+		histpostprocess.ambient_thresh_events_scaler, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_NOISE_THRESHOLD,
+		histpostprocess.noise_threshold, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_SIGNAL_TOTAL_EVENTS_LIMIT,
+		histpostprocess.signal_total_events_limit, I32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_SIGMA_EST_REF_MM,
+		histpostprocess.sigma_estimator__sigma_ref_mm, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM,
+		histpostprocess.sigma_thresh, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_GAIN_FACTOR,
+		gain_cal.histogram_ranging_gain_factor, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_CONSISTENCY_HIST_PHASE_TOLERANCE,
+		histpostprocess.algo__consistency_check__phase_tolerance, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_CONSISTENCY_HIST_MIN_MAX_TOLERANCE_MM,
+		histpostprocess.algo__consistency_check__min_max_tolerance, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA,
+		histpostprocess.algo__consistency_check__event_sigma, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA_MIN_SPAD_LIMIT,
+		histpostprocess.algo__consistency_check__event_min_spad_count, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_LONG_RANGE,
+		tuning_parms.tp_init_phase_rtn_hist_long, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_MED_RANGE,
+		tuning_parms.tp_init_phase_rtn_hist_med, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_SHORT_RANGE,
+		tuning_parms.tp_init_phase_rtn_hist_short, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_LONG_RANGE,
+		tuning_parms.tp_init_phase_ref_hist_long, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_MED_RANGE,
+		tuning_parms.tp_init_phase_ref_hist_med, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_SHORT_RANGE,
+		tuning_parms.tp_init_phase_ref_hist_short, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_MIN_VALID_RANGE_MM,
+		xtalk_cfg.algo__crosstalk_detect_min_valid_range_mm, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RANGE_MM,
+		xtalk_cfg.algo__crosstalk_detect_max_valid_range_mm, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_MAX_SIGMA_MM,
+		xtalk_cfg.algo__crosstalk_detect_max_sigma_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_MIN_MAX_TOLERANCE,
+		histpostprocess.algo__crosstalk_detect_min_max_tolerance, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RATE_KCPS,
+		xtalk_cfg.algo__crosstalk_detect_max_valid_rate_kcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_DETECT_EVENT_SIGMA,
+		histpostprocess.algo__crosstalk_detect_event_sigma, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_XTALK_MARGIN_KCPS,
+		xtalk_cfg.histogram_mode_crosstalk_margin_kcps, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_CONSISTENCY_LITE_PHASE_TOLERANCE,
+		tuning_parms.tp_consistency_lite_phase_tolerance, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_PHASECAL_TARGET,
+		tuning_parms.tp_phasecal_target, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_CAL_REPEAT_RATE,
+		tuning_parms.tp_cal_repeat_rate, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_RANGING_GAIN_FACTOR,
+		gain_cal.standard_ranging_gain_factor, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_MIN_CLIP_MM,
+		tuning_parms.tp_lite_min_clip, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_LONG_SIGMA_THRESH_MM,
+		tuning_parms.tp_lite_long_sigma_thresh_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_MED_SIGMA_THRESH_MM,
+		tuning_parms.tp_lite_med_sigma_thresh_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SHORT_SIGMA_THRESH_MM,
+		tuning_parms.tp_lite_short_sigma_thresh_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_LONG_MIN_COUNT_RATE_RTN_MCPS,
+		tuning_parms.tp_lite_long_min_count_rate_rtn_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_MED_MIN_COUNT_RATE_RTN_MCPS,
+		tuning_parms.tp_lite_med_min_count_rate_rtn_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SHORT_MIN_COUNT_RATE_RTN_MCPS,
+		tuning_parms.tp_lite_short_min_count_rate_rtn_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SIGMA_EST_PULSE_WIDTH,
+		tuning_parms.tp_lite_sigma_est_pulse_width_ns, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SIGMA_EST_AMB_WIDTH_NS,
+		tuning_parms.tp_lite_sigma_est_amb_width_ns, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SIGMA_REF_MM,
+		tuning_parms.tp_lite_sigma_ref_mm, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_RIT_MULT,
+		xtalk_cfg.crosstalk_range_ignore_threshold_mult, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_SEED_CONFIG,
+		tuning_parms.tp_lite_seed_cfg, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_QUANTIFIER,
+		tuning_parms.tp_lite_quantifier, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_FIRST_ORDER_SELECT,
+		tuning_parms.tp_lite_first_order_select, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_XTALK_MARGIN_KCPS,
+		xtalk_cfg.lite_mode_crosstalk_margin_kcps, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_LONG_RANGE,
+		tuning_parms.tp_init_phase_rtn_lite_long, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_MED_RANGE,
+		tuning_parms.tp_init_phase_rtn_lite_med, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_SHORT_RANGE,
+		tuning_parms.tp_init_phase_rtn_lite_short, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_LONG_RANGE,
+		tuning_parms.tp_init_phase_ref_lite_long, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_MED_RANGE,
+		tuning_parms.tp_init_phase_ref_lite_med, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_SHORT_RANGE,
+		tuning_parms.tp_init_phase_ref_lite_short, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_TIMED_SEED_CONFIG,
+		tuning_parms.tp_timed_seed_cfg, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_SIGNAL_THRESH_SIGMA,
+		dmax_cfg.signal_thresh_sigma, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_0,
+		dmax_cfg.target_reflectance_for_dmax_calc[0], U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_1,
+		dmax_cfg.target_reflectance_for_dmax_calc[1], U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_2,
+		dmax_cfg.target_reflectance_for_dmax_calc[2], U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_3,
+		dmax_cfg.target_reflectance_for_dmax_calc[3], U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_4,
+		dmax_cfg.target_reflectance_for_dmax_calc[4], U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_VHV_LOOPBOUND,
+		stat_nvm.vhv_config__timeout_macrop_loop_bound, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_DEVICE_TEST_MODE,
+		refspadchar.device_test_mode, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_VCSEL_PERIOD,
+		refspadchar.VL53LX_p_005, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_PHASECAL_TIMEOUT_US,
+		refspadchar.timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_TARGET_COUNT_RATE_MCPS,
+		refspadchar.target_count_rate_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_MIN_COUNTRATE_LIMIT_MCPS,
+		refspadchar.min_count_rate_limit_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_REFSPADCHAR_MAX_COUNTRATE_LIMIT_MCPS,
+		refspadchar.max_count_rate_limit_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_NUM_OF_SAMPLES,
+		xtalk_extract_cfg.num_of_samples, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_MIN_FILTER_THRESH_MM,
+		xtalk_extract_cfg.algo__crosstalk_extract_min_valid_range_mm, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_FILTER_THRESH_MM,
+		xtalk_extract_cfg.algo__crosstalk_extract_max_valid_range_mm, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_RATE_MCPS,
+		xtalk_extract_cfg.dss_config__target_total_rate_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_PHASECAL_TIMEOUT_US,
+		xtalk_extract_cfg.phasecal_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_VALID_RATE_KCPS,
+		xtalk_extract_cfg.algo__crosstalk_extract_max_valid_rate_kcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_SIGMA_THRESHOLD_MM,
+		xtalk_extract_cfg.algo__crosstalk_extract_max_sigma_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_TIMEOUT_US,
+		xtalk_extract_cfg.mm_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_XTALK_EXTRACT_BIN_TIMEOUT_US,
+		xtalk_extract_cfg.range_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_DSS_RATE_MCPS,
+		offsetcal_cfg.dss_config__target_total_rate_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_PHASECAL_TIMEOUT_US,
+		offsetcal_cfg.phasecal_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_MM_TIMEOUT_US,
+		offsetcal_cfg.mm_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_RANGE_TIMEOUT_US,
+		offsetcal_cfg.range_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_PRE_SAMPLES,
+		offsetcal_cfg.pre_num_of_samples, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_MM1_SAMPLES,
+		offsetcal_cfg.mm1_num_of_samples, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_OFFSET_CAL_MM2_SAMPLES,
+		offsetcal_cfg.mm2_num_of_samples, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_DSS_RATE_MCPS,
+		zonecal_cfg.dss_config__target_total_rate_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_TIMEOUT_US,
+		zonecal_cfg.phasecal_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_DSS_TIMEOUT_US,
+		zonecal_cfg.mm_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_NUM_SAMPLES,
+		zonecal_cfg.phasecal_num_of_samples, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_RANGE_TIMEOUT_US,
+		zonecal_cfg.range_config_timeout_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_ZONE_CAL_ZONE_NUM_SAMPLES,
+		zonecal_cfg.zone_num_of_samples, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_SPADMAP_VCSEL_PERIOD,
+		ssc_cfg.VL53LX_p_005, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_SPADMAP_VCSEL_START,
+		ssc_cfg.vcsel_start, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_SPADMAP_RATE_LIMIT_MCPS,
+		ssc_cfg.rate_limit_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS,
+		tuning_parms.tp_dss_target_lite_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS,
+		tuning_parms.tp_dss_target_histo_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS,
+		tuning_parms.tp_dss_target_histo_mz_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_TIMED_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS,
+		tuning_parms.tp_dss_target_timed_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_lite_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_LONG_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_hist_long_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_MED_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_hist_med_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_SHORT_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_hist_short_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_LONG_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_mz_long_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_MED_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_mz_med_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_SHORT_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_mz_short_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_TIMED_PHASECAL_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_phasecal_timeout_timed_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_MM_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_mm_timeout_lite_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_MM_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_mm_timeout_histo_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_MM_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_mm_timeout_mz_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_TIMED_MM_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_mm_timeout_timed_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LITE_RANGE_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_range_timeout_lite_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RANGING_RANGE_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_range_timeout_histo_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_MZ_RANGE_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_range_timeout_mz_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_TIMED_RANGE_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_range_timeout_timed_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_MARGIN,
+		smudge_correct_config.smudge_margin, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_NOISE_MARGIN,
+		smudge_correct_config.noise_margin, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT,
+		smudge_correct_config.user_xtalk_offset_limit, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT_HI,
+		smudge_correct_config.user_xtalk_offset_limit_hi, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_SAMPLE_LIMIT,
+		smudge_correct_config.sample_limit, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_SINGLE_XTALK_DELTA,
+		smudge_correct_config.single_xtalk_delta, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_AVERAGED_XTALK_DELTA,
+		smudge_correct_config.averaged_xtalk_delta, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_CLIP_LIMIT,
+		smudge_correct_config.smudge_corr_clip_limit, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_SCALER_CALC_METHOD,
+		smudge_correct_config.scaler_calc_method, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_XGRADIENT_SCALER,
+		smudge_correct_config.x_gradient_scaler, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_YGRADIENT_SCALER,
+		smudge_correct_config.y_gradient_scaler, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_USER_SCALER_SET,
+		smudge_correct_config.user_scaler_set, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_COR_SINGLE_APPLY,
+		smudge_correct_config.smudge_corr_single_apply, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_XTALK_AMB_THRESHOLD,
+		smudge_correct_config.smudge_corr_ambient_threshold, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_NODETECT_AMB_THRESHOLD_KCPS,
+		smudge_correct_config.nodetect_ambient_threshold, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_NODETECT_SAMPLE_LIMIT,
+		smudge_correct_config.nodetect_sample_limit, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_NODETECT_XTALK_OFFSET_KCPS,
+		smudge_correct_config.nodetect_xtalk_offset, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_NODETECT_MIN_RANGE_MM,
+		smudge_correct_config.nodetect_min_range_mm, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LOWPOWERAUTO_VHV_LOOP_BOUND,
+		low_power_auto_data.vhv_loop_bound, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LOWPOWERAUTO_MM_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_mm_timeout_lpa_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_LOWPOWERAUTO_RANGE_CONFIG_TIMEOUT_US,
+		tuning_parms.tp_range_timeout_lpa_us, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_VERY_SHORT_DSS_RATE_MCPS,
+		tuning_parms.tp_dss_target_very_short_mcps, U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_PHASECAL_PATCH_POWER,
+		tuning_parms.tp_phasecal_patch_power, U32_U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_MERGE,
+		tuning_parms.tp_hist_merge, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD,
+		tuning_parms.tp_reset_merge_threshold, U32_U16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE,
+		tuning_parms.tp_hist_merge_max_size, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_DYNXTALK_MAX_SMUDGE_FACTOR,
+		smudge_correct_config.max_smudge_factor, U32),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_ENABLE,
+		tuning_parms.tp_uwr_enable, U8),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MIN,
+		tuning_parms.tp_uwr_med_z_1_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MAX,
+		tuning_parms.tp_uwr_med_z_1_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MIN,
+		tuning_parms.tp_uwr_med_z_2_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MAX,
+		tuning_parms.tp_uwr_med_z_2_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MIN,
+		tuning_parms.tp_uwr_med_z_3_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MAX,
+		tuning_parms.tp_uwr_med_z_3_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MIN,
+		tuning_parms.tp_uwr_med_z_4_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MAX,
+		tuning_parms.tp_uwr_med_z_4_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MIN,
+		tuning_parms.tp_uwr_med_z_5_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MAX,
+		tuning_parms.tp_uwr_med_z_5_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEA,
+		tuning_parms.tp_uwr_med_corr_z_1_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEB,
+		tuning_parms.tp_uwr_med_corr_z_1_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEA,
+		tuning_parms.tp_uwr_med_corr_z_2_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEB,
+		tuning_parms.tp_uwr_med_corr_z_2_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEA,
+		tuning_parms.tp_uwr_med_corr_z_3_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEB,
+		tuning_parms.tp_uwr_med_corr_z_3_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEA,
+		tuning_parms.tp_uwr_med_corr_z_4_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEB,
+		tuning_parms.tp_uwr_med_corr_z_4_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEA,
+		tuning_parms.tp_uwr_med_corr_z_5_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEB,
+		tuning_parms.tp_uwr_med_corr_z_5_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MIN,
+		tuning_parms.tp_uwr_lng_z_1_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MAX,
+		tuning_parms.tp_uwr_lng_z_1_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MIN,
+		tuning_parms.tp_uwr_lng_z_2_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MAX,
+		tuning_parms.tp_uwr_lng_z_2_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MIN,
+		tuning_parms.tp_uwr_lng_z_3_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MAX,
+		tuning_parms.tp_uwr_lng_z_3_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MIN,
+		tuning_parms.tp_uwr_lng_z_4_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MAX,
+		tuning_parms.tp_uwr_lng_z_4_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MIN,
+		tuning_parms.tp_uwr_lng_z_5_min, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MAX,
+		tuning_parms.tp_uwr_lng_z_5_max, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEA,
+		tuning_parms.tp_uwr_lng_corr_z_1_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEB,
+		tuning_parms.tp_uwr_lng_corr_z_1_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEA,
+		tuning_parms.tp_uwr_lng_corr_z_2_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEB,
+		tuning_parms.tp_uwr_lng_corr_z_2_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEA,
+		tuning_parms.tp_uwr_lng_corr_z_3_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEB,
+		tuning_parms.tp_uwr_lng_corr_z_3_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEA,
+		tuning_parms.tp_uwr_lng_corr_z_4_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEB,
+		tuning_parms.tp_uwr_lng_corr_z_4_rangeb, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEA,
+		tuning_parms.tp_uwr_lng_corr_z_5_rangea, I16),
+	VL53LX_TP_ENTRY(VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEB,
+		tuning_parms.tp_uwr_lng_corr_z_5_rangeb, I16),
+};
+
+
+
+
+static const VL53LX_tuning_parm_field_t *VL53LX_tuning_parm_lookup(
+	VL53LX_TuningParms             tuning_parm_key)
 {
+	uint16_t index;
 
+	if (tuning_parm_key < VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS ||
+		tuning_parm_key > VL53LX_TUNINGPARMS_LLD_PUBLIC_MAX_ADDRESS)
+		return NULL;
 
+	index = tuning_parm_key - VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS;
+	if (VL53LX_tuning_parm_fields[index].valid == 0)
+		return NULL;
 
-	VL53LX_Error  status = VL53LX_ERROR_NONE;
+	return &VL53LX_tuning_parm_fields[index];
+}
 
-	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
-	VL53LX_hist_post_process_config_t *pHP = &(pdev->histpostprocess);
-	VL53LX_xtalkextract_config_t *pXC = &(pdev->xtalk_extract_cfg);
 
-	LOG_FUNCTION_START("");
 
-	switch (tuning_parm_key) {
 
-	case VL53LX_TUNINGPARM_VERSION:
-		*ptuning_parm_value =
-			(int32_t)pdev->tuning_parms.tp_tuning_parm_version;
-	break;
-	case VL53LX_TUNINGPARM_KEY_TABLE_VERSION:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_tuning_parm_key_table_version;
-	break;
-	case VL53LX_TUNINGPARM_LLD_VERSION:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_tuning_parm_lld_version;
+static int32_t VL53LX_tuning_parm_read(
+	VL53LX_LLDriverData_t            *pdev,
+	const VL53LX_tuning_parm_field_t *pfield)
+{
+	const uint8_t *pdata = (const uint8_t *)pdev + pfield->offset;
+	int32_t value;
+
+	switch (pfield->type) {
+	case VL53LX_TP_TYPE_U8:
+		value = (int32_t)(*pdata);
 	break;
-	case VL53LX_TUNINGPARM_HIST_ALGO_SELECT:
-		*ptuning_parm_value =
-				(int32_t)pHP->hist_algo_select;
+	case VL53LX_TP_TYPE_U16:
+		value = (int32_t)(*(const uint16_t *)pdata);
 	break;
-	case VL53LX_TUNINGPARM_HIST_TARGET_ORDER:
-		*ptuning_parm_value =
-				(int32_t)pHP->hist_target_order;
+	case VL53LX_TP_TYPE_I16:
+		value = (int32_t)(*(const int16_t *)pdata);
 	break;
-	case VL53LX_TUNINGPARM_HIST_FILTER_WOI_0:
-		*ptuning_parm_value =
-				(int32_t)pHP->filter_woi0;
+	case VL53LX_TP_TYPE_I32:
+		value = *(const int32_t *)pdata;
 	break;
-	case VL53LX_TUNINGPARM_HIST_FILTER_WOI_1:
-		*ptuning_parm_value =
-				(int32_t)pHP->filter_woi1;
+	default:
+		value = (int32_t)(*(const uint32_t *)pdata);
 	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_EST_METHOD:
-		*ptuning_parm_value =
-				(int32_t)pHP->hist_amb_est_method;
+	}
+
+	return value;
+}
+
+
+
+
+static void VL53LX_tuning_parm_write(
+	VL53LX_LLDriverData_t            *pdev,
+	const VL53LX_tuning_parm_field_t *pfield,
+	int32_t                           value)
+{
+	uint8_t *pdata = (uint8_t *)pdev + pfield->offset;
+
+	switch (pfield->type) {
+	case VL53LX_TP_TYPE_U8:
+		*pdata = (uint8_t)value;
 	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_0:
-		*ptuning_parm_value =
-				(int32_t)pHP->ambient_thresh_sigma0;
+	case VL53LX_TP_TYPE_U16:
+		*(uint16_t *)pdata = (uint16_t)value;
 	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_1:
-		*ptuning_parm_value =
-				(int32_t)pHP->ambient_thresh_sigma1;
+	case VL53LX_TP_TYPE_I16:
+		*(int16_t *)pdata = (int16_t)value;
 	break;
-	case VL53LX_TUNINGPARM_HIST_MIN_AMB_THRESH_EVENTS:
-		*ptuning_parm_value =
-				(int32_t)pHP->min_ambient_thresh_events;
+	case VL53LX_TP_TYPE_U32:
+		*(uint32_t *)pdata = (uint32_t)value;
 	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_EVENTS_SCALER:
-		*ptuning_parm_value =
-				(int32_t)pHP->ambient_thresh_events_scaler;
+	case VL53LX_TP_TYPE_I32:
+		*(int32_t *)pdata = value;
 	break;
-	case VL53LX_TUNINGPARM_HIST_NOISE_THRESHOLD:
-		*ptuning_parm_value =
-				(int32_t)pHP->noise_threshold;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGNAL_TOTAL_EVENTS_LIMIT:
-		*ptuning_parm_value =
-				(int32_t)pHP->signal_total_events_limit;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGMA_EST_REF_MM:
-		*ptuning_parm_value =
-				(int32_t)pHP->sigma_estimator__sigma_ref_mm;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM:
-		*ptuning_parm_value =
-				(int32_t)pHP->sigma_thresh;
-	break;
-	case VL53LX_TUNINGPARM_HIST_GAIN_FACTOR:
-		*ptuning_parm_value =
-		(int32_t)pdev->gain_cal.histogram_ranging_gain_factor;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_PHASE_TOLERANCE:
-		*ptuning_parm_value =
-	(int32_t)pHP->algo__consistency_check__phase_tolerance;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_MIN_MAX_TOLERANCE_MM:
-		*ptuning_parm_value =
-	(int32_t)pHP->algo__consistency_check__min_max_tolerance;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA:
-		*ptuning_parm_value =
-		(int32_t)pHP->algo__consistency_check__event_sigma;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA_MIN_SPAD_LIMIT:
-		*ptuning_parm_value =
-		(int32_t)pHP->algo__consistency_check__event_min_spad_count;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_LONG_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_hist_long;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_MED_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_hist_med;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_SHORT_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_hist_short;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_LONG_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_hist_long;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_MED_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_hist_med;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_SHORT_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_hist_short;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MIN_VALID_RANGE_MM:
-		*ptuning_parm_value = (int32_t)(
-		pdev->xtalk_cfg.algo__crosstalk_detect_min_valid_range_mm);
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RANGE_MM:
-		*ptuning_parm_value = (int32_t)(
-		pdev->xtalk_cfg.algo__crosstalk_detect_max_valid_range_mm);
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_SIGMA_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->xtalk_cfg.algo__crosstalk_detect_max_sigma_mm;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MIN_MAX_TOLERANCE:
-		*ptuning_parm_value =
-		(int32_t)pHP->algo__crosstalk_detect_min_max_tolerance;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RATE_KCPS:
-		*ptuning_parm_value = (int32_t)(
-		pdev->xtalk_cfg.algo__crosstalk_detect_max_valid_rate_kcps);
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_EVENT_SIGMA:
-		*ptuning_parm_value =
-		(int32_t)pHP->algo__crosstalk_detect_event_sigma;
-	break;
-	case VL53LX_TUNINGPARM_HIST_XTALK_MARGIN_KCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->xtalk_cfg.histogram_mode_crosstalk_margin_kcps;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_LITE_PHASE_TOLERANCE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_consistency_lite_phase_tolerance;
-	break;
-	case VL53LX_TUNINGPARM_PHASECAL_TARGET:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_target;
-	break;
-	case VL53LX_TUNINGPARM_LITE_CAL_REPEAT_RATE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_cal_repeat_rate;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RANGING_GAIN_FACTOR:
-		*ptuning_parm_value =
-		(int32_t)pdev->gain_cal.standard_ranging_gain_factor;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MIN_CLIP_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_min_clip;
-	break;
-	case VL53LX_TUNINGPARM_LITE_LONG_SIGMA_THRESH_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_long_sigma_thresh_mm;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MED_SIGMA_THRESH_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_med_sigma_thresh_mm;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SHORT_SIGMA_THRESH_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_short_sigma_thresh_mm;
-	break;
-	case VL53LX_TUNINGPARM_LITE_LONG_MIN_COUNT_RATE_RTN_MCPS:
-		*ptuning_parm_value = (int32_t)(
-		pdev->tuning_parms.tp_lite_long_min_count_rate_rtn_mcps);
-	break;
-	case VL53LX_TUNINGPARM_LITE_MED_MIN_COUNT_RATE_RTN_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_med_min_count_rate_rtn_mcps;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SHORT_MIN_COUNT_RATE_RTN_MCPS:
-		*ptuning_parm_value = (int32_t)(
-		pdev->tuning_parms.tp_lite_short_min_count_rate_rtn_mcps);
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_EST_PULSE_WIDTH:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_sigma_est_pulse_width_ns;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_EST_AMB_WIDTH_NS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_sigma_est_amb_width_ns;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_REF_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_sigma_ref_mm;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RIT_MULT:
-		*ptuning_parm_value =
-		(int32_t)pdev->xtalk_cfg.crosstalk_range_ignore_threshold_mult;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SEED_CONFIG:
-		*ptuning_parm_value =
-				(int32_t)pdev->tuning_parms.tp_lite_seed_cfg;
-	break;
-	case VL53LX_TUNINGPARM_LITE_QUANTIFIER:
-		*ptuning_parm_value =
-				(int32_t)pdev->tuning_parms.tp_lite_quantifier;
-	break;
-	case VL53LX_TUNINGPARM_LITE_FIRST_ORDER_SELECT:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_lite_first_order_select;
-	break;
-	case VL53LX_TUNINGPARM_LITE_XTALK_MARGIN_KCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->xtalk_cfg.lite_mode_crosstalk_margin_kcps;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_LONG_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_lite_long;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_MED_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_lite_med;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_SHORT_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_rtn_lite_short;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_LONG_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_lite_long;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_MED_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_lite_med;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_SHORT_RANGE:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_init_phase_ref_lite_short;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_SEED_CONFIG:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_timed_seed_cfg;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_SIGNAL_THRESH_SIGMA:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.signal_thresh_sigma;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_0:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.target_reflectance_for_dmax_calc[0];
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_1:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.target_reflectance_for_dmax_calc[1];
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_2:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.target_reflectance_for_dmax_calc[2];
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_3:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.target_reflectance_for_dmax_calc[3];
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_4:
-		*ptuning_parm_value =
-		(int32_t)pdev->dmax_cfg.target_reflectance_for_dmax_calc[4];
-	break;
-	case VL53LX_TUNINGPARM_VHV_LOOPBOUND:
-		*ptuning_parm_value =
-		(int32_t)pdev->stat_nvm.vhv_config__timeout_macrop_loop_bound;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_DEVICE_TEST_MODE:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.device_test_mode;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_VCSEL_PERIOD:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.VL53LX_p_005;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_PHASECAL_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_TARGET_COUNT_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.target_count_rate_mcps;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_MIN_COUNTRATE_LIMIT_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.min_count_rate_limit_mcps;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_MAX_COUNTRATE_LIMIT_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->refspadchar.max_count_rate_limit_mcps;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_NUM_OF_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pXC->num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MIN_FILTER_THRESH_MM:
-		*ptuning_parm_value =
-		(int32_t)pXC->algo__crosstalk_extract_min_valid_range_mm;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_FILTER_THRESH_MM:
-		*ptuning_parm_value =
-		(int32_t)pXC->algo__crosstalk_extract_max_valid_range_mm;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pXC->dss_config__target_total_rate_mcps;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_PHASECAL_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pXC->phasecal_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_VALID_RATE_KCPS:
-		*ptuning_parm_value =
-		(int32_t)pXC->algo__crosstalk_extract_max_valid_rate_kcps;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_SIGMA_THRESHOLD_MM:
-		*ptuning_parm_value =
-		(int32_t)pXC->algo__crosstalk_extract_max_sigma_mm;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pXC->mm_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_BIN_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pXC->range_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_DSS_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.dss_config__target_total_rate_mcps;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_PHASECAL_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.phasecal_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.mm_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_RANGE_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.range_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_PRE_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.pre_num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM1_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.mm1_num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM2_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pdev->offsetcal_cfg.mm2_num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_DSS_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->zonecal_cfg.dss_config__target_total_rate_mcps;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_TIMEOUT_US:
-		*ptuning_parm_value =
-	(int32_t)pdev->zonecal_cfg.phasecal_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_DSS_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->zonecal_cfg.mm_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_NUM_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pdev->zonecal_cfg.phasecal_num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_RANGE_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->zonecal_cfg.range_config_timeout_us;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_ZONE_NUM_SAMPLES:
-		*ptuning_parm_value =
-		(int32_t)pdev->zonecal_cfg.zone_num_of_samples;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_VCSEL_PERIOD:
-		*ptuning_parm_value =
-		(int32_t)pdev->ssc_cfg.VL53LX_p_005;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_VCSEL_START:
-		*ptuning_parm_value =
-		(int32_t)pdev->ssc_cfg.vcsel_start;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_RATE_LIMIT_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->ssc_cfg.rate_limit_mcps;
-	break;
-	case VL53LX_TUNINGPARM_LITE_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_dss_target_lite_mcps;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_dss_target_histo_mcps;
-	break;
-	case VL53LX_TUNINGPARM_MZ_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_dss_target_histo_mz_mcps;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_dss_target_timed_mcps;
-	break;
-	case VL53LX_TUNINGPARM_LITE_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_lite_us;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_LONG_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_hist_long_us;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_MED_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_hist_med_us;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_SHORT_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_hist_short_us;
-	break;
-	case VL53LX_TUNINGPARM_MZ_LONG_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_mz_long_us;
-	break;
-	case VL53LX_TUNINGPARM_MZ_MED_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_mz_med_us;
-	break;
-	case VL53LX_TUNINGPARM_MZ_SHORT_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_mz_short_us;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_PHASECAL_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_phasecal_timeout_timed_us;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MM_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_mm_timeout_lite_us;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_MM_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_mm_timeout_histo_us;
-	break;
-	case VL53LX_TUNINGPARM_MZ_MM_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_mm_timeout_mz_us;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_MM_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_mm_timeout_timed_us;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RANGE_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_range_timeout_lite_us;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_RANGE_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_range_timeout_histo_us;
-	break;
-	case VL53LX_TUNINGPARM_MZ_RANGE_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_range_timeout_mz_us;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_RANGE_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_range_timeout_timed_us;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_MARGIN:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.smudge_margin;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NOISE_MARGIN:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.noise_margin;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.user_xtalk_offset_limit;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT_HI:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.user_xtalk_offset_limit_hi;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SAMPLE_LIMIT:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.sample_limit;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SINGLE_XTALK_DELTA:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.single_xtalk_delta;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_AVERAGED_XTALK_DELTA:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.averaged_xtalk_delta;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_CLIP_LIMIT:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.smudge_corr_clip_limit;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SCALER_CALC_METHOD:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.scaler_calc_method;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XGRADIENT_SCALER:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.x_gradient_scaler;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_YGRADIENT_SCALER:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.y_gradient_scaler;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_USER_SCALER_SET:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.user_scaler_set;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_COR_SINGLE_APPLY:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.smudge_corr_single_apply;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_AMB_THRESHOLD:
-		*ptuning_parm_value = (int32_t)(
-		pdev->smudge_correct_config.smudge_corr_ambient_threshold);
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_AMB_THRESHOLD_KCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.nodetect_ambient_threshold;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_SAMPLE_LIMIT:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.nodetect_sample_limit;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_XTALK_OFFSET_KCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.nodetect_xtalk_offset;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_MIN_RANGE_MM:
-		*ptuning_parm_value =
-		(int32_t)pdev->smudge_correct_config.nodetect_min_range_mm;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_VHV_LOOP_BOUND:
-		*ptuning_parm_value =
-		(int32_t)pdev->low_power_auto_data.vhv_loop_bound;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_MM_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_mm_timeout_lpa_us;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_RANGE_CONFIG_TIMEOUT_US:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_range_timeout_lpa_us;
-	break;
-	case VL53LX_TUNINGPARM_VERY_SHORT_DSS_RATE_MCPS:
-		*ptuning_parm_value =
-		(int32_t)pdev->tuning_parms.tp_dss_target_very_short_mcps;
-	break;
-	case VL53LX_TUNINGPARM_PHASECAL_PATCH_POWER:
-		*ptuning_parm_value =
-		(int32_t) pdev->tuning_parms.tp_phasecal_patch_power;
-	break;
-	case VL53LX_TUNINGPARM_HIST_MERGE:
-		*ptuning_parm_value =
-		(int32_t) pdev->tuning_parms.tp_hist_merge;
-	break;
-	case VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD:
-		*ptuning_parm_value =
-		(int32_t) pdev->tuning_parms.tp_reset_merge_threshold;
-	break;
-	case VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE:
-		*ptuning_parm_value =
-		(int32_t) pdev->tuning_parms.tp_hist_merge_max_size;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_MAX_SMUDGE_FACTOR:
-		*ptuning_parm_value =
-		pdev->smudge_correct_config.max_smudge_factor;
+	default:
+		*(uint32_t *)pdata = (uint16_t)value;
 	break;
+	}
+}
 
-	case VL53LX_TUNINGPARM_UWR_ENABLE:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_enable;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_1_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_1_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_2_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_2_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_3_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_3_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_4_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_4_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_5_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_z_5_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_1_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_1_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_2_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_2_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_3_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_3_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_4_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_4_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_5_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_med_corr_z_5_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_1_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_1_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_2_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_2_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_3_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_3_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_4_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_4_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MIN:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_5_min;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MAX:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_z_5_max;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_1_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_1_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_2_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_2_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_3_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_3_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_4_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_4_rangeb;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEA:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_5_rangea;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEB:
-		*ptuning_parm_value =
-		pdev->tuning_parms.tp_uwr_lng_corr_z_5_rangeb;
-	break;
 
-	default:
+
+
+static uint8_t VL53LX_tuning_parm_is_uwr(
+	VL53LX_TuningParms             tuning_parm_key)
+{
+	return (tuning_parm_key >= VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MIN &&
+		tuning_parm_key <=
+		VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEB) ? 1 : 0;
+}
+
+
+
+
+static VL53LX_TuningParms VL53LX_tuning_parm_profile_key(
+	const VL53LX_TuningParms      *ptuning_parm_keys,
+	uint16_t                       index)
+{
+	if (ptuning_parm_keys != NULL)
+		return ptuning_parm_keys[index];
+
+	return (VL53LX_TuningParms)
+		(VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS + index);
+}
+
+
+
+
+VL53LX_Error VL53LX_get_tuning_parm(
+	VL53LX_DEV                     Dev,
+	VL53LX_TuningParms             tuning_parm_key,
+	int32_t                       *ptuning_parm_value)
+{
+
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	const VL53LX_tuning_parm_field_t *pfield;
+
+	LOG_FUNCTION_START("");
+
+	pfield = VL53LX_tuning_parm_lookup(tuning_parm_key);
+
+	if (pfield != NULL) {
+		*ptuning_parm_value = VL53LX_tuning_parm_read(pdev, pfield);
+	} else {
 		*ptuning_parm_value = 0x7FFFFFFF;
 		status = VL53LX_ERROR_INVALID_PARAMS;
-	break;
-
 	}
 
 	LOG_FUNCTION_END(status);
@@ -4365,771 +4497,117 @@ VL53LX_Error VL53LX_set_tuning_parm(
 	VL53LX_Error  status = VL53LX_ERROR_NONE;
 
 	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
-	VL53LX_hist_post_process_config_t *pHP = &(pdev->histpostprocess);
-	VL53LX_xtalkextract_config_t *pXC = &(pdev->xtalk_extract_cfg);
+	const VL53LX_tuning_parm_field_t *pfield;
 
 	LOG_FUNCTION_START("");
 
-	switch (tuning_parm_key) {
+	pfield = VL53LX_tuning_parm_lookup(tuning_parm_key);
 
-	case VL53LX_TUNINGPARM_VERSION:
-		pdev->tuning_parms.tp_tuning_parm_version =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_KEY_TABLE_VERSION:
-		pdev->tuning_parms.tp_tuning_parm_key_table_version =
-					(uint16_t)tuning_parm_value;
+	if (pfield != NULL)
+		VL53LX_tuning_parm_write(pdev, pfield, tuning_parm_value);
+	else
+		status = VL53LX_ERROR_INVALID_PARAMS;
 
+	if (VL53LX_tuning_parm_is_uwr(tuning_parm_key))
+		pdev->uwr.tables_stale = 1;
 
+	if (tuning_parm_key == VL53LX_TUNINGPARM_KEY_TABLE_VERSION &&
+		(uint16_t)tuning_parm_value !=
+		VL53LX_TUNINGPARM_KEY_TABLE_VERSION_DEFAULT)
+		status = VL53LX_ERROR_TUNING_PARM_KEY_MISMATCH;
 
-		if ((uint16_t)tuning_parm_value
-			!= VL53LX_TUNINGPARM_KEY_TABLE_VERSION_DEFAULT)
-			status = VL53LX_ERROR_TUNING_PARM_KEY_MISMATCH;
+	LOG_FUNCTION_END(status);
 
-	break;
-	case VL53LX_TUNINGPARM_LLD_VERSION:
-		pdev->tuning_parms.tp_tuning_parm_lld_version =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_ALGO_SELECT:
-		pHP->hist_algo_select =
-				(VL53LX_HistAlgoSelect)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_TARGET_ORDER:
-		pHP->hist_target_order =
-				(VL53LX_HistTargetOrder)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_FILTER_WOI_0:
-		pHP->filter_woi0 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_FILTER_WOI_1:
-		pHP->filter_woi1 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_EST_METHOD:
-		pHP->hist_amb_est_method =
-				(VL53LX_HistAmbEstMethod)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_0:
-		pHP->ambient_thresh_sigma0 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_THRESH_SIGMA_1:
-		pHP->ambient_thresh_sigma1 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_MIN_AMB_THRESH_EVENTS:
-		pHP->min_ambient_thresh_events =
-		(int32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_AMB_EVENTS_SCALER:
-		pHP->ambient_thresh_events_scaler =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_NOISE_THRESHOLD:
-		pHP->noise_threshold =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGNAL_TOTAL_EVENTS_LIMIT:
-		pHP->signal_total_events_limit =
-		(int32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGMA_EST_REF_MM:
-		pHP->sigma_estimator__sigma_ref_mm =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM:
-		pHP->sigma_thresh =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_GAIN_FACTOR:
-		pdev->gain_cal.histogram_ranging_gain_factor =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_PHASE_TOLERANCE:
-		pHP->algo__consistency_check__phase_tolerance =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_MIN_MAX_TOLERANCE_MM:
-		pHP->algo__consistency_check__min_max_tolerance =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA:
-		pHP->algo__consistency_check__event_sigma =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_HIST_EVENT_SIGMA_MIN_SPAD_LIMIT:
-		pHP->algo__consistency_check__event_min_spad_count =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_LONG_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_hist_long =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_MED_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_hist_med =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_HISTO_SHORT_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_hist_short =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_LONG_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_hist_long =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_MED_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_hist_med =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_HISTO_SHORT_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_hist_short =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MIN_VALID_RANGE_MM:
-		pdev->xtalk_cfg.algo__crosstalk_detect_min_valid_range_mm =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RANGE_MM:
-		pdev->xtalk_cfg.algo__crosstalk_detect_max_valid_range_mm =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_SIGMA_MM:
-		pdev->xtalk_cfg.algo__crosstalk_detect_max_sigma_mm =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MIN_MAX_TOLERANCE:
-		pHP->algo__crosstalk_detect_min_max_tolerance =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_MAX_VALID_RATE_KCPS:
-		pdev->xtalk_cfg.algo__crosstalk_detect_max_valid_rate_kcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_DETECT_EVENT_SIGMA:
-		pHP->algo__crosstalk_detect_event_sigma =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_XTALK_MARGIN_KCPS:
-		pdev->xtalk_cfg.histogram_mode_crosstalk_margin_kcps =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_CONSISTENCY_LITE_PHASE_TOLERANCE:
-		pdev->tuning_parms.tp_consistency_lite_phase_tolerance =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_PHASECAL_TARGET:
-		pdev->tuning_parms.tp_phasecal_target =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_CAL_REPEAT_RATE:
-		pdev->tuning_parms.tp_cal_repeat_rate =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RANGING_GAIN_FACTOR:
-		pdev->gain_cal.standard_ranging_gain_factor =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MIN_CLIP_MM:
-		pdev->tuning_parms.tp_lite_min_clip =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_LONG_SIGMA_THRESH_MM:
-		pdev->tuning_parms.tp_lite_long_sigma_thresh_mm =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MED_SIGMA_THRESH_MM:
-		pdev->tuning_parms.tp_lite_med_sigma_thresh_mm =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SHORT_SIGMA_THRESH_MM:
-		pdev->tuning_parms.tp_lite_short_sigma_thresh_mm =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_LONG_MIN_COUNT_RATE_RTN_MCPS:
-		pdev->tuning_parms.tp_lite_long_min_count_rate_rtn_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MED_MIN_COUNT_RATE_RTN_MCPS:
-		pdev->tuning_parms.tp_lite_med_min_count_rate_rtn_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SHORT_MIN_COUNT_RATE_RTN_MCPS:
-		pdev->tuning_parms.tp_lite_short_min_count_rate_rtn_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_EST_PULSE_WIDTH:
-		pdev->tuning_parms.tp_lite_sigma_est_pulse_width_ns =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_EST_AMB_WIDTH_NS:
-		pdev->tuning_parms.tp_lite_sigma_est_amb_width_ns =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SIGMA_REF_MM:
-		pdev->tuning_parms.tp_lite_sigma_ref_mm =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RIT_MULT:
-		pdev->xtalk_cfg.crosstalk_range_ignore_threshold_mult =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_SEED_CONFIG:
-		pdev->tuning_parms.tp_lite_seed_cfg =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_QUANTIFIER:
-		pdev->tuning_parms.tp_lite_quantifier =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_FIRST_ORDER_SELECT:
-		pdev->tuning_parms.tp_lite_first_order_select =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_XTALK_MARGIN_KCPS:
-		pdev->xtalk_cfg.lite_mode_crosstalk_margin_kcps =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_LONG_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_lite_long =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_MED_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_lite_med =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_RTN_LITE_SHORT_RANGE:
-		pdev->tuning_parms.tp_init_phase_rtn_lite_short =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_LONG_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_lite_long =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_MED_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_lite_med =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_INITIAL_PHASE_REF_LITE_SHORT_RANGE:
-		pdev->tuning_parms.tp_init_phase_ref_lite_short =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_SEED_CONFIG:
-		pdev->tuning_parms.tp_timed_seed_cfg =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_SIGNAL_THRESH_SIGMA:
-		pdev->dmax_cfg.signal_thresh_sigma =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_0:
-		pdev->dmax_cfg.target_reflectance_for_dmax_calc[0] =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_1:
-		pdev->dmax_cfg.target_reflectance_for_dmax_calc[1] =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_2:
-		pdev->dmax_cfg.target_reflectance_for_dmax_calc[2] =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_3:
-		pdev->dmax_cfg.target_reflectance_for_dmax_calc[3] =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_4:
-		pdev->dmax_cfg.target_reflectance_for_dmax_calc[4] =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_VHV_LOOPBOUND:
-		pdev->stat_nvm.vhv_config__timeout_macrop_loop_bound =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_DEVICE_TEST_MODE:
-		pdev->refspadchar.device_test_mode =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_VCSEL_PERIOD:
-		pdev->refspadchar.VL53LX_p_005 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_PHASECAL_TIMEOUT_US:
-		pdev->refspadchar.timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_TARGET_COUNT_RATE_MCPS:
-		pdev->refspadchar.target_count_rate_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_MIN_COUNTRATE_LIMIT_MCPS:
-		pdev->refspadchar.min_count_rate_limit_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_REFSPADCHAR_MAX_COUNTRATE_LIMIT_MCPS:
-		pdev->refspadchar.max_count_rate_limit_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_NUM_OF_SAMPLES:
-		pXC->num_of_samples =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MIN_FILTER_THRESH_MM:
-		pXC->algo__crosstalk_extract_min_valid_range_mm =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_FILTER_THRESH_MM:
-		pXC->algo__crosstalk_extract_max_valid_range_mm =
-				(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_RATE_MCPS:
-		pXC->dss_config__target_total_rate_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_PHASECAL_TIMEOUT_US:
-		pXC->phasecal_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_MAX_VALID_RATE_KCPS:
-		 pXC->algo__crosstalk_extract_max_valid_rate_kcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_SIGMA_THRESHOLD_MM:
-		pXC->algo__crosstalk_extract_max_sigma_mm =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_DSS_TIMEOUT_US:
-		pXC->mm_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_XTALK_EXTRACT_BIN_TIMEOUT_US:
-		pXC->range_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_DSS_RATE_MCPS:
-		pdev->offsetcal_cfg.dss_config__target_total_rate_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_PHASECAL_TIMEOUT_US:
-		pdev->offsetcal_cfg.phasecal_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM_TIMEOUT_US:
-		pdev->offsetcal_cfg.mm_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_RANGE_TIMEOUT_US:
-		pdev->offsetcal_cfg.range_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_PRE_SAMPLES:
-		pdev->offsetcal_cfg.pre_num_of_samples =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM1_SAMPLES:
-		pdev->offsetcal_cfg.mm1_num_of_samples =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_OFFSET_CAL_MM2_SAMPLES:
-		pdev->offsetcal_cfg.mm2_num_of_samples =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_DSS_RATE_MCPS:
-		pdev->zonecal_cfg.dss_config__target_total_rate_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_TIMEOUT_US:
-		pdev->zonecal_cfg.phasecal_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_DSS_TIMEOUT_US:
-		pdev->zonecal_cfg.mm_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_PHASECAL_NUM_SAMPLES:
-		pdev->zonecal_cfg.phasecal_num_of_samples =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_RANGE_TIMEOUT_US:
-		pdev->zonecal_cfg.range_config_timeout_us =
-				(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_ZONE_CAL_ZONE_NUM_SAMPLES:
-		pdev->zonecal_cfg.zone_num_of_samples =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_VCSEL_PERIOD:
-		pdev->ssc_cfg.VL53LX_p_005 =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_VCSEL_START:
-		pdev->ssc_cfg.vcsel_start =
-				(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_SPADMAP_RATE_LIMIT_MCPS:
-		pdev->ssc_cfg.rate_limit_mcps =
-				(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		pdev->tuning_parms.tp_dss_target_lite_mcps =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		pdev->tuning_parms.tp_dss_target_histo_mcps =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		pdev->tuning_parms.tp_dss_target_histo_mz_mcps =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_DSS_CONFIG_TARGET_TOTAL_RATE_MCPS:
-		pdev->tuning_parms.tp_dss_target_timed_mcps =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_lite_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_LONG_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_hist_long_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_MED_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_hist_med_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_SHORT_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_hist_short_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_LONG_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_mz_long_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_MED_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_mz_med_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_SHORT_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_mz_short_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_PHASECAL_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_phasecal_timeout_timed_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_MM_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_mm_timeout_lite_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_MM_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_mm_timeout_histo_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_MM_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_mm_timeout_mz_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_MM_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_mm_timeout_timed_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LITE_RANGE_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_range_timeout_lite_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RANGING_RANGE_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_range_timeout_histo_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_MZ_RANGE_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_range_timeout_mz_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_TIMED_RANGE_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_range_timeout_timed_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_MARGIN:
-		pdev->smudge_correct_config.smudge_margin =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NOISE_MARGIN:
-		pdev->smudge_correct_config.noise_margin =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT:
-		pdev->smudge_correct_config.user_xtalk_offset_limit =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_OFFSET_LIMIT_HI:
-		pdev->smudge_correct_config.user_xtalk_offset_limit_hi =
-			(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SAMPLE_LIMIT:
-		pdev->smudge_correct_config.sample_limit =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SINGLE_XTALK_DELTA:
-		pdev->smudge_correct_config.single_xtalk_delta =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_AVERAGED_XTALK_DELTA:
-		pdev->smudge_correct_config.averaged_xtalk_delta =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_CLIP_LIMIT:
-		pdev->smudge_correct_config.smudge_corr_clip_limit =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_SCALER_CALC_METHOD:
-		pdev->smudge_correct_config.scaler_calc_method =
-			(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XGRADIENT_SCALER:
-		pdev->smudge_correct_config.x_gradient_scaler =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_YGRADIENT_SCALER:
-		pdev->smudge_correct_config.y_gradient_scaler =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_USER_SCALER_SET:
-		pdev->smudge_correct_config.user_scaler_set =
-			(uint8_t)tuning_parm_value;
-	break;
+	return status;
+}
 
-	case VL53LX_TUNINGPARM_DYNXTALK_SMUDGE_COR_SINGLE_APPLY:
-		pdev->smudge_correct_config.smudge_corr_single_apply =
-			(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_XTALK_AMB_THRESHOLD:
-		pdev->smudge_correct_config.smudge_corr_ambient_threshold =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_AMB_THRESHOLD_KCPS:
-		pdev->smudge_correct_config.nodetect_ambient_threshold =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_SAMPLE_LIMIT:
-		pdev->smudge_correct_config.nodetect_sample_limit =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_XTALK_OFFSET_KCPS:
-		pdev->smudge_correct_config.nodetect_xtalk_offset =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_NODETECT_MIN_RANGE_MM:
-		pdev->smudge_correct_config.nodetect_min_range_mm =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_VHV_LOOP_BOUND:
-		pdev->low_power_auto_data.vhv_loop_bound =
-			(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_MM_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_mm_timeout_lpa_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_LOWPOWERAUTO_RANGE_CONFIG_TIMEOUT_US:
-		pdev->tuning_parms.tp_range_timeout_lpa_us =
-			(uint32_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_VERY_SHORT_DSS_RATE_MCPS:
-		pdev->tuning_parms.tp_dss_target_very_short_mcps =
-			(uint16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_PHASECAL_PATCH_POWER:
-		pdev->tuning_parms.tp_phasecal_patch_power =
-			(uint16_t) tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_MERGE:
-		pdev->tuning_parms.tp_hist_merge =
-			(uint16_t) tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD:
-		pdev->tuning_parms.tp_reset_merge_threshold =
-			(uint16_t) tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE:
-		pdev->tuning_parms.tp_hist_merge_max_size =
-			(uint16_t) tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_DYNXTALK_MAX_SMUDGE_FACTOR:
-		pdev->smudge_correct_config.max_smudge_factor =
-			(uint32_t)tuning_parm_value;
-	break;
 
-	case VL53LX_TUNINGPARM_UWR_ENABLE:
-		pdev->tuning_parms.tp_uwr_enable =
-			(uint8_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MIN:
-		pdev->tuning_parms.tp_uwr_med_z_1_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MAX:
-		pdev->tuning_parms.tp_uwr_med_z_1_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MIN:
-		pdev->tuning_parms.tp_uwr_med_z_2_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_2_MAX:
-		pdev->tuning_parms.tp_uwr_med_z_2_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MIN:
-		pdev->tuning_parms.tp_uwr_med_z_3_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MAX:
-		pdev->tuning_parms.tp_uwr_med_z_3_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MIN:
-		pdev->tuning_parms.tp_uwr_med_z_4_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_4_MAX:
-		pdev->tuning_parms.tp_uwr_med_z_4_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MIN:
-		pdev->tuning_parms.tp_uwr_med_z_5_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_5_MAX:
-		pdev->tuning_parms.tp_uwr_med_z_5_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEA:
-		pdev->tuning_parms.tp_uwr_med_corr_z_1_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_1_RANGEB:
-		pdev->tuning_parms.tp_uwr_med_corr_z_1_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEA:
-		pdev->tuning_parms.tp_uwr_med_corr_z_2_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_2_RANGEB:
-		pdev->tuning_parms.tp_uwr_med_corr_z_2_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEA:
-		pdev->tuning_parms.tp_uwr_med_corr_z_3_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_3_RANGEB:
-		pdev->tuning_parms.tp_uwr_med_corr_z_3_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEA:
-		pdev->tuning_parms.tp_uwr_med_corr_z_4_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_4_RANGEB:
-		pdev->tuning_parms.tp_uwr_med_corr_z_4_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEA:
-		pdev->tuning_parms.tp_uwr_med_corr_z_5_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_MEDIUM_CORRECTION_ZONE_5_RANGEB:
-		pdev->tuning_parms.tp_uwr_med_corr_z_5_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MIN:
-		pdev->tuning_parms.tp_uwr_lng_z_1_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_1_MAX:
-		pdev->tuning_parms.tp_uwr_lng_z_1_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MIN:
-		pdev->tuning_parms.tp_uwr_lng_z_2_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_2_MAX:
-		pdev->tuning_parms.tp_uwr_lng_z_2_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MIN:
-		pdev->tuning_parms.tp_uwr_lng_z_3_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MAX:
-		pdev->tuning_parms.tp_uwr_lng_z_3_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MIN:
-		pdev->tuning_parms.tp_uwr_lng_z_4_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_4_MAX:
-		pdev->tuning_parms.tp_uwr_lng_z_4_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MIN:
-		pdev->tuning_parms.tp_uwr_lng_z_5_min =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_ZONE_5_MAX:
-		pdev->tuning_parms.tp_uwr_lng_z_5_max =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEA:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_1_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_1_RANGEB:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_1_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEA:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_2_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_2_RANGEB:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_2_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEA:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_3_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_3_RANGEB:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_3_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEA:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_4_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_4_RANGEB:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_4_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEA:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_5_rangea =
-			(int16_t)tuning_parm_value;
-	break;
-	case VL53LX_TUNINGPARM_UWR_LONG_CORRECTION_ZONE_5_RANGEB:
-		pdev->tuning_parms.tp_uwr_lng_corr_z_5_rangeb =
-			(int16_t)tuning_parm_value;
-	break;
 
-	default:
+
+VL53LX_Error VL53LX_get_tuning_parm_profile(
+	VL53LX_DEV                     Dev,
+	const VL53LX_TuningParms      *ptuning_parm_keys,
+	int32_t                       *ptuning_parm_values,
+	uint16_t                       count)
+{
+
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	const VL53LX_tuning_parm_field_t *pfield;
+	uint16_t i;
+
+	LOG_FUNCTION_START("");
+
+	if (ptuning_parm_values == NULL)
 		status = VL53LX_ERROR_INVALID_PARAMS;
-	break;
 
+	for (i = 0; status == VL53LX_ERROR_NONE && i < count; i++) {
+		pfield = VL53LX_tuning_parm_lookup(
+			VL53LX_tuning_parm_profile_key(ptuning_parm_keys, i));
+
+		if (pfield != NULL)
+			ptuning_parm_values[i] =
+				VL53LX_tuning_parm_read(pdev, pfield);
+		else
+			status = VL53LX_ERROR_INVALID_PARAMS;
+	}
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+
+
+VL53LX_Error VL53LX_set_tuning_parm_profile(
+	VL53LX_DEV                     Dev,
+	const VL53LX_TuningParms      *ptuning_parm_keys,
+	const int32_t                 *ptuning_parm_values,
+	uint16_t                       count)
+{
+
+
+
+	VL53LX_Error  status = VL53LX_ERROR_NONE;
+
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	VL53LX_TuningParms key;
+	uint16_t i;
+
+	LOG_FUNCTION_START("");
+
+	if (ptuning_parm_values == NULL)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+
+
+	for (i = 0; status == VL53LX_ERROR_NONE && i < count; i++) {
+		key = VL53LX_tuning_parm_profile_key(ptuning_parm_keys, i);
+		if (VL53LX_tuning_parm_lookup(key) == NULL)
+			status = VL53LX_ERROR_INVALID_PARAMS;
+	}
+
+	if (status != VL53LX_ERROR_NONE)
+		count = 0;
+
+	for (i = 0; i < count; i++) {
+		key = VL53LX_tuning_parm_profile_key(ptuning_parm_keys, i);
+
+		VL53LX_tuning_parm_write(pdev,
+			VL53LX_tuning_parm_lookup(key),
+			ptuning_parm_values[i]);
+
+		if (VL53LX_tuning_parm_is_uwr(key))
+			pdev->uwr.tables_stale = 1;
+
+		if (key == VL53LX_TUNINGPARM_KEY_TABLE_VERSION &&
+			(uint16_t)ptuning_parm_values[i] !=
+			VL53LX_TUNINGPARM_KEY_TABLE_VERSION_DEFAULT)
+			status = VL53LX_ERROR_TUNING_PARM_KEY_MISMATCH;
 	}
 
 	LOG_FUNCTION_END(status);
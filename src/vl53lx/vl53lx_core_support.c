@@ -162,6 +162,28 @@ uint32_t VL53LX_isqrt(uint32_t num)
 }
 
 
+
+uint32_t VL53LX_crc32(
+	uint32_t        crc,
+	const uint8_t  *pdata,
+	uint32_t        size)
+{
+
+
+
+	uint8_t  i;
+
+	crc = ~crc;
+	while (size--) {
+		crc ^= *pdata++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+	}
+
+	return ~crc;
+}
+
+
 void  VL53LX_hist_calc_zero_distance_phase(
 	VL53LX_histogram_bin_data_t   *pdata)
 {
@@ -57,6 +57,38 @@ VL53LX_Error VL53LX_f_001(
 
 	VL53LX_Error status  = VL53LX_ERROR_NONE;
 
+	LOG_FUNCTION_START("");
+
+	VL53LX_dmax_calc_ambient_terms(
+		pcal,
+		pcfg,
+		pbins,
+		pdata);
+
+	*pambient_dmax_mm =
+		VL53LX_dmax_calc_reflectance(
+			target_reflectance,
+			pcal,
+			pcfg,
+			pbins,
+			pdata);
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+
+}
+
+
+void VL53LX_dmax_calc_ambient_terms(
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata)
+{
+
+
+
 	uint32_t    pll_period_us       = 0;
 	uint32_t    periods_elapsed     = 0;
 
@@ -65,8 +97,6 @@ VL53LX_Error VL53LX_f_001(
 
 	uint32_t    amb_thres_delta     = 0;
 
-	LOG_FUNCTION_START("");
-
 
 
 	pdata->VL53LX_p_004     = 0x0000;
@@ -77,8 +107,7 @@ VL53LX_Error VL53LX_f_001(
 	pdata->VL53LX_p_035 = 0x0000;
 	pdata->VL53LX_p_036             = 0;
 	pdata->VL53LX_p_022            = 0;
-
-	*pambient_dmax_mm  = 0;
+	pdata->ambient_thresh_events    = 0;
 
 
 	if ((pbins->VL53LX_p_015        != 0) &&
@@ -173,6 +202,55 @@ VL53LX_Error VL53LX_f_001(
 
 
 
+		tmp32  = VL53LX_isqrt(pdata->VL53LX_p_028 << 8);
+		tmp32 *= (uint32_t)pcfg->ambient_thresh_sigma;
+
+
+
+		if (pdata->VL53LX_p_028 <
+			(uint32_t)pcfg->min_ambient_thresh_events) {
+
+			amb_thres_delta =
+				pcfg->min_ambient_thresh_events -
+				(uint32_t)pdata->VL53LX_p_028;
+
+
+			amb_thres_delta <<= 8;
+
+			if (tmp32 < amb_thres_delta)
+				tmp32 = amb_thres_delta;
+		}
+
+		pdata->ambient_thresh_events = tmp32;
+
+	}
+
+}
+
+
+int16_t VL53LX_dmax_calc_reflectance(
+	uint16_t                              target_reflectance,
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata)
+{
+
+
+
+	uint32_t    tmp32               = 0;
+	uint64_t    tmp64               = 0;
+
+	int16_t     ambient_dmax_mm     = 0;
+
+
+	if ((pcal->ref__actual_effective_spads != 0) &&
+		(pbins->VL53LX_p_015        != 0) &&
+		(pcal->ref_reflectance_pc          != 0) &&
+		(pbins->total_periods_elapsed      != 0)) {
+
+
+
 		tmp64   = (uint64_t)pdata->VL53LX_p_037;
 		tmp64  *= (uint64_t)pdata->VL53LX_p_009;
 		tmp64  *= (uint64_t)pdata->VL53LX_p_004;
@@ -199,30 +277,9 @@ VL53LX_Error VL53LX_f_001(
 
 
 
-		tmp32  = VL53LX_isqrt(pdata->VL53LX_p_028 << 8);
-		tmp32 *= (uint32_t)pcfg->ambient_thresh_sigma;
-
-
-
-		if (pdata->VL53LX_p_028 <
-			(uint32_t)pcfg->min_ambient_thresh_events) {
-
-			amb_thres_delta =
-				pcfg->min_ambient_thresh_events -
-				(uint32_t)pdata->VL53LX_p_028;
-
-
-			amb_thres_delta <<= 8;
-
-			if (tmp32 < amb_thres_delta)
-				tmp32 = amb_thres_delta;
-		}
-
-
-
 		pdata->VL53LX_p_022 =
 			(int16_t)VL53LX_f_002(
-				tmp32,
+				pdata->ambient_thresh_events,
 				pdata->VL53LX_p_035,
 				(uint32_t)pcal->ref__distance_mm,
 				(uint32_t)pcfg->signal_thresh_sigma);
@@ -245,12 +302,182 @@ VL53LX_Error VL53LX_f_001(
 
 
 		if (pdata->VL53LX_p_036 < pdata->VL53LX_p_022)
-			*pambient_dmax_mm = pdata->VL53LX_p_036;
+			ambient_dmax_mm = pdata->VL53LX_p_036;
 		else
-			*pambient_dmax_mm = pdata->VL53LX_p_022;
+			ambient_dmax_mm = pdata->VL53LX_p_022;
+
+	}
+
+	return ambient_dmax_mm;
+
+}
+
+
+static uint8_t VL53LX_dmax_cache_inputs_match(
+	VL53LX_dmax_cache_entry_t            *pentry,
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins)
+{
+
+
+
+	uint8_t  p = 0;
+
+	if (pentry->VL53LX_p_015 != pbins->VL53LX_p_015 ||
+		pentry->VL53LX_p_005 != pbins->VL53LX_p_005 ||
+		pentry->vcsel_width != pbins->vcsel_width ||
+		pentry->total_periods_elapsed !=
+			pbins->total_periods_elapsed ||
+		pentry->effective_spads !=
+			pbins->result__dss_actual_effective_spads)
+		return 0;
+
+
+
+	if (pentry->cal.ref__actual_effective_spads !=
+			pcal->ref__actual_effective_spads ||
+		pentry->cal.ref__peak_signal_count_rate_mcps !=
+			pcal->ref__peak_signal_count_rate_mcps ||
+		pentry->cal.ref__distance_mm != pcal->ref__distance_mm ||
+		pentry->cal.ref_reflectance_pc != pcal->ref_reflectance_pc ||
+		pentry->cal.coverglass_transmission !=
+			pcal->coverglass_transmission)
+		return 0;
+
+
+
+	if (pentry->cfg.signal_thresh_sigma != pcfg->signal_thresh_sigma ||
+		pentry->cfg.ambient_thresh_sigma !=
+			pcfg->ambient_thresh_sigma ||
+		pentry->cfg.min_ambient_thresh_events !=
+			pcfg->min_ambient_thresh_events ||
+		pentry->cfg.signal_total_events_limit !=
+			pcfg->signal_total_events_limit ||
+		pentry->cfg.max_effective_spads != pcfg->max_effective_spads ||
+		pentry->cfg.dss_config__target_total_rate_mcps !=
+			pcfg->dss_config__target_total_rate_mcps ||
+		pentry->cfg.dss_config__aperture_attenuation !=
+			pcfg->dss_config__aperture_attenuation)
+		return 0;
+
+	for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++)
+		if (pentry->cfg.target_reflectance_for_dmax_calc[p] !=
+			pcfg->target_reflectance_for_dmax_calc[p])
+			return 0;
+
+	return 1;
+}
+
+
+VL53LX_Error VL53LX_dmax_calc_cached(
+	VL53LX_dmax_cache_t                  *pcache,
+	VL53LX_dmax_calibration_data_t	     *pcal,
+	VL53LX_hist_gen3_dmax_config_t	     *pcfg,
+	VL53LX_histogram_bin_data_t          *pbins,
+	VL53LX_hist_gen3_dmax_private_data_t *pdata,
+	int16_t                              *pambient_dmax_mm)
+{
+
+
+
+	VL53LX_Error status  = VL53LX_ERROR_NONE;
 
+	VL53LX_dmax_cache_entry_t *pentry = NULL;
+
+	uint32_t    ambient_key         = 0;
+	uint8_t     e                   = 0;
+	uint8_t     p                   = 0;
+
+	LOG_FUNCTION_START("");
+
+
+
+	VL53LX_dmax_calc_ambient_terms(
+		pcal,
+		pcfg,
+		pbins,
+		pdata);
+
+
+
+	if (pcache->cache_enable > 0) {
+
+		ambient_key =
+			(uint32_t)pbins->VL53LX_p_028 >>
+			pcache->ambient_quant_shift;
+
+		for (e = 0; e < VL53LX_DMAX_CACHE_ENTRIES; e++) {
+			if (pcache->entry[e].valid > 0 &&
+				pcache->entry[e].ambient_key == ambient_key &&
+				pcache->entry[e].reflectance_mask ==
+					pcache->reflectance_mask &&
+				VL53LX_dmax_cache_inputs_match(
+					&(pcache->entry[e]), pcal, pcfg, pbins))
+				pentry = &(pcache->entry[e]);
+		}
+
+		if (pentry != NULL &&
+			pentry->age < pcache->refresh_period) {
+
+			for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++)
+				pambient_dmax_mm[p] =
+					pentry->ambient_dmax_mm[p];
+
+			pentry->age++;
+			pcache->hit_count++;
+
+			goto ENDFUNC;
+		}
+
+		pcache->miss_count++;
 	}
 
+
+
+	for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
+		if ((pcache->reflectance_mask & (1 << p)) == 0)
+			continue;
+
+		pambient_dmax_mm[p] =
+			VL53LX_dmax_calc_reflectance(
+				pcfg->target_reflectance_for_dmax_calc[p],
+				pcal,
+				pcfg,
+				pbins,
+				pdata);
+	}
+
+
+
+	if (pcache->cache_enable > 0) {
+
+		if (pentry == NULL) {
+			pentry = &(pcache->entry[pcache->next_entry]);
+			pcache->next_entry++;
+			if (pcache->next_entry >= VL53LX_DMAX_CACHE_ENTRIES)
+				pcache->next_entry = 0;
+		}
+
+		pentry->valid            = 1;
+		pentry->VL53LX_p_015     = pbins->VL53LX_p_015;
+		pentry->VL53LX_p_005     = pbins->VL53LX_p_005;
+		pentry->vcsel_width      = pbins->vcsel_width;
+		pentry->total_periods_elapsed = pbins->total_periods_elapsed;
+		pentry->effective_spads  =
+			pbins->result__dss_actual_effective_spads;
+		pentry->cal              = *pcal;
+		pentry->cfg              = *pcfg;
+		pentry->ambient_key      = ambient_key;
+		pentry->reflectance_mask = pcache->reflectance_mask;
+		pentry->age              = 0;
+
+		for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++)
+			pentry->ambient_dmax_mm[p] = pambient_dmax_mm[p];
+	}
+
+ENDFUNC:
+
 	LOG_FUNCTION_END(status);
 
 	return status;
@@ -258,6 +485,22 @@ VL53LX_Error VL53LX_f_001(
 }
 
 
+void VL53LX_dmax_cache_invalidate(
+	VL53LX_dmax_cache_t                  *pcache)
+{
+
+
+
+	uint8_t  e = 0;
+
+	for (e = 0; e < VL53LX_DMAX_CACHE_ENTRIES; e++)
+		pcache->entry[e].valid = 0;
+
+	pcache->next_entry = 0;
+
+}
+
+
 uint32_t VL53LX_f_002(
 	uint32_t     events_threshold,
 	uint32_t     ref_signal_events,
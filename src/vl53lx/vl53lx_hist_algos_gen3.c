@@ -75,10 +75,6 @@ void VL53LX_f_003(
 
 
 
-	VL53LX_init_histogram_bin_data_struct(
-		0,
-		VL53LX_HISTOGRAM_BUFFER_SIZE,
-		&(palgo->VL53LX_p_006));
 	VL53LX_init_histogram_bin_data_struct(
 		0,
 		VL53LX_HISTOGRAM_BUFFER_SIZE,
@@ -201,6 +197,188 @@ VL53LX_Error VL53LX_f_006(
 
 
 
+static uint8_t VL53LX_hist_gate_walk(
+	VL53LX_hist_gen3_algo_private_data_t  *palgo,
+	uint8_t                                start,
+	int32_t                                min_bin,
+	int32_t                                span,
+	uint8_t                                clear,
+	uint8_t                               *ppulses)
+{
+
+
+
+	uint8_t  period    = palgo->VL53LX_p_030;
+	uint8_t  k         = 0;
+	uint8_t  b         = 0;
+	uint8_t  run_start = 0;
+	uint8_t  run_len   = 0;
+	uint8_t  in_window = 0;
+	uint8_t  kept      = 0;
+	uint8_t  flag      = 0;
+	int32_t  offset    = 0;
+
+	*ppulses = 0;
+
+	for (k = 1; k <= period; k++) {
+
+		b = (start + k) % period;
+		flag = (b < palgo->VL53LX_p_021) ? palgo->VL53LX_p_041[b] : 0;
+
+		if (flag > 0) {
+			if (run_len == 0) {
+				run_start = b;
+				in_window = 0;
+			}
+			run_len++;
+
+			offset = ((int32_t)b - min_bin) % (int32_t)period;
+			if (offset < 0)
+				offset += (int32_t)period;
+			if (offset <= span)
+				in_window = 1;
+
+		} else if (run_len > 0) {
+
+			(*ppulses)++;
+
+			if (in_window > 0) {
+				kept++;
+			} else if (clear > 0) {
+				while (run_len > 0) {
+					palgo->VL53LX_p_041[run_start] = 0;
+					palgo->VL53LX_p_039--;
+					run_start = (run_start + 1) % period;
+					run_len--;
+				}
+			}
+			run_len = 0;
+		}
+	}
+
+	return kept;
+}
+
+
+VL53LX_Error VL53LX_hist_gate_pulses(
+	VL53LX_hist_gate_t                    *pgate,
+	uint16_t                               gain_factor,
+	int16_t                                range_offset_mm,
+	VL53LX_histogram_bin_data_t           *pbins,
+	VL53LX_hist_gen3_algo_private_data_t  *palgo)
+{
+
+
+
+	VL53LX_Error  status  = VL53LX_ERROR_NONE;
+
+	uint32_t  pll_period_mm = 0;
+	int64_t   tmp           = 0;
+	int32_t   min_bin       = 0;
+	int32_t   max_bin       = 0;
+	int32_t   gain          = (int32_t)gain_factor;
+	uint8_t   period        = palgo->VL53LX_p_030;
+	uint8_t   start         = 0;
+	uint8_t   found         = 0;
+	uint8_t   pulses        = 0;
+	uint8_t   kept          = 0;
+	uint8_t   i             = 0;
+
+	LOG_FUNCTION_START("");
+
+	if (period == 0 || pbins->VL53LX_p_015 == 0)
+		goto ENDFUNC;
+
+	pll_period_mm = VL53LX_calc_pll_period_mm(pbins->VL53LX_p_015);
+	if (pll_period_mm == 0)
+		goto ENDFUNC;
+
+	if (gain == 0)
+		gain = 0x0800;
+
+
+
+	tmp = ((int64_t)pgate->min_range_mm * 4 * 0x0800) / gain;
+	tmp = (tmp - range_offset_mm) * 2048 * 4 / (int64_t)pll_period_mm;
+	tmp += (int64_t)pbins->zero_distance_phase;
+	min_bin = (tmp < 0) ? 0 : (int32_t)(tmp / 2048);
+
+	tmp = ((int64_t)pgate->max_range_mm * 4 * 0x0800) / gain;
+	tmp = (tmp - range_offset_mm) * 2048 * 4 / (int64_t)pll_period_mm;
+	tmp += (int64_t)pbins->zero_distance_phase;
+	max_bin = (tmp < 0) ? 0 : (int32_t)(tmp / 2048);
+
+	min_bin -= (int32_t)pgate->margin_bins;
+	max_bin += (int32_t)pgate->margin_bins;
+	if (min_bin < 0)
+		min_bin = 0;
+
+
+
+	if ((max_bin - min_bin) >= ((int32_t)period - 1))
+		goto ENDFUNC;
+
+
+
+	for (i = 0; i < period && found == 0; i++) {
+		if (i >= palgo->VL53LX_p_021 || palgo->VL53LX_p_041[i] == 0) {
+			start = i;
+			found = 1;
+		}
+	}
+
+	if (found == 0)
+		goto ENDFUNC;
+
+	pgate->pass_count++;
+
+	kept = VL53LX_hist_gate_walk(
+			palgo, start, min_bin, max_bin - min_bin, 0, &pulses);
+
+	pgate->pulses_found += pulses;
+
+
+
+	if (kept == 0) {
+		if (pulses > 0)
+			pgate->fallback_count++;
+		goto ENDFUNC;
+	}
+
+	if (kept < pulses) {
+		pgate->pulses_skipped += (uint32_t)(pulses - kept);
+		VL53LX_hist_gate_walk(
+			palgo, start, min_bin, max_bin - min_bin, 1, &pulses);
+	}
+
+ENDFUNC:
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+uint8_t VL53LX_hist_gate_restore(
+	VL53LX_hist_gen3_algo_private_data_t  *palgo)
+{
+
+
+
+	uint8_t  restored = 0;
+	uint8_t  lb       = 0;
+
+	for (lb = palgo->VL53LX_p_019; lb < palgo->VL53LX_p_020; lb++) {
+		if (palgo->VL53LX_p_041[lb] != palgo->VL53LX_p_040[lb]) {
+			palgo->VL53LX_p_041[lb] = palgo->VL53LX_p_040[lb];
+			palgo->VL53LX_p_039++;
+			restored++;
+		}
+	}
+
+	return restored;
+}
+
+
 VL53LX_Error VL53LX_f_007(
 	VL53LX_hist_gen3_algo_private_data_t  *palgo)
 {
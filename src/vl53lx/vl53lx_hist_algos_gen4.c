@@ -48,15 +48,10 @@
 	level, VL53LX_TRACE_FUNCTION_NONE, ##__VA_ARGS__)
 
 
-VL53LX_Error VL53LX_f_025(
-	VL53LX_dmax_calibration_data_t         *pdmax_cal,
-	VL53LX_hist_gen3_dmax_config_t         *pdmax_cfg,
+static VL53LX_Error VL53LX_hist_find_targets(
 	VL53LX_hist_post_process_config_t      *ppost_cfg,
-	VL53LX_histogram_bin_data_t            *pbins_input,
-	VL53LX_histogram_bin_data_t            *pxtalk,
 	VL53LX_hist_gen3_algo_private_data_t   *palgo3,
 	VL53LX_hist_gen4_algo_filtered_data_t  *pfiltered,
-	VL53LX_hist_gen3_dmax_private_data_t   *pdmax_algo,
 	VL53LX_range_results_t                 *presults,
 	uint8_t                                histo_merge_nb)
 {
@@ -70,92 +65,10 @@ VL53LX_Error VL53LX_f_025(
 	uint8_t                       p = 0;
 	VL53LX_histogram_bin_data_t *pB = &(palgo3->VL53LX_p_006);
 
-	LOG_FUNCTION_START("");
-
-
-
-
-
-	VL53LX_f_003(palgo3);
-
-
-
-	memcpy(
-		&(palgo3->VL53LX_p_006),
-		pbins_input,
-		sizeof(VL53LX_histogram_bin_data_t));
-
-
-
-	presults->cfg_device_state = pbins_input->cfg_device_state;
-	presults->rd_device_state  = pbins_input->rd_device_state;
-	presults->zone_id          = pbins_input->zone_id;
-	presults->stream_count     = pbins_input->result__stream_count;
-	presults->wrap_dmax_mm     = 0;
-	presults->max_results      = VL53LX_MAX_RANGE_RESULTS;
-	presults->active_results   = 0;
-
-	for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++)
-		presults->VL53LX_p_022[p] = 0;
-
-
-
-	VL53LX_hist_calc_zero_distance_phase(&(palgo3->VL53LX_p_006));
-
-
-
-	VL53LX_hist_estimate_ambient_from_thresholded_bins(
-		(int32_t)ppost_cfg->ambient_thresh_sigma0,
-		&(palgo3->VL53LX_p_006));
-
-	VL53LX_hist_estimate_ambient_from_ambient_bins(
-			&(palgo3->VL53LX_p_006));
-
-
-	VL53LX_hist_remove_ambient_bins(&(palgo3->VL53LX_p_006));
-
-
-	if (ppost_cfg->algo__crosstalk_compensation_enable > 0)
-		VL53LX_f_005(
-				pxtalk,
-				&(palgo3->VL53LX_p_006),
-				&(palgo3->VL53LX_p_047));
-
-
-	pdmax_cfg->ambient_thresh_sigma =
-		ppost_cfg->ambient_thresh_sigma1;
-
-	for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
-		if (status == VL53LX_ERROR_NONE) {
-			status =
-			VL53LX_f_001(
-				pdmax_cfg->target_reflectance_for_dmax_calc[p],
-				pdmax_cal,
-				pdmax_cfg,
-				&(palgo3->VL53LX_p_006),
-				pdmax_algo,
-				&(presults->VL53LX_p_022[p]));
-		}
-	}
-
-
-
-
-
-	if (status == VL53LX_ERROR_NONE)
-		status =
-			VL53LX_f_006(
-			ppost_cfg->ambient_thresh_events_scaler,
-			(int32_t)pdmax_cfg->ambient_thresh_sigma,
-			(int32_t)ppost_cfg->min_ambient_thresh_events,
-			ppost_cfg->algo__crosstalk_compensation_enable,
-			&(palgo3->VL53LX_p_006),
-			&(palgo3->VL53LX_p_047),
-			palgo3);
-
-
 
 
+	palgo3->VL53LX_p_046     = 0;
+	presults->active_results = 0;
 
 	if (status == VL53LX_ERROR_NONE)
 		status =
@@ -329,6 +242,197 @@ VL53LX_Error VL53LX_f_025(
 
 
 
+	return status;
+}
+
+
+
+
+static uint8_t VL53LX_hist_valid_targets(
+	VL53LX_range_results_t                 *presults)
+{
+
+
+	uint8_t  valid = 0;
+	uint8_t  i     = 0;
+
+	for (i = 0; i < presults->active_results; i++)
+		if (presults->VL53LX_p_003[i].range_status ==
+			VL53LX_DEVICEERROR_RANGECOMPLETE_NO_WRAP_CHECK)
+			valid++;
+
+	return valid;
+}
+
+
+
+
+VL53LX_Error VL53LX_f_025(
+	VL53LX_dmax_calibration_data_t         *pdmax_cal,
+	VL53LX_hist_gen3_dmax_config_t         *pdmax_cfg,
+	VL53LX_hist_post_process_config_t      *ppost_cfg,
+	VL53LX_histogram_bin_data_t            *pbins_input,
+	VL53LX_histogram_bin_data_t            *pxtalk,
+	VL53LX_hist_gen3_algo_private_data_t   *palgo3,
+	VL53LX_hist_gen4_algo_filtered_data_t  *pfiltered,
+	VL53LX_hist_gen3_dmax_private_data_t   *pdmax_algo,
+	VL53LX_dmax_cache_t                    *pdmax_cache,
+	VL53LX_hist_gate_t                     *phist_gate,
+	VL53LX_range_results_t                 *presults,
+	uint8_t                                histo_merge_nb)
+{
+
+
+	VL53LX_Error  status  = VL53LX_ERROR_NONE;
+
+	uint8_t                       p = 0;
+
+	LOG_FUNCTION_START("");
+
+
+
+
+
+	VL53LX_f_003(palgo3);
+
+
+
+	if (pbins_input != &(palgo3->VL53LX_p_006))
+		memcpy(
+			&(palgo3->VL53LX_p_006),
+			pbins_input,
+			sizeof(VL53LX_histogram_bin_data_t));
+
+
+
+	presults->cfg_device_state = pbins_input->cfg_device_state;
+	presults->rd_device_state  = pbins_input->rd_device_state;
+	presults->zone_id          = pbins_input->zone_id;
+	presults->stream_count     = pbins_input->result__stream_count;
+	presults->wrap_dmax_mm     = 0;
+	presults->max_results      = VL53LX_MAX_RANGE_RESULTS;
+	presults->active_results   = 0;
+
+	for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++)
+		presults->VL53LX_p_022[p] = 0;
+
+
+
+	VL53LX_hist_calc_zero_distance_phase(&(palgo3->VL53LX_p_006));
+
+
+
+	VL53LX_hist_estimate_ambient_from_thresholded_bins(
+		(int32_t)ppost_cfg->ambient_thresh_sigma0,
+		&(palgo3->VL53LX_p_006));
+
+	VL53LX_hist_estimate_ambient_from_ambient_bins(
+			&(palgo3->VL53LX_p_006));
+
+
+	VL53LX_hist_remove_ambient_bins(&(palgo3->VL53LX_p_006));
+
+
+	if (ppost_cfg->algo__crosstalk_compensation_enable > 0)
+		VL53LX_f_005(
+				pxtalk,
+				&(palgo3->VL53LX_p_006),
+				&(palgo3->VL53LX_p_047));
+
+
+	pdmax_cfg->ambient_thresh_sigma =
+		ppost_cfg->ambient_thresh_sigma1;
+
+	if (pdmax_cache != NULL) {
+		status =
+			VL53LX_dmax_calc_cached(
+				pdmax_cache,
+				pdmax_cal,
+				pdmax_cfg,
+				&(palgo3->VL53LX_p_006),
+				pdmax_algo,
+				&(presults->VL53LX_p_022[0]));
+	} else {
+		for (p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
+			if (status == VL53LX_ERROR_NONE) {
+				status =
+				VL53LX_f_001(
+				pdmax_cfg->target_reflectance_for_dmax_calc[p],
+				pdmax_cal,
+				pdmax_cfg,
+				&(palgo3->VL53LX_p_006),
+				pdmax_algo,
+				&(presults->VL53LX_p_022[p]));
+			}
+		}
+	}
+
+
+
+
+
+	if (status == VL53LX_ERROR_NONE)
+		status =
+			VL53LX_f_006(
+			ppost_cfg->ambient_thresh_events_scaler,
+			(int32_t)pdmax_cfg->ambient_thresh_sigma,
+			(int32_t)ppost_cfg->min_ambient_thresh_events,
+			ppost_cfg->algo__crosstalk_compensation_enable,
+			&(palgo3->VL53LX_p_006),
+			&(palgo3->VL53LX_p_047),
+			palgo3);
+
+
+
+
+
+	if (status == VL53LX_ERROR_NONE &&
+		phist_gate != NULL && phist_gate->gate_enable > 0)
+		status =
+			VL53LX_hist_gate_pulses(
+				phist_gate,
+				ppost_cfg->gain_factor,
+				ppost_cfg->range_offset_mm,
+				&(palgo3->VL53LX_p_006),
+				palgo3);
+
+
+
+	if (status == VL53LX_ERROR_NONE)
+		status =
+			VL53LX_hist_find_targets(
+				ppost_cfg,
+				palgo3,
+				pfiltered,
+				presults,
+				histo_merge_nb);
+
+
+
+	if (phist_gate != NULL && phist_gate->gate_enable > 0) {
+
+		phist_gate->pulses_characterised += palgo3->VL53LX_p_046;
+
+		if (status == VL53LX_ERROR_NONE &&
+			VL53LX_hist_valid_targets(presults) == 0 &&
+			VL53LX_hist_gate_restore(palgo3) > 0) {
+
+			phist_gate->rerun_count++;
+			status =
+				VL53LX_hist_find_targets(
+					ppost_cfg,
+					palgo3,
+					pfiltered,
+					presults,
+					histo_merge_nb);
+			phist_gate->pulses_characterised +=
+				palgo3->VL53LX_p_046;
+		}
+	}
+
+
+
+
 	LOG_FUNCTION_END(status);
 
 	return status;
@@ -61,6 +61,9 @@ VL53LX_Error VL53LX_hist_process_data(
 	VL53LX_hist_post_process_config_t  *ppost_cfg,
 	VL53LX_histogram_bin_data_t        *pbins_input,
 	VL53LX_xtalk_histogram_data_t      *pxtalk_shape,
+	VL53LX_dmax_cache_t                *pdmax_cache,
+	VL53LX_hist_gate_t                 *phist_gate,
+	VL53LX_hist_gen3_dmax_private_data_t *pdmax_algo_gen3,
 	uint8_t                            *pArea1,
 	uint8_t                            *pArea2,
 	VL53LX_range_results_t             *presults,
@@ -76,12 +79,8 @@ VL53LX_Error VL53LX_hist_process_data(
 	VL53LX_hist_gen4_algo_filtered_data_t *pfiltered4 =
 			(VL53LX_hist_gen4_algo_filtered_data_t *) pArea2;
 
-	VL53LX_hist_gen3_dmax_private_data_t   dmax_algo_gen3;
-	VL53LX_hist_gen3_dmax_private_data_t  *pdmax_algo_gen3 =
-						&dmax_algo_gen3;
-
-	VL53LX_histogram_bin_data_t             bins_averaged;
-	VL53LX_histogram_bin_data_t           *pbins_averaged = &bins_averaged;
+	VL53LX_histogram_bin_data_t           *pworking =
+					&(palgo_gen3->VL53LX_p_006);
 
 	VL53LX_range_data_t                   *pdata;
 
@@ -100,22 +99,17 @@ VL53LX_Error VL53LX_hist_process_data(
 
 
 
-	VL53LX_f_031(
-			pbins_input,
-			pbins_averaged);
-
+	if (ppost_cfg->algo__crosstalk_compensation_enable > 0) {
 
-
-	VL53LX_init_histogram_bin_data_struct(
+		VL53LX_init_histogram_bin_data_struct(
 			0,
 			pxtalk_shape->xtalk_shape.VL53LX_p_021,
 			&(pxtalk_shape->xtalk_hist_removed));
 
-
-
-	VL53LX_copy_xtalk_bin_data_to_histogram_data_struct(
+		VL53LX_copy_xtalk_bin_data_to_histogram_data_struct(
 			&(pxtalk_shape->xtalk_shape),
 			&(pxtalk_shape->xtalk_hist_removed));
+	}
 
 
 
@@ -139,7 +133,7 @@ VL53LX_Error VL53LX_hist_process_data(
 		(ppost_cfg->algo__crosstalk_compensation_enable > 0))
 		status =
 			VL53LX_f_033(
-			  pbins_averaged,
+			  pbins_input,
 			  &(pxtalk_shape->xtalk_shape),
 			  xtalk_rate_kcps,
 			  &(pxtalk_shape->xtalk_hist_removed));
@@ -149,9 +143,9 @@ VL53LX_Error VL53LX_hist_process_data(
 
 
 	presults->xmonitor.total_periods_elapsed =
-		pbins_averaged->total_periods_elapsed;
+		pbins_input->total_periods_elapsed;
 	presults->xmonitor.VL53LX_p_004 =
-		pbins_averaged->result__dss_actual_effective_spads;
+		pbins_input->result__dss_actual_effective_spads;
 
 	presults->xmonitor.peak_signal_count_rate_mcps = 0;
 	presults->xmonitor.VL53LX_p_009     = 0;
@@ -174,16 +168,22 @@ VL53LX_Error VL53LX_hist_process_data(
 
 
 
+		VL53LX_f_031(
+			pbins_input,
+			pworking);
+
 		status =
 		VL53LX_f_025(
 			pdmax_cal,
 			pdmax_cfg,
 			ppost_cfg,
-			pbins_averaged,
+			pworking,
 			&(pxtalk_shape->xtalk_hist_removed),
 			palgo_gen3,
 			pfiltered4,
 			pdmax_algo_gen3,
+			pdmax_cache,
+			phist_gate,
 			presults,
 			*HistMergeNumber);
 
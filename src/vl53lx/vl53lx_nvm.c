@@ -24,6 +24,8 @@
 #include <vl53lx_platform_log.h>
 #include "vl53lx_register_map.h"
 #include "vl53lx_core.h"
+#include "vl53lx_core_support.h"
+#include "vl53lx_register_funcs.h"
 #include "vl53lx_nvm_structs.h"
 #include "vl53lx_nvm_map.h"
 #include "vl53lx_nvm.h"
@@ -1538,3 +1540,297 @@ VL53LX_Error VL53LX_read_nvm_fmt_range_results_data(
 }
 
 
+static const struct {
+	uint16_t  index;
+	uint16_t  size;
+} nvm_cache_blocks[] = {
+	{VL53LX_NVM__FMT__OPTICAL_CENTRE_DATA_INDEX,
+		VL53LX_NVM__FMT__OPTICAL_CENTRE_DATA_SIZE},
+	{VL53LX_NVM__FMT__CAL_PEAK_RATE_MAP_DATA_INDEX,
+		VL53LX_NVM__FMT__CAL_PEAK_RATE_MAP_DATA_SIZE},
+	{VL53LX_NVM__FMT__ADDITIONAL_OFFSET_CAL_DATA_INDEX,
+		VL53LX_NVM__FMT__ADDITIONAL_OFFSET_CAL_DATA_SIZE},
+	{VL53LX_NVM__FMT__RANGE_RESULTS__140MM_DARK,
+		VL53LX_NVM__FMT__RANGE_RESULTS__SIZE_BYTES},
+};
+
+#define NVM_CACHE_BLOCKS \
+	(sizeof(nvm_cache_blocks) / sizeof(nvm_cache_blocks[0]))
+
+#if (VL53LX_NVM__FMT__OPTICAL_CENTRE_DATA_SIZE + \
+	VL53LX_NVM__FMT__CAL_PEAK_RATE_MAP_DATA_SIZE + \
+	VL53LX_NVM__FMT__ADDITIONAL_OFFSET_CAL_DATA_SIZE + \
+	VL53LX_NVM__FMT__RANGE_RESULTS__SIZE_BYTES) != \
+	VL53LX_NVM_CACHE_RAW_SIZE_BYTES
+#error "VL53LX_NVM_CACHE_RAW_SIZE_BYTES does not match the cached blocks"
+#endif
+
+#define NVM_CACHE_LL_DRIVER_VERSION \
+	VL53LX_PACK_VERSION(VL53LX_LL_API_IMPLEMENTATION_VER_MAJOR, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_MINOR, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_SUB, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_REVISION)
+
+
+static uint32_t nvm_cache_fingerprint(
+	VL53LX_LLDriverData_t               *pdev)
+{
+
+
+	uint8_t  buffer[VL53LX_STATIC_NVM_MANAGED_I2C_SIZE_BYTES +
+		VL53LX_NVM_COPY_DATA_I2C_SIZE_BYTES];
+	uint32_t hash = 0x811C9DC5;
+	uint16_t i;
+
+	memset(buffer, 0, sizeof(buffer));
+	VL53LX_i2c_encode_static_nvm_managed(
+		&(pdev->stat_nvm),
+		VL53LX_STATIC_NVM_MANAGED_I2C_SIZE_BYTES,
+		buffer);
+	VL53LX_i2c_encode_nvm_copy_data(
+		&(pdev->nvm_copy_data),
+		VL53LX_NVM_COPY_DATA_I2C_SIZE_BYTES,
+		buffer + VL53LX_STATIC_NVM_MANAGED_I2C_SIZE_BYTES);
+
+	for (i = 0; i < sizeof(buffer); i++)
+		hash = (hash ^ buffer[i]) * 0x01000193;
+
+	return hash;
+}
+
+
+static uint8_t nvm_cache_word_address(
+	uint8_t  word)
+{
+
+
+	uint8_t  i;
+	uint8_t  block_words;
+
+	for (i = 0; i < NVM_CACHE_BLOCKS; i++) {
+		block_words = (uint8_t)(nvm_cache_blocks[i].size >> 2);
+		if (word < block_words)
+			break;
+		word -= block_words;
+	}
+
+	return (uint8_t)((nvm_cache_blocks[i].index >> 2) + word);
+}
+
+
+static VL53LX_Error nvm_cache_verify(
+	VL53LX_DEV                           Dev,
+	VL53LX_nvm_cache_t                  *pcache,
+	uint8_t                             *pmatch)
+{
+
+
+	VL53LX_Error status = VL53LX_ERROR_NONE;
+
+	uint8_t  nvm_data[VL53LX_NVM_UID_SIZE];
+	uint64_t uid = 0;
+	uint8_t  count = pcache->verify_words;
+	uint8_t  word;
+	uint8_t  i;
+
+	LOG_FUNCTION_START("");
+
+	*pmatch = 1;
+
+	if (count > VL53LX_NVM_CACHE_RAW_WORDS)
+		count = VL53LX_NVM_CACHE_RAW_WORDS;
+
+	word = (uint8_t)(pcache->verify_seed % VL53LX_NVM_CACHE_RAW_WORDS);
+
+
+
+	status = VL53LX_nvm_enable(
+				Dev,
+				0x0004,
+				VL53LX_NVM_POWER_UP_DELAY_US);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_read(
+			Dev,
+			(uint8_t)(VL53LX_NVM_UID_INDEX >> 2),
+			(uint8_t)(VL53LX_NVM_UID_SIZE >> 2),
+			nvm_data);
+
+	if (status == VL53LX_ERROR_NONE) {
+		memcpy(&uid, nvm_data, sizeof(uint64_t));
+		if (uid != pcache->data.uid)
+			*pmatch = 0;
+	}
+
+
+
+	for (i = 0; i < count; i++) {
+
+		if (status != VL53LX_ERROR_NONE || *pmatch == 0)
+			break;
+
+		status = VL53LX_nvm_read(
+			Dev,
+			nvm_cache_word_address(word),
+			1,
+			nvm_data);
+
+		if (status == VL53LX_ERROR_NONE &&
+			memcmp(nvm_data, &(pcache->data.nvm_raw[word << 2]), 4))
+			*pmatch = 0;
+
+		word = (uint8_t)((word + VL53LX_NVM_CACHE_VERIFY_STRIDE) %
+				VL53LX_NVM_CACHE_RAW_WORDS);
+	}
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_disable(Dev);
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
+
+VL53LX_Error VL53LX_read_nvm_p2p_cal_data(
+	VL53LX_DEV                           Dev,
+	VL53LX_nvm_cache_t                  *pcache,
+	VL53LX_nvm_cache_data_t             *pdata)
+{
+
+
+	VL53LX_Error status = VL53LX_ERROR_NONE;
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	VL53LX_decoded_nvm_fmt_range_data_t fmt_rrd;
+	uint8_t  nvm_data[VL53LX_NVM_UID_SIZE];
+	uint32_t fingerprint;
+	uint8_t  match = 0;
+	uint8_t *praw;
+	uint8_t  i;
+
+	LOG_FUNCTION_START("");
+
+
+
+	/* the registers the firmware copied from the NVM at boot are
+	 * already read: a different fingerprint is another part without
+	 * an NVM session, an equal one is confirmed by the UID
+	 */
+	fingerprint = nvm_cache_fingerprint(pdev);
+
+	if (pcache != NULL) {
+		pcache->hit     = 0;
+		pcache->updated = 0;
+
+		if (pcache->valid &&
+			pcache->data.struct_version ==
+				VL53LX_NVM_CACHE_STRUCT_VERSION &&
+			pcache->data.ll_driver_version ==
+				NVM_CACHE_LL_DRIVER_VERSION &&
+			pcache->data.nvm_copy_fingerprint == fingerprint) {
+
+			match = 1;
+			status = nvm_cache_verify(Dev, pcache, &match);
+		}
+	}
+
+	if (status == VL53LX_ERROR_NONE && match) {
+		memcpy(pdata, &(pcache->data), sizeof(VL53LX_nvm_cache_data_t));
+		pcache->hit = 1;
+		LOG_FUNCTION_END(status);
+		return status;
+	}
+
+
+
+	memset(pdata, 0, sizeof(VL53LX_nvm_cache_data_t));
+	pdata->struct_version    = VL53LX_NVM_CACHE_STRUCT_VERSION;
+	pdata->ll_driver_version = NVM_CACHE_LL_DRIVER_VERSION;
+	pdata->nvm_copy_fingerprint = fingerprint;
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_enable(
+					Dev,
+					0x0004,
+					VL53LX_NVM_POWER_UP_DELAY_US);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_read(
+			Dev,
+			(uint8_t)(VL53LX_NVM_UID_INDEX >> 2),
+			(uint8_t)(VL53LX_NVM_UID_SIZE >> 2),
+			nvm_data);
+
+	if (status == VL53LX_ERROR_NONE)
+		memcpy(&(pdata->uid), nvm_data, sizeof(uint64_t));
+
+	praw = pdata->nvm_raw;
+	for (i = 0; i < NVM_CACHE_BLOCKS; i++) {
+
+		if (status == VL53LX_ERROR_NONE)
+			status = VL53LX_nvm_read(
+				Dev,
+				(uint8_t)(nvm_cache_blocks[i].index >> 2),
+				(uint8_t)(nvm_cache_blocks[i].size >> 2),
+				praw);
+
+		praw += nvm_cache_blocks[i].size;
+	}
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_disable(Dev);
+
+
+
+	praw = pdata->nvm_raw;
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_decode_optical_centre(
+			VL53LX_NVM__FMT__OPTICAL_CENTRE_DATA_SIZE,
+			praw,
+			&(pdata->optical_centre));
+	praw += VL53LX_NVM__FMT__OPTICAL_CENTRE_DATA_SIZE;
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_decode_cal_peak_rate_map(
+			VL53LX_NVM__FMT__CAL_PEAK_RATE_MAP_DATA_SIZE,
+			praw,
+			&(pdata->cal_peak_rate_map));
+	praw += VL53LX_NVM__FMT__CAL_PEAK_RATE_MAP_DATA_SIZE;
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_decode_additional_offset_cal_data(
+			VL53LX_NVM__FMT__ADDITIONAL_OFFSET_CAL_DATA_SIZE,
+			praw,
+			&(pdata->add_off_cal_data));
+	praw += VL53LX_NVM__FMT__ADDITIONAL_OFFSET_CAL_DATA_SIZE;
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_nvm_decode_fmt_range_results_data(
+			VL53LX_NVM__FMT__RANGE_RESULTS__SIZE_BYTES,
+			praw,
+			&fmt_rrd);
+
+	if (status == VL53LX_ERROR_NONE) {
+		pdata->fmt_dark__actual_effective_rtn_spads =
+			fmt_rrd.result__actual_effective_rtn_spads;
+		pdata->fmt_dark__peak_signal_count_rate_rtn_mcps =
+			fmt_rrd.result__peak_signal_count_rate_rtn_mcps;
+		pdata->fmt_dark__measured_distance_mm =
+			fmt_rrd.measured_distance_mm;
+	}
+
+
+
+	if (status == VL53LX_ERROR_NONE && pcache != NULL) {
+		memcpy(&(pcache->data), pdata, sizeof(VL53LX_nvm_cache_data_t));
+		pcache->valid   = 1;
+		pcache->updated = 1;
+	}
+
+	LOG_FUNCTION_END(status);
+
+	return status;
+}
+
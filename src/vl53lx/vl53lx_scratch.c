@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_scratch.c
+ * @brief Per-frame scratch arena for the VL53LX histogram processing chain
+ */
+
+#include "vl53lx_scratch.h"
+#include "vl53lx_hist_private_structs.h"
+#include "vl53lx_dmax_private_structs.h"
+
+#include <stddef.h>
+
+
+/* the arena bookkeeping is 16 bit */
+VL53LX_SCRATCH_STATIC_CHECK(
+	VL53LX_SCRATCH_SIZE_BYTES <= 0xFFFF,
+	size_fits_uint16);
+
+/* deepest nesting: GetMultiRangingData -> get_device_results -> hist */
+VL53LX_SCRATCH_STATIC_CHECK(
+	sizeof(VL53LX_range_results_t) +
+	sizeof(VL53LX_dmax_calibration_data_t) +
+	sizeof(VL53LX_hist_gen3_algo_private_data_t) +
+	sizeof(VL53LX_hist_gen4_algo_filtered_data_t) +
+	sizeof(VL53LX_hist_gen3_dmax_private_data_t) +
+	5 * VL53LX_SCRATCH_ALIGN <= VL53LX_SCRATCH_SIZE_BYTES,
+	ranging_chain);
+
+
+void VL53LX_scratch_init(
+	VL53LX_scratch_t   *pscratch,
+	void               *pbuffer,
+	uint16_t            size_bytes)
+{
+	pscratch->pbuffer    = (uint8_t *)pbuffer;
+	pscratch->size_bytes = size_bytes;
+	pscratch->used_bytes = 0;
+	pscratch->peak_bytes = 0;
+	pscratch->fail_count = 0;
+}
+
+
+void *VL53LX_scratch_alloc(
+	VL53LX_scratch_t   *pscratch,
+	uint16_t            size_bytes)
+{
+	void      *pblock  = NULL;
+	uint32_t   aligned = 0;
+
+	if (pscratch == NULL || pscratch->pbuffer == NULL)
+		return NULL;
+
+	aligned = ((uint32_t)size_bytes + (VL53LX_SCRATCH_ALIGN - 1)) &
+		~((uint32_t)VL53LX_SCRATCH_ALIGN - 1);
+
+	if (aligned > (uint32_t)(pscratch->size_bytes - pscratch->used_bytes)) {
+		pscratch->fail_count++;
+		return NULL;
+	}
+
+	pblock = pscratch->pbuffer + pscratch->used_bytes;
+	pscratch->used_bytes += (uint16_t)aligned;
+
+	if (pscratch->used_bytes > pscratch->peak_bytes)
+		pscratch->peak_bytes = pscratch->used_bytes;
+
+	return pblock;
+}
+
+
+uint16_t VL53LX_scratch_mark(
+	VL53LX_scratch_t   *pscratch)
+{
+	if (pscratch == NULL)
+		return 0;
+
+	return pscratch->used_bytes;
+}
+
+
+void VL53LX_scratch_release(
+	VL53LX_scratch_t   *pscratch,
+	uint16_t            mark)
+{
+	if (pscratch != NULL && mark <= pscratch->used_bytes)
+		pscratch->used_bytes = mark;
+}
@@ -0,0 +1,370 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_snapshot.c
+ * @brief Driver state snapshot for warm restart without VL53LX_DataInit()
+ */
+
+#include "vl53lx_snapshot.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_core.h"
+#include "vl53lx_core_support.h"
+#include "vl53lx_register_map.h"
+#include "vl53lx_register_funcs.h"
+#include <vl53lx_platform_log.h>
+
+#include <stddef.h>
+#include <string.h>
+
+
+#define LOG_FUNCTION_START(fmt, ...) \
+	_LOG_FUNCTION_START(VL53LX_TRACE_MODULE_API, fmt, ##__VA_ARGS__)
+#define LOG_FUNCTION_END(status, ...) \
+	_LOG_FUNCTION_END(VL53LX_TRACE_MODULE_API, status, ##__VA_ARGS__)
+
+#define SNAPSHOT_LL_DRIVER_VERSION \
+	VL53LX_PACK_VERSION(VL53LX_LL_API_IMPLEMENTATION_VER_MAJOR, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_MINOR, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_SUB, \
+		VL53LX_LL_API_IMPLEMENTATION_VER_REVISION)
+
+#define LL_FIELD(field) \
+	{offsetof(VL53LX_DevData_t, LLData.field), \
+	 sizeof(((VL53LX_DevData_t *)0)->LLData.field)}
+
+#define LL_RANGE(first, next) \
+	{offsetof(VL53LX_DevData_t, LLData.first), \
+	 offsetof(VL53LX_DevData_t, LLData.next) - \
+	 offsetof(VL53LX_DevData_t, LLData.first)}
+
+#define DEV_FIELD(field) \
+	{offsetof(VL53LX_DevData_t, field), \
+	 sizeof(((VL53LX_DevData_t *)0)->field)}
+
+#define IMAGE_SIZE_BYTES \
+	(VL53LX_SYSTEM_CONTROL_I2C_INDEX - VL53LX_STATIC_NVM_MANAGED_I2C_INDEX)
+
+
+/* configuration only; results, histograms, the dmax cache entries, gate
+ * statistics, UWR confirmation counts and the scratch arena are not saved
+ * and come from VL53LX_data_init(Dev, 0) on restore */
+static const struct {
+	uint16_t  offset;
+	uint16_t  size;
+} snapshot_fields[] = {
+	LL_RANGE(wait_method, version),
+	LL_FIELD(gpio_interrupt_config),
+	LL_FIELD(customer),
+	LL_FIELD(cal_peak_rate_map),
+	LL_FIELD(add_off_cal_data),
+	LL_FIELD(fmt_dmax_cal),
+	LL_FIELD(cust_dmax_cal),
+	LL_FIELD(gain_cal),
+	LL_FIELD(mm_roi),
+	LL_FIELD(optical_centre),
+	LL_FIELD(zone_cfg),
+	LL_FIELD(tuning_parms),
+	LL_FIELD(rtn_good_spads),
+	LL_FIELD(refspadchar),
+	LL_FIELD(ssc_cfg),
+	LL_FIELD(histpostprocess),
+	LL_FIELD(dmax_cfg),
+	LL_FIELD(dmax_cache.reflectance_mask),
+	LL_FIELD(dmax_cache.cache_enable),
+	LL_FIELD(dmax_cache.ambient_quant_shift),
+	LL_FIELD(dmax_cache.refresh_period),
+	LL_FIELD(hist_gate.gate_enable),
+	LL_FIELD(hist_gate.margin_bins),
+	LL_FIELD(hist_gate.min_range_mm),
+	LL_FIELD(hist_gate.max_range_mm),
+	LL_FIELD(uwr.confirm_depth),
+	LL_FIELD(uwr.hysteresis_mm),
+	LL_FIELD(uwr.mode),
+	LL_FIELD(xtalk_extract_cfg),
+	LL_FIELD(xtalk_cfg),
+	LL_FIELD(offsetcal_cfg),
+	LL_FIELD(zonecal_cfg),
+	LL_FIELD(stat_nvm),
+	LL_FIELD(hist_cfg),
+	LL_FIELD(stat_cfg),
+	LL_FIELD(gen_cfg),
+	LL_FIELD(tim_cfg),
+	LL_FIELD(dyn_cfg),
+	LL_FIELD(sys_ctrl),
+	LL_FIELD(nvm_copy_data),
+	LL_FIELD(nvm_uid),
+	LL_FIELD(dbg_results.result__osc_calibrate_val),
+	LL_FIELD(xtalk_shapes),
+	LL_FIELD(xtalk_cal),
+	LL_FIELD(smudge_correct_config),
+	LL_FIELD(per_vcsel_cal_data),
+	DEV_FIELD(llresults.zone_dyn_cfgs),
+	DEV_FIELD(CurrentParameters),
+	DEV_FIELD(BDTable),
+};
+
+#define SNAPSHOT_FIELDS \
+	(sizeof(snapshot_fields) / sizeof(snapshot_fields[0]))
+
+/* every saved field lies inside VL53LX_DevData_t */
+_Static_assert(sizeof(VL53LX_DevData_t) <= UINT16_MAX,
+	"snapshot field offsets and sizes must fit uint16_t");
+
+
+static uint32_t snapshot_layout(void)
+{
+	return VL53LX_crc32(0, (const uint8_t *)snapshot_fields,
+		(uint32_t)sizeof(snapshot_fields));
+}
+
+
+static uint32_t snapshot_payload_size(void)
+{
+	uint32_t  size = 0;
+	uint8_t   i;
+
+	for (i = 0; i < SNAPSHOT_FIELDS; i++)
+		size += snapshot_fields[i].size;
+
+	return size;
+}
+
+
+static uint32_t snapshot_record_crc(
+	const uint8_t  *pbuffer)
+{
+	VL53LX_snapshot_header_t header;
+	uint32_t crc;
+
+	memcpy(&header, pbuffer, sizeof(header));
+	header.crc32 = 0;
+
+	crc = VL53LX_crc32(0, (const uint8_t *)&header, sizeof(header));
+	return VL53LX_crc32(crc, pbuffer + sizeof(header),
+		header.payload_size);
+}
+
+
+uint32_t VL53LX_GetStateSnapshotSize(void)
+{
+	return (uint32_t)sizeof(VL53LX_snapshot_header_t) +
+		snapshot_payload_size();
+}
+
+
+VL53LX_Error VL53LX_GetStateSnapshot(VL53LX_DEV Dev,
+	uint8_t *pbuffer, uint32_t buffer_size, uint32_t *psnapshot_size)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+	const uint8_t *pdata = (const uint8_t *)&(Dev->Data);
+	VL53LX_snapshot_header_t header;
+	uint32_t  size = VL53LX_GetStateSnapshotSize();
+	uint8_t  *pout;
+	uint8_t   i;
+
+	LOG_FUNCTION_START("");
+
+	*psnapshot_size = 0;
+
+	if (buffer_size < size)
+		Status = VL53LX_ERROR_BUFFER_TOO_SMALL;
+
+	if (Status == VL53LX_ERROR_NONE) {
+
+		memset(&header, 0, sizeof(header));
+		header.magic             = VL53LX_SNAPSHOT_MAGIC;
+		header.format_version    = VL53LX_SNAPSHOT_FORMAT_VERSION;
+		header.header_size       = (uint16_t)sizeof(header);
+		header.ll_driver_version = SNAPSHOT_LL_DRIVER_VERSION;
+		header.layout            = snapshot_layout();
+		header.payload_size      = snapshot_payload_size();
+		memcpy(pbuffer, &header, sizeof(header));
+
+		pout = pbuffer + sizeof(header);
+		for (i = 0; i < SNAPSHOT_FIELDS; i++) {
+			memcpy(pout, pdata + snapshot_fields[i].offset,
+				snapshot_fields[i].size);
+			pout += snapshot_fields[i].size;
+		}
+
+		header.crc32 = snapshot_record_crc(pbuffer);
+		memcpy(pbuffer, &header, sizeof(header));
+
+		*psnapshot_size = size;
+	}
+
+	LOG_FUNCTION_END(Status);
+	return Status;
+}
+
+
+static VL53LX_Error snapshot_check(
+	const uint8_t  *pbuffer,
+	uint32_t        snapshot_size)
+{
+	VL53LX_snapshot_header_t header;
+
+	if (snapshot_size < sizeof(header))
+		return VL53LX_ERROR_INVALID_PARAMS;
+
+	memcpy(&header, pbuffer, sizeof(header));
+
+	if (header.magic != VL53LX_SNAPSHOT_MAGIC ||
+		header.header_size != sizeof(header) ||
+		header.payload_size != snapshot_size - sizeof(header))
+		return VL53LX_ERROR_INVALID_PARAMS;
+
+	if (header.crc32 != snapshot_record_crc(pbuffer))
+		return VL53LX_ERROR_INVALID_PARAMS;
+
+	if (header.format_version != VL53LX_SNAPSHOT_FORMAT_VERSION ||
+		header.ll_driver_version != SNAPSHOT_LL_DRIVER_VERSION ||
+		header.layout != snapshot_layout() ||
+		header.payload_size != snapshot_payload_size())
+		return VL53LX_ERROR_NOT_SUPPORTED;
+
+	return VL53LX_ERROR_NONE;
+}
+
+
+static VL53LX_Error snapshot_write_image(
+	VL53LX_DEV  Dev)
+{
+	VL53LX_Error status = VL53LX_ERROR_NONE;
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	uint8_t  buffer[IMAGE_SIZE_BYTES];
+
+	memset(buffer, 0, sizeof(buffer));
+
+	status = VL53LX_i2c_encode_static_nvm_managed(
+		&(pdev->stat_nvm),
+		VL53LX_STATIC_NVM_MANAGED_I2C_SIZE_BYTES,
+		&buffer[VL53LX_STATIC_NVM_MANAGED_I2C_INDEX -
+			VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_i2c_encode_customer_nvm_managed(
+			&(pdev->customer),
+			VL53LX_CUSTOMER_NVM_MANAGED_I2C_SIZE_BYTES,
+			&buffer[VL53LX_CUSTOMER_NVM_MANAGED_I2C_INDEX -
+				VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_i2c_encode_static_config(
+			&(pdev->stat_cfg),
+			VL53LX_STATIC_CONFIG_I2C_SIZE_BYTES,
+			&buffer[VL53LX_STATIC_CONFIG_I2C_INDEX -
+				VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_i2c_encode_general_config(
+			&(pdev->gen_cfg),
+			VL53LX_GENERAL_CONFIG_I2C_SIZE_BYTES,
+			&buffer[VL53LX_GENERAL_CONFIG_I2C_INDEX -
+				VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_i2c_encode_timing_config(
+			&(pdev->tim_cfg),
+			VL53LX_TIMING_CONFIG_I2C_SIZE_BYTES,
+			&buffer[VL53LX_TIMING_CONFIG_I2C_INDEX -
+				VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_i2c_encode_dynamic_config(
+			&(pdev->dyn_cfg),
+			VL53LX_DYNAMIC_CONFIG_I2C_SIZE_BYTES,
+			&buffer[VL53LX_DYNAMIC_CONFIG_I2C_INDEX -
+				VL53LX_STATIC_NVM_MANAGED_I2C_INDEX]);
+
+	if (status == VL53LX_ERROR_NONE)
+		status = VL53LX_WriteMulti(
+			Dev,
+			VL53LX_STATIC_NVM_MANAGED_I2C_INDEX,
+			buffer,
+			IMAGE_SIZE_BYTES);
+
+	return status;
+}
+
+
+static void snapshot_load(
+	VL53LX_DEV      Dev,
+	const uint8_t  *pbuffer)
+{
+	uint8_t *pdata = (uint8_t *)&(Dev->Data);
+	const uint8_t *pin = pbuffer + sizeof(VL53LX_snapshot_header_t);
+	uint8_t  i;
+
+	for (i = 0; i < SNAPSHOT_FIELDS; i++) {
+		memcpy(pdata + snapshot_fields[i].offset, pin,
+			snapshot_fields[i].size);
+		pin += snapshot_fields[i].size;
+	}
+}
+
+
+VL53LX_Error VL53LX_RestoreStateSnapshot(VL53LX_DEV Dev,
+	const uint8_t *pbuffer, uint32_t snapshot_size)
+{
+	VL53LX_Error Status = VL53LX_ERROR_NONE;
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+	uint8_t  i2c_address = 0;
+#ifdef USE_I2C_2V8
+	uint8_t  i;
+#endif
+
+	LOG_FUNCTION_START("");
+
+	Status = snapshot_check(pbuffer, snapshot_size);
+
+
+
+	if (Status == VL53LX_ERROR_NONE)
+		Status = VL53LX_RdByte(Dev, VL53LX_I2C_SLAVE__DEVICE_ADDRESS,
+			&i2c_address);
+
+
+
+#ifdef USE_I2C_2V8
+	if (Status == VL53LX_ERROR_NONE)
+		Status = VL53LX_RdByte(Dev, VL53LX_PAD_I2C_HV__EXTSUP_CONFIG,
+			&i);
+	if (Status == VL53LX_ERROR_NONE) {
+		i = (i & 0xfe) | 0x01;
+		Status = VL53LX_WrByte(Dev, VL53LX_PAD_I2C_HV__EXTSUP_CONFIG,
+				i);
+	}
+#endif
+
+
+
+	/* the RAM-only data init derives its presets from the decoded NVM
+	 * and oscillator calibration, so load before and again after it */
+	if (Status == VL53LX_ERROR_NONE) {
+		snapshot_load(Dev, pbuffer);
+		Status = VL53LX_data_init(Dev, 0);
+	}
+
+	if (Status == VL53LX_ERROR_NONE) {
+		snapshot_load(Dev, pbuffer);
+
+		pdev->stat_nvm.i2c_slave__device_address =
+			i2c_address & 0x7F;
+
+		VL53LX_init_ll_driver_state(Dev,
+			VL53LX_DEVICESTATE_SW_STANDBY);
+	}
+
+
+
+	if (Status == VL53LX_ERROR_NONE)
+		Status = snapshot_write_image(Dev);
+
+	LOG_FUNCTION_END(Status);
+	return Status;
+}
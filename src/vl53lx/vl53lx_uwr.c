@@ -0,0 +1,325 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_uwr.c
+ * @brief Table-driven ultra wide range (wrap around) resolution
+ */
+
+#include "vl53lx_uwr.h"
+
+#include <string.h>
+
+
+#define VL53LX_UWR_RULE(pr, lo, hi, seq, offset) \
+	do { \
+		(pr)->range_diff_min_mm = (int16_t)(lo); \
+		(pr)->range_diff_max_mm = (int16_t)(hi); \
+		(pr)->sequence = (seq); \
+		(pr)->offset_mm = (offset); \
+		(pr)++; \
+	} while (0)
+
+
+void VL53LX_uwr_init(
+	VL53LX_uwr_config_t                 *puwr)
+{
+	memset(puwr, 0, sizeof(VL53LX_uwr_config_t));
+
+	puwr->tables_stale  = 1;
+	puwr->confirm_depth = 1;
+	puwr->hysteresis_mm = 0;
+}
+
+
+uint8_t VL53LX_uwr_mode_index(
+	VL53LX_DevicePresetModes             preset_mode)
+{
+	switch (preset_mode) {
+	case VL53LX_DEVICEPRESETMODE_HISTOGRAM_SHORT_RANGE:
+		return VL53LX_UWR_MODE_SHORT;
+	case VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE:
+		return VL53LX_UWR_MODE_MEDIUM;
+	case VL53LX_DEVICEPRESETMODE_HISTOGRAM_LONG_RANGE:
+		return VL53LX_UWR_MODE_LONG;
+	default:
+		return VL53LX_UWR_MODE_COUNT;
+	}
+}
+
+
+void VL53LX_uwr_tuning_rules(
+	const VL53LX_tuning_parm_storage_t  *ptp,
+	uint8_t                              uwr_mode,
+	VL53LX_uwr_rule_t                   *prules,
+	uint8_t                             *prule_count)
+{
+	VL53LX_uwr_rule_t *pr = prules;
+
+	/* same priority order as the historical SetTargetData() chain */
+	switch (uwr_mode) {
+	case VL53LX_UWR_MODE_MEDIUM:
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_med_z_1_min,
+			ptp->tp_uwr_med_z_1_max, 1,
+			ptp->tp_uwr_med_corr_z_1_rangeb);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_med_z_1_max,
+			-ptp->tp_uwr_med_z_1_min, 0,
+			ptp->tp_uwr_med_corr_z_1_rangea);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_med_z_2_min,
+			ptp->tp_uwr_med_z_2_max, 0,
+			ptp->tp_uwr_med_corr_z_2_rangea);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_med_z_2_max,
+			-ptp->tp_uwr_med_z_2_min, 1,
+			ptp->tp_uwr_med_corr_z_2_rangeb);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_med_z_3_min,
+			ptp->tp_uwr_med_z_3_max, 1,
+			ptp->tp_uwr_med_corr_z_3_rangeb);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_med_z_3_max,
+			-ptp->tp_uwr_med_z_3_min, 0,
+			ptp->tp_uwr_med_corr_z_3_rangea);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_med_z_4_min,
+			ptp->tp_uwr_med_z_4_max, 0,
+			ptp->tp_uwr_med_corr_z_4_rangea);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_med_z_4_max,
+			-ptp->tp_uwr_med_z_4_min, 1,
+			ptp->tp_uwr_med_corr_z_4_rangeb);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_med_z_5_min,
+			ptp->tp_uwr_med_z_5_max, VL53LX_UWR_SEQUENCE_ANY,
+			ptp->tp_uwr_med_corr_z_5_rangea);
+	break;
+	case VL53LX_UWR_MODE_LONG:
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_lng_z_1_min,
+			ptp->tp_uwr_lng_z_1_max, 0,
+			ptp->tp_uwr_lng_corr_z_1_rangea);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_lng_z_1_max,
+			-ptp->tp_uwr_lng_z_1_min, 1,
+			ptp->tp_uwr_lng_corr_z_1_rangeb);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_lng_z_2_min,
+			ptp->tp_uwr_lng_z_2_max, 1,
+			ptp->tp_uwr_lng_corr_z_2_rangeb);
+		VL53LX_UWR_RULE(pr, -ptp->tp_uwr_lng_z_2_max,
+			-ptp->tp_uwr_lng_z_2_min, 0,
+			ptp->tp_uwr_lng_corr_z_2_rangea);
+		VL53LX_UWR_RULE(pr, ptp->tp_uwr_lng_z_3_min,
+			ptp->tp_uwr_lng_z_3_max, VL53LX_UWR_SEQUENCE_ANY,
+			ptp->tp_uwr_lng_corr_z_3_rangea);
+	break;
+	default:
+	break;
+	}
+
+	*prule_count = (uint8_t)(pr - prules);
+}
+
+
+static VL53LX_Error VL53LX_uwr_build_sequence(
+	const VL53LX_uwr_rule_t             *prules,
+	uint8_t                              rule_count,
+	uint8_t                              sequence,
+	VL53LX_uwr_sequence_table_t         *pseq)
+{
+	int32_t  lo[VL53LX_UWR_MAX_RULES];
+	int32_t  hi[VL53LX_UWR_MAX_RULES];
+	int16_t  offset[VL53LX_UWR_MAX_RULES];
+	int32_t  edge[2 * VL53LX_UWR_MAX_RULES];
+	int32_t  tmp;
+	uint8_t  used = 0;
+	uint8_t  edges = 0;
+	uint8_t  i, j;
+	VL53LX_uwr_zone_t *pzone;
+
+	/* rule windows are exclusive, zones hold inclusive bounds */
+	for (i = 0; i < rule_count; i++) {
+		if (prules[i].sequence != VL53LX_UWR_SEQUENCE_ANY &&
+			prules[i].sequence != sequence)
+			continue;
+
+		lo[used] = (int32_t)prules[i].range_diff_min_mm + 1;
+		hi[used] = (int32_t)prules[i].range_diff_max_mm - 1;
+		if (lo[used] > hi[used])
+			continue;
+
+		offset[used] = prules[i].offset_mm;
+		edge[edges++] = lo[used];
+		edge[edges++] = hi[used] + 1;
+		used++;
+	}
+
+	for (i = 1; i < edges; i++) {
+		tmp = edge[i];
+		for (j = i; j > 0 && edge[j - 1] > tmp; j--)
+			edge[j] = edge[j - 1];
+		edge[j] = tmp;
+	}
+
+	/* each elementary span takes the first rule covering it */
+	pseq->zone_count = 0;
+	for (i = 0; i + 1 < edges; i++) {
+		if (edge[i] == edge[i + 1])
+			continue;
+
+		for (j = 0; j < used; j++)
+			if (lo[j] <= edge[i] && hi[j] >= edge[i])
+				break;
+		if (j == used)
+			continue;
+
+		if (pseq->zone_count > 0) {
+			pzone = &(pseq->zones[pseq->zone_count - 1]);
+			if ((int32_t)pzone->range_diff_hi_mm + 1 == edge[i] &&
+				pzone->offset_mm == offset[j]) {
+				pzone->range_diff_hi_mm =
+					(int16_t)(edge[i + 1] - 1);
+				continue;
+			}
+		}
+
+		if (pseq->zone_count >= VL53LX_UWR_MAX_ZONES)
+			return VL53LX_ERROR_INVALID_PARAMS;
+
+		pzone = &(pseq->zones[pseq->zone_count++]);
+		pzone->range_diff_lo_mm = (int16_t)edge[i];
+		pzone->range_diff_hi_mm = (int16_t)(edge[i + 1] - 1);
+		pzone->offset_mm        = offset[j];
+	}
+
+	return VL53LX_ERROR_NONE;
+}
+
+
+VL53LX_Error VL53LX_uwr_build_table(
+	const VL53LX_uwr_rule_t             *prules,
+	uint8_t                              rule_count,
+	uint8_t                              sequence_count,
+	VL53LX_uwr_mode_table_t             *ptable)
+{
+	VL53LX_Error status = VL53LX_ERROR_NONE;
+	uint8_t      s;
+
+	/* stream counts wrap from 255 to 128, keep the sequence in step */
+	if (sequence_count != 1 && sequence_count != 2 && sequence_count != 4)
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	if (rule_count > VL53LX_UWR_MAX_RULES ||
+		(rule_count > 0 && prules == NULL))
+		status = VL53LX_ERROR_INVALID_PARAMS;
+
+	for (s = 0; status == VL53LX_ERROR_NONE &&
+		s < VL53LX_UWR_MAX_SEQUENCES; s++) {
+		if (s < sequence_count)
+			status = VL53LX_uwr_build_sequence(
+				prules, rule_count, s, &(ptable->sequence[s]));
+		else
+			ptable->sequence[s].zone_count = 0;
+	}
+
+	if (status == VL53LX_ERROR_NONE)
+		ptable->sequence_count = sequence_count;
+
+	return status;
+}
+
+
+uint8_t VL53LX_uwr_find_zone(
+	const VL53LX_uwr_sequence_table_t   *pseq,
+	int16_t                              range_diff_mm,
+	int16_t                              margin_mm,
+	int16_t                             *poffset_mm)
+{
+	const VL53LX_uwr_zone_t *pzones = pseq->zones;
+	int32_t below = 0x7FFFFFFF;
+	int32_t above = 0x7FFFFFFF;
+	uint8_t first = 0;
+	uint8_t last  = pseq->zone_count;
+	uint8_t mid;
+
+	/* first = number of zones starting at or below range_diff_mm */
+	while (first < last) {
+		mid = (uint8_t)((first + last) / 2);
+		if (pzones[mid].range_diff_lo_mm <= range_diff_mm)
+			first = (uint8_t)(mid + 1);
+		else
+			last = mid;
+	}
+
+	if (first > 0 && range_diff_mm <= pzones[first - 1].range_diff_hi_mm) {
+		*poffset_mm = pzones[first - 1].offset_mm;
+		return 1;
+	}
+
+	if (margin_mm <= 0)
+		return 0;
+
+	if (first > 0)
+		below = (int32_t)range_diff_mm -
+			pzones[first - 1].range_diff_hi_mm;
+	if (first < pseq->zone_count)
+		above = (int32_t)pzones[first].range_diff_lo_mm -
+			range_diff_mm;
+
+	if (below <= above && below <= margin_mm) {
+		*poffset_mm = pzones[first - 1].offset_mm;
+		return 1;
+	}
+
+	if (above < below && above <= margin_mm) {
+		*poffset_mm = pzones[first].offset_mm;
+		return 1;
+	}
+
+	return 0;
+}
+
+
+uint8_t VL53LX_uwr_resolve(
+	VL53LX_uwr_config_t                 *puwr,
+	const VL53LX_tuning_parm_storage_t  *ptp,
+	VL53LX_DevicePresetModes             preset_mode,
+	uint8_t                              stream_count,
+	uint8_t                              target,
+	int16_t                              range_diff_mm,
+	uint8_t                              previous_extended,
+	int16_t                             *poffset_mm)
+{
+	VL53LX_uwr_rule_t        rules[VL53LX_UWR_MAX_RULES];
+	VL53LX_uwr_mode_table_t *ptable;
+	uint8_t rule_count;
+	uint8_t mode;
+	uint8_t found = 0;
+
+	if (puwr->tables_stale) {
+		for (mode = 0; mode < VL53LX_UWR_MODE_COUNT; mode++) {
+			if (puwr->mode[mode].custom)
+				continue;
+			VL53LX_uwr_tuning_rules(ptp, mode, rules, &rule_count);
+			VL53LX_uwr_build_table(rules, rule_count, 2,
+				&(puwr->mode[mode]));
+		}
+		puwr->tables_stale = 0;
+	}
+
+	mode = VL53LX_uwr_mode_index(preset_mode);
+	if (mode < VL53LX_UWR_MODE_COUNT) {
+		ptable = &(puwr->mode[mode]);
+		found = VL53LX_uwr_find_zone(
+			&(ptable->sequence[stream_count % ptable->sequence_count]),
+			range_diff_mm,
+			previous_extended ? puwr->hysteresis_mm : 0,
+			poffset_mm);
+	}
+
+	if (target >= VL53LX_MAX_RANGE_RESULTS)
+		return found;
+
+	if (found == 0) {
+		puwr->confirm_count[target] = 0;
+		return 0;
+	}
+
+	if (puwr->confirm_count[target] < puwr->confirm_depth)
+		puwr->confirm_count[target]++;
+
+	return (puwr->confirm_count[target] >= puwr->confirm_depth) ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_align.c
+ * @brief VL53LX Multi-Sensor Time Alignment Implementation
+ */
+
+#include "vl53lx_align.h"
+#include <string.h>
+
+// Default configuration values
+#define DEFAULT_OUTPUT_PERIOD_US    20000   // 50 Hz
+#define DEFAULT_DELAY_US            0
+#define DEFAULT_MAX_GAP_US          100000  // About three missed samples at 33 ms
+#define DEFAULT_MAX_AGE_US          100000
+
+#define QUEUE_MASK                  (VL53LX_ALIGN_QUEUE_LENGTH - 1)
+
+#if (VL53LX_ALIGN_QUEUE_LENGTH & QUEUE_MASK) != 0
+#error "VL53LX_ALIGN_QUEUE_LENGTH must be a power of two"
+#endif
+
+// Queue indices: acquire/release so that the sample is visible before the index
+#define INDEX_LOAD(p)               __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define INDEX_STORE(p, v)           __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+vl53lx_align_config_t VL53LX_AlignGetDefaultConfig(void)
+{
+    vl53lx_align_config_t config = {
+        .output_period_us = DEFAULT_OUTPUT_PERIOD_US,
+        .delay_us = DEFAULT_DELAY_US,
+        .max_gap_us = DEFAULT_MAX_GAP_US,
+        .max_age_us = DEFAULT_MAX_AGE_US,
+        .interpolate = true,
+    };
+    return config;
+}
+
+bool VL53LX_AlignInit(vl53lx_align_t *align)
+{
+    vl53lx_align_config_t config = VL53LX_AlignGetDefaultConfig();
+    return VL53LX_AlignInitWithConfig(align, &config);
+}
+
+bool VL53LX_AlignInitWithConfig(vl53lx_align_t *align, const vl53lx_align_config_t *config)
+{
+    if (align == NULL || config == NULL || config->output_period_us == 0) {
+        return false;
+    }
+
+    memset(align, 0, sizeof(*align));
+    align->config = *config;
+    align->initialized = true;
+
+    return true;
+}
+
+int VL53LX_AlignAddSensor(vl53lx_align_t *align)
+{
+    if (align == NULL || !align->initialized || align->count >= VL53LX_ALIGN_MAX_SENSORS) {
+        return -1;
+    }
+
+    memset(&align->channels[align->count], 0, sizeof(align->channels[0]));
+    return align->count++;
+}
+
+bool VL53LX_AlignPush(vl53lx_align_t *align, uint8_t index, uint32_t timestamp_us, uint16_t distance_mm,
+                      uint8_t range_status)
+{
+    if (align == NULL || index >= align->count) {
+        return false;
+    }
+
+    vl53lx_align_channel_t *channel = &align->channels[index];
+    uint32_t head = channel->head;
+
+    if (head - INDEX_LOAD(&channel->tail) >= VL53LX_ALIGN_QUEUE_LENGTH) {
+        channel->dropped++;
+        return false;
+    }
+
+    vl53lx_align_sample_t *sample = &channel->queue[head & QUEUE_MASK];
+    sample->timestamp_us = timestamp_us;
+    sample->distance_mm = distance_mm;
+    sample->range_status = range_status;
+    INDEX_STORE(&channel->head, head + 1);
+
+    return true;
+}
+
+// Move the queued samples into the history, oldest dropped first
+static void align_drain(vl53lx_align_channel_t *channel)
+{
+    uint32_t head = INDEX_LOAD(&channel->head);
+    uint32_t tail = channel->tail;
+
+    while (tail != head) {
+        vl53lx_align_sample_t sample = channel->queue[tail & QUEUE_MASK];
+        tail++;
+        INDEX_STORE(&channel->tail, tail);
+        channel->received++;
+
+        if (sample.range_status != 0) {
+            channel->invalid++;
+            continue;
+        }
+        if (channel->history_count > 0 &&
+            (int32_t)(sample.timestamp_us - channel->history[channel->history_count - 1].timestamp_us) <= 0) {
+            channel->out_of_order++;
+            continue;
+        }
+        if (channel->history_count == VL53LX_ALIGN_HISTORY_LENGTH) {
+            memmove(&channel->history[0], &channel->history[1],
+                    (VL53LX_ALIGN_HISTORY_LENGTH - 1) * sizeof(channel->history[0]));
+            channel->history_count--;
+        }
+        channel->history[channel->history_count++] = sample;
+    }
+}
+
+static void align_value(const vl53lx_align_config_t *config, const vl53lx_align_channel_t *channel,
+                        uint32_t timestamp_us, vl53lx_align_value_t *value)
+{
+    // Newest sample at or before the snapshot time, and the one after it
+    int before = -1;
+    for (int i = channel->history_count - 1; i >= 0; i--) {
+        if ((int32_t)(channel->history[i].timestamp_us - timestamp_us) <= 0) {
+            before = i;
+            break;
+        }
+    }
+
+    if (before < 0) {
+        value->distance_mm = 0;
+        value->age_us = 0;
+        value->source = VL53LX_ALIGN_NONE;
+        return;
+    }
+
+    const vl53lx_align_sample_t *s0 = &channel->history[before];
+    value->age_us = timestamp_us - s0->timestamp_us;
+    value->distance_mm = s0->distance_mm;
+    value->source = value->age_us > config->max_age_us ? VL53LX_ALIGN_STALE : VL53LX_ALIGN_HELD;
+
+    if (!config->interpolate || before + 1 >= channel->history_count || value->age_us == 0) {
+        return;
+    }
+
+    const vl53lx_align_sample_t *s1 = &channel->history[before + 1];
+    uint32_t gap_us = s1->timestamp_us - s0->timestamp_us;
+    if (gap_us > config->max_gap_us) {
+        return;
+    }
+
+    int32_t delta_mm = (int32_t)s1->distance_mm - (int32_t)s0->distance_mm;
+    int64_t scaled = (int64_t)delta_mm * value->age_us;
+    // Round to nearest, away from zero
+    scaled += scaled >= 0 ? gap_us / 2 : -(int64_t)(gap_us / 2);
+    value->distance_mm = (uint16_t)((int32_t)s0->distance_mm + (int32_t)(scaled / gap_us));
+    value->source = VL53LX_ALIGN_INTERPOLATED;
+}
+
+void VL53LX_AlignSnapshot(vl53lx_align_t *align, uint32_t timestamp_us, vl53lx_align_snapshot_t *snapshot)
+{
+    if (align == NULL || !align->initialized || snapshot == NULL) {
+        return;
+    }
+
+    snapshot->timestamp_us = timestamp_us;
+    snapshot->sequence = align->sequence++;
+    snapshot->count = align->count;
+    for (uint8_t i = 0; i < align->count; i++) {
+        align_drain(&align->channels[i]);
+        align_value(&align->config, &align->channels[i], timestamp_us, &snapshot->values[i]);
+    }
+}
+
+bool VL53LX_AlignPoll(vl53lx_align_t *align, uint32_t now_us, vl53lx_align_snapshot_t *snapshot)
+{
+    if (align == NULL || !align->initialized || snapshot == NULL) {
+        return false;
+    }
+
+    if (!align->started) {
+        align->next_output_us = now_us;
+        align->started = true;
+    }
+    if ((int32_t)(align->next_output_us - now_us) > 0) {
+        return false;
+    }
+
+    // From the previous tick, not from now, so that the rate does not drift
+    uint32_t tick_us = align->next_output_us;
+    align->next_output_us += align->config.output_period_us;
+    while ((int32_t)(align->next_output_us - now_us) <= 0) {
+        tick_us = align->next_output_us;
+        align->next_output_us += align->config.output_period_us;
+        align->skipped++;
+    }
+
+    VL53LX_AlignSnapshot(align, tick_us - align->config.delay_us, snapshot);
+    return true;
+}
+
+uint32_t VL53LX_AlignUntilNext(const vl53lx_align_t *align, uint32_t now_us)
+{
+    if (align == NULL || !align->started) {
+        return 0;
+    }
+
+    int32_t diff = (int32_t)(align->next_output_us - now_us);
+    return diff > 0 ? (uint32_t)diff : 0;
+}
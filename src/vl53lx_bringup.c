@@ -0,0 +1,312 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_bringup.c
+ * @brief VL53LX Parallel Multi-Sensor Bring-Up Implementation
+ */
+
+#include "vl53lx_bringup.h"
+#include "vl53lx_platform.h"
+#include "vl53lx_core.h"
+#include "vl53lx_wait.h"
+#include <string.h>
+
+// Default configuration values
+#define DEFAULT_RESET_HOLD_US       1000
+#define DEFAULT_BOOT_TIME_US        VL53LX_FIRMWARE_BOOT_TIME_US
+#define DEFAULT_POLL_INTERVAL_US    500
+#define DEFAULT_BOOT_TIMEOUT_US     (VL53LX_BOOT_COMPLETION_POLLING_TIMEOUT_MS * 1000u)
+
+vl53lx_bringup_config_t VL53LX_BringupGetDefaultConfig(void)
+{
+    vl53lx_bringup_config_t config = {
+        .reset_hold_us = DEFAULT_RESET_HOLD_US,
+        .boot_time_us = DEFAULT_BOOT_TIME_US,
+        .poll_interval_us = DEFAULT_POLL_INTERVAL_US,
+        .boot_timeout_us = DEFAULT_BOOT_TIMEOUT_US,
+        .data_init = true,
+    };
+    return config;
+}
+
+bool VL53LX_BringupInit(vl53lx_bringup_t *bringup, const vl53lx_bringup_hal_t *hal)
+{
+    vl53lx_bringup_config_t config = VL53LX_BringupGetDefaultConfig();
+    return VL53LX_BringupInitWithConfig(bringup, hal, &config);
+}
+
+bool VL53LX_BringupInitWithConfig(vl53lx_bringup_t *bringup, const vl53lx_bringup_hal_t *hal,
+                                  const vl53lx_bringup_config_t *config)
+{
+    if (bringup == NULL || hal == NULL || config == NULL ||
+        hal->set_xshut == NULL || hal->bind == NULL || config->poll_interval_us == 0) {
+        return false;
+    }
+
+    memset(bringup, 0, sizeof(*bringup));
+    bringup->config = *config;
+    bringup->hal = *hal;
+    bringup->booting = -1;
+    bringup->initialized = true;
+
+    return true;
+}
+
+bool VL53LX_BringupAddDevice(vl53lx_bringup_t *bringup, VL53LX_DEV dev, uint8_t address,
+                             VL53LX_nvm_cache_t *nvm_cache)
+{
+    if (bringup == NULL || !bringup->initialized || bringup->started || dev == NULL ||
+        bringup->count >= VL53LX_BRINGUP_MAX_DEVICES || address == 0 || address > 0x7F) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < bringup->count; i++) {
+        if (bringup->devices[i].address == address) {
+            return false;
+        }
+    }
+
+    vl53lx_bringup_device_t *device = &bringup->devices[bringup->count];
+    memset(device, 0, sizeof(*device));
+    device->dev = dev;
+    device->nvm_cache = nvm_cache;
+    device->address = address;
+    device->state = VL53LX_BRINGUP_PENDING;
+    bringup->count++;
+
+    return true;
+}
+
+// Microseconds since an arbitrary origin, wraps; only differences are used
+static uint32_t bringup_now_us(void)
+{
+    int32_t freq_hz = 0;
+    int32_t ticks = 0;
+
+    if (VL53LX_GetTimerFrequency(&freq_hz) != VL53LX_ERROR_NONE || freq_hz <= 0 ||
+        VL53LX_GetTimerValue(&ticks) != VL53LX_ERROR_NONE) {
+        return 0;
+    }
+    if (freq_hz == 1000000) {
+        return (uint32_t)ticks;
+    }
+    return (uint32_t)((uint64_t)(uint32_t)ticks * 1000000u / (uint32_t)freq_hz);
+}
+
+static uint32_t bringup_elapsed_us(const vl53lx_bringup_t *bringup)
+{
+    return bringup_now_us() - bringup->start_us;
+}
+
+// Signed distance to a deadline, safe across timer wrap
+static int32_t bringup_until_us(const vl53lx_bringup_t *bringup, uint32_t deadline_us)
+{
+    return (int32_t)(deadline_us - bringup_elapsed_us(bringup));
+}
+
+static void bringup_fail(vl53lx_bringup_t *bringup, uint8_t index, VL53LX_Error error)
+{
+    vl53lx_bringup_device_t *device = &bringup->devices[index];
+
+    // Back into reset so that the default address is free for the next sensor
+    bringup->hal.set_xshut(bringup->hal.ctx, index, false);
+    device->state = VL53LX_BRINGUP_FAILED;
+    device->error = error;
+    if (bringup->booting == (int8_t)index) {
+        bringup->booting = -1;
+    }
+}
+
+bool VL53LX_BringupStart(vl53lx_bringup_t *bringup)
+{
+    if (bringup == NULL || !bringup->initialized || bringup->started || bringup->count == 0) {
+        return false;
+    }
+
+    // A sensor that keeps the default address must come out of reset last
+    uint8_t n = 0;
+    int8_t keeps_default = -1;
+    for (uint8_t i = 0; i < bringup->count; i++) {
+        if (bringup->devices[i].address == VL53LX_BRINGUP_DEFAULT_ADDRESS) {
+            keeps_default = (int8_t)i;
+        } else {
+            bringup->order[n++] = i;
+        }
+    }
+    if (keeps_default >= 0) {
+        bringup->order[n++] = (uint8_t)keeps_default;
+    }
+
+    for (uint8_t i = 0; i < bringup->count; i++) {
+        if (!bringup->hal.set_xshut(bringup->hal.ctx, i, false)) {
+            return false;
+        }
+    }
+    if (bringup->config.reset_hold_us > 0) {
+        VL53LX_WaitUs(bringup->devices[0].dev, (int32_t)bringup->config.reset_hold_us);
+    }
+
+    bringup->next_release = 0;
+    bringup->booting = -1;
+    bringup->start_us = bringup_now_us();
+    bringup->started = true;
+
+    return true;
+}
+
+// Release the next sensor in order, the default address is known to be free
+static void bringup_release(vl53lx_bringup_t *bringup)
+{
+    uint8_t index = bringup->order[bringup->next_release++];
+    vl53lx_bringup_device_t *device = &bringup->devices[index];
+
+    if (!bringup->hal.bind(bringup->hal.ctx, index, device->dev, VL53LX_BRINGUP_DEFAULT_ADDRESS) ||
+        !bringup->hal.set_xshut(bringup->hal.ctx, index, true)) {
+        bringup_fail(bringup, index, VL53LX_ERROR_CONTROL_INTERFACE);
+        return;
+    }
+
+    device->timing.release_us = bringup_elapsed_us(bringup);
+    device->next_poll_us = device->timing.release_us + bringup->config.boot_time_us;
+    device->state = VL53LX_BRINGUP_BOOTING;
+    bringup->booting = (int8_t)index;
+}
+
+// One boot status read; on completion move the sensor off the default address
+static void bringup_poll(vl53lx_bringup_t *bringup)
+{
+    uint8_t index = (uint8_t)bringup->booting;
+    vl53lx_bringup_device_t *device = &bringup->devices[index];
+    uint8_t ready = 0;
+
+    VL53LX_Error status = VL53LX_is_boot_complete(device->dev, &ready);
+    device->timing.boot_polls++;
+
+    if (status != VL53LX_ERROR_NONE || ready == 0) {
+        // A sensor still in its boot ROM may NACK, so errors count as not ready
+        uint32_t waited_us = bringup_elapsed_us(bringup) - device->timing.release_us;
+        if (waited_us >= bringup->config.boot_timeout_us) {
+            bringup_fail(bringup, index, status != VL53LX_ERROR_NONE ? status : VL53LX_ERROR_TIME_OUT);
+        } else {
+            device->next_poll_us += bringup->config.poll_interval_us;
+        }
+        return;
+    }
+
+    device->timing.booted_us = bringup_elapsed_us(bringup);
+    VL53LX_init_ll_driver_state(device->dev, VL53LX_DEVICESTATE_SW_STANDBY);
+
+    if (device->address != VL53LX_BRINGUP_DEFAULT_ADDRESS) {
+        status = VL53LX_SetDeviceAddress(device->dev, (uint8_t)(device->address << 1));
+        if (status != VL53LX_ERROR_NONE) {
+            bringup_fail(bringup, index, status);
+            return;
+        }
+        if (!bringup->hal.bind(bringup->hal.ctx, index, device->dev, device->address)) {
+            bringup_fail(bringup, index, VL53LX_ERROR_CONTROL_INTERFACE);
+            return;
+        }
+    }
+
+    device->timing.addressed_us = bringup_elapsed_us(bringup);
+    device->state = bringup->config.data_init ? VL53LX_BRINGUP_ADDRESSED : VL53LX_BRINGUP_READY;
+    if (!bringup->config.data_init) {
+        device->timing.init_start_us = device->timing.addressed_us;
+        device->timing.ready_us = device->timing.addressed_us;
+    }
+    bringup->booting = -1;
+}
+
+static void bringup_data_init(vl53lx_bringup_t *bringup, uint8_t index)
+{
+    vl53lx_bringup_device_t *device = &bringup->devices[index];
+
+    device->timing.init_start_us = bringup_elapsed_us(bringup);
+    if (bringup->hal.before_init != NULL &&
+        !bringup->hal.before_init(bringup->hal.ctx, index, device->dev)) {
+        bringup_fail(bringup, index, VL53LX_ERROR_CONTROL_INTERFACE);
+        return;
+    }
+
+    VL53LX_Error status = VL53LX_DataInitWithNvmCache(device->dev, device->nvm_cache);
+    if (status == VL53LX_ERROR_NONE && bringup->config.distance_mode != 0) {
+        status = VL53LX_SetDistanceMode(device->dev, bringup->config.distance_mode);
+    }
+    if (status == VL53LX_ERROR_NONE && bringup->config.cal_storage != NULL) {
+        // Only a device error fails the sensor; without a record it just needs calibrating
+        device->cal_status = VL53LX_CalStoreApply(device->dev, bringup->config.cal_storage);
+        if (device->cal_status == VL53LX_CAL_STORE_DEVICE_ERROR) {
+            status = VL53LX_ERROR_CONTROL_INTERFACE;
+        }
+    }
+    device->timing.ready_us = bringup_elapsed_us(bringup);
+
+    if (status != VL53LX_ERROR_NONE) {
+        bringup_fail(bringup, index, status);
+        return;
+    }
+    device->state = VL53LX_BRINGUP_READY;
+}
+
+uint32_t VL53LX_BringupStep(vl53lx_bringup_t *bringup)
+{
+    if (bringup == NULL || !bringup->started) {
+        return VL53LX_BRINGUP_DONE;
+    }
+
+    // Releasing first lets the next sensor boot while DataInit holds the bus
+    if (bringup->booting < 0 && bringup->next_release < bringup->count) {
+        bringup_release(bringup);
+        return 0;
+    }
+
+    if (bringup->booting >= 0) {
+        int32_t until_us = bringup_until_us(bringup, bringup->devices[bringup->booting].next_poll_us);
+        if (until_us <= 0) {
+            bringup_poll(bringup);
+            return 0;
+        }
+    }
+
+    for (uint8_t i = 0; i < bringup->count; i++) {
+        if (bringup->devices[i].state == VL53LX_BRINGUP_ADDRESSED) {
+            bringup_data_init(bringup, i);
+            return 0;
+        }
+    }
+
+    if (bringup->booting >= 0) {
+        int32_t until_us = bringup_until_us(bringup, bringup->devices[bringup->booting].next_poll_us);
+        return until_us > 0 ? (uint32_t)until_us : 0;
+    }
+
+    if (bringup->total_us == 0) {
+        bringup->total_us = bringup_elapsed_us(bringup);
+    }
+    return VL53LX_BRINGUP_DONE;
+}
+
+uint8_t VL53LX_BringupRun(vl53lx_bringup_t *bringup)
+{
+    if (!VL53LX_BringupStart(bringup)) {
+        return 0;
+    }
+
+    uint32_t wait_us;
+    while ((wait_us = VL53LX_BringupStep(bringup)) != VL53LX_BRINGUP_DONE) {
+        if (wait_us > 0) {
+            VL53LX_WaitUs(bringup->devices[0].dev, (int32_t)wait_us);
+        }
+    }
+
+    uint8_t ready = 0;
+    for (uint8_t i = 0; i < bringup->count; i++) {
+        if (bringup->devices[i].state == VL53LX_BRINGUP_READY) {
+            ready++;
+        }
+    }
+    return ready;
+}
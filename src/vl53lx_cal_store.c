@@ -0,0 +1,469 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_cal_store.c
+ * @brief VL53LX Persistent Calibration Store Implementation
+ */
+
+#include "vl53lx_cal_store.h"
+#include "vl53lx_core_support.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "nvs.h"
+#endif
+
+#define DRIVER_VERSION  VL53LX_PACK_VERSION(VL53LX_IMPLEMENTATION_VER_MAJOR, VL53LX_IMPLEMENTATION_VER_MINOR, \
+                                            VL53LX_IMPLEMENTATION_VER_SUB, VL53LX_IMPLEMENTATION_VER_REVISION)
+
+#define FILE_PATH_SIZE  128
+
+typedef struct {
+    vl53lx_cal_record_header_t header;
+    VL53LX_CalibrationData_t cal;
+} cal_record_t;
+
+typedef struct {
+    vl53lx_cal_record_header_t header;
+    VL53LX_nvm_cache_data_t data;
+} nvm_record_t;
+
+// Stored size: header and payload, without the tail padding of the record structs
+#define CAL_RECORD_SIZE (sizeof(vl53lx_cal_record_header_t) + sizeof(VL53LX_CalibrationData_t))
+#define NVM_RECORD_SIZE (sizeof(vl53lx_cal_record_header_t) + sizeof(VL53LX_nvm_cache_data_t))
+
+// The payload directly follows the header in every record type
+static uint32_t record_crc(const vl53lx_cal_record_header_t *record)
+{
+    vl53lx_cal_record_header_t header = *record;
+    header.crc32 = 0;
+
+    uint32_t crc = VL53LX_crc32(0, (const uint8_t *)&header, sizeof(header));
+    return VL53LX_crc32(crc, (const uint8_t *)(record + 1), record->payload_size);
+}
+
+static void record_seal(vl53lx_cal_record_header_t *record, uint32_t magic, size_t payload_size,
+                        uint32_t struct_version, uint64_t uid, uint8_t preset_mode)
+{
+    record->magic = magic;
+    record->format_version = VL53LX_CAL_STORE_FORMAT_VERSION;
+    record->payload_size = (uint16_t)payload_size;
+    record->driver_version = DRIVER_VERSION;
+    record->struct_version = struct_version;
+    record->uid = uid;
+    record->preset_mode = preset_mode;
+    record->crc32 = record_crc(record);
+}
+
+// Layout checks first: a foreign or older format cannot be CRC checked
+static vl53lx_cal_store_status_t record_check(const vl53lx_cal_record_header_t *record, size_t len,
+                                              uint32_t magic, size_t payload_size, uint64_t uid)
+{
+    if (len != sizeof(*record) + payload_size ||
+        record->magic != magic ||
+        record->format_version != VL53LX_CAL_STORE_FORMAT_VERSION ||
+        record->payload_size != payload_size) {
+        return VL53LX_CAL_STORE_CORRUPT;
+    }
+    if (record->crc32 != record_crc(record)) {
+        return VL53LX_CAL_STORE_CORRUPT;
+    }
+    if (record->uid != uid) {
+        return VL53LX_CAL_STORE_UID_MISMATCH;
+    }
+    if (record->driver_version != DRIVER_VERSION) {
+        return VL53LX_CAL_STORE_STALE;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+// DataInit keeps the UID it read with the factory calibration; before DataInit it takes an NVM session
+static VL53LX_Error device_uid(VL53LX_DEV Dev, uint64_t *uid)
+{
+    *uid = VL53LXDevStructGetLLDriverHandle(Dev)->nvm_uid;
+    if (*uid != 0) {
+        return VL53LX_ERROR_NONE;
+    }
+    return VL53LX_GetUID(Dev, uid);
+}
+
+static uint8_t device_preset_mode(VL53LX_DEV Dev)
+{
+    return (uint8_t)VL53LXDevStructGetLLDriverHandle(Dev)->preset_mode;
+}
+
+void VL53LX_CalStoreMakeKey(uint64_t uid, char key[VL53LX_CAL_STORE_KEY_SIZE])
+{
+    uint64_t folded = (uid ^ (uid >> 48)) & 0xFFFFFFFFFFFFull;
+
+    snprintf(key, VL53LX_CAL_STORE_KEY_SIZE, "cal%04X%08X",
+             (unsigned)(folded >> 32), (unsigned)(folded & 0xFFFFFFFFu));
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreSave(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage)
+{
+    if (Dev == NULL || storage == NULL || storage->write == NULL) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    cal_record_t record;
+    memset(&record, 0, sizeof(record));
+
+    uint64_t uid;
+    if (device_uid(Dev, &uid) != VL53LX_ERROR_NONE ||
+        VL53LX_GetCalibrationData(Dev, &record.cal) != VL53LX_ERROR_NONE) {
+        return VL53LX_CAL_STORE_DEVICE_ERROR;
+    }
+
+    record_seal(&record.header, VL53LX_CAL_STORE_MAGIC, sizeof(record.cal),
+                record.cal.struct_version, uid, device_preset_mode(Dev));
+
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    VL53LX_CalStoreMakeKey(uid, key);
+
+    if (!storage->write(storage->ctx, key, &record, CAL_RECORD_SIZE)) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+// Read and check a record; the key is returned for invalidation
+static vl53lx_cal_store_status_t load_record(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage,
+                                             cal_record_t *record, char key[VL53LX_CAL_STORE_KEY_SIZE])
+{
+    if (Dev == NULL || storage == NULL || storage->read == NULL) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    uint64_t uid;
+    if (device_uid(Dev, &uid) != VL53LX_ERROR_NONE) {
+        return VL53LX_CAL_STORE_DEVICE_ERROR;
+    }
+    VL53LX_CalStoreMakeKey(uid, key);
+
+    size_t len = 0;
+    if (!storage->read(storage->ctx, key, record, CAL_RECORD_SIZE, &len)) {
+        return VL53LX_CAL_STORE_NOT_FOUND;
+    }
+
+    vl53lx_cal_store_status_t status =
+        record_check(&record->header, len, VL53LX_CAL_STORE_MAGIC, sizeof(record->cal), uid);
+    if (status != VL53LX_CAL_STORE_OK) {
+        return status;
+    }
+    if (record->header.struct_version != record->cal.struct_version ||
+        record->header.preset_mode != device_preset_mode(Dev)) {
+        return VL53LX_CAL_STORE_STALE;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreLoad(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage,
+                                              VL53LX_CalibrationData_t *cal)
+{
+    if (cal == NULL) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    cal_record_t record;
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+
+    vl53lx_cal_store_status_t status = load_record(Dev, storage, &record, key);
+    if (status == VL53LX_CAL_STORE_OK) {
+        *cal = record.cal;
+    }
+
+    return status;
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreApply(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage)
+{
+    cal_record_t record;
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+
+    vl53lx_cal_store_status_t status = load_record(Dev, storage, &record, key);
+
+    if (status == VL53LX_CAL_STORE_CORRUPT || status == VL53LX_CAL_STORE_STALE) {
+        // Invalidate so the record is not checked again until recalibrated
+        if (storage->erase != NULL) {
+            storage->erase(storage->ctx, key);
+        }
+        return status;
+    }
+    if (status != VL53LX_CAL_STORE_OK) {
+        return status;
+    }
+
+    if (VL53LX_SetCalibrationData(Dev, &record.cal) != VL53LX_ERROR_NONE) {
+        return VL53LX_CAL_STORE_DEVICE_ERROR;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreErase(VL53LX_DEV Dev, const vl53lx_cal_storage_t *storage)
+{
+    if (Dev == NULL || storage == NULL || storage->erase == NULL) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    uint64_t uid;
+    if (device_uid(Dev, &uid) != VL53LX_ERROR_NONE) {
+        return VL53LX_CAL_STORE_DEVICE_ERROR;
+    }
+
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    VL53LX_CalStoreMakeKey(uid, key);
+
+    if (!storage->erase(storage->ctx, key)) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+//=============================================================================
+// NVM cache
+//=============================================================================
+
+static void make_nvm_key(uint8_t slot, char key[VL53LX_CAL_STORE_KEY_SIZE])
+{
+    snprintf(key, VL53LX_CAL_STORE_KEY_SIZE, "nvm%02X", (unsigned)slot);
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreLoadNvmCache(const vl53lx_cal_storage_t *storage, uint8_t slot,
+                                                      VL53LX_nvm_cache_t *cache)
+{
+    if (storage == NULL || storage->read == NULL || cache == NULL) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    cache->valid = 0;
+
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    make_nvm_key(slot, key);
+
+    nvm_record_t record;
+    size_t len = 0;
+    if (!storage->read(storage->ctx, key, &record, NVM_RECORD_SIZE, &len)) {
+        return VL53LX_CAL_STORE_NOT_FOUND;
+    }
+
+    // The sensor is not asked: DataInit matches the cache against the part
+    vl53lx_cal_store_status_t status =
+        record_check(&record.header, len, VL53LX_NVM_CACHE_STORE_MAGIC, sizeof(record.data), record.header.uid);
+    if (status != VL53LX_CAL_STORE_OK) {
+        return status;
+    }
+    if (record.header.struct_version != VL53LX_NVM_CACHE_STRUCT_VERSION ||
+        record.data.struct_version != VL53LX_NVM_CACHE_STRUCT_VERSION ||
+        record.data.uid != record.header.uid) {
+        return VL53LX_CAL_STORE_STALE;
+    }
+
+    cache->data = record.data;
+    cache->valid = 1;
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+vl53lx_cal_store_status_t VL53LX_CalStoreSaveNvmCache(const vl53lx_cal_storage_t *storage, uint8_t slot,
+                                                      const VL53LX_nvm_cache_t *cache)
+{
+    if (storage == NULL || storage->write == NULL || cache == NULL || !cache->valid) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    nvm_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.data = cache->data;
+
+    record_seal(&record.header, VL53LX_NVM_CACHE_STORE_MAGIC, sizeof(record.data),
+                VL53LX_NVM_CACHE_STRUCT_VERSION, cache->data.uid, 0);
+
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    make_nvm_key(slot, key);
+
+    if (!storage->write(storage->ctx, key, &record, NVM_RECORD_SIZE)) {
+        return VL53LX_CAL_STORE_STORAGE_ERROR;
+    }
+
+    return VL53LX_CAL_STORE_OK;
+}
+
+//=============================================================================
+// File backend
+//=============================================================================
+
+static bool file_path(const void *ctx, const char *key, const char *suffix, char *path)
+{
+    int n = snprintf(path, FILE_PATH_SIZE, "%s/%s%s", (const char *)ctx, key, suffix);
+    return n > 0 && n < FILE_PATH_SIZE;
+}
+
+static bool file_read(void *ctx, const char *key, void *buf, size_t size, size_t *out_len)
+{
+    char path[FILE_PATH_SIZE];
+    if (!file_path(ctx, key, ".bin", path)) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+
+    // Read one byte past the buffer so an oversized record shows in out_len
+    uint8_t extra;
+    size_t len = fread(buf, 1, size, f);
+    if (len == size && fread(&extra, 1, 1, f) == 1) {
+        len++;
+    }
+    fclose(f);
+
+    *out_len = len;
+    return true;
+}
+
+static bool file_write(void *ctx, const char *key, const void *buf, size_t size)
+{
+    char path[FILE_PATH_SIZE];
+    char tmp_path[FILE_PATH_SIZE];
+    if (!file_path(ctx, key, ".bin", path) || !file_path(ctx, key, ".tmp", tmp_path)) {
+        return false;
+    }
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+
+    bool ok = fwrite(buf, 1, size, f) == size;
+    ok = (fclose(f) == 0) && ok;
+
+    if (ok) {
+        remove(path);   // rename() does not replace on every VFS
+        ok = rename(tmp_path, path) == 0;
+    }
+    if (!ok) {
+        remove(tmp_path);
+    }
+
+    return ok;
+}
+
+static bool file_erase(void *ctx, const char *key)
+{
+    char path[FILE_PATH_SIZE];
+    if (!file_path(ctx, key, ".bin", path)) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return true;    // Nothing to erase
+    }
+    fclose(f);
+
+    return remove(path) == 0;
+}
+
+bool VL53LX_CalStorageInitFile(vl53lx_cal_storage_t *storage, const char *directory)
+{
+    if (storage == NULL || directory == NULL) {
+        return false;
+    }
+
+    storage->read = file_read;
+    storage->write = file_write;
+    storage->erase = file_erase;
+    storage->ctx = (void *)directory;
+
+    return true;
+}
+
+//=============================================================================
+// ESP-IDF NVS backend
+//=============================================================================
+
+#ifdef ESP_PLATFORM
+
+static bool nvs_backend_read(void *ctx, const char *key, void *buf, size_t size, size_t *out_len)
+{
+    nvs_handle_t handle;
+    if (nvs_open((const char *)ctx, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    // Query the stored length first: nvs_get_blob() fails on short buffers
+    size_t len = 0;
+    esp_err_t ret = nvs_get_blob(handle, key, NULL, &len);
+    if (ret == ESP_OK && len == size) {
+        ret = nvs_get_blob(handle, key, buf, &len);
+    }
+    nvs_close(handle);
+
+    if (ret != ESP_OK) {
+        return false;
+    }
+
+    *out_len = len;
+    return true;
+}
+
+static bool nvs_backend_write(void *ctx, const char *key, const void *buf, size_t size)
+{
+    nvs_handle_t handle;
+    if (nvs_open((const char *)ctx, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+
+    esp_err_t ret = nvs_set_blob(handle, key, buf, size);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    return ret == ESP_OK;
+}
+
+static bool nvs_backend_erase(void *ctx, const char *key)
+{
+    nvs_handle_t handle;
+    if (nvs_open((const char *)ctx, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+
+    esp_err_t ret = nvs_erase_key(handle, key);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    } else if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        ret = ESP_OK;
+    }
+    nvs_close(handle);
+
+    return ret == ESP_OK;
+}
+
+bool VL53LX_CalStorageInitNvs(vl53lx_cal_storage_t *storage, const char *nvs_namespace)
+{
+    if (storage == NULL || nvs_namespace == NULL || strlen(nvs_namespace) > NVS_KEY_NAME_MAX_SIZE - 1) {
+        return false;
+    }
+
+    storage->read = nvs_backend_read;
+    storage->write = nvs_backend_write;
+    storage->erase = nvs_backend_erase;
+    storage->ctx = (void *)nvs_namespace;
+
+    return true;
+}
+
+#endif // ESP_PLATFORM
@@ -16,6 +16,24 @@
 #define DEFAULT_VALID_STATUS_MASK   0x01    // Only status 0 (valid) by default
 #define DEFAULT_KALMAN_Q            1.0f    // Process noise (responsive)
 #define DEFAULT_KALMAN_R            4.0f    // Measurement noise (~2mm std)
+#define INITIAL_KALMAN_P            1000.0f // High initial uncertainty
+
+// Fixed point: distance in Q16.16, variances in Q12.20, gain in Q2.30
+#define Q16_HALF                    (1u << 15)
+#define Q20_ONE                     (1u << 20)
+#define Q20_MAX                     UINT32_MAX
+#define GAIN_SHIFT                  30
+#define GAIN_ONE                    (1u << GAIN_SHIFT)
+#define GAIN_HALF                   (1u << (GAIN_SHIFT - 1))
+
+// Adaptive update: R from sigma and signal rate, rate limit per second
+#define DEFAULT_ADAPTIVE_SIGMA_SCALE    1.0f    // R = sigma^2
+#define DEFAULT_ADAPTIVE_SIGNAL_NOISE   0.0f    // Sigma already reflects the signal rate
+#define DEFAULT_ADAPTIVE_NOISE_MIN      1.0f    // 1 mm std
+#define DEFAULT_ADAPTIVE_NOISE_MAX      2500.0f // 50 mm std
+#define DEFAULT_MAX_CHANGE_RATE_MM_S    15000   // 500 mm at 33 ms
+#define MIN_RATE_LIMIT_MM               1       // Samples microseconds apart still pass an unchanged distance
+#define MAX_RATE_LIMIT_MM               (UINT16_MAX / 3)  // x3 after a reset must not wrap
 
 vl53lx_filter_config_t VL53LX_FilterGetDefaultConfig(void)
 {
@@ -26,6 +44,12 @@ vl53lx_filter_config_t VL53LX_FilterGetDefaultConfig(void)
         .valid_status_mask = DEFAULT_VALID_STATUS_MASK,
         .kalman_process_noise = DEFAULT_KALMAN_Q,
         .kalman_measurement_noise = DEFAULT_KALMAN_R,
+        .fixed_point = false,
+        .adaptive_sigma_scale = DEFAULT_ADAPTIVE_SIGMA_SCALE,
+        .adaptive_signal_noise = DEFAULT_ADAPTIVE_SIGNAL_NOISE,
+        .adaptive_noise_min = DEFAULT_ADAPTIVE_NOISE_MIN,
+        .adaptive_noise_max = DEFAULT_ADAPTIVE_NOISE_MAX,
+        .max_change_rate_mm_s = DEFAULT_MAX_CHANGE_RATE_MM_S,
     };
     return config;
 }
@@ -36,6 +60,30 @@ bool VL53LX_FilterInit(vl53lx_filter_t *filter)
     return VL53LX_FilterInitWithConfig(filter, &config);
 }
 
+// Only at init, so that the fixed-point update has no floating point
+static uint32_t filter_to_q20(float value)
+{
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    if (value >= (float)Q20_MAX / Q20_ONE) {
+        return Q20_MAX;
+    }
+    return (uint32_t)(value * Q20_ONE + 0.5f);
+}
+
+static void filter_reset_kalman(vl53lx_filter_t *filter)
+{
+    if (filter->config.fixed_point) {
+        filter->kalman_x_q16 = 0;
+        filter->kalman_p_q20 = (uint32_t)INITIAL_KALMAN_P * Q20_ONE;
+    } else {
+        filter->kalman_x = 0.0f;
+        filter->kalman_p = INITIAL_KALMAN_P;
+    }
+    filter->kalman_initialized = false;
+}
+
 bool VL53LX_FilterInitWithConfig(vl53lx_filter_t *filter, const vl53lx_filter_config_t *config)
 {
     if (filter == NULL || config == NULL) {
@@ -52,8 +100,18 @@ bool VL53LX_FilterInitWithConfig(vl53lx_filter_t *filter, const vl53lx_filter_co
 
     // Initialize Kalman filter state
     filter->kalman_x = 0.0f;
-    filter->kalman_p = 1000.0f;  // High initial uncertainty
-    filter->kalman_initialized = false;
+    filter->kalman_p = INITIAL_KALMAN_P;
+    filter->kalman_q_q20 = filter_to_q20(config->kalman_process_noise);
+    filter->kalman_r_q20 = filter_to_q20(config->kalman_measurement_noise);
+    filter_reset_kalman(filter);
+
+    // Adaptive update
+    filter->adaptive_sigma_scale_q20 = filter_to_q20(config->adaptive_sigma_scale);
+    filter->adaptive_signal_noise_q20 = filter_to_q20(config->adaptive_signal_noise);
+    filter->adaptive_noise_min_q20 = filter_to_q20(config->adaptive_noise_min);
+    filter->adaptive_noise_max_q20 = filter_to_q20(config->adaptive_noise_max);
+    filter->last_accept_us = 0;
+    filter->has_accept_time = false;
 
     filter->initialized = true;
 
@@ -78,11 +136,10 @@ void VL53LX_FilterReset(vl53lx_filter_t *filter)
     filter->last_output = 0;
     filter->rejected_count = 0;
     filter->samples_since_reset = 0;
+    filter->has_accept_time = false;
 
     // Reset Kalman filter
-    filter->kalman_x = 0.0f;
-    filter->kalman_p = 1000.0f;
-    filter->kalman_initialized = false;
+    filter_reset_kalman(filter);
 }
 
 bool VL53LX_FilterIsValidRangeStatus(uint8_t range_status)
@@ -93,12 +150,56 @@ bool VL53LX_FilterIsValidRangeStatus(uint8_t range_status)
     return (range_status == 0);
 }
 
-bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status, uint16_t *output_mm)
+static uint32_t filter_add_saturate(uint32_t a, uint32_t b)
 {
-    if (filter == NULL || !filter->initialized || output_mm == NULL) {
-        return false;
+    return a > UINT32_MAX - b ? UINT32_MAX : a + b;
+}
+
+// Same steps as the float filter, with 64-bit intermediates
+static bool filter_kalman_q16(uint32_t *x, uint32_t *p, bool *kalman_initialized, uint32_t q, uint32_t r,
+                              uint16_t distance_mm, bool valid, uint16_t *filtered_value)
+{
+    uint32_t z = (uint32_t)distance_mm << 16;
+
+    if (!*kalman_initialized) {
+        // Initialize with first measurement (only if valid)
+        if (!valid) {
+            return false;
+        }
+        *x = z;
+        *p = r;
+        *kalman_initialized = true;
+        *filtered_value = distance_mm;
+        return true;
     }
 
+    // Prediction step (always execute)
+    uint32_t p_pred = filter_add_saturate(*p, q);
+
+    if (valid) {
+        // Kalman gain K = P / (P + R), 0..1
+        uint32_t denominator = filter_add_saturate(p_pred, r);
+        uint32_t K = denominator > 0 ? (uint32_t)(((uint64_t)p_pred << GAIN_SHIFT) / denominator) : GAIN_ONE;
+
+        // x += K * (z - x), rounded to nearest; |z - x| < 2^32 and K <= 2^30 fit in 64 bits
+        int64_t step = (int64_t)K * ((int64_t)z - (int64_t)*x);
+        step += step >= 0 ? (int64_t)GAIN_HALF : -(int64_t)GAIN_HALF;
+        *x = (uint32_t)((int64_t)*x + step / (int64_t)GAIN_ONE);
+        *p = (uint32_t)(((uint64_t)(GAIN_ONE - K) * p_pred + GAIN_HALF) >> GAIN_SHIFT);
+    } else {
+        // Observation invalid: prediction only (uncertainty increases)
+        *p = p_pred;
+    }
+
+    // Round to nearest integer
+    *filtered_value = (uint16_t)(filter_add_saturate(*x, Q16_HALF) >> 16);
+    return true;
+}
+
+// One sample with the given rate limit and measurement noise R (float or Q12.20, per mode)
+static bool filter_update(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status, uint16_t rate_limit_mm,
+                          float R, uint32_t r_q20, bool *accepted, uint16_t *output_mm)
+{
     bool status_valid = true;
     bool rate_valid = true;
 
@@ -121,9 +222,9 @@ bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t
         int32_t change = (int32_t)distance_mm - (int32_t)filter->last_output;
 
         // After reset, allow larger changes for first few samples
-        uint16_t effective_rate_limit = filter->config.max_change_rate_mm;
+        uint16_t effective_rate_limit = rate_limit_mm;
         if (filter->samples_since_reset < 3) {
-            effective_rate_limit = filter->config.max_change_rate_mm * 3;  // 3x more lenient
+            effective_rate_limit = rate_limit_mm * 3;  // 3x more lenient
         }
 
         if (abs(change) > effective_rate_limit) {
@@ -143,14 +244,22 @@ bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t
         filter->rejected_count = 0;
     }
 
+    *accepted = status_valid && rate_valid;
+
     // Kalman filter
     uint16_t filtered_value;
 
-    if (!filter->kalman_initialized) {
+    if (filter->config.fixed_point) {
+        if (!filter_kalman_q16(&filter->kalman_x_q16, &filter->kalman_p_q20, &filter->kalman_initialized,
+                               filter->kalman_q_q20, r_q20, distance_mm, status_valid && rate_valid,
+                               &filtered_value)) {
+            return false;
+        }
+    } else if (!filter->kalman_initialized) {
         // Initialize with first measurement (only if valid)
         if (status_valid && rate_valid) {
             filter->kalman_x = (float)distance_mm;
-            filter->kalman_p = filter->config.kalman_measurement_noise;
+            filter->kalman_p = R;
             filter->kalman_initialized = true;
             filtered_value = distance_mm;
         } else {
@@ -160,7 +269,6 @@ bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t
     } else {
         // Kalman filter update
         float Q = filter->config.kalman_process_noise;
-        float R = filter->config.kalman_measurement_noise;
 
         // Prediction step (always execute)
         float x_pred = filter->kalman_x;  // No state transition for stationary model
@@ -191,3 +299,275 @@ bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t
 
     return true;
 }
+
+bool VL53LX_FilterUpdate(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status, uint16_t *output_mm)
+{
+    if (filter == NULL || !filter->initialized || output_mm == NULL) {
+        return false;
+    }
+
+    bool accepted;
+    return filter_update(filter, distance_mm, range_status, filter->config.max_change_rate_mm,
+                         filter->config.kalman_measurement_noise, filter->kalman_r_q20, &accepted, output_mm);
+}
+
+size_t VL53LX_FilterUpdateBatch(vl53lx_filter_t *filter, const uint16_t *distance_mm, const uint8_t *range_status,
+                                size_t count, uint16_t *output_mm, bool *output_valid)
+{
+    if (filter == NULL || !filter->initialized || distance_mm == NULL || range_status == NULL ||
+        output_mm == NULL) {
+        return 0;
+    }
+
+    // Checks once per batch instead of once per sample
+    size_t valid_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool accepted;
+        bool valid = filter_update(filter, distance_mm[i], range_status[i], filter->config.max_change_rate_mm,
+                                   filter->config.kalman_measurement_noise, filter->kalman_r_q20, &accepted,
+                                   &output_mm[i]);
+        if (output_valid != NULL) {
+            output_valid[i] = valid;
+        }
+        valid_count += valid;
+    }
+
+    return valid_count;
+}
+
+// R = (scale * sigma)^2 + c / signal rate, clamped; sigma and signal rate in Q16.16
+static float filter_adaptive_noise(const vl53lx_filter_config_t *config, uint32_t sigma_mm, uint32_t signal_rate_mcps)
+{
+    float sigma = config->adaptive_sigma_scale * (float)sigma_mm * (1.0f / 65536.0f);
+    float R = sigma * sigma;
+
+    if (config->adaptive_signal_noise > 0.0f) {
+        // No signal: as noisy as allowed
+        R += signal_rate_mcps > 0 ? config->adaptive_signal_noise * 65536.0f / (float)signal_rate_mcps
+                                  : config->adaptive_noise_max;
+    }
+
+    if (R > config->adaptive_noise_max) {
+        R = config->adaptive_noise_max;
+    }
+    if (R < config->adaptive_noise_min) {
+        R = config->adaptive_noise_min;
+    }
+    return R;
+}
+
+// Same mapping in Q12.20, saturating at 4096 mm^2
+static uint32_t filter_adaptive_noise_q20(const vl53lx_filter_t *filter, uint32_t sigma_mm, uint32_t signal_rate_mcps)
+{
+    // Q16.16 sigma squared is Q32; 64 mm and above saturate
+    uint64_t sigma_q16 = ((uint64_t)sigma_mm * filter->adaptive_sigma_scale_q20) >> 20;
+    uint32_t r = sigma_q16 >= (64u << 16) ? Q20_MAX : (uint32_t)((sigma_q16 * sigma_q16) >> 12);
+
+    if (filter->adaptive_signal_noise_q20 > 0) {
+        uint64_t term = signal_rate_mcps > 0 ? ((uint64_t)filter->adaptive_signal_noise_q20 << 16) / signal_rate_mcps
+                                             : Q20_MAX;
+        r = filter_add_saturate(r, term > Q20_MAX ? Q20_MAX : (uint32_t)term);
+    }
+
+    if (r > filter->adaptive_noise_max_q20) {
+        r = filter->adaptive_noise_max_q20;
+    }
+    if (r < filter->adaptive_noise_min_q20) {
+        r = filter->adaptive_noise_min_q20;
+    }
+    return r;
+}
+
+bool VL53LX_FilterUpdateAdaptive(vl53lx_filter_t *filter, uint16_t distance_mm, uint8_t range_status,
+                                 uint32_t sigma_mm, uint32_t signal_rate_mcps, uint32_t timestamp_us,
+                                 uint16_t *output_mm)
+{
+    if (filter == NULL || !filter->initialized || output_mm == NULL) {
+        return false;
+    }
+
+    // Rate limit over the time since the last accepted sample, so that gaps and
+    // slower timing budgets allow proportionally larger changes
+    uint16_t rate_limit_mm = filter->config.max_change_rate_mm;
+    if (filter->config.max_change_rate_mm_s > 0 && filter->has_accept_time) {
+        // Rounded up, so that a short interval does not truncate the limit to zero
+        uint64_t limit = ((uint64_t)filter->config.max_change_rate_mm_s * (timestamp_us - filter->last_accept_us) +
+                          999999u) / 1000000u;
+        rate_limit_mm = limit > MAX_RATE_LIMIT_MM   ? MAX_RATE_LIMIT_MM
+                        : limit < MIN_RATE_LIMIT_MM ? MIN_RATE_LIMIT_MM
+                                                    : (uint16_t)limit;
+    }
+
+    float R = 0.0f;
+    uint32_t r_q20 = 0;
+    if (filter->config.fixed_point) {
+        r_q20 = filter_adaptive_noise_q20(filter, sigma_mm, signal_rate_mcps);
+    } else {
+        R = filter_adaptive_noise(&filter->config, sigma_mm, signal_rate_mcps);
+    }
+
+    bool accepted;
+    bool valid = filter_update(filter, distance_mm, range_status, rate_limit_mm, R, r_q20, &accepted, output_mm);
+    if (accepted) {
+        filter->last_accept_us = timestamp_us;
+        filter->has_accept_time = true;
+    }
+
+    return valid;
+}
+
+//=============================================================================
+// Multi-channel filter bank (structure of arrays)
+//=============================================================================
+
+static void filter_bank_reset_channel(vl53lx_filter_bank_t *bank, uint8_t c)
+{
+    bank->last_output[c] = 0;
+    bank->rejected_count[c] = 0;
+    bank->samples_since_reset[c] = 0;
+    bank->kalman_x[c] = 0.0f;
+    bank->kalman_p[c] = INITIAL_KALMAN_P;
+    bank->kalman_x_q16[c] = 0;
+    bank->kalman_p_q20[c] = (uint32_t)INITIAL_KALMAN_P * Q20_ONE;
+    bank->kalman_initialized[c] = 0;
+}
+
+bool VL53LX_FilterBankInit(vl53lx_filter_bank_t *bank, const vl53lx_filter_config_t *config, uint8_t channels)
+{
+    if (bank == NULL || config == NULL || channels == 0 || channels > VL53LX_FILTER_BANK_MAX_CHANNELS) {
+        return false;
+    }
+
+    bank->config = *config;
+    bank->channels = channels;
+    bank->kalman_q_q20 = filter_to_q20(config->kalman_process_noise);
+    bank->kalman_r_q20 = filter_to_q20(config->kalman_measurement_noise);
+    for (uint8_t c = 0; c < VL53LX_FILTER_BANK_MAX_CHANNELS; c++) {
+        filter_bank_reset_channel(bank, c);
+    }
+    bank->initialized = true;
+
+    return true;
+}
+
+void VL53LX_FilterBankReset(vl53lx_filter_bank_t *bank)
+{
+    if (bank == NULL || !bank->initialized) {
+        return;
+    }
+
+    for (uint8_t c = 0; c < bank->channels; c++) {
+        filter_bank_reset_channel(bank, c);
+    }
+}
+
+// Status and rate checks of one channel, as in filter_update()
+static bool filter_bank_check(vl53lx_filter_bank_t *bank, const vl53lx_filter_config_t *config, uint8_t c,
+                              uint16_t distance_mm, uint8_t range_status)
+{
+    bool status_valid = true;
+    bool rate_valid = true;
+
+    if (config->enable_status_check && !((1 << range_status) & config->valid_status_mask)) {
+        status_valid = false;
+        bank->rejected_count[c]++;
+        if (bank->rejected_count[c] >= 5) {
+            filter_bank_reset_channel(bank, c);
+        }
+    }
+
+    if (config->enable_rate_limit && bank->kalman_initialized[c]) {
+        int32_t change = (int32_t)distance_mm - (int32_t)bank->last_output[c];
+        uint16_t effective_rate_limit = config->max_change_rate_mm;
+        if (bank->samples_since_reset[c] < 3) {
+            effective_rate_limit = config->max_change_rate_mm * 3;
+        }
+        if (abs(change) > effective_rate_limit) {
+            rate_valid = false;
+            bank->rejected_count[c]++;
+            if (bank->rejected_count[c] >= 5) {
+                filter_bank_reset_channel(bank, c);
+            }
+        }
+    }
+
+    if (status_valid && rate_valid) {
+        bank->rejected_count[c] = 0;
+    }
+    return status_valid && rate_valid;
+}
+
+uint8_t VL53LX_FilterBankUpdate(vl53lx_filter_bank_t *bank, const uint16_t *distance_mm,
+                                const uint8_t *range_status, uint16_t *output_mm, bool *output_valid)
+{
+    if (bank == NULL || !bank->initialized || distance_mm == NULL || range_status == NULL || output_mm == NULL) {
+        return 0;
+    }
+
+    const uint8_t n = bank->channels;
+    uint8_t accepted[VL53LX_FILTER_BANK_MAX_CHANNELS];
+    uint8_t valid[VL53LX_FILTER_BANK_MAX_CHANNELS];
+    uint16_t filtered[VL53LX_FILTER_BANK_MAX_CHANNELS];
+
+    // Pass 1: checks, branchy but cheap. The local copy keeps the configuration
+    // in registers across the state stores
+    const vl53lx_filter_config_t config = bank->config;
+    for (uint8_t c = 0; c < n; c++) {
+        accepted[c] = filter_bank_check(bank, &config, c, distance_mm[c], range_status[c]);
+    }
+
+    // Pass 2: Kalman step of every channel
+    if (bank->config.fixed_point) {
+        // The 64-bit division does not vectorise
+        for (uint8_t c = 0; c < n; c++) {
+            bool initialized = bank->kalman_initialized[c];
+            valid[c] = filter_kalman_q16(&bank->kalman_x_q16[c], &bank->kalman_p_q20[c], &initialized,
+                                         bank->kalman_q_q20, bank->kalman_r_q20, distance_mm[c], accepted[c],
+                                         &filtered[c]);
+            bank->kalman_initialized[c] = initialized;
+        }
+    } else {
+        // Branch-free: compute the update for every channel, then select. Vectorises
+        // where the compiler may if-convert float operations (-fno-trapping-math)
+        const float Q = bank->config.kalman_process_noise;
+        const float R = bank->config.kalman_measurement_noise;
+        for (uint8_t c = 0; c < n; c++) {
+            float x_pred = bank->kalman_x[c];
+            float p_pred = bank->kalman_p[c] + Q;
+            float K = p_pred / (p_pred + R);
+            float z = (float)distance_mm[c];
+            float x_update = x_pred + K * (z - x_pred);
+            float p_update = (1.0f - K) * p_pred;
+            uint8_t initialized = bank->kalman_initialized[c];
+            uint8_t accept = accepted[c];
+
+            float x = initialized ? (accept ? x_update : x_pred) : (accept ? z : x_pred);
+            float p = initialized ? (accept ? p_update : p_pred) : (accept ? R : bank->kalman_p[c]);
+            uint16_t rounded = (uint16_t)(int32_t)(x + 0.5f);  // Same as via uint16_t, x is 0..65535
+
+            bank->kalman_x[c] = x;
+            bank->kalman_p[c] = p;
+            bank->kalman_initialized[c] = initialized | accept;
+            valid[c] = initialized | accept;
+            filtered[c] = initialized ? rounded : distance_mm[c];
+        }
+    }
+
+    // Pass 3: outputs, left unchanged where not valid as with VL53LX_FilterUpdate()
+    uint8_t valid_count = 0;
+    for (uint8_t c = 0; c < n; c++) {
+        if (valid[c]) {
+            output_mm[c] = filtered[c];
+            bank->last_output[c] = filtered[c];
+            valid_count++;
+        }
+        if (accepted[c] && bank->samples_since_reset[c] < 255) {
+            bank->samples_since_reset[c]++;
+        }
+        if (output_valid != NULL) {
+            output_valid[c] = valid[c];
+        }
+    }
+
+    return valid_count;
+}
@@ -17,6 +17,8 @@
 #include "vl53lx_hist_structs.h"
 #include "vl53lx_hist_funcs.h"
 #include "vl53lx_xtalk.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_scratch.h"
 
 
 #define LOG_FUNCTION_START(fmt, ...) \
@@ -42,7 +44,16 @@ VL53LX_Error VL53LX_ipp_hist_process_data(
 
 	VL53LX_Error status         = VL53LX_ERROR_NONE;
 
-	SUPPRESS_UNUSED_WARNING(Dev);
+	VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(Dev);
+
+	VL53LX_scratch_t *pscratch = VL53LX_get_scratch(Dev);
+	uint16_t scratch_mark = VL53LX_scratch_mark(pscratch);
+	VL53LX_hist_gen3_dmax_private_data_t *pdmax_algo =
+		VL53LX_SCRATCH_ALLOC(pscratch,
+			VL53LX_hist_gen3_dmax_private_data_t);
+
+	if (pdmax_algo == NULL)
+		return VL53LX_ERROR_BUFFER_TOO_SMALL;
 
 	status =
 		VL53LX_hist_process_data(
@@ -51,11 +62,16 @@ VL53LX_Error VL53LX_ipp_hist_process_data(
 			ppost_cfg,
 			pbins,
 			pxtalk,
+			&(pdev->dmax_cache),
+			&(pdev->hist_gate),
+			pdmax_algo,
 			pArea1,
 			pArea2,
 			presults,
 			phisto_merge_nb);
 
+	VL53LX_scratch_release(pscratch, scratch_mark);
+
 	return status;
 }
 
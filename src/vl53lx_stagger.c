@@ -0,0 +1,227 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_stagger.c
+ * @brief VL53LX Phase-Staggered Ranging Schedule Implementation
+ */
+
+#include "vl53lx_stagger.h"
+#include <string.h>
+
+// Default configuration values
+#define DEFAULT_GUARD_US            1000    // Gap between windows, covers measurement time spread
+#define DEFAULT_START_BUS_US        1700    // ClearInterruptAndStartMeasurement at 400 kHz
+#define DEFAULT_READOUT_BUS_US      2100    // GetMultiRangingData at 400 kHz
+#define PERIOD_ROUND_US             1000    // Automatic period granularity
+
+typedef struct {
+    uint32_t start_us;
+    uint32_t length_us;
+} window_t;
+
+vl53lx_stagger_config_t VL53LX_StaggerGetDefaultConfig(void)
+{
+    vl53lx_stagger_config_t config = {
+        .frame_period_us = 0,
+        .guard_us = DEFAULT_GUARD_US,
+        .start_bus_us = DEFAULT_START_BUS_US,
+        .readout_bus_us = DEFAULT_READOUT_BUS_US,
+    };
+    return config;
+}
+
+bool VL53LX_StaggerInit(vl53lx_stagger_t *stagger)
+{
+    vl53lx_stagger_config_t config = VL53LX_StaggerGetDefaultConfig();
+    return VL53LX_StaggerInitWithConfig(stagger, &config);
+}
+
+bool VL53LX_StaggerInitWithConfig(vl53lx_stagger_t *stagger, const vl53lx_stagger_config_t *config)
+{
+    if (stagger == NULL || config == NULL) {
+        return false;
+    }
+
+    memset(stagger, 0, sizeof(*stagger));
+    stagger->config = *config;
+    stagger->initialized = true;
+
+    return true;
+}
+
+int VL53LX_StaggerAddSensor(vl53lx_stagger_t *stagger, uint32_t measure_us)
+{
+    if (stagger == NULL || !stagger->initialized || stagger->planned ||
+        stagger->count >= VL53LX_STAGGER_MAX_SENSORS || measure_us == 0) {
+        return -1;
+    }
+
+    vl53lx_stagger_slot_t *slot = &stagger->slots[stagger->count];
+    memset(slot, 0, sizeof(*slot));
+    slot->measure_us = measure_us;
+
+    return stagger->count++;
+}
+
+// Smallest gap between consecutive windows on a circle of period_us
+static int32_t min_circular_gap(window_t *windows, uint8_t n, uint32_t period_us)
+{
+    // Insertion sort by start, n is at most 2 * VL53LX_STAGGER_MAX_SENSORS
+    for (uint8_t i = 1; i < n; i++) {
+        window_t w = windows[i];
+        uint8_t j = i;
+        while (j > 0 && windows[j - 1].start_us > w.start_us) {
+            windows[j] = windows[j - 1];
+            j--;
+        }
+        windows[j] = w;
+    }
+
+    int32_t margin = INT32_MAX;
+    for (uint8_t i = 0; i < n; i++) {
+        const window_t *cur = &windows[i];
+        uint32_t next_start = (i + 1 < n) ? windows[i + 1].start_us : windows[0].start_us + period_us;
+        int32_t gap = (int32_t)(next_start - cur->start_us) - (int32_t)cur->length_us;
+        if (gap < margin) {
+            margin = gap;
+        }
+    }
+    return margin;
+}
+
+bool VL53LX_StaggerPlan(vl53lx_stagger_t *stagger)
+{
+    if (stagger == NULL || !stagger->initialized || stagger->count == 0) {
+        return false;
+    }
+
+    const vl53lx_stagger_config_t *config = &stagger->config;
+    uint32_t measure_max_us = 0;
+    for (uint8_t i = 0; i < stagger->count; i++) {
+        if (stagger->slots[i].measure_us > measure_max_us) {
+            measure_max_us = stagger->slots[i].measure_us;
+        }
+    }
+
+    // Ranging begins when the start transfer ends; a sensor cannot restart
+    // before its own readout, whatever the period
+    uint32_t sensor_period_us = config->start_bus_us + measure_max_us + config->readout_bus_us + config->guard_us;
+    uint32_t period_us = config->frame_period_us;
+    if (period_us == 0) {
+        // Next start after the previous readout: no emission and no bus overlap
+        period_us = stagger->count * sensor_period_us;
+        period_us = (period_us + PERIOD_ROUND_US - 1) / PERIOD_ROUND_US * PERIOD_ROUND_US;
+    } else if (period_us < sensor_period_us) {
+        period_us = sensor_period_us;
+    }
+    stagger->period_us = period_us;
+
+    window_t emission[VL53LX_STAGGER_MAX_SENSORS];
+    window_t bus[2 * VL53LX_STAGGER_MAX_SENSORS];
+    for (uint8_t i = 0; i < stagger->count; i++) {
+        vl53lx_stagger_slot_t *slot = &stagger->slots[i];
+        slot->phase_us = (uint32_t)((uint64_t)period_us * i / stagger->count);
+
+        emission[i].start_us = (slot->phase_us + config->start_bus_us) % period_us;
+        emission[i].length_us = slot->measure_us;
+        bus[2 * i].start_us = slot->phase_us;
+        bus[2 * i].length_us = config->start_bus_us;
+        bus[2 * i + 1].start_us = (slot->phase_us + config->start_bus_us + slot->measure_us) % period_us;
+        bus[2 * i + 1].length_us = config->readout_bus_us;
+    }
+    stagger->emission_margin_us = min_circular_gap(emission, stagger->count, period_us);
+    stagger->bus_idle_margin_us = min_circular_gap(bus, 2 * stagger->count, period_us);
+    stagger->planned = true;
+
+    return true;
+}
+
+void VL53LX_StaggerBegin(vl53lx_stagger_t *stagger, uint32_t now_us)
+{
+    if (stagger == NULL || !stagger->planned) {
+        return;
+    }
+
+    stagger->epoch_us = now_us;
+    for (uint8_t i = 0; i < stagger->count; i++) {
+        vl53lx_stagger_slot_t *slot = &stagger->slots[i];
+        slot->next_start_us = now_us + slot->phase_us;
+        slot->pending = true;
+    }
+}
+
+uint32_t VL53LX_StaggerDue(const vl53lx_stagger_t *stagger, uint32_t now_us)
+{
+    if (stagger == NULL || !stagger->planned) {
+        return 0;
+    }
+
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < stagger->count; i++) {
+        const vl53lx_stagger_slot_t *slot = &stagger->slots[i];
+        if (slot->pending && (int32_t)(slot->next_start_us - now_us) <= 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+uint32_t VL53LX_StaggerUntilNext(const vl53lx_stagger_t *stagger, uint32_t now_us)
+{
+    if (stagger == NULL || !stagger->planned) {
+        return VL53LX_STAGGER_NONE;
+    }
+
+    uint32_t until_us = VL53LX_STAGGER_NONE;
+    for (uint8_t i = 0; i < stagger->count; i++) {
+        const vl53lx_stagger_slot_t *slot = &stagger->slots[i];
+        if (!slot->pending) {
+            continue;
+        }
+        int32_t diff = (int32_t)(slot->next_start_us - now_us);
+        uint32_t wait_us = diff > 0 ? (uint32_t)diff : 0;
+        if (wait_us < until_us) {
+            until_us = wait_us;
+        }
+    }
+    return until_us;
+}
+
+void VL53LX_StaggerStarted(vl53lx_stagger_t *stagger, uint8_t index, uint32_t now_us)
+{
+    if (stagger == NULL || index >= stagger->count) {
+        return;
+    }
+
+    vl53lx_stagger_slot_t *slot = &stagger->slots[index];
+    int32_t error_us = (int32_t)(now_us - slot->next_start_us);
+    uint32_t abs_error_us = error_us < 0 ? (uint32_t)-error_us : (uint32_t)error_us;
+
+    slot->last_start_us = now_us;
+    slot->pending = false;
+    slot->starts++;
+    slot->phase_error_us = error_us;
+    slot->phase_error_sum_us += abs_error_us;
+    if (abs_error_us > slot->phase_error_max_us) {
+        slot->phase_error_max_us = abs_error_us;
+    }
+}
+
+void VL53LX_StaggerRearm(vl53lx_stagger_t *stagger, uint8_t index, uint32_t now_us)
+{
+    if (stagger == NULL || index >= stagger->count) {
+        return;
+    }
+
+    // From the target, not the actual start, so that errors do not accumulate
+    vl53lx_stagger_slot_t *slot = &stagger->slots[index];
+    slot->next_start_us += stagger->period_us;
+    while ((int32_t)(slot->next_start_us - now_us) < 0) {
+        slot->next_start_us += stagger->period_us;
+        slot->skipped_frames++;
+    }
+    slot->pending = true;
+}
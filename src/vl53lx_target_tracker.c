@@ -0,0 +1,297 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_target_tracker.c
+ * @brief VL53LX Frame-to-Frame Multi-Target Tracker Implementation
+ */
+
+#include "vl53lx_target_tracker.h"
+#include <string.h>
+#include <math.h>
+
+// Default configuration values
+#define DEFAULT_GATE_RANGE_MM       300     // 300mm association gate
+#define DEFAULT_GATE_SIGNAL_RATIO   4.0f    // Signal may change 4x between frames
+#define DEFAULT_SIGNAL_COST_MM      50.0f   // 2x signal change costs as much as 50mm
+#define DEFAULT_VALID_STATUS_MASK   0x01    // Only status 0 (valid) by default
+#define DEFAULT_CONFIRM_HITS        3
+#define DEFAULT_MAX_MISSES          5
+#define DEFAULT_ALPHA               0.5f
+#define DEFAULT_BETA                0.2f
+
+#define MAX_PAIRS   (VL53LX_TRACKER_MAX_TRACKS * VL53LX_MAX_RANGE_RESULTS)
+#define NO_TARGET   0xFF
+
+typedef struct {
+    float cost;
+    uint8_t track;
+    uint8_t target;
+} tracker_pair_t;
+
+vl53lx_tracker_config_t VL53LX_TrackerGetDefaultConfig(void)
+{
+    vl53lx_tracker_config_t config = {
+        .association = VL53LX_TRACKER_ASSOC_GATED,
+        .gate_range_mm = DEFAULT_GATE_RANGE_MM,
+        .gate_signal_ratio = DEFAULT_GATE_SIGNAL_RATIO,
+        .signal_cost_mm = DEFAULT_SIGNAL_COST_MM,
+        .valid_status_mask = DEFAULT_VALID_STATUS_MASK,
+        .confirm_hits = DEFAULT_CONFIRM_HITS,
+        .max_misses = DEFAULT_MAX_MISSES,
+        .alpha = DEFAULT_ALPHA,
+        .beta = DEFAULT_BETA,
+    };
+    return config;
+}
+
+bool VL53LX_TrackerInit(vl53lx_tracker_t *tracker)
+{
+    vl53lx_tracker_config_t config = VL53LX_TrackerGetDefaultConfig();
+    return VL53LX_TrackerInitWithConfig(tracker, &config);
+}
+
+bool VL53LX_TrackerInitWithConfig(vl53lx_tracker_t *tracker, const vl53lx_tracker_config_t *config)
+{
+    if (tracker == NULL || config == NULL) {
+        return false;
+    }
+
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->config = *config;
+    tracker->next_id = 1;
+    tracker->initialized = true;
+
+    return true;
+}
+
+void VL53LX_TrackerReset(vl53lx_tracker_t *tracker)
+{
+    if (tracker == NULL || !tracker->initialized) {
+        return;
+    }
+
+    memset(tracker->tracks, 0, sizeof(tracker->tracks));
+    tracker->has_timestamp = false;
+}
+
+// Association cost of a target for a track, negative if outside the gates
+static float tracker_cost(const vl53lx_tracker_t *tracker, const vl53lx_track_t *track,
+                          float range_mm, float signal_mcps)
+{
+    float cost = fabsf(range_mm - track->range_mm);
+
+    if (cost > (float)tracker->config.gate_range_mm) {
+        return -1.0f;
+    }
+
+    if (tracker->config.association == VL53LX_TRACKER_ASSOC_GATED &&
+        track->signal_mcps > 0.0f && signal_mcps > 0.0f) {
+        float ratio = (signal_mcps > track->signal_mcps) ?
+                      signal_mcps / track->signal_mcps : track->signal_mcps / signal_mcps;
+        if (ratio > tracker->config.gate_signal_ratio) {
+            return -1.0f;
+        }
+        cost += tracker->config.signal_cost_mm * (ratio - 1.0f);
+    }
+
+    return cost;
+}
+
+static void tracker_correct(const vl53lx_tracker_t *tracker, vl53lx_track_t *track,
+                            float range_mm, float signal_mcps, float dt_s)
+{
+    float residual = range_mm - track->range_mm;
+
+    if (track->hits == 1 && dt_s > 0.0f) {
+        // Second detection: two-point velocity initialisation
+        track->velocity_mm_s = residual / dt_s;
+        track->range_mm = range_mm;
+    } else {
+        track->range_mm += tracker->config.alpha * residual;
+        if (dt_s > 0.0f) {
+            track->velocity_mm_s += tracker->config.beta * residual / dt_s;
+        }
+    }
+
+    track->signal_mcps += tracker->config.alpha * (signal_mcps - track->signal_mcps);
+
+    if (track->hits < 255) {
+        track->hits++;
+    }
+    track->misses = 0;
+
+    if (track->state == VL53LX_TRACK_TENTATIVE && track->hits >= tracker->config.confirm_hits) {
+        track->state = VL53LX_TRACK_CONFIRMED;
+    }
+}
+
+static void tracker_birth(vl53lx_tracker_t *tracker, uint8_t target, float range_mm, float signal_mcps)
+{
+    for (uint8_t i = 0; i < VL53LX_TRACKER_MAX_TRACKS; i++) {
+        vl53lx_track_t *track = &tracker->tracks[i];
+        if (track->state != VL53LX_TRACK_FREE) {
+            continue;
+        }
+
+        memset(track, 0, sizeof(*track));
+        track->id = tracker->next_id++;
+        if (tracker->next_id == 0) {
+            tracker->next_id = 1;  // 0 is reserved for "no track"
+        }
+        track->state = (tracker->config.confirm_hits <= 1) ?
+                       VL53LX_TRACK_CONFIRMED : VL53LX_TRACK_TENTATIVE;
+        track->range_mm = range_mm;
+        track->signal_mcps = signal_mcps;
+        track->hits = 1;
+        track->target_index = target;
+        return;
+    }
+    // All slots busy: the target is dropped for this frame
+}
+
+uint8_t VL53LX_TrackerUpdate(vl53lx_tracker_t *tracker, const VL53LX_MultiRangingData_t *data,
+                             uint32_t timestamp_ms)
+{
+    if (tracker == NULL || !tracker->initialized || data == NULL) {
+        return 0;
+    }
+
+    float dt_s = 0.0f;
+    if (tracker->has_timestamp) {
+        dt_s = (float)(uint32_t)(timestamp_ms - tracker->last_timestamp_ms) * 0.001f;
+    }
+    tracker->last_timestamp_ms = timestamp_ms;
+    tracker->has_timestamp = true;
+
+    // Collect valid detections
+    float range_mm[VL53LX_MAX_RANGE_RESULTS];
+    float signal_mcps[VL53LX_MAX_RANGE_RESULTS];
+    bool valid[VL53LX_MAX_RANGE_RESULTS];
+    bool used[VL53LX_MAX_RANGE_RESULTS];
+    uint8_t targets = data->NumberOfObjectsFound;
+    if (targets > VL53LX_MAX_RANGE_RESULTS) {
+        targets = VL53LX_MAX_RANGE_RESULTS;
+    }
+
+    for (uint8_t j = 0; j < targets; j++) {
+        const VL53LX_TargetRangeData_t *target = &data->RangeData[j];
+        valid[j] = target->RangeStatus < 32 &&
+                   ((1UL << target->RangeStatus) & tracker->config.valid_status_mask) != 0;
+        range_mm[j] = (float)target->RangeMilliMeter;
+        signal_mcps[j] = (float)target->SignalRateRtnMegaCps / 65536.0f;
+        used[j] = false;
+    }
+
+    // Predict and build the gated candidate list, sorted by cost
+    tracker_pair_t pairs[MAX_PAIRS];
+    uint8_t pair_count = 0;
+
+    for (uint8_t i = 0; i < VL53LX_TRACKER_MAX_TRACKS; i++) {
+        vl53lx_track_t *track = &tracker->tracks[i];
+        if (track->state == VL53LX_TRACK_FREE) {
+            continue;
+        }
+
+        track->range_mm += track->velocity_mm_s * dt_s;
+        track->target_index = NO_TARGET;
+
+        for (uint8_t j = 0; j < targets; j++) {
+            if (!valid[j]) {
+                continue;
+            }
+            float cost = tracker_cost(tracker, track, range_mm[j], signal_mcps[j]);
+            if (cost < 0.0f) {
+                continue;
+            }
+
+            // Insertion sort; on equal cost confirmed tracks come first
+            uint8_t k = pair_count++;
+            while (k > 0 &&
+                   (pairs[k - 1].cost > cost ||
+                    (pairs[k - 1].cost == cost && track->state == VL53LX_TRACK_CONFIRMED &&
+                     tracker->tracks[pairs[k - 1].track].state != VL53LX_TRACK_CONFIRMED))) {
+                pairs[k] = pairs[k - 1];
+                k--;
+            }
+            pairs[k].cost = cost;
+            pairs[k].track = i;
+            pairs[k].target = j;
+        }
+    }
+
+    // Greedy assignment, cheapest pair first
+    for (uint8_t p = 0; p < pair_count; p++) {
+        vl53lx_track_t *track = &tracker->tracks[pairs[p].track];
+        uint8_t j = pairs[p].target;
+        if (used[j] || track->target_index != NO_TARGET) {
+            continue;
+        }
+
+        used[j] = true;
+        track->target_index = j;
+        tracker_correct(tracker, track, range_mm[j], signal_mcps[j], dt_s);
+    }
+
+    // Age unmatched tracks
+    for (uint8_t i = 0; i < VL53LX_TRACKER_MAX_TRACKS; i++) {
+        vl53lx_track_t *track = &tracker->tracks[i];
+        if (track->state == VL53LX_TRACK_FREE || track->target_index != NO_TARGET) {
+            continue;
+        }
+
+        if (track->misses < 255) {
+            track->misses++;
+        }
+        if (track->state == VL53LX_TRACK_TENTATIVE || track->misses >= tracker->config.max_misses) {
+            track->state = VL53LX_TRACK_FREE;
+        }
+    }
+
+    // Start tracks for unmatched detections
+    for (uint8_t j = 0; j < targets; j++) {
+        if (valid[j] && !used[j]) {
+            tracker_birth(tracker, j, range_mm[j], signal_mcps[j]);
+        }
+    }
+
+    uint8_t confirmed = 0;
+    for (uint8_t i = 0; i < VL53LX_TRACKER_MAX_TRACKS; i++) {
+        if (tracker->tracks[i].state == VL53LX_TRACK_CONFIRMED) {
+            confirmed++;
+        }
+    }
+
+    return confirmed;
+}
+
+uint8_t VL53LX_TrackerGetTracks(const vl53lx_tracker_t *tracker, vl53lx_track_t *tracks, uint8_t max_tracks)
+{
+    if (tracker == NULL || !tracker->initialized || tracks == NULL) {
+        return 0;
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < VL53LX_TRACKER_MAX_TRACKS; i++) {
+        const vl53lx_track_t *track = &tracker->tracks[i];
+        if (track->state != VL53LX_TRACK_CONFIRMED) {
+            continue;
+        }
+
+        // Insertion into the output, nearest first, keeping the closest max_tracks
+        uint8_t k = (count < max_tracks) ? count++ : max_tracks;
+        while (k > 0 && tracks[k - 1].range_mm > track->range_mm) {
+            if (k < max_tracks) {
+                tracks[k] = tracks[k - 1];
+            }
+            k--;
+        }
+        if (k < max_tracks) {
+            tracks[k] = *track;
+        }
+    }
+
+    return count;
+}
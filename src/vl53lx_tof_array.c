@@ -0,0 +1,671 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_tof_array.c
+ * @brief VL53LX N-Sensor Array Manager Implementation
+ */
+
+#include "vl53lx_tof_array.h"
+#include "vl53lx_platform.h"
+#include "vl53lx_scratch.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+static const char *TAG = "VL53LX_TOF_ARRAY";
+#endif
+
+// Default configuration values
+#define DEFAULT_TASK_STACK_SIZE     4096
+#define DEFAULT_TASK_PRIORITY       5
+#define DEFAULT_POLL_TIMEOUT_MS     200
+#define DEFAULT_POLL_INTERVAL_US    2000
+#define DEFAULT_TIMING_BUDGET_US    33000
+
+// Task notification bits above the sensor bits
+#define NOTIFY_STOP                 (1u << 31)
+#define NOTIFY_TIMER                (1u << 30)
+
+_Static_assert(VL53LX_TOF_ARRAY_MAX_SENSORS <= 30, "sensor bits must stay below the notification bits");
+_Static_assert(VL53LX_TOF_ARRAY_MAX_SENSORS <= VL53LX_BRINGUP_MAX_DEVICES, "every sensor needs a bring-up slot");
+
+vl53lx_tof_array_config_t VL53LX_TofArrayGetDefaultConfig(void)
+{
+    vl53lx_tof_array_config_t config = {
+        .on_sample = NULL,
+        .ctx = NULL,
+        .task_stack_size = DEFAULT_TASK_STACK_SIZE,
+        .task_priority = DEFAULT_TASK_PRIORITY,
+        .poll_timeout_ms = DEFAULT_POLL_TIMEOUT_MS,
+        .poll_interval_us = DEFAULT_POLL_INTERVAL_US,
+        .staggered = false,
+        .stagger = VL53LX_StaggerGetDefaultConfig(),
+    };
+    return config;
+}
+
+vl53lx_tof_sensor_config_t VL53LX_TofArrayGetDefaultSensorConfig(void)
+{
+    vl53lx_tof_sensor_config_t config = {
+        .name = NULL,
+        .xshut_gpio = VL53LX_TOF_ARRAY_NO_GPIO,
+        .int_gpio = VL53LX_TOF_ARRAY_NO_GPIO,
+        .address = VL53LX_BRINGUP_DEFAULT_ADDRESS,
+        .distance_mode = VL53LX_DISTANCEMODE_MEDIUM,
+        .timing_budget_us = DEFAULT_TIMING_BUDGET_US,
+    };
+    return config;
+}
+
+bool VL53LX_TofArrayInit(vl53lx_tof_array_t *array)
+{
+    vl53lx_tof_array_config_t config = VL53LX_TofArrayGetDefaultConfig();
+    return VL53LX_TofArrayInitWithConfig(array, &config);
+}
+
+bool VL53LX_TofArrayInitWithConfig(vl53lx_tof_array_t *array, const vl53lx_tof_array_config_t *config)
+{
+    if (array == NULL || config == NULL || config->poll_timeout_ms == 0 || config->poll_interval_us == 0) {
+        return false;
+    }
+
+    memset(array, 0, sizeof(*array));
+    array->config = *config;
+#ifdef VL53LX_SCRATCH_SHARED
+    VL53LX_scratch_init(&array->scratch, array->scratch_buffer.words, sizeof(array->scratch_buffer));
+#endif
+    array->initialized = true;
+
+    return true;
+}
+
+int VL53LX_TofArrayAddSensor(vl53lx_tof_array_t *array, const vl53lx_tof_sensor_config_t *config,
+                             VL53LX_DEV dev)
+{
+    if (array == NULL || !array->initialized || config == NULL || dev == NULL ||
+        array->count >= VL53LX_TOF_ARRAY_MAX_SENSORS || config->address == 0 || config->address > 0x7F) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < array->count; i++) {
+        if (array->sensors[i].config.address == config->address) {
+            return -1;
+        }
+    }
+
+    vl53lx_tof_sensor_t *sensor = &array->sensors[array->count];
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->config = *config;
+    sensor->dev = dev;
+    sensor->array = array;
+    sensor->index = array->count;
+    sensor->slot = -1;
+    if (config->int_gpio == VL53LX_TOF_ARRAY_NO_GPIO) {
+        array->poll_mask |= 1u << array->count;
+    }
+
+    return array->count++;
+}
+
+// Microseconds since an arbitrary origin, wraps; only differences are used
+static uint32_t tof_array_now_us(void)
+{
+    int32_t freq_hz = 0;
+    int32_t ticks = 0;
+
+    if (VL53LX_GetTimerFrequency(&freq_hz) != VL53LX_ERROR_NONE || freq_hz <= 0 ||
+        VL53LX_GetTimerValue(&ticks) != VL53LX_ERROR_NONE) {
+        return 0;
+    }
+    if (freq_hz == 1000000) {
+        return (uint32_t)ticks;
+    }
+    return (uint32_t)((uint64_t)(uint32_t)ticks * 1000000u / (uint32_t)freq_hz);
+}
+
+static VL53LX_Error tof_array_configure(vl53lx_tof_array_t *array, vl53lx_tof_sensor_t *sensor)
+{
+    VL53LX_Error status = VL53LX_ERROR_NONE;
+
+#ifdef VL53LX_SCRATCH_SHARED
+    // Bring-up runs DataInit on the device's own arena; the registration
+    // survives later DataInit calls
+    status = VL53LX_set_scratch_arena(sensor->dev, &array->scratch);
+#else
+    (void)array;
+#endif
+    if (status == VL53LX_ERROR_NONE) {
+        status = VL53LX_SetDistanceMode(sensor->dev, sensor->config.distance_mode);
+    }
+    if (status == VL53LX_ERROR_NONE && sensor->config.timing_budget_us > 0) {
+        status = VL53LX_SetMeasurementTimingBudgetMicroSeconds(sensor->dev, sensor->config.timing_budget_us);
+    }
+
+    return status;
+}
+
+uint8_t VL53LX_TofArrayBringupWithHal(vl53lx_tof_array_t *array, const vl53lx_bringup_hal_t *hal)
+{
+    if (array == NULL || !array->initialized || array->count == 0) {
+        return 0;
+    }
+
+    vl53lx_bringup_t bringup;
+    if (!VL53LX_BringupInit(&bringup, hal)) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        sensor->ready = false;
+        if (!VL53LX_BringupAddDevice(&bringup, sensor->dev, sensor->config.address, NULL)) {
+            return 0;
+        }
+    }
+
+    VL53LX_BringupRun(&bringup);
+
+    uint8_t ready = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        if (bringup.devices[i].state != VL53LX_BRINGUP_READY) {
+            sensor->stats.errors++;
+            continue;
+        }
+        if (tof_array_configure(array, sensor) != VL53LX_ERROR_NONE) {
+            sensor->stats.errors++;
+            continue;
+        }
+        sensor->ready = true;
+        ready++;
+    }
+
+    return ready;
+}
+
+static void tof_array_start(vl53lx_tof_array_t *array, vl53lx_tof_sensor_t *sensor)
+{
+    uint32_t now_us = tof_array_now_us();
+    VL53LX_Error status;
+
+    if (sensor->running) {
+        status = VL53LX_ClearInterruptAndStartMeasurement(sensor->dev);
+    } else {
+        status = VL53LX_StartMeasurement(sensor->dev);
+        sensor->running = status == VL53LX_ERROR_NONE;
+    }
+    if (status != VL53LX_ERROR_NONE) {
+        sensor->stats.errors++;
+    }
+
+    // A failed start is retried one frame later
+    VL53LX_StaggerStarted(&array->stagger, (uint8_t)sensor->slot, now_us);
+    if (status != VL53LX_ERROR_NONE) {
+        VL53LX_StaggerRearm(&array->stagger, (uint8_t)sensor->slot, now_us);
+    } else {
+        sensor->waiting = false;
+    }
+}
+
+static uint8_t tof_array_plan(vl53lx_tof_array_t *array)
+{
+    if (!VL53LX_StaggerInitWithConfig(&array->stagger, &array->config.stagger)) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        sensor->slot = -1;
+        sensor->waiting = false;
+        if (!sensor->ready) {
+            continue;
+        }
+
+        uint32_t measure_us = sensor->config.timing_budget_us;
+        if (measure_us == 0 &&
+            VL53LX_GetMeasurementTimingBudgetMicroSeconds(sensor->dev, &measure_us) != VL53LX_ERROR_NONE) {
+            sensor->stats.errors++;
+            continue;
+        }
+        sensor->slot = (int8_t)VL53LX_StaggerAddSensor(&array->stagger, measure_us);
+        sensor->waiting = sensor->slot >= 0;
+    }
+
+    if (!VL53LX_StaggerPlan(&array->stagger)) {
+        return 0;
+    }
+    VL53LX_StaggerBegin(&array->stagger, tof_array_now_us());
+    VL53LX_TofArrayRunDue(array);
+
+    return array->stagger.count;
+}
+
+uint8_t VL53LX_TofArrayStartRanging(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || !array->initialized) {
+        return 0;
+    }
+
+    array->poll_us = tof_array_now_us();
+    array->event_us = array->poll_us;
+    if (array->config.staggered) {
+        return tof_array_plan(array);
+    }
+
+    uint8_t running = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        if (sensor->ready && !sensor->running) {
+            sensor->ready_us = tof_array_now_us();
+            if (VL53LX_StartMeasurement(sensor->dev) == VL53LX_ERROR_NONE) {
+                sensor->running = true;
+            } else {
+                sensor->stats.errors++;
+            }
+        }
+        if (sensor->running) {
+            running++;
+        }
+    }
+
+    return running;
+}
+
+void VL53LX_TofArrayStopRanging(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || !array->initialized) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        if (sensor->running) {
+            VL53LX_StopMeasurement(sensor->dev);
+            sensor->running = false;
+        }
+        sensor->waiting = false;
+        sensor->slot = -1;
+    }
+    array->stagger.planned = false;
+}
+
+static uint32_t tof_array_poll(vl53lx_tof_array_t *array, uint32_t poll_mask)
+{
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        uint8_t ready = 0;
+        if ((poll_mask & (1u << i)) != 0 && sensor->running && !sensor->waiting &&
+            VL53LX_GetMeasurementDataReady(sensor->dev, &ready) == VL53LX_ERROR_NONE && ready) {
+            sensor->ready_us = tof_array_now_us();
+            mask |= 1u << i;
+        }
+    }
+
+    return mask;
+}
+
+uint32_t VL53LX_TofArrayPollReady(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || !array->initialized) {
+        return 0;
+    }
+
+    return tof_array_poll(array, UINT32_MAX);
+}
+
+uint32_t VL53LX_TofArrayCollectReady(vl53lx_tof_array_t *array, uint32_t notified)
+{
+    if (array == NULL || !array->initialized) {
+        return 0;
+    }
+
+    uint32_t now_us = tof_array_now_us();
+    uint32_t ready = notified & ((1u << array->count) - 1u);
+    if (ready != 0) {
+        array->event_us = now_us;
+    }
+
+    // Sensors without an INT pin run on their own period, interrupts of the others do not delay them
+    if (array->poll_mask != 0 && now_us - array->poll_us >= array->config.poll_interval_us) {
+        array->poll_us = now_us;
+        ready |= tof_array_poll(array, array->poll_mask & ~ready);
+    }
+
+    // A missed edge leaves its sensor stopped; no interrupt for a while, poll them all
+    if (now_us - array->event_us >= array->config.poll_timeout_ms * 1000u) {
+        array->event_us = now_us;
+        ready |= tof_array_poll(array, ~ready);
+    }
+
+    return ready;
+}
+
+uint32_t VL53LX_TofArrayRunDue(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || !array->initialized || !array->config.staggered) {
+        return VL53LX_STAGGER_NONE;
+    }
+
+    // Starts take bus time, so check again until nothing is due
+    uint32_t due;
+    while ((due = VL53LX_StaggerDue(&array->stagger, tof_array_now_us())) != 0) {
+        for (uint8_t i = 0; i < array->count; i++) {
+            vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+            if (sensor->slot >= 0 && (due & (1u << sensor->slot)) != 0) {
+                tof_array_start(array, sensor);
+            }
+        }
+    }
+
+    return VL53LX_StaggerUntilNext(&array->stagger, tof_array_now_us());
+}
+
+uint8_t VL53LX_TofArrayService(vl53lx_tof_array_t *array, uint32_t ready_mask)
+{
+    if (array == NULL || !array->initialized) {
+        return 0;
+    }
+
+    uint8_t published = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        if ((ready_mask & (1u << i)) == 0 || !sensor->running || sensor->waiting) {
+            continue;
+        }
+
+        VL53LX_Error status = VL53LX_GetMultiRangingData(sensor->dev, &array->data);
+        if (status == VL53LX_ERROR_NONE) {
+            vl53lx_tof_sample_t sample = {
+                .index = i,
+                .name = sensor->config.name,
+                .ready_us = sensor->ready_us,
+                .latency_us = tof_array_now_us() - sensor->ready_us,
+                .data = &array->data,
+            };
+
+            sensor->stats.samples++;
+            sensor->stats.latency_sum_us += sample.latency_us;
+            if (sample.latency_us > sensor->stats.latency_max_us) {
+                sensor->stats.latency_max_us = sample.latency_us;
+            }
+            if (array->config.on_sample != NULL) {
+                array->config.on_sample(array->config.ctx, &sample);
+            }
+            published++;
+        } else {
+            sensor->stats.errors++;
+        }
+
+        // Restart after a failed read too, or the sensor stops ranging
+        if (sensor->slot >= 0) {
+            VL53LX_StaggerRearm(&array->stagger, (uint8_t)sensor->slot, tof_array_now_us());
+            sensor->waiting = true;
+        } else if (VL53LX_ClearInterruptAndStartMeasurement(sensor->dev) != VL53LX_ERROR_NONE) {
+            sensor->stats.errors++;
+        }
+    }
+
+    return published;
+}
+
+//=============================================================================
+// ESP-IDF bring-up and service task
+//=============================================================================
+
+#ifdef ESP_PLATFORM
+
+typedef struct {
+    vl53lx_tof_array_t *array;
+    i2c_master_bus_handle_t bus;
+} tof_array_bringup_ctx_t;
+
+static bool tof_array_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    const tof_array_bringup_ctx_t *bringup = (const tof_array_bringup_ctx_t *)ctx;
+    int gpio = bringup->array->sensors[index].config.xshut_gpio;
+
+    if (gpio == VL53LX_TOF_ARRAY_NO_GPIO) {
+        return true;
+    }
+    return gpio_set_level((gpio_num_t)gpio, release ? 1 : 0) == ESP_OK;
+}
+
+static bool tof_array_bind(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address)
+{
+    const tof_array_bringup_ctx_t *bringup = (const tof_array_bringup_ctx_t *)ctx;
+    (void)index;
+
+    if (dev->I2cHandle != NULL) {
+        VL53LX_PlatformDeinit(dev);
+    }
+    return VL53LX_PlatformInit(dev, bringup->bus, address) == VL53LX_ERROR_NONE;
+}
+
+uint8_t VL53LX_TofArrayBringup(vl53lx_tof_array_t *array, i2c_master_bus_handle_t bus)
+{
+    if (array == NULL || !array->initialized || bus == NULL) {
+        return 0;
+    }
+
+    uint64_t xshut_mask = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        if (array->sensors[i].config.xshut_gpio != VL53LX_TOF_ARRAY_NO_GPIO) {
+            xshut_mask |= 1ULL << array->sensors[i].config.xshut_gpio;
+        }
+    }
+    if (xshut_mask != 0) {
+        gpio_config_t io_conf = {
+            .pin_bit_mask = xshut_mask,
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_DISABLE,
+        };
+        if (gpio_config(&io_conf) != ESP_OK) {
+            ESP_LOGE(TAG, "XSHUT GPIO config failed");
+            return 0;
+        }
+    }
+
+    tof_array_bringup_ctx_t ctx = {
+        .array = array,
+        .bus = bus,
+    };
+    vl53lx_bringup_hal_t hal = {
+        .set_xshut = tof_array_set_xshut,
+        .bind = tof_array_bind,
+        .before_init = NULL,
+        .ctx = &ctx,
+    };
+    uint8_t ready = VL53LX_TofArrayBringupWithHal(array, &hal);
+
+    for (uint8_t i = 0; i < array->count; i++) {
+        const vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+        ESP_LOGI(TAG, "Sensor %u (%s) at 0x%02X: %s", i, sensor->config.name ? sensor->config.name : "-",
+                 sensor->config.address, sensor->ready ? "ready" : "failed");
+    }
+
+    return ready;
+}
+
+static void IRAM_ATTR tof_array_isr(void *arg)
+{
+    vl53lx_tof_sensor_t *sensor = (vl53lx_tof_sensor_t *)arg;
+    TaskHandle_t task = (TaskHandle_t)sensor->array->task;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (task == NULL) {
+        return;
+    }
+
+    sensor->ready_us = (uint32_t)esp_timer_get_time();
+    xTaskNotifyFromISR(task, 1u << sensor->index, eSetBits, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Only this task calls into the driver once the array is started
+static void tof_array_task(void *arg)
+{
+    vl53lx_tof_array_t *array = (vl53lx_tof_array_t *)arg;
+    TickType_t timeout = pdMS_TO_TICKS(array->config.poll_timeout_ms);
+    if (array->poll_mask != 0) {
+        // Wake up for the sensors without an INT pin, at most once per tick
+        TickType_t poll = pdMS_TO_TICKS(array->config.poll_interval_us / 1000);
+        timeout = poll == 0 ? 1 : (poll < timeout ? poll : timeout);
+    }
+
+    // Set before the first interrupt can come, xTaskCreate() may not have returned yet
+    array->task = xTaskGetCurrentTaskHandle();
+    VL53LX_TofArrayStartRanging(array);
+
+    while (!array->stop) {
+        // Tick resolution is too coarse for the phases, the timer wakes the task
+        uint32_t until_us = VL53LX_TofArrayRunDue(array);
+        if (until_us != VL53LX_STAGGER_NONE) {
+            esp_timer_stop((esp_timer_handle_t)array->timer);
+            esp_timer_start_once((esp_timer_handle_t)array->timer, until_us > 0 ? until_us : 1);
+        }
+
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &bits, timeout) != pdTRUE) {
+            bits = 0;
+        }
+        if ((bits & NOTIFY_STOP) != 0 || array->stop) {
+            break;
+        }
+        VL53LX_TofArrayService(array, VL53LX_TofArrayCollectReady(array, bits));
+    }
+
+    if (array->timer != NULL) {
+        esp_timer_stop((esp_timer_handle_t)array->timer);
+    }
+
+    VL53LX_TofArrayStopRanging(array);
+    array->task = NULL;
+    vTaskDelete(NULL);
+}
+
+static void tof_array_timer_cb(void *arg)
+{
+    vl53lx_tof_array_t *array = (vl53lx_tof_array_t *)arg;
+    TaskHandle_t task = (TaskHandle_t)array->task;
+
+    if (task != NULL) {
+        xTaskNotify(task, NOTIFY_TIMER, eSetBits);
+    }
+}
+
+static void tof_array_remove_isr(vl53lx_tof_array_t *array)
+{
+    for (uint8_t i = 0; i < array->count; i++) {
+        if (array->sensors[i].config.int_gpio != VL53LX_TOF_ARRAY_NO_GPIO) {
+            gpio_isr_handler_remove((gpio_num_t)array->sensors[i].config.int_gpio);
+        }
+    }
+}
+
+bool VL53LX_TofArrayStart(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || !array->initialized || array->task != NULL) {
+        return false;
+    }
+
+    uint64_t int_mask = 0;
+    for (uint8_t i = 0; i < array->count; i++) {
+        if (array->sensors[i].ready && array->sensors[i].config.int_gpio != VL53LX_TOF_ARRAY_NO_GPIO) {
+            int_mask |= 1ULL << array->sensors[i].config.int_gpio;
+        }
+    }
+
+    if (int_mask != 0) {
+        gpio_config_t io_conf = {
+            .pin_bit_mask = int_mask,
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = GPIO_PULLUP_ENABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_NEGEDGE,
+        };
+        if (gpio_config(&io_conf) != ESP_OK) {
+            ESP_LOGE(TAG, "INT GPIO config failed");
+            return false;
+        }
+
+        esp_err_t err = gpio_install_isr_service(0);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+            ESP_LOGE(TAG, "GPIO ISR service install failed: %s", esp_err_to_name(err));
+            return false;
+        }
+
+        for (uint8_t i = 0; i < array->count; i++) {
+            vl53lx_tof_sensor_t *sensor = &array->sensors[i];
+            if (!sensor->ready || sensor->config.int_gpio == VL53LX_TOF_ARRAY_NO_GPIO) {
+                continue;
+            }
+            err = gpio_isr_handler_add((gpio_num_t)sensor->config.int_gpio, tof_array_isr, sensor);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "ISR handler add failed: %s", esp_err_to_name(err));
+                tof_array_remove_isr(array);
+                return false;
+            }
+        }
+    }
+
+    if (array->config.staggered && array->timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = tof_array_timer_cb,
+            .arg = array,
+            .name = "tof_array",
+        };
+        esp_timer_handle_t timer = NULL;
+        if (esp_timer_create(&timer_args, &timer) != ESP_OK) {
+            ESP_LOGE(TAG, "Start timer create failed");
+            tof_array_remove_isr(array);
+            return false;
+        }
+        array->timer = timer;
+    }
+
+    array->stop = false;
+    TaskHandle_t task = NULL;
+    if (xTaskCreate(tof_array_task, "tof_array", array->config.task_stack_size, array,
+                    array->config.task_priority, &task) != pdPASS) {
+        ESP_LOGE(TAG, "Service task create failed");
+        tof_array_remove_isr(array);
+        return false;
+    }
+    array->task = task;
+
+    return true;
+}
+
+void VL53LX_TofArrayStop(vl53lx_tof_array_t *array)
+{
+    if (array == NULL || array->task == NULL) {
+        return;
+    }
+
+    array->stop = true;
+    xTaskNotify((TaskHandle_t)array->task, NOTIFY_STOP, eSetBits);
+    while (array->task != NULL) {
+        vTaskDelay(1);
+    }
+
+    tof_array_remove_isr(array);
+    if (array->timer != NULL) {
+        esp_timer_delete((esp_timer_handle_t)array->timer);
+        array->timer = NULL;
+    }
+}
+
+#endif // ESP_PLATFORM
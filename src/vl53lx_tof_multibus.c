@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_tof_multibus.c
+ * @brief VL53LX Multi-Bus ToF Array Implementation
+ */
+
+#include "vl53lx_tof_multibus.h"
+#include "vl53lx_register_structs.h"
+#include "vl53lx_hist_map.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+
+static const char *TAG = "VL53LX_TOF_MULTIBUS";
+#endif
+
+// Default configuration values
+#define DEFAULT_SCL_HZ              400000
+#define DEFAULT_TIMING_BUDGET_US    33000
+
+// 8 data bits and ACK per byte
+#define BITS_PER_BYTE               9
+
+// Address byte and 16-bit register index of every transfer
+#define TRANSFER_HEADER_BYTES       3
+
+// GetMultiRangingData(): the histogram block
+#define READOUT_BYTES   (TRANSFER_HEADER_BYTES + VL53LX_HISTOGRAM_BIN_DATA_I2C_SIZE_BYTES)
+
+// ClearInterruptAndStartMeasurement(): general to system control config in one write
+#define RESTART_BYTES   (TRANSFER_HEADER_BYTES + VL53LX_GENERAL_CONFIG_I2C_SIZE_BYTES + \
+                         VL53LX_TIMING_CONFIG_I2C_SIZE_BYTES + VL53LX_DYNAMIC_CONFIG_I2C_SIZE_BYTES + \
+                         VL53LX_SYSTEM_CONTROL_I2C_SIZE_BYTES)
+
+vl53lx_tof_multibus_config_t VL53LX_TofMultiBusGetDefaultConfig(void)
+{
+    vl53lx_tof_multibus_config_t config = {
+        .bus_count = VL53LX_TOF_MULTIBUS_MAX_BUSES,
+        .scl_hz = DEFAULT_SCL_HZ,
+        .array = VL53LX_TofArrayGetDefaultConfig(),
+    };
+    return config;
+}
+
+bool VL53LX_TofMultiBusInit(vl53lx_tof_multibus_t *multibus)
+{
+    vl53lx_tof_multibus_config_t config = VL53LX_TofMultiBusGetDefaultConfig();
+    return VL53LX_TofMultiBusInitWithConfig(multibus, &config);
+}
+
+// Per-bus sample callback: array index to multi-bus index
+static void tof_multibus_on_sample(void *ctx, const vl53lx_tof_sample_t *sample)
+{
+    const vl53lx_tof_multibus_bus_t *bus = (const vl53lx_tof_multibus_bus_t *)ctx;
+    const vl53lx_tof_multibus_t *multibus = bus->owner;
+
+    if (multibus->config.array.on_sample == NULL) {
+        return;
+    }
+
+    vl53lx_tof_sample_t mapped = *sample;
+    mapped.index = bus->sensor_index[sample->index];
+    multibus->config.array.on_sample(multibus->config.array.ctx, &mapped);
+}
+
+bool VL53LX_TofMultiBusInitWithConfig(vl53lx_tof_multibus_t *multibus,
+                                      const vl53lx_tof_multibus_config_t *config)
+{
+    if (multibus == NULL || config == NULL || config->bus_count == 0 ||
+        config->bus_count > VL53LX_TOF_MULTIBUS_MAX_BUSES || config->scl_hz == 0) {
+        return false;
+    }
+
+    memset(multibus, 0, sizeof(*multibus));
+    multibus->config = *config;
+
+    for (uint8_t b = 0; b < config->bus_count; b++) {
+        vl53lx_tof_multibus_bus_t *bus = &multibus->buses[b];
+        vl53lx_tof_array_config_t array_config = config->array;
+        array_config.on_sample = tof_multibus_on_sample;
+        array_config.ctx = bus;
+        if (!VL53LX_TofArrayInitWithConfig(&bus->array, &array_config)) {
+            return false;
+        }
+        bus->owner = multibus;
+    }
+    multibus->initialized = true;
+
+    return true;
+}
+
+uint32_t VL53LX_TofMultiBusBytesPerSecond(const vl53lx_tof_sensor_config_t *config)
+{
+    if (config == NULL) {
+        return 0;
+    }
+
+    uint32_t budget_us = config->timing_budget_us > 0 ? config->timing_budget_us : DEFAULT_TIMING_BUDGET_US;
+    return (uint32_t)((uint64_t)(READOUT_BYTES + RESTART_BYTES) * 1000000u / budget_us);
+}
+
+int VL53LX_TofMultiBusAddSensor(vl53lx_tof_multibus_t *multibus, const vl53lx_tof_sensor_config_t *config,
+                                VL53LX_DEV dev, int bus)
+{
+    if (multibus == NULL || !multibus->initialized || multibus->assigned || config == NULL || dev == NULL ||
+        multibus->count >= VL53LX_TOF_MULTIBUS_MAX_SENSORS ||
+        (bus != VL53LX_TOF_MULTIBUS_AUTO && (bus < 0 || bus >= multibus->config.bus_count))) {
+        return -1;
+    }
+
+    vl53lx_tof_multibus_sensor_t *sensor = &multibus->sensors[multibus->count];
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->config = *config;
+    sensor->dev = dev;
+    sensor->requested_bus = (int8_t)bus;
+    sensor->bytes_per_second = VL53LX_TofMultiBusBytesPerSecond(config);
+    sensor->bus = -1;
+    sensor->index = -1;
+
+    return multibus->count++;
+}
+
+static bool tof_multibus_place(vl53lx_tof_multibus_t *multibus, uint8_t i, uint8_t b)
+{
+    vl53lx_tof_multibus_sensor_t *sensor = &multibus->sensors[i];
+    vl53lx_tof_multibus_bus_t *bus = &multibus->buses[b];
+
+    // Fails if the bus is full or the address is taken there
+    int index = VL53LX_TofArrayAddSensor(&bus->array, &sensor->config, sensor->dev);
+    if (index < 0) {
+        return false;
+    }
+
+    bus->sensor_index[index] = i;
+    bus->load_bytes_per_second += sensor->bytes_per_second;
+    sensor->bus = (int8_t)b;
+    sensor->index = (int8_t)index;
+    return true;
+}
+
+bool VL53LX_TofMultiBusAssign(vl53lx_tof_multibus_t *multibus)
+{
+    if (multibus == NULL || !multibus->initialized || multibus->assigned) {
+        return false;
+    }
+
+    bool ok = true;
+
+    // Wired sensors first, they leave no choice
+    for (uint8_t i = 0; i < multibus->count; i++) {
+        vl53lx_tof_multibus_sensor_t *sensor = &multibus->sensors[i];
+        if (sensor->requested_bus != VL53LX_TOF_MULTIBUS_AUTO &&
+            !tof_multibus_place(multibus, i, (uint8_t)sensor->requested_bus)) {
+            ok = false;
+        }
+    }
+
+    // Then heaviest first onto the least loaded bus (greedy LPT)
+    uint8_t order[VL53LX_TOF_MULTIBUS_MAX_SENSORS];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < multibus->count; i++) {
+        if (multibus->sensors[i].requested_bus != VL53LX_TOF_MULTIBUS_AUTO) {
+            continue;
+        }
+        // Insertion sort, stable so that equal loads keep AddSensor order
+        uint8_t j = n++;
+        while (j > 0 && multibus->sensors[order[j - 1]].bytes_per_second < multibus->sensors[i].bytes_per_second) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    for (uint8_t k = 0; k < n; k++) {
+        uint8_t i = order[k];
+        bool placed = false;
+        uint32_t tried = 0;
+
+        // Least loaded bus first, the next one if it is full or has the address
+        for (uint8_t attempt = 0; !placed && attempt < multibus->config.bus_count; attempt++) {
+            int best = -1;
+            for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+                if ((tried & (1u << b)) != 0) {
+                    continue;
+                }
+                if (best < 0 || multibus->buses[b].load_bytes_per_second <
+                                multibus->buses[best].load_bytes_per_second) {
+                    best = b;
+                }
+            }
+            tried |= 1u << best;
+            placed = tof_multibus_place(multibus, i, (uint8_t)best);
+        }
+        if (!placed) {
+            ok = false;
+        }
+    }
+
+    multibus->assigned = true;
+    return ok;
+}
+
+uint8_t VL53LX_TofMultiBusBringupWithHal(vl53lx_tof_multibus_t *multibus, const vl53lx_bringup_hal_t *hals)
+{
+    if (multibus == NULL || !multibus->assigned || hals == NULL) {
+        return 0;
+    }
+
+    uint8_t ready = 0;
+    for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+        if (multibus->buses[b].array.count > 0) {
+            ready += VL53LX_TofArrayBringupWithHal(&multibus->buses[b].array, &hals[b]);
+        }
+    }
+
+    return ready;
+}
+
+void VL53LX_TofMultiBusGetStats(const vl53lx_tof_multibus_t *multibus, uint32_t elapsed_us,
+                                vl53lx_tof_multibus_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (multibus == NULL || !multibus->initialized) {
+        return;
+    }
+
+    uint32_t capacity = multibus->config.scl_hz / BITS_PER_BYTE;
+    for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+        const vl53lx_tof_multibus_bus_t *bus = &multibus->buses[b];
+        vl53lx_tof_multibus_bus_stats_t *bus_stats = &stats->bus[b];
+
+        for (uint8_t i = 0; i < bus->array.count; i++) {
+            bus_stats->samples += bus->array.sensors[i].stats.samples;
+            bus_stats->errors += bus->array.sensors[i].stats.errors;
+        }
+        if (elapsed_us > 0) {
+            bus_stats->samples_per_second = (uint32_t)((uint64_t)bus_stats->samples * 1000000u / elapsed_us);
+        }
+        bus_stats->load_bytes_per_second = bus->load_bytes_per_second;
+        bus_stats->load_permille = (uint16_t)((uint64_t)bus->load_bytes_per_second * 1000u / capacity);
+
+        stats->samples += bus_stats->samples;
+        stats->errors += bus_stats->errors;
+    }
+    if (elapsed_us > 0) {
+        stats->samples_per_second = (uint32_t)((uint64_t)stats->samples * 1000000u / elapsed_us);
+    }
+}
+
+//=============================================================================
+// ESP-IDF bring-up and service tasks
+//=============================================================================
+
+#ifdef ESP_PLATFORM
+
+uint8_t VL53LX_TofMultiBusBringup(vl53lx_tof_multibus_t *multibus, const i2c_master_bus_handle_t *buses)
+{
+    if (multibus == NULL || !multibus->assigned || buses == NULL) {
+        return 0;
+    }
+
+    uint8_t ready = 0;
+    for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+        vl53lx_tof_array_t *array = &multibus->buses[b].array;
+        if (array->count == 0) {
+            continue;
+        }
+        uint8_t bus_ready = VL53LX_TofArrayBringup(array, buses[b]);
+        ESP_LOGI(TAG, "Bus %u: %u of %u sensors ready, %lu bytes/s expected", b, bus_ready, array->count,
+                 (unsigned long)multibus->buses[b].load_bytes_per_second);
+        ready += bus_ready;
+    }
+
+    return ready;
+}
+
+bool VL53LX_TofMultiBusStart(vl53lx_tof_multibus_t *multibus)
+{
+    if (multibus == NULL || !multibus->assigned) {
+        return false;
+    }
+
+    // One service task per bus, so that the transfers of the buses overlap
+    for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+        vl53lx_tof_array_t *array = &multibus->buses[b].array;
+        if (array->count > 0 && !VL53LX_TofArrayStart(array)) {
+            ESP_LOGE(TAG, "Bus %u start failed", b);
+            VL53LX_TofMultiBusStop(multibus);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VL53LX_TofMultiBusStop(vl53lx_tof_multibus_t *multibus)
+{
+    if (multibus == NULL || !multibus->initialized) {
+        return;
+    }
+
+    for (uint8_t b = 0; b < multibus->config.bus_count; b++) {
+        VL53LX_TofArrayStop(&multibus->buses[b].array);
+    }
+}
+
+#endif // ESP_PLATFORM
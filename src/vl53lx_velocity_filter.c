@@ -0,0 +1,266 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_velocity_filter.c
+ * @brief VL53LX Constant-Velocity Kalman Filter Implementation
+ */
+
+#include "vl53lx_velocity_filter.h"
+#include <stddef.h>
+
+// Default configuration values
+#define DEFAULT_VALID_STATUS_MASK   0x01        // Only status 0 (valid) by default
+#define DEFAULT_PROCESS_NOISE       4.0e6f      // 2000 mm/s^2 (0.2 g) acceleration std
+#define DEFAULT_MEASUREMENT_NOISE   4.0f        // ~2mm std, as the 1D filter
+#define DEFAULT_VELOCITY_NOISE      1.0e6f      // 1000 mm/s std before the second sample
+#define DEFAULT_GATE_SIGMA          5.0f
+#define DEFAULT_MAX_DT_US           500000
+
+// Consecutive gated samples before the filter restarts on the new distance
+#define MAX_REJECTED                5
+
+vl53lx_velocity_filter_config_t VL53LX_VelocityFilterGetDefaultConfig(void)
+{
+    vl53lx_velocity_filter_config_t config = {
+        .enable_status_check = true,
+        .valid_status_mask = DEFAULT_VALID_STATUS_MASK,
+        .process_noise = DEFAULT_PROCESS_NOISE,
+        .measurement_noise = DEFAULT_MEASUREMENT_NOISE,
+        .initial_velocity_noise = DEFAULT_VELOCITY_NOISE,
+        .gate_sigma = DEFAULT_GATE_SIGMA,
+        .max_dt_us = DEFAULT_MAX_DT_US,
+    };
+    return config;
+}
+
+bool VL53LX_VelocityFilterInit(vl53lx_velocity_filter_t *filter)
+{
+    vl53lx_velocity_filter_config_t config = VL53LX_VelocityFilterGetDefaultConfig();
+    return VL53LX_VelocityFilterInitWithConfig(filter, &config);
+}
+
+bool VL53LX_VelocityFilterInitWithConfig(vl53lx_velocity_filter_t *filter,
+                                         const vl53lx_velocity_filter_config_t *config)
+{
+    if (filter == NULL || config == NULL) {
+        return false;
+    }
+
+    filter->config = *config;
+    filter->initialized = true;
+    VL53LX_VelocityFilterReset(filter);
+
+    return true;
+}
+
+// Forget the gated samples: a restart needs a new run of them
+static void velocity_filter_clear_rejected(vl53lx_velocity_filter_t *filter)
+{
+    filter->rejected_count = 0;
+    filter->rejected_run = 0;
+    filter->rejected_innovation = 0.0f;
+    filter->rejected_distance_mm = 0;
+    filter->rejected_timestamp_us = 0;
+    filter->rejected_prev_distance_mm = 0;
+    filter->rejected_prev_timestamp_us = 0;
+}
+
+void VL53LX_VelocityFilterReset(vl53lx_velocity_filter_t *filter)
+{
+    if (filter == NULL || !filter->initialized) {
+        return;
+    }
+
+    filter->range_mm = 0.0f;
+    filter->velocity_mm_s = 0.0f;
+    filter->p00 = 0.0f;
+    filter->p01 = 0.0f;
+    filter->p11 = 0.0f;
+    filter->last_timestamp_us = 0;
+    velocity_filter_clear_rejected(filter);
+    filter->state_initialized = false;
+}
+
+static void velocity_filter_start(vl53lx_velocity_filter_t *filter, uint16_t distance_mm, uint32_t timestamp_us)
+{
+    filter->range_mm = (float)distance_mm;
+    filter->velocity_mm_s = 0.0f;
+    filter->p00 = filter->config.measurement_noise;
+    filter->p01 = 0.0f;
+    filter->p11 = filter->config.initial_velocity_noise;
+    filter->last_timestamp_us = timestamp_us;
+    velocity_filter_clear_rejected(filter);
+    filter->state_initialized = true;
+}
+
+// Whether this gated sample lies on the line through the previous two, within the gate.
+// Variance of the extrapolated line and this sample, plus the acceleration over the three
+static bool velocity_filter_confirms(const vl53lx_velocity_filter_t *filter, uint16_t distance_mm,
+                                     uint32_t timestamp_us)
+{
+    uint32_t first_us = timestamp_us - filter->rejected_prev_timestamp_us;
+    uint32_t second_us = timestamp_us - filter->rejected_timestamp_us;
+    if (second_us == 0 || second_us >= first_us) {
+        return false;
+    }
+
+    float dt01 = (float)(first_us - second_us) * 1.0e-6f;
+    float dt12 = (float)second_us * 1.0e-6f;
+    float dt02 = (float)first_us * 1.0e-6f;
+    float k = dt12 / dt01;
+    float velocity = ((float)filter->rejected_distance_mm - (float)filter->rejected_prev_distance_mm) / dt01;
+    float residual = (float)distance_mm - ((float)filter->rejected_distance_mm + velocity * dt12);
+    float variance = filter->config.measurement_noise * (1.0f + (1.0f + k) * (1.0f + k) + k * k) +
+                     0.25f * filter->config.process_noise * dt02 * dt02 * dt02 * dt02;
+    float gate = filter->config.gate_sigma;
+
+    return residual * residual <= gate * gate * variance;
+}
+
+// From the first of the gated samples to this one: velocity from the difference
+static void velocity_filter_start_two_point(vl53lx_velocity_filter_t *filter, uint16_t distance_mm,
+                                            uint32_t timestamp_us)
+{
+    float dt = (float)(timestamp_us - filter->rejected_prev_timestamp_us) * 1.0e-6f;
+    float R = filter->config.measurement_noise;
+    float velocity = ((float)distance_mm - (float)filter->rejected_prev_distance_mm) / dt;
+
+    velocity_filter_start(filter, distance_mm, timestamp_us);
+    filter->velocity_mm_s = velocity;
+    filter->p01 = R / dt;
+    filter->p11 = 2.0f * R / (dt * dt);
+}
+
+// Constant velocity over dt, white-noise acceleration: Q = q * [dt^4/4 dt^3/2; dt^3/2 dt^2]
+static void velocity_filter_predict(vl53lx_velocity_filter_t *filter, uint32_t timestamp_us)
+{
+    uint32_t elapsed_us = timestamp_us - filter->last_timestamp_us;
+    if (elapsed_us == 0) {
+        // Same timestamp: nothing to predict
+        return;
+    }
+    if (elapsed_us > filter->config.max_dt_us) {
+        // Too long to extrapolate, or older than the state (wrapped): restart at the next valid sample
+        filter->state_initialized = false;
+        return;
+    }
+
+    float dt = (float)elapsed_us * 1.0e-6f;
+    float dt2 = dt * dt;
+    float q = filter->config.process_noise;
+
+    filter->range_mm += filter->velocity_mm_s * dt;
+    filter->p00 += dt * (2.0f * filter->p01 + dt * filter->p11) + 0.25f * q * dt2 * dt2;
+    filter->p01 += dt * filter->p11 + 0.5f * q * dt2 * dt;
+    filter->p11 += q * dt2;
+    filter->last_timestamp_us = timestamp_us;
+}
+
+static bool velocity_filter_output(const vl53lx_velocity_filter_t *filter, uint16_t *output_mm,
+                                   float *velocity_mm_s)
+{
+    if (!filter->state_initialized) {
+        return false;
+    }
+
+    // Extrapolation may leave the sensor range: round and clamp
+    float range = filter->range_mm + 0.5f;
+    if (range < 0.0f) {
+        range = 0.0f;
+    } else if (range > (float)UINT16_MAX) {
+        range = (float)UINT16_MAX;
+    }
+    *output_mm = (uint16_t)range;
+    if (velocity_mm_s != NULL) {
+        *velocity_mm_s = filter->velocity_mm_s;
+    }
+    return true;
+}
+
+bool VL53LX_VelocityFilterUpdate(vl53lx_velocity_filter_t *filter, uint16_t distance_mm, uint8_t range_status,
+                                 uint32_t timestamp_us, uint16_t *output_mm, float *velocity_mm_s)
+{
+    if (filter == NULL || !filter->initialized || output_mm == NULL) {
+        return false;
+    }
+
+    bool status_valid = !filter->config.enable_status_check ||
+                        (range_status < 8 && ((1u << range_status) & filter->config.valid_status_mask) != 0);
+
+    if (filter->state_initialized) {
+        velocity_filter_predict(filter, timestamp_us);
+    }
+
+    if (!filter->state_initialized) {
+        // Initialize with first measurement (only if valid)
+        if (!status_valid) {
+            return false;
+        }
+        velocity_filter_start(filter, distance_mm, timestamp_us);
+        return velocity_filter_output(filter, output_mm, velocity_mm_s);
+    }
+
+    if (!status_valid) {
+        // Observation invalid: prediction only
+        return velocity_filter_output(filter, output_mm, velocity_mm_s);
+    }
+
+    float R = filter->config.measurement_noise;
+    float S = filter->p00 + R;
+    float innovation = (float)distance_mm - filter->range_mm;
+    float gate = filter->config.gate_sigma;
+
+    if (gate > 0.0f && innovation * innovation > gate * gate * S) {
+        // Too far from the prediction: prediction only. Three in a row on the
+        // same side and on one line are a step or a manoeuvre: restart from
+        // them. Two could be a pair of outliers, whose difference would give
+        // any velocity. Waiting for the growing P to open the gate would overshoot
+        bool same_side = filter->rejected_run > 0 && (innovation > 0.0f) == (filter->rejected_innovation > 0.0f);
+        if (!same_side) {
+            filter->rejected_run = 0;
+        }
+        if (filter->rejected_run >= 2 && velocity_filter_confirms(filter, distance_mm, timestamp_us)) {
+            velocity_filter_start_two_point(filter, distance_mm, timestamp_us);
+        } else if (filter->rejected_count + 1 >= MAX_REJECTED) {
+            velocity_filter_start(filter, distance_mm, timestamp_us);
+        } else {
+            filter->rejected_count++;
+            filter->rejected_run = filter->rejected_run < 2 ? filter->rejected_run + 1 : 2;
+            filter->rejected_innovation = innovation;
+            filter->rejected_prev_distance_mm = filter->rejected_distance_mm;
+            filter->rejected_prev_timestamp_us = filter->rejected_timestamp_us;
+            filter->rejected_distance_mm = distance_mm;
+            filter->rejected_timestamp_us = timestamp_us;
+        }
+        return velocity_filter_output(filter, output_mm, velocity_mm_s);
+    }
+    velocity_filter_clear_rejected(filter);
+
+    // Kalman gain K = P H^T / S with H = [1 0]
+    float k0 = filter->p00 / S;
+    float k1 = filter->p01 / S;
+
+    filter->range_mm += k0 * innovation;
+    filter->velocity_mm_s += k1 * innovation;
+
+    // P = (I - K H) P, using the old p01 for p11
+    filter->p11 -= k1 * filter->p01;
+    filter->p01 -= k0 * filter->p01;
+    filter->p00 -= k0 * filter->p00;
+
+    return velocity_filter_output(filter, output_mm, velocity_mm_s);
+}
+
+bool VL53LX_VelocityFilterPredict(vl53lx_velocity_filter_t *filter, uint32_t timestamp_us, uint16_t *output_mm,
+                                  float *velocity_mm_s)
+{
+    if (filter == NULL || !filter->initialized || output_mm == NULL || !filter->state_initialized) {
+        return false;
+    }
+
+    velocity_filter_predict(filter, timestamp_us);
+    return velocity_filter_output(filter, output_mm, velocity_mm_s);
+}
@@ -0,0 +1,424 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file replay.c
+ * @brief Replay a recorded corpus through the full ranging chain
+ *
+ *   replay <corpus.txt> <golden.txt> [--update] [--xtalk-kcps <kcps>] [--merge-state]
+ *
+ * The simulated device reports the corpus result blocks in order, and the
+ * host runs the same loop as an application: GetMeasurementDataReady,
+ * GetMultiRangingData, ClearInterruptAndStartMeasurement, then the outlier
+ * filter and the target tracker. One line per frame is compared against
+ * the golden file; any difference fails the run. --update rewrites it.
+ * --xtalk-kcps enables crosstalk compensation with the given plane offset
+ * (kcps, 9 fractional bits) so the compensated histogram pass runs too.
+ * --merge-state adds the histogram merge state to each line: records
+ * merged, record position, reset wait, and hashes of the stored records
+ * and of the histogram the algorithms ran on.
+ *
+ * Corpus directives between frames run before the next frame is read:
+ * "tuning <parm> <value>" calls VL53LX_set_tuning_parm(), "restart" stops
+ * and starts ranging (stream count 0 again). Each one is also written to
+ * the output, so the golden file shows where it took effect.
+ *
+ * Reported: ns/frame of each stage (host CPU, the simulated bus costs no
+ * wall time), heap allocations during ranging (must be 0), peak stack of
+ * the whole run from boot to stop, and bus traffic per frame.
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_core.h"
+#include "vl53lx_hist_map.h"
+#include "vl53lx_outlier_filter.h"
+#include "vl53lx_target_tracker.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define MAX_FRAMES          1024
+#define BLOCK_SIZE          VL53LX_HISTOGRAM_BIN_DATA_I2C_SIZE_BYTES
+#define OUTPUT_SIZE         (MAX_FRAMES * 512)
+#define LINE_SIZE           512
+#define MAX_EVENTS          64
+
+typedef struct {
+    uint32_t frame;                      // Applied before this frame is read
+    bool restart;                        // Stop and start ranging, else set a tuning parameter
+    uint16_t parm;
+    int32_t value;
+} event_t;
+
+typedef struct {
+    uint32_t distance_mode;
+    uint32_t budget_us;
+    uint32_t measure_us;
+    uint32_t seed;
+    uint8_t blocks[MAX_FRAMES][BLOCK_SIZE];
+    uint32_t count;
+    uint32_t next;                       // Next block the device reports
+    event_t events[MAX_EVENTS];
+    uint32_t event_count;
+} corpus_t;
+
+typedef struct {
+    uint64_t ranging_ns;                 // GetMeasurementDataReady + GetMultiRangingData + restart
+    uint64_t ranging_max_ns;
+    uint64_t filter_ns;
+    uint64_t tracker_ns;
+    uint32_t tracks;                     // Confirmed tracks after each update, summed
+    uint32_t frames;
+    uint32_t allocations;
+    uint32_t bus_bytes;
+    uint32_t bus_transfers;
+    bool ok;
+} stats_t;
+
+static corpus_t corpus;
+static uint32_t xtalk_kcps;              // 0: crosstalk compensation off
+static bool merge_state;
+static char output[OUTPUT_SIZE];
+static size_t output_length;
+static stats_t stats;
+
+static bool load_corpus(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "cannot open corpus %s\n", path);
+        return false;
+    }
+
+    char line[2 * BLOCK_SIZE + 64];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        char key[32];
+        unsigned value;
+        unsigned parm;
+        int parm_value;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "config %31s %u", key, &value) == 2) {
+            if (strcmp(key, "distance_mode") == 0) {
+                corpus.distance_mode = value;
+            } else if (strcmp(key, "budget_us") == 0) {
+                corpus.budget_us = value;
+            } else if (strcmp(key, "measure_us") == 0) {
+                corpus.measure_us = value;
+            } else if (strcmp(key, "seed") == 0) {
+                corpus.seed = value;
+            } else {
+                fprintf(stderr, "%s: unknown config %s\n", path, key);
+                ok = false;
+            }
+        } else if (sscanf(line, "tuning %i %i", &parm, &parm_value) == 2 && corpus.event_count < MAX_EVENTS) {
+            event_t *e = &corpus.events[corpus.event_count++];
+            e->frame = corpus.count;
+            e->restart = false;
+            e->parm = (uint16_t)parm;
+            e->value = parm_value;
+        } else if (strcmp(line, "restart\n") == 0 && corpus.event_count < MAX_EVENTS) {
+            event_t *e = &corpus.events[corpus.event_count++];
+            e->frame = corpus.count;
+            e->restart = true;
+        } else if (strncmp(line, "frame ", 6) == 0 && corpus.count < MAX_FRAMES) {
+            const char *hex = &line[6];
+            for (uint32_t b = 0; ok && b < BLOCK_SIZE; b++) {
+                unsigned byte;
+                ok = sscanf(&hex[2 * b], "%2x", &byte) == 1;
+                corpus.blocks[corpus.count][b] = (uint8_t)byte;
+            }
+            corpus.count++;
+        } else {
+            fprintf(stderr, "%s: bad line: %s", path, line);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (ok && (corpus.count == 0 || corpus.distance_mode == 0 || corpus.budget_us == 0 ||
+               corpus.measure_us == 0)) {
+        fprintf(stderr, "%s: incomplete corpus\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+static void replay_source(void *ctx, int index, uint32_t frame, uint8_t *block)
+{
+    corpus_t *c = ctx;
+    (void)index;
+    (void)frame;
+    if (c->next < c->count) {
+        memcpy(block, c->blocks[c->next], BLOCK_SIZE);
+    }
+    c->next++;
+}
+
+static void append(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void append(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(&output[output_length], OUTPUT_SIZE - output_length, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        output_length += (size_t)n;
+        if (output_length >= OUTPUT_SIZE) {
+            output_length = OUTPUT_SIZE - 1;
+        }
+    }
+}
+
+// The distance the filter sees: the first valid target, else the first one
+static void pick_target(const VL53LX_MultiRangingData_t *data, uint16_t *distance_mm, uint8_t *status)
+{
+    *distance_mm = 0;
+    *status = 255;
+    for (uint8_t i = 0; i < data->NumberOfObjectsFound; i++) {
+        const VL53LX_TargetRangeData_t *t = &data->RangeData[i];
+        if (i == 0 || t->RangeStatus == VL53LX_RANGESTATUS_RANGE_VALID) {
+            *distance_mm = (t->RangeMilliMeter > 0) ? (uint16_t)t->RangeMilliMeter : 0;
+            *status = t->RangeStatus;
+            if (t->RangeStatus == VL53LX_RANGESTATUS_RANGE_VALID) {
+                break;
+            }
+        }
+    }
+}
+
+static uint32_t hash(const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    uint32_t h = 0x811C9DC5;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ bytes[i]) * 0x01000193;
+    }
+    return h;
+}
+
+// Runs the corpus directives placed before frame k
+static bool apply_events(VL53LX_Dev_t *dev, uint32_t k)
+{
+    for (uint32_t i = 0; i < corpus.event_count; i++) {
+        const event_t *e = &corpus.events[i];
+        if (e->frame != k) {
+            continue;
+        }
+        if (e->restart) {
+            // The aborted measurement may already have taken the next block
+            uint32_t next = corpus.next;
+            if (VL53LX_StopMeasurement(dev) != VL53LX_ERROR_NONE ||
+                VL53LX_StartMeasurement(dev) != VL53LX_ERROR_NONE) {
+                fprintf(stderr, "frame %u: restart failed\n", k);
+                return false;
+            }
+            corpus.next = next;
+            append("restart\n");
+        } else {
+            if (VL53LX_set_tuning_parm(dev, (VL53LX_TuningParms)e->parm, e->value) != VL53LX_ERROR_NONE) {
+                fprintf(stderr, "frame %u: cannot set tuning parameter 0x%04X\n", k, e->parm);
+                return false;
+            }
+            append("tuning 0x%04X %d\n", e->parm, e->value);
+        }
+    }
+    return true;
+}
+
+static void run_replay(void *ctx)
+{
+    (void)ctx;
+    static VL53LX_Dev_t dev;
+    static vl53lx_filter_t filter;
+    static vl53lx_tracker_t tracker;
+
+    int index = sim_single_device(&dev, corpus.seed);
+    sim_device_set_measure_us(index, corpus.measure_us);
+    sim_device_set_source(index, replay_source, &corpus);
+    corpus.next = 0;
+
+    if (VL53LX_WaitDeviceBooted(&dev) != VL53LX_ERROR_NONE ||
+        VL53LX_DataInit(&dev) != VL53LX_ERROR_NONE ||
+        VL53LX_SetDistanceMode(&dev, (VL53LX_DistanceModes)corpus.distance_mode) != VL53LX_ERROR_NONE ||
+        VL53LX_SetMeasurementTimingBudgetMicroSeconds(&dev, corpus.budget_us) != VL53LX_ERROR_NONE ||
+        !VL53LX_FilterInit(&filter) || !VL53LX_TrackerInit(&tracker)) {
+        fprintf(stderr, "initialization failed\n");
+        return;
+    }
+
+    if (xtalk_kcps > 0) {
+        static VL53LX_CalibrationData_t cal;
+        if (VL53LX_GetCalibrationData(&dev, &cal) != VL53LX_ERROR_NONE) {
+            fprintf(stderr, "cannot read calibration data\n");
+            return;
+        }
+        // The driver's fallback shape when a calibration fails
+        cal.customer.algo__crosstalk_compensation_plane_offset_kcps = xtalk_kcps;
+        memset(cal.xtalkhisto.xtalk_shape.bin_data, 0, sizeof(cal.xtalkhisto.xtalk_shape.bin_data));
+        cal.xtalkhisto.xtalk_shape.bin_data[0] = 307;
+        cal.xtalkhisto.xtalk_shape.bin_data[1] = 410;
+        cal.xtalkhisto.xtalk_shape.bin_data[2] = 410;
+        cal.xtalkhisto.xtalk_shape.bin_data[3] = 307;
+        for (uint32_t i = 0; i < VL53LX_BIN_REC_SIZE; i++) {
+            cal.algo__xtalk_cpo_HistoMerge_kcps[i] = xtalk_kcps;
+        }
+        if (VL53LX_SetCalibrationData(&dev, &cal) != VL53LX_ERROR_NONE ||
+            VL53LX_SetXTalkCompensationEnable(&dev, 1) != VL53LX_ERROR_NONE) {
+            fprintf(stderr, "cannot enable crosstalk compensation\n");
+            return;
+        }
+    }
+
+    if (VL53LX_StartMeasurement(&dev) != VL53LX_ERROR_NONE) {
+        fprintf(stderr, "start failed\n");
+        return;
+    }
+    sim_reset_stats();
+    uint32_t allocations = host_alloc_count();
+
+    for (uint32_t k = 0; k < corpus.count; k++) {
+        if (!apply_events(&dev, k)) {
+            return;
+        }
+        sim_advance_to(0, sim_device_ready_at(index));
+
+        VL53LX_MultiRangingData_t data;
+        uint8_t ready = 0;
+        uint64_t t0 = host_time_ns();
+        VL53LX_Error status = VL53LX_GetMeasurementDataReady(&dev, &ready);
+        if (status == VL53LX_ERROR_NONE && ready) {
+            status = VL53LX_GetMultiRangingData(&dev, &data);
+        }
+        if (status == VL53LX_ERROR_NONE) {
+            status = VL53LX_ClearInterruptAndStartMeasurement(&dev);
+        }
+        uint64_t t1 = host_time_ns();
+        if (status != VL53LX_ERROR_NONE || !ready) {
+            fprintf(stderr, "frame %u: ranging failed (status %d, ready %u)\n", k, status, ready);
+            return;
+        }
+
+        uint16_t distance_mm;
+        uint8_t range_status;
+        uint16_t filtered_mm = 0;
+        pick_target(&data, &distance_mm, &range_status);
+        bool filtered = VL53LX_FilterUpdate(&filter, distance_mm, range_status, &filtered_mm);
+        uint64_t t2 = host_time_ns();
+
+        uint8_t active = VL53LX_TrackerUpdate(&tracker, &data, (uint32_t)(sim_now_us(0) / 1000));
+        uint64_t t3 = host_time_ns();
+
+        stats.ranging_ns += t1 - t0;
+        if (t1 - t0 > stats.ranging_max_ns) {
+            stats.ranging_max_ns = t1 - t0;
+        }
+        stats.filter_ns += t2 - t1;
+        stats.tracker_ns += t3 - t2;
+        stats.tracks += active;
+        stats.frames++;
+
+        char line[LINE_SIZE];
+        int n = snprintf(line, sizeof(line), "%u sc=%u n=%u", k, data.StreamCount, data.NumberOfObjectsFound);
+        for (uint8_t i = 0; i < data.NumberOfObjectsFound && n < LINE_SIZE; i++) {
+            const VL53LX_TargetRangeData_t *t = &data.RangeData[i];
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " | st=%u r=%d [%d,%d] sig=%u sr=%u ar=%u",
+                          t->RangeStatus, t->RangeMilliMeter, t->RangeMinMilliMeter,
+                          t->RangeMaxMilliMeter, (unsigned)t->SigmaMilliMeter,
+                          (unsigned)t->SignalRateRtnMegaCps, (unsigned)t->AmbientRateRtnMegaCps);
+        }
+        if (n < LINE_SIZE) {
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " | filt=%s%u", filtered ? "" : "!", filtered_mm);
+        }
+
+        vl53lx_track_t tracks[VL53LX_TRACKER_MAX_TRACKS];
+        uint8_t count = VL53LX_TrackerGetTracks(&tracker, tracks, VL53LX_TRACKER_MAX_TRACKS);
+        for (uint8_t i = 0; i < count && n < LINE_SIZE; i++) {
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " trk%u=%.1f/%.1f",
+                          tracks[i].id, tracks[i].range_mm, tracks[i].velocity_mm_s);
+        }
+        if (merge_state && n < LINE_SIZE) {
+            const VL53LX_LLDriverData_t *pdev = &dev.Data.LLData;
+            uint8_t merged = 0;
+            VL53LX_compute_histo_merge_nb(&dev, &merged);
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " merge=%u/%u/%u rec=%08x hist=%08x", merged,
+                          pdev->bin_rec_pos, pdev->pos_before_next_recom,
+                          hash(pdev->multi_bins_rec, sizeof(pdev->multi_bins_rec)),
+                          hash(pdev->hist_data.bin_data, sizeof(pdev->hist_data.bin_data)));
+        }
+        append("%s\n", line);
+    }
+
+    stats.allocations = host_alloc_count() - allocations;
+    stats.bus_bytes = sim_bus_stats(0)->bytes;
+    stats.bus_transfers = sim_bus_stats(0)->transfers;
+    VL53LX_StopMeasurement(&dev);
+    stats.ok = corpus.next == corpus.count;
+    if (!stats.ok) {
+        fprintf(stderr, "device reported %u of %u corpus frames\n", corpus.next, corpus.count);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <corpus.txt> <golden.txt> [--update] [--xtalk-kcps <kcps>] [--merge-state]\n", argv[0]);
+        return 2;
+    }
+    bool update = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--xtalk-kcps") == 0 && i + 1 < argc) {
+            xtalk_kcps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--merge-state") == 0) {
+            merge_state = true;
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!load_corpus(argv[1])) {
+        return 1;
+    }
+
+    size_t stack = host_stack_peak(run_replay, NULL);
+    CHECK(stats.ok);
+    CHECK_MSG(stats.allocations == 0, "%u heap allocations while ranging", stats.allocations);
+
+    if (stats.frames > 0) {
+        printf("%s: %u frames\n", argv[1], stats.frames);
+        printf("  ranging  %8.0f ns/frame (max %llu ns)\n", (double)stats.ranging_ns / stats.frames,
+               (unsigned long long)stats.ranging_max_ns);
+        printf("  filter   %8.0f ns/frame\n", (double)stats.filter_ns / stats.frames);
+        printf("  tracker  %8.0f ns/frame, %.1f tracks/frame, %.2f M tracks/s\n",
+               (double)stats.tracker_ns / stats.frames, (double)stats.tracks / stats.frames,
+               stats.tracker_ns > 0 ? stats.tracks * 1e3 / stats.tracker_ns : 0.0);
+        printf("  heap allocations while ranging: %u\n", stats.allocations);
+        printf("  peak stack, boot to stop: %zu bytes\n", stack);
+        printf("  bus: %.1f transfers, %.1f bytes per frame\n",
+               (double)stats.bus_transfers / stats.frames, (double)stats.bus_bytes / stats.frames);
+    }
+
+    if (update) {
+        if (!host_write_golden(output, output_length, argv[2])) {
+            fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        printf("  wrote %s\n", argv[2]);
+    } else {
+        CHECK(host_compare_golden(output, output_length, argv[2]));
+    }
+
+    return host_test_result();
+}
@@ -0,0 +1,425 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file sim_device.c
+ * @brief Simulated VL53L3CX devices for the host build
+ */
+
+#include "sim_device.h"
+#include "vl53lx_register_map.h"
+#include "vl53lx_register_settings.h"
+#include "vl53lx_hist_map.h"
+#include "vl53lx_ll_device.h"
+#include <string.h>
+
+#define GPH_ID_BIT          0x20    // RESULT__INTERRUPT_STATUS, GPH ID of the result
+#define MODE_ABORT          0x80
+
+typedef struct {
+    uint8_t regs[SIM_REG_SPACE];
+    uint8_t nvm[SIM_NVM_SIZE];
+    uint8_t bus;
+    uint8_t address;
+    bool powered;
+    uint64_t release_us;
+    uint32_t boot_us;
+
+    bool ranging;
+    bool ready;
+    uint64_t ready_at_us;
+    uint32_t measure_us;
+    uint32_t frame;
+    uint32_t starts;
+    uint64_t last_start_us;
+    sim_frame_fn source;
+    void *source_ctx;
+
+    uint16_t fail_reg;
+    uint32_t fail_reads;
+} sim_dev_t;
+
+static sim_dev_t devices[SIM_MAX_DEVICES];
+static int device_count;
+static uint64_t clocks[SIM_MAX_BUSES];
+static sim_bus_stats_t stats[SIM_MAX_BUSES];
+static uint8_t current_bus;
+
+static uint8_t *log_buffer;
+static size_t log_size;
+static size_t log_length;
+static uint32_t log_dropped;
+
+void sim_reset(void)
+{
+    memset(devices, 0, sizeof(devices));
+    device_count = 0;
+    memset(clocks, 0, sizeof(clocks));
+    current_bus = 0;
+    sim_reset_stats();
+    sim_log_writes(NULL, 0);
+}
+
+void sim_reset_stats(void)
+{
+    memset(stats, 0, sizeof(stats));
+}
+
+int sim_device_add(uint8_t bus, uint32_t seed, uint32_t boot_us)
+{
+    if (device_count >= SIM_MAX_DEVICES || bus >= SIM_MAX_BUSES) {
+        return -1;
+    }
+
+    int index = device_count++;
+    sim_dev_t *d = &devices[index];
+    memset(d, 0, sizeof(*d));
+    d->bus = bus;
+    d->address = SIM_DEFAULT_ADDRESS;
+    d->boot_us = boot_us;
+    d->measure_us = SIM_DEFAULT_MEASURE_US;
+
+    // Factory NVM: no part-to-part calibration, a unique ID from the seed
+    for (int i = SIM_NVM_UID_OFFSET; i < SIM_NVM_UID_OFFSET + 8; i++) {
+        seed = seed * 1103515245u + 12345u;
+        d->nvm[i] = (uint8_t)(seed >> 16);
+    }
+
+    // Registers the driver reads before it writes them
+    d->regs[VL53LX_I2C_SLAVE__DEVICE_ADDRESS] = SIM_DEFAULT_ADDRESS;
+    d->regs[VL53LX_OSC_MEASURED__FAST_OSC__FREQUENCY] = 0xBC;
+    d->regs[VL53LX_OSC_MEASURED__FAST_OSC__FREQUENCY + 1] = 0xCC;
+    d->regs[VL53LX_IDENTIFICATION__MODEL_ID] = 0xEA;
+    d->regs[VL53LX_IDENTIFICATION__MODULE_TYPE] = 0xAA;
+    d->regs[VL53LX_IDENTIFICATION__REVISION_ID] = 0x10;
+    d->regs[VL53LX_RESULT__OSC_CALIBRATE_VAL + 1] = 0xC0;
+
+    return index;
+}
+
+void sim_device_xshut(int index, bool release)
+{
+    sim_dev_t *d = &devices[index];
+
+    if (release && !d->powered) {
+        d->release_us = clocks[d->bus];
+        d->address = SIM_DEFAULT_ADDRESS;
+        d->regs[VL53LX_I2C_SLAVE__DEVICE_ADDRESS] = SIM_DEFAULT_ADDRESS;
+    }
+    if (!release) {
+        d->ranging = false;
+        d->ready = false;
+    }
+    d->regs[VL53LX_FIRMWARE__SYSTEM_STATUS] = 0;
+    d->powered = release;
+}
+
+void sim_device_never_boot(int index)
+{
+    devices[index].boot_us = UINT32_MAX;
+}
+
+void sim_device_set_measure_us(int index, uint32_t measure_us)
+{
+    devices[index].measure_us = measure_us;
+}
+
+void sim_device_set_source(int index, sim_frame_fn fn, void *ctx)
+{
+    devices[index].source = fn;
+    devices[index].source_ctx = ctx;
+}
+
+void sim_device_fail_reads(int index, uint16_t reg, uint32_t count)
+{
+    devices[index].fail_reg = reg;
+    devices[index].fail_reads = count;
+}
+
+uint8_t *sim_device_regs(int index)
+{
+    return devices[index].regs;
+}
+
+uint8_t *sim_device_nvm(int index)
+{
+    return devices[index].nvm;
+}
+
+uint8_t sim_device_address(int index)
+{
+    return devices[index].address;
+}
+
+bool sim_device_ranging(int index)
+{
+    return devices[index].ranging;
+}
+
+uint64_t sim_device_ready_at(int index)
+{
+    const sim_dev_t *d = &devices[index];
+    return (d->ranging && !d->ready) ? d->ready_at_us : UINT64_MAX;
+}
+
+uint32_t sim_device_starts(int index)
+{
+    return devices[index].starts;
+}
+
+uint64_t sim_device_last_start(int index)
+{
+    return devices[index].last_start_us;
+}
+
+int sim_single_device(VL53LX_Dev_t *dev, uint32_t seed)
+{
+    sim_reset();
+    int index = sim_device_add(0, seed, SIM_DEFAULT_BOOT_US);
+    sim_device_xshut(index, true);
+    sim_advance_us(0, SIM_DEFAULT_BOOT_US);
+
+    memset(dev, 0, sizeof(*dev));
+    dev->I2cHandle = sim_bus_handle(0);
+    dev->I2cDevAddr = SIM_DEFAULT_ADDRESS;
+    return index;
+}
+
+i2c_master_dev_handle_t sim_bus_handle(uint8_t bus)
+{
+    return (i2c_master_dev_handle_t)(uintptr_t)(bus + 1);
+}
+
+uint8_t sim_bus_of(const VL53LX_Dev_t *dev)
+{
+    uintptr_t handle = (uintptr_t)dev->I2cHandle;
+    return (handle == 0 || handle > SIM_MAX_BUSES) ? 0 : (uint8_t)(handle - 1);
+}
+
+void sim_select_bus(uint8_t bus)
+{
+    current_bus = bus;
+}
+
+uint8_t sim_current_bus(void)
+{
+    return current_bus;
+}
+
+uint64_t sim_now_us(uint8_t bus)
+{
+    return clocks[bus];
+}
+
+void sim_advance_us(uint8_t bus, uint64_t us)
+{
+    clocks[bus] += us;
+}
+
+void sim_advance_to(uint8_t bus, uint64_t t)
+{
+    if (t > clocks[bus]) {
+        clocks[bus] = t;
+    }
+}
+
+const sim_bus_stats_t *sim_bus_stats(uint8_t bus)
+{
+    return &stats[bus];
+}
+
+void sim_log_writes(uint8_t *buffer, size_t size)
+{
+    log_buffer = buffer;
+    log_size = size;
+    log_length = 0;
+    log_dropped = 0;
+}
+
+size_t sim_log_length(void)
+{
+    return log_length;
+}
+
+uint32_t sim_log_dropped(void)
+{
+    return log_dropped;
+}
+
+// Data ready level of GPIO__TIO_HV_STATUS bit 0, as configured by the driver
+static uint8_t ready_level(const sim_dev_t *d, bool ready)
+{
+    bool active_high = (d->regs[VL53LX_GPIO_HV_MUX__CTRL] & VL53LX_DEVICEINTERRUPTLEVEL_ACTIVE_MASK) ==
+                       VL53LX_DEVICEINTERRUPTLEVEL_ACTIVE_HIGH;
+    return (uint8_t)(ready == active_high ? 1 : 0);
+}
+
+static void set_ready(sim_dev_t *d, bool ready)
+{
+    d->ready = ready;
+    d->regs[VL53LX_GPIO__TIO_HV_STATUS] = (uint8_t)((d->regs[VL53LX_GPIO__TIO_HV_STATUS] & ~0x01) |
+                                                    ready_level(d, ready));
+}
+
+/*
+ * Completes the running measurement once its time has come. The driver
+ * treats the first result after a start as the GPH sync frame and expects
+ * stream count 0 again on the next one, then 1, 2, ... 255, 128, ...; the
+ * GPH ID bit toggles on every result.
+ */
+static void update_ranging(sim_dev_t *d)
+{
+    if (!d->ranging || d->ready || clocks[d->bus] < d->ready_at_us) {
+        return;
+    }
+
+    uint8_t *block = &d->regs[VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX];
+    memset(block, 0, VL53LX_HISTOGRAM_BIN_DATA_I2C_SIZE_BYTES);
+    block[1] = VL53LX_DEVICEERROR_RANGECOMPLETE;
+    if (d->source != NULL) {
+        d->source(d->source_ctx, (int)(d - devices), d->frame, block);
+    }
+
+    uint32_t sequence = (d->frame == 0) ? 0 : d->frame - 1;
+    uint8_t stream_count = (sequence < 256) ? (uint8_t)sequence : (uint8_t)(128 + (sequence - 256) % 128);
+    block[0] = (uint8_t)((block[0] & ~GPH_ID_BIT) | ((d->frame & 1) ? GPH_ID_BIT : 0));
+    block[3] = stream_count;
+
+    set_ready(d, true);
+}
+
+static void write_register(sim_dev_t *d, uint16_t reg, uint8_t value)
+{
+    d->regs[reg] = value;
+
+    switch (reg) {
+    case VL53LX_I2C_SLAVE__DEVICE_ADDRESS:
+        d->address = value & 0x7F;
+        break;
+
+    case VL53LX_RANGING_CORE__NVM_CTRL__READN:
+        if (value == 1) {
+            uint8_t word = d->regs[VL53LX_RANGING_CORE__NVM_CTRL__ADDR];
+            memcpy(&d->regs[VL53LX_RANGING_CORE__NVM_CTRL__DATAOUT_MMM], &d->nvm[(word * 4) % SIM_NVM_SIZE], 4);
+        }
+        break;
+
+    case VL53LX_SYSTEM__INTERRUPT_CLEAR:
+        if (value & 0x01) {
+            set_ready(d, false);
+        }
+        break;
+
+    case VL53LX_SYSTEM__MODE_START:
+        if ((value & MODE_ABORT) || (value & VL53LX_DEVICEMEASUREMENTMODE_MODE_MASK) == 0) {
+            d->ranging = false;
+            set_ready(d, false);
+        } else {
+            d->frame = d->ranging ? d->frame + 1 : 0;
+            d->ranging = true;
+            d->ready_at_us = clocks[d->bus] + d->measure_us;
+            d->starts++;
+            d->last_start_us = clocks[d->bus];
+            set_ready(d, false);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void transfer_time(uint8_t bus, uint32_t count)
+{
+    uint64_t us = SIM_XFER_OVERHEAD_US + (uint64_t)SIM_US_PER_BYTE * (3 + count);
+    clocks[bus] += us;
+    stats[bus].busy_us += us;
+    stats[bus].bytes += 3 + count;
+    stats[bus].transfers++;
+}
+
+// The device that answers at @p address, NULL on NACK or collision
+static sim_dev_t *select_device(uint8_t bus, uint8_t address)
+{
+    sim_dev_t *hit = NULL;
+    int answers = 0;
+
+    for (int i = 0; i < device_count; i++) {
+        sim_dev_t *d = &devices[i];
+        if (d->bus != bus || !d->powered || d->address != address) {
+            continue;
+        }
+        uint64_t since_release = clocks[bus] - d->release_us;
+        if (since_release < SIM_NACK_WINDOW_US) {
+            continue;
+        }
+        if (d->boot_us != UINT32_MAX && since_release >= d->boot_us) {
+            d->regs[VL53LX_FIRMWARE__SYSTEM_STATUS] |= 0x01;
+        }
+        hit = d;
+        answers++;
+    }
+
+    if (answers > 1) {
+        stats[bus].collisions++;
+        return NULL;
+    }
+    if (hit == NULL) {
+        stats[bus].nacks++;
+    }
+    return hit;
+}
+
+bool sim_bus_write(uint8_t bus, uint8_t address, uint16_t index, const uint8_t *data, uint32_t count)
+{
+    current_bus = bus;
+    transfer_time(bus, count);
+
+    sim_dev_t *d = select_device(bus, address);
+    if (d == NULL) {
+        return false;
+    }
+
+    if (log_buffer != NULL) {
+        if (log_length + 4 + count <= log_size) {
+            uint8_t *p = &log_buffer[log_length];
+            p[0] = (uint8_t)(index >> 8);
+            p[1] = (uint8_t)index;
+            p[2] = (uint8_t)(count >> 8);
+            p[3] = (uint8_t)count;
+            memcpy(&p[4], data, count);
+            log_length += 4 + count;
+        } else {
+            log_dropped++;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        write_register(d, (uint16_t)(index + i), data[i]);
+    }
+    return true;
+}
+
+bool sim_bus_read(uint8_t bus, uint8_t address, uint16_t index, uint8_t *data, uint32_t count)
+{
+    current_bus = bus;
+    transfer_time(bus, count);
+
+    sim_dev_t *d = select_device(bus, address);
+    if (d == NULL) {
+        return false;
+    }
+
+    if (d->fail_reads > 0 && d->fail_reg >= index && d->fail_reg < index + count) {
+        d->fail_reads--;
+        return false;
+    }
+
+    update_ranging(d);
+    for (uint32_t i = 0; i < count; i++) {
+        data[i] = d->regs[(uint16_t)(index + i)];
+    }
+    return true;
+}
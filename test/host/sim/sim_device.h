@@ -0,0 +1,193 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file sim_device.h
+ * @brief Simulated VL53L3CX devices for the host build
+ *
+ * Register-level stand-in for the sensor, used by sim_platform.c to back
+ * the VL53LX platform API on a Linux host:
+ * - Register file with NVM emulation through the RANGING_CORE NVM port
+ * - XSHUT, boot time, boot ROM NACK window and I2C address change
+ * - Up to SIM_MAX_BUSES buses, each with its own virtual clock and
+ *   400 kHz transfer timing; address collisions are detected
+ * - Ranging engine: starts, data ready, interrupt clear, stream count and
+ *   GPH ID sequence as the driver expects them. The histogram block of
+ *   each frame comes from a per-device frame source, zero bins otherwise
+ * - Transfer log and per-bus statistics
+ *
+ * Nothing here allocates; all state is static.
+ */
+
+#ifndef SIM_DEVICE_H
+#define SIM_DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "vl53lx_platform_user_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_MAX_BUSES           2
+#define SIM_MAX_DEVICES         16
+#define SIM_REG_SPACE           0x10000
+#define SIM_NVM_SIZE            512
+#define SIM_NVM_UID_OFFSET      0x1F8   ///< Byte offset of the 64-bit unique ID (VL53LX_GetUID)
+#define SIM_DEFAULT_ADDRESS     0x29    ///< 7-bit address after XSHUT release
+#define SIM_DEFAULT_BOOT_US     1100
+#define SIM_DEFAULT_MEASURE_US  33000
+
+#define SIM_XFER_OVERHEAD_US    60      ///< Start, stop and turnaround per transfer
+#define SIM_US_PER_BYTE         23      ///< 9 bits at 400 kHz
+#define SIM_NACK_WINDOW_US      400     ///< Boot ROM does not answer right after release
+
+/**
+ * @brief Frame source
+ *
+ * Fills the histogram result block (VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX,
+ * VL53LX_HISTOGRAM_BIN_DATA_I2C_SIZE_BYTES) of one frame. The simulator
+ * overwrites the stream count and the GPH ID bit afterwards.
+ *
+ * @param ctx Context passed to sim_device_set_source()
+ * @param index Device index
+ * @param frame Frame number since the measurement was started
+ * @param block Result block, zeroed before the call
+ */
+typedef void (*sim_frame_fn)(void *ctx, int index, uint32_t frame, uint8_t *block);
+
+/**
+ * @brief Per-bus transfer statistics
+ */
+typedef struct {
+    uint64_t busy_us;                   ///< Time spent in transfers
+    uint64_t bytes;                     ///< Bytes on the wire, 3 address/index bytes per transfer included
+    uint32_t transfers;                 ///< Transfers, including NACKed ones
+    uint32_t nacks;                     ///< Transfers no device answered
+    uint32_t collisions;                ///< Transfers answered by more than one device
+} sim_bus_stats_t;
+
+/** @brief Remove all devices, reset clocks, statistics and the transfer log */
+void sim_reset(void);
+
+/** @brief Reset statistics only */
+void sim_reset_stats(void);
+
+/**
+ * @brief Add a device
+ *
+ * The device starts in reset (XSHUT low). Its NVM is filled from @p seed.
+ *
+ * @return Device index, or -1 when SIM_MAX_DEVICES are in use
+ */
+int sim_device_add(uint8_t bus, uint32_t seed, uint32_t boot_us);
+
+/** @brief Drive XSHUT of a device; release starts the boot time */
+void sim_device_xshut(int index, bool release);
+
+/** @brief Keep a device in its boot ROM forever */
+void sim_device_never_boot(int index);
+
+/** @brief Measurement time of every following frame (default SIM_DEFAULT_MEASURE_US) */
+void sim_device_set_measure_us(int index, uint32_t measure_us);
+
+/** @brief Install a frame source, NULL for zero bins */
+void sim_device_set_source(int index, sim_frame_fn fn, void *ctx);
+
+/**
+ * @brief Fail the next reads that cover a register
+ *
+ * @param index Device index
+ * @param reg Register index
+ * @param count Number of reads to fail
+ */
+void sim_device_fail_reads(int index, uint16_t reg, uint32_t count);
+
+/** @brief Register file of a device */
+uint8_t *sim_device_regs(int index);
+
+/** @brief NVM of a device */
+uint8_t *sim_device_nvm(int index);
+
+/** @brief Current 7-bit address of a device */
+uint8_t sim_device_address(int index);
+
+/** @brief Device is ranging */
+bool sim_device_ranging(int index);
+
+/** @brief Time the running measurement completes, UINT64_MAX when idle or already complete */
+uint64_t sim_device_ready_at(int index);
+
+/** @brief Number of measurement starts */
+uint32_t sim_device_starts(int index);
+
+/** @brief Time of the last measurement start */
+uint64_t sim_device_last_start(int index);
+
+/**
+ * @brief Add device 0 on bus 0, booted, and bind a driver instance to it
+ *
+ * Shortcut for single-sensor tests: calls sim_reset().
+ */
+int sim_single_device(VL53LX_Dev_t *dev, uint32_t seed);
+
+/** @brief Platform handle of a bus, for VL53LX_Dev_t.I2cHandle */
+i2c_master_dev_handle_t sim_bus_handle(uint8_t bus);
+
+/** @brief Bus of a driver instance */
+uint8_t sim_bus_of(const VL53LX_Dev_t *dev);
+
+/** @brief Make @p bus the clock VL53LX_GetTimerValue() reads */
+void sim_select_bus(uint8_t bus);
+
+/** @brief Bus selected by the last device access or sim_select_bus() */
+uint8_t sim_current_bus(void);
+
+/** @brief Virtual time of a bus (us) */
+uint64_t sim_now_us(uint8_t bus);
+
+/** @brief Advance the clock of a bus */
+void sim_advance_us(uint8_t bus, uint64_t us);
+
+/** @brief Advance the clock of a bus to @p t, if it is later */
+void sim_advance_to(uint8_t bus, uint64_t t);
+
+/** @brief Transfer statistics of a bus */
+const sim_bus_stats_t *sim_bus_stats(uint8_t bus);
+
+/**
+ * @brief Log every write from now on
+ *
+ * Each write is stored as the index (2 bytes, big endian), the length
+ * (2 bytes) and the data. Reads are not logged.
+ *
+ * @param buffer Log buffer, NULL stops logging
+ * @param size Buffer size; writes that do not fit are counted only
+ */
+void sim_log_writes(uint8_t *buffer, size_t size);
+
+/** @brief Bytes logged since sim_log_writes() */
+size_t sim_log_length(void);
+
+/** @brief Writes that did not fit the log buffer */
+uint32_t sim_log_dropped(void);
+
+/*
+ * Transfer entry points for sim_platform.c.
+ */
+
+/** @brief Write @p count bytes; false on NACK or collision */
+bool sim_bus_write(uint8_t bus, uint8_t address, uint16_t index, const uint8_t *data, uint32_t count);
+
+/** @brief Read @p count bytes; false on NACK, collision or an injected failure */
+bool sim_bus_read(uint8_t bus, uint8_t address, uint16_t index, uint8_t *data, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_DEVICE_H
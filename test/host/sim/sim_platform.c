@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file sim_platform.c
+ * @brief VL53LX platform layer on top of the simulated devices
+ *
+ * Host counterpart of src/vl53lx_platform.c. Transfers go to sim_device.c,
+ * waits advance the virtual clock of the device's bus, and the timer reads
+ * the clock of the bus used last. Dev->I2cHandle selects the bus (see
+ * sim_bus_handle()), Dev->I2cDevAddr is the 7-bit address.
+ */
+
+#include "vl53lx_platform.h"
+#include "sim_device.h"
+#include <stddef.h>
+
+VL53LX_Error VL53LX_CommsInitialise(VL53LX_Dev_t *pdev, uint8_t comms_type, uint16_t comms_speed_khz)
+{
+    (void)pdev;
+    (void)comms_type;
+    (void)comms_speed_khz;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_CommsClose(VL53LX_Dev_t *pdev)
+{
+    (void)pdev;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_WriteMulti(VL53LX_Dev_t *pdev, uint16_t index, uint8_t *pdata, uint32_t count)
+{
+    if (pdev == NULL || pdata == NULL) {
+        return VL53LX_ERROR_INVALID_PARAMS;
+    }
+    if (!sim_bus_write(sim_bus_of(pdev), (uint8_t)pdev->I2cDevAddr, index, pdata, count)) {
+        return VL53LX_ERROR_CONTROL_INTERFACE;
+    }
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_ReadMulti(VL53LX_Dev_t *pdev, uint16_t index, uint8_t *pdata, uint32_t count)
+{
+    if (pdev == NULL || pdata == NULL) {
+        return VL53LX_ERROR_INVALID_PARAMS;
+    }
+    if (!sim_bus_read(sim_bus_of(pdev), (uint8_t)pdev->I2cDevAddr, index, pdata, count)) {
+        return VL53LX_ERROR_CONTROL_INTERFACE;
+    }
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_WrByte(VL53LX_Dev_t *pdev, uint16_t index, uint8_t data)
+{
+    return VL53LX_WriteMulti(pdev, index, &data, 1);
+}
+
+VL53LX_Error VL53LX_WrWord(VL53LX_Dev_t *pdev, uint16_t index, uint16_t data)
+{
+    uint8_t buffer[2] = { (uint8_t)(data >> 8), (uint8_t)data };
+    return VL53LX_WriteMulti(pdev, index, buffer, 2);
+}
+
+VL53LX_Error VL53LX_WrDWord(VL53LX_Dev_t *pdev, uint16_t index, uint32_t data)
+{
+    uint8_t buffer[4] = { (uint8_t)(data >> 24), (uint8_t)(data >> 16), (uint8_t)(data >> 8), (uint8_t)data };
+    return VL53LX_WriteMulti(pdev, index, buffer, 4);
+}
+
+VL53LX_Error VL53LX_RdByte(VL53LX_Dev_t *pdev, uint16_t index, uint8_t *pdata)
+{
+    return VL53LX_ReadMulti(pdev, index, pdata, 1);
+}
+
+VL53LX_Error VL53LX_RdWord(VL53LX_Dev_t *pdev, uint16_t index, uint16_t *pdata)
+{
+    uint8_t buffer[2] = { 0 };
+    VL53LX_Error status = VL53LX_ReadMulti(pdev, index, buffer, 2);
+    *pdata = (uint16_t)((buffer[0] << 8) | buffer[1]);
+    return status;
+}
+
+VL53LX_Error VL53LX_RdDWord(VL53LX_Dev_t *pdev, uint16_t index, uint32_t *pdata)
+{
+    uint8_t buffer[4] = { 0 };
+    VL53LX_Error status = VL53LX_ReadMulti(pdev, index, buffer, 4);
+    *pdata = ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
+             ((uint32_t)buffer[2] << 8) | buffer[3];
+    return status;
+}
+
+VL53LX_Error VL53LX_WaitUs(VL53LX_Dev_t *pdev, int32_t wait_us)
+{
+    if (wait_us < 0) {
+        return VL53LX_ERROR_INVALID_PARAMS;
+    }
+    uint8_t bus = (pdev != NULL) ? sim_bus_of(pdev) : sim_current_bus();
+    sim_advance_us(bus, (uint64_t)wait_us);
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_WaitMs(VL53LX_Dev_t *pdev, int32_t wait_ms)
+{
+    if (wait_ms < 0) {
+        return VL53LX_ERROR_INVALID_PARAMS;
+    }
+    return VL53LX_WaitUs(pdev, wait_ms * 1000);
+}
+
+VL53LX_Error VL53LX_GetTimerFrequency(int32_t *ptimer_freq_hz)
+{
+    *ptimer_freq_hz = 1000000;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GetTimerValue(int32_t *ptimer_count)
+{
+    *ptimer_count = (int32_t)sim_now_us(sim_current_bus());
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GetTickCount(VL53LX_DEV Dev, uint32_t *ptime_ms)
+{
+    uint8_t bus = (Dev != NULL) ? sim_bus_of(Dev) : sim_current_bus();
+    *ptime_ms = (uint32_t)(sim_now_us(bus) / 1000);
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_WaitValueMaskEx(
+    VL53LX_Dev_t *pdev,
+    uint32_t      timeout_ms,
+    uint16_t      index,
+    uint8_t       value,
+    uint8_t       mask,
+    uint32_t      poll_delay_ms)
+{
+    uint8_t bus = sim_bus_of(pdev);
+    uint64_t start_us = sim_now_us(bus);
+
+    for (;;) {
+        uint8_t byte_value = 0;
+        VL53LX_Error status = VL53LX_RdByte(pdev, index, &byte_value);
+        if (status == VL53LX_ERROR_NONE && (byte_value & mask) == value) {
+            return VL53LX_ERROR_NONE;
+        }
+        if (sim_now_us(bus) - start_us >= (uint64_t)timeout_ms * 1000) {
+            return (status != VL53LX_ERROR_NONE) ? status : VL53LX_ERROR_TIME_OUT;
+        }
+        VL53LX_WaitMs(pdev, (int32_t)poll_delay_ms);
+    }
+}
+
+VL53LX_Error VL53LX_GpioSetMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioSetValue(uint8_t pin, uint8_t value)
+{
+    (void)pin;
+    (void)value;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioGetValue(uint8_t pin, uint8_t *pvalue)
+{
+    (void)pin;
+    *pvalue = 0;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioXshutdown(uint8_t value)
+{
+    (void)value;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioCommsSelect(uint8_t value)
+{
+    (void)value;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioPowerEnable(uint8_t value)
+{
+    (void)value;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioInterruptEnable(void (*function)(void), uint8_t edge_type)
+{
+    (void)function;
+    (void)edge_type;
+    return VL53LX_ERROR_NONE;
+}
+
+VL53LX_Error VL53LX_GpioInterruptDisable(void)
+{
+    return VL53LX_ERROR_NONE;
+}
@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file host_test.c
+ * @brief Minimal check and measurement helpers for the host tests
+ */
+
+#define _GNU_SOURCE
+#include "host_test.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STACK_SIZE      (256 * 1024)
+#define STACK_PAINT     0xA5
+
+uint32_t host_test_failures;
+
+int host_test_result(void)
+{
+    if (host_test_failures > 0) {
+        fprintf(stderr, "%u check(s) failed\n", host_test_failures);
+        return 1;
+    }
+    return 0;
+}
+
+uint64_t host_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Allocation counter. The test executables link with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc.
+ */
+static uint32_t alloc_count;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    __atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    __atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+uint32_t host_alloc_count(void)
+{
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+}
+
+typedef struct {
+    void (*fn)(void *ctx);
+    void *ctx;
+} stack_job_t;
+
+static void *stack_thread(void *arg)
+{
+    stack_job_t *job = arg;
+    if (job->fn != NULL) {
+        job->fn(job->ctx);
+    }
+    return NULL;
+}
+
+// Bytes of the painted stack that were written, counted from the bottom
+static size_t stack_used(void (*fn)(void *ctx), void *ctx)
+{
+    uint8_t *stack = NULL;
+    if (posix_memalign((void **)&stack, 4096, STACK_SIZE) != 0) {
+        return 0;
+    }
+    memset(stack, STACK_PAINT, STACK_SIZE);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, STACK_SIZE);
+
+    stack_job_t job = { fn, ctx };
+    pthread_t thread;
+    size_t used = 0;
+    if (pthread_create(&thread, &attr, stack_thread, &job) == 0) {
+        pthread_join(thread, NULL);
+        size_t untouched = 0;
+        while (untouched < STACK_SIZE && stack[untouched] == STACK_PAINT) {
+            untouched++;
+        }
+        used = STACK_SIZE - untouched;
+    }
+
+    pthread_attr_destroy(&attr);
+    free(stack);
+    return used;
+}
+
+size_t host_stack_peak(void (*fn)(void *ctx), void *ctx)
+{
+    size_t baseline = stack_used(NULL, NULL);
+    size_t used = stack_used(fn, ctx);
+    return (used > baseline) ? used - baseline : 0;
+}
+
+bool host_compare_golden(const char *output, size_t length, const char *golden_path)
+{
+    FILE *file = fopen(golden_path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "cannot open golden file %s\n", golden_path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *golden = malloc((size_t)size + 1);
+    size_t read = (golden != NULL) ? fread(golden, 1, (size_t)size, file) : 0;
+    fclose(file);
+    if (golden == NULL || read != (size_t)size) {
+        free(golden);
+        return false;
+    }
+
+    size_t line = 1;
+    size_t line_start = 0;
+    size_t i = 0;
+    while (i < length && i < (size_t)size && output[i] == golden[i]) {
+        if (output[i] == '\n') {
+            line++;
+            line_start = i + 1;
+        }
+        i++;
+    }
+
+    bool match = (i == length && i == (size_t)size);
+    if (!match) {
+        const char *got = &output[line_start];
+        const char *want = &golden[line_start];
+        size_t got_rest = (line_start < length) ? length - line_start : 0;
+        size_t want_rest = (line_start < (size_t)size) ? (size_t)size - line_start : 0;
+        const char *got_end = memchr(got, '\n', got_rest);
+        const char *want_end = memchr(want, '\n', want_rest);
+        int got_len = (int)(got_end ? (size_t)(got_end - got) : got_rest);
+        int want_len = (int)(want_end ? (size_t)(want_end - want) : want_rest);
+        fprintf(stderr, "%s: first difference on line %zu\n  golden: %.*s\n  output: %.*s\n",
+                golden_path, line, want_len, want, got_len, got);
+    }
+
+    free(golden);
+    return match;
+}
+
+bool host_write_golden(const char *output, size_t length, const char *golden_path)
+{
+    FILE *file = fopen(golden_path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fwrite(output, 1, length, file) == length;
+    fclose(file);
+    return ok;
+}
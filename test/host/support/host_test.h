@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file host_test.h
+ * @brief Minimal check and measurement helpers for the host tests
+ *
+ * - CHECK() records a failure and keeps going; host_test_result() is the
+ *   process exit code, so a failed check fails the ctest entry
+ * - Monotonic nanosecond clock for the benchmarks
+ * - Heap allocation counter (malloc/calloc/realloc are wrapped at link time)
+ * - Peak stack use of a function, measured on a painted thread stack
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint32_t host_test_failures;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            host_test_failures++;                                               \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_MSG(cond, ...)                                                    \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            host_test_failures++;                                               \
+            fprintf(stderr, "%s:%d: CHECK failed: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__);                                       \
+            fprintf(stderr, "\n");                                              \
+        }                                                                       \
+    } while (0)
+
+/** @brief Exit code: 0 when every check passed */
+int host_test_result(void);
+
+/** @brief Monotonic time in nanoseconds */
+uint64_t host_time_ns(void);
+
+/** @brief Heap allocations (malloc, calloc, realloc) since program start */
+uint32_t host_alloc_count(void);
+
+/**
+ * @brief Run a function on a painted stack and report its peak stack use
+ *
+ * The thread's own start-up use is measured with an empty function and
+ * subtracted.
+ *
+ * @param fn Function to run
+ * @param ctx Argument for @p fn
+ * @return Peak stack use of @p fn in bytes
+ */
+size_t host_stack_peak(void (*fn)(void *ctx), void *ctx);
+
+/** @brief Compare a text file against a golden file; prints the first difference */
+bool host_compare_golden(const char *output, size_t length, const char *golden_path);
+
+/** @brief Write a golden file */
+bool host_write_golden(const char *output, size_t length, const char *golden_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_TEST_H
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file sim_scene.c
+ * @brief Synthetic histogram frames for the simulated device
+ */
+
+#include "sim_scene.h"
+#include "sim_device.h"
+#include "vl53lx_api.h"
+#include "vl53lx_core.h"
+#include "vl53lx_hist_map.h"
+#include "vl53lx_register_map.h"
+#include <string.h>
+
+#define BLOCK_OFFSET(reg)   ((reg) - VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX)
+
+void sim_scene_init(sim_scene_t *scene, VL53LX_DEV dev, const vl53lx_hist_synth_config_t *base)
+{
+    memset(scene, 0, sizeof(*scene));
+    scene->dev = dev;
+    scene->base = *base;
+}
+
+void sim_scene_set_targets(sim_scene_t *scene, const vl53lx_hist_synth_target_t *targets, uint8_t count)
+{
+    if (count > VL53LX_HIST_SYNTH_MAX_TARGETS) {
+        count = VL53LX_HIST_SYNTH_MAX_TARGETS;
+    }
+    memcpy(scene->targets, targets, count * sizeof(*targets));
+    scene->count = count;
+}
+
+void sim_scene_set_ambient(sim_scene_t *scene, float ambient_events)
+{
+    scene->base.ambient_events = ambient_events;
+    scene->synth[0].initialized = false;
+    scene->synth[1].initialized = false;
+}
+
+void sim_scene_encode(const VL53LX_histogram_bin_data_t *hist, const uint8_t *bin_seq, uint8_t period_bins,
+                      uint8_t *block)
+{
+    block[BLOCK_OFFSET(VL53LX_RESULT__RANGE_STATUS)] = hist->result__range_status;
+    block[BLOCK_OFFSET(VL53LX_RESULT__DSS_ACTUAL_EFFECTIVE_SPADS_SD0)] =
+        (uint8_t)(hist->result__dss_actual_effective_spads >> 8);
+    block[BLOCK_OFFSET(VL53LX_RESULT__DSS_ACTUAL_EFFECTIVE_SPADS_SD0) + 1] =
+        (uint8_t)hist->result__dss_actual_effective_spads;
+    block[BLOCK_OFFSET(VL53LX_PHASECAL_RESULT__REFERENCE_PHASE)] =
+        (uint8_t)(hist->phasecal_result__reference_phase >> 8);
+    block[BLOCK_OFFSET(VL53LX_PHASECAL_RESULT__REFERENCE_PHASE) + 1] =
+        (uint8_t)hist->phasecal_result__reference_phase;
+    block[BLOCK_OFFSET(VL53LX_PHASECAL_RESULT__VCSEL_START)] = hist->phasecal_result__vcsel_start;
+
+    uint8_t ambient_bins = 0;
+    for (uint8_t g = 0; g < VL53LX_MAX_BIN_SEQUENCE_LENGTH; g++) {
+        if ((bin_seq[g] & 0x07) == 0x07) {
+            ambient_bins += 4;
+        }
+    }
+
+    /*
+     * Each group of four bins is filled as its sequence code says: code 7
+     * counts ambient only (the ambient sum spread over those bins), code c
+     * counts period bins 4c..4c+3, wrapped at the VCSEL period.
+     */
+    int32_t ambient_sum = hist->ambient_events_sum;
+    uint8_t ambient_index = 0;
+    uint8_t *bin = &block[BLOCK_OFFSET(VL53LX_RESULT__HISTOGRAM_BIN_0_2)];
+    for (uint8_t i = 0; i < VL53LX_HISTOGRAM_BUFFER_SIZE; i++) {
+        uint8_t code = bin_seq[i >> 2] & 0x07;
+        int32_t value;
+        if (code == 0x07) {
+            value = ambient_sum / ambient_bins + ((ambient_index < ambient_sum % ambient_bins) ? 1 : 0);
+            ambient_index++;
+        } else {
+            value = hist->bin_data[(4 * code + (i & 0x03)) % period_bins];
+        }
+        if (value < 0) {
+            value = 0;
+        }
+        bin[3 * i] = (uint8_t)(value >> 16);
+        bin[3 * i + 1] = (uint8_t)(value >> 8);
+        bin[3 * i + 2] = (uint8_t)value;
+    }
+
+    // The low byte of bin 23 is reported split over two registers
+    uint8_t low = bin[3 * (VL53LX_HISTOGRAM_BUFFER_SIZE - 1) + 2];
+    block[BLOCK_OFFSET(VL53LX_RESULT__HISTOGRAM_BIN_23_0_MSB)] = (uint8_t)(low >> 2);
+    block[BLOCK_OFFSET(VL53LX_RESULT__HISTOGRAM_BIN_23_0_LSB)] = (uint8_t)(low & 0x03);
+}
+
+void sim_scene_frame(void *ctx, int index, uint32_t frame, uint8_t *block)
+{
+    sim_scene_t *scene = ctx;
+    VL53LX_LLDriverData_t *pdev = VL53LXDevStructGetLLDriverHandle(scene->dev);
+    VL53LX_timing_config_t *ptim = &pdev->tim_cfg;
+    (void)index;
+    (void)frame;
+
+    // The timing and bin sequence the driver will decode this frame with
+    uint8_t timing = pdev->ll_state.rd_timing_status & 0x01;
+    VL53LX_histogram_bin_data_t seq;
+    memset(&seq, 0, sizeof(seq));
+    VL53LX_hist_get_bin_sequence_config(scene->dev, &seq);
+
+    vl53lx_hist_synth_config_t config = scene->base;
+    uint16_t encoded_timeout;
+    if (timing == 0) {
+        encoded_timeout = (uint16_t)((ptim->range_config__timeout_macrop_a_hi << 8) +
+                                     ptim->range_config__timeout_macrop_a_lo);
+        config.vcsel_period = ptim->range_config__vcsel_period_a;
+    } else {
+        encoded_timeout = (uint16_t)((ptim->range_config__timeout_macrop_b_hi << 8) +
+                                     ptim->range_config__timeout_macrop_b_lo);
+        config.vcsel_period = ptim->range_config__vcsel_period_b;
+    }
+    config.total_periods_elapsed = VL53LX_decode_timeout(encoded_timeout);
+    config.fast_osc_frequency = pdev->stat_nvm.osc_measured__fast_osc__frequency;
+    config.vcsel_width = (uint16_t)(((uint16_t)pdev->gen_cfg.global_config__vcsel_width << 4) +
+                                    pdev->stat_cfg.ana_config__vcsel_pulse_width_offset);
+    config.cal_vcsel_start = pdev->gen_cfg.cal_config__vcsel_start;
+    config.gain_factor = pdev->gain_cal.histogram_ranging_gain_factor;
+    config.seed = scene->base.seed * 2 + timing;
+
+    // Rebuild the generator of this timing when the driver reprogrammed it
+    vl53lx_hist_synth_t *synth = &scene->synth[timing];
+    const vl53lx_hist_synth_config_t *current = &synth->config;
+    if (!synth->initialized || current->vcsel_period != config.vcsel_period ||
+        current->total_periods_elapsed != config.total_periods_elapsed ||
+        current->fast_osc_frequency != config.fast_osc_frequency ||
+        current->vcsel_width != config.vcsel_width ||
+        current->cal_vcsel_start != config.cal_vcsel_start ||
+        current->gain_factor != config.gain_factor) {
+        if (!VL53LX_HistSynthInitWithConfig(synth, &config)) {
+            return;
+        }
+    }
+
+    VL53LX_histogram_bin_data_t hist;
+    if (VL53LX_HistSynthFrame(synth, scene->targets, scene->count, &hist)) {
+        sim_scene_encode(&hist, seq.bin_seq, synth->period_bins, block);
+        scene->frames++;
+    }
+}
+
+VL53LX_Error sim_scene_range(VL53LX_DEV dev, int index, VL53LX_MultiRangingData_t *data)
+{
+    uint8_t ready = 0;
+    uint64_t ready_at = sim_device_ready_at(index);
+    if (ready_at != UINT64_MAX) {
+        sim_advance_to(sim_bus_of(dev), ready_at);
+    }
+    VL53LX_Error status = VL53LX_GetMeasurementDataReady(dev, &ready);
+    if (status == VL53LX_ERROR_NONE && !ready) {
+        status = VL53LX_ERROR_TIME_OUT;
+    }
+    if (status == VL53LX_ERROR_NONE) {
+        status = VL53LX_GetMultiRangingData(dev, data);
+    }
+    if (status == VL53LX_ERROR_NONE) {
+        status = VL53LX_ClearInterruptAndStartMeasurement(dev);
+    }
+    return status;
+}
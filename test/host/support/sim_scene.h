@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file sim_scene.h
+ * @brief Synthetic histogram frames for the simulated device
+ *
+ * A frame source for sim_device_set_source(). Each frame is rendered with
+ * VL53LX_HistSynth using the timing the driver instance has programmed
+ * for that frame (VCSEL period, timeout, VCSEL width, oscillator, ambient
+ * bins), then encoded into the histogram result block the way the device
+ * reports it: each group of four bins follows the bin sequence code of the
+ * timing (ambient, or a step of the VCSEL period), 24-bit big endian bins,
+ * and the split low byte of bin 23.
+ */
+
+#ifndef SIM_SCENE_H
+#define SIM_SCENE_H
+
+#include <stdint.h>
+#include "vl53lx_platform_user_data.h"
+#include "vl53lx_hist_synth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Scene state
+ */
+typedef struct {
+    VL53LX_DEV dev;                      ///< Driver instance whose configuration the frames follow
+    vl53lx_hist_synth_config_t base;     ///< Signal, ambient, crosstalk and noise settings
+    vl53lx_hist_synth_t synth[2];        ///< Generator per timing (A, B)
+    vl53lx_hist_synth_target_t targets[VL53LX_HIST_SYNTH_MAX_TARGETS];  ///< Targets of the next frames
+    uint8_t count;                       ///< Number of targets
+    uint32_t frames;                     ///< Frames rendered
+} sim_scene_t;
+
+/**
+ * @brief Initialize a scene
+ *
+ * @param scene Scene state
+ * @param dev Driver instance bound to the simulated device
+ * @param base Generator settings; the timing fields are taken from the driver
+ */
+void sim_scene_init(sim_scene_t *scene, VL53LX_DEV dev, const vl53lx_hist_synth_config_t *base);
+
+/** @brief Set the targets of the following frames */
+void sim_scene_set_targets(sim_scene_t *scene, const vl53lx_hist_synth_target_t *targets, uint8_t count);
+
+/** @brief Change the ambient events per bin per SPAD of the following frames */
+void sim_scene_set_ambient(sim_scene_t *scene, float ambient_events);
+
+/** @brief Frame source for sim_device_set_source(), @p ctx is the scene */
+void sim_scene_frame(void *ctx, int index, uint32_t frame, uint8_t *block);
+
+/**
+ * @brief Encode a frame into a histogram result block
+ *
+ * @param hist Frame with the period bins starting at bin 0
+ * @param bin_seq Bin sequence codes of the timing, one per four bins
+ *                (VL53LX_hist_get_bin_sequence_config())
+ * @param period_bins Histogram bins per VCSEL period
+ * @param block Result block at VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX
+ */
+void sim_scene_encode(const VL53LX_histogram_bin_data_t *hist, const uint8_t *bin_seq, uint8_t period_bins,
+                      uint8_t *block);
+
+/**
+ * @brief Read the next frame of a ranging device the way an application does
+ *
+ * Advances the bus clock to the end of the running measurement, then
+ * GetMeasurementDataReady, GetMultiRangingData and
+ * ClearInterruptAndStartMeasurement.
+ *
+ * @param dev Driver instance, already ranging
+ * @param index Simulated device index
+ * @param data Ranging result
+ * @return Driver status; VL53LX_ERROR_TIME_OUT when no data was ready
+ */
+VL53LX_Error sim_scene_range(VL53LX_DEV dev, int index, VL53LX_MultiRangingData_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_SCENE_H
@@ -0,0 +1,300 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_hist_synth.c
+ * @brief VL53LX Synthetic Histogram Generator Implementation
+ */
+
+#include "vl53lx_hist_synth.h"
+#include "vl53lx_core.h"
+#include "vl53lx_tuning_parm_defaults.h"
+#include <string.h>
+#include <math.h>
+
+// Default configuration values (medium distance preset, 33 ms budget)
+#define DEFAULT_FAST_OSC_FREQUENCY  0xBCCC
+#define DEFAULT_VCSEL_PERIOD        0x05    // 12 bins
+#define DEFAULT_VCSEL_WIDTH         0x28    // 2.5 bins
+#define DEFAULT_REFERENCE_PHASE     0x0B40
+#define DEFAULT_PHASECAL_VCSEL_START 0x0B
+#define DEFAULT_CAL_VCSEL_START     0x05
+#define DEFAULT_PERIODS_ELAPSED     142
+#define DEFAULT_EFFECTIVE_SPADS     0x2400  // 36 SPADs
+#define DEFAULT_SIGNAL_EVENTS_1M    2000.0f
+#define DEFAULT_AMBIENT_EVENTS      8.0f
+
+#define PHASE_PER_BIN       2048        // 5.11 phase units per histogram bin
+#define SHAPE_EVENTS        1024        // Full-bin value of the unit pulse shape
+#define MAX_PULSE_PHASE     (4 * PHASE_PER_BIN)  // Half width the shape model can hold
+#define AMBIENT_SAMPLES     4           // Ambient bins the device would have reported
+#define MIN_DISTANCE_MM     10.0f
+#define MAX_BIN_EVENTS      16777215.0f // 24-bit histogram bins
+
+vl53lx_hist_synth_config_t VL53LX_HistSynthGetDefaultConfig(void)
+{
+    vl53lx_hist_synth_config_t config = {
+        .fast_osc_frequency = DEFAULT_FAST_OSC_FREQUENCY,
+        .vcsel_period = DEFAULT_VCSEL_PERIOD,
+        .vcsel_width = DEFAULT_VCSEL_WIDTH,
+        .phasecal_reference_phase = DEFAULT_REFERENCE_PHASE,
+        .phasecal_vcsel_start = DEFAULT_PHASECAL_VCSEL_START,
+        .cal_vcsel_start = DEFAULT_CAL_VCSEL_START,
+        .total_periods_elapsed = DEFAULT_PERIODS_ELAPSED,
+        .effective_spads = DEFAULT_EFFECTIVE_SPADS,
+        .gain_factor = VL53LX_TUNINGPARM_HIST_GAIN_FACTOR_DEFAULT,
+        .signal_events_1m = DEFAULT_SIGNAL_EVENTS_1M,
+        .ambient_events = DEFAULT_AMBIENT_EVENTS,
+        .xtalk_events = 0.0f,
+        .xtalk_shape = NULL,
+        .enable_noise = true,
+        .seed = 1,
+    };
+    return config;
+}
+
+bool VL53LX_HistSynthInit(vl53lx_hist_synth_t *synth)
+{
+    vl53lx_hist_synth_config_t config = VL53LX_HistSynthGetDefaultConfig();
+    return VL53LX_HistSynthInitWithConfig(synth, &config);
+}
+
+// Spread a pulse of @p events centred on @p phase over the period bins
+static void synth_add_pulse(const vl53lx_hist_synth_t *synth, float *bins, uint32_t phase, float events)
+{
+    VL53LX_xtalk_histogram_shape_t shape;
+    uint32_t width = (uint32_t)synth->config.vcsel_width * 128;  // 4.4 bins -> 5.11 phase
+    uint32_t lead = (width / 2) / PHASE_PER_BIN + 1;             // Shape bins before the centre bin
+    uint32_t centre_bin = phase / PHASE_PER_BIN;
+
+    // Model the pulse near the start of the shape, then rotate it into place
+    VL53LX_hist_xtalk_shape_model(SHAPE_EVENTS,
+                                  (uint16_t)(phase % PHASE_PER_BIN + lead * PHASE_PER_BIN),
+                                  (uint16_t)width, &shape);
+
+    uint32_t area = 0;
+    for (uint8_t lb = 0; lb < VL53LX_XTALK_HISTO_BINS; lb++) {
+        area += shape.bin_data[lb];
+    }
+    if (area == 0) {
+        return;
+    }
+
+    float scale = events / (float)area;
+    for (uint8_t lb = 0; lb < VL53LX_XTALK_HISTO_BINS; lb++) {
+        if (shape.bin_data[lb] != 0) {
+            uint32_t bin = (centre_bin + synth->period_bins + lb - lead) % synth->period_bins;
+            bins[bin] += scale * (float)shape.bin_data[lb];
+        }
+    }
+}
+
+bool VL53LX_HistSynthInitWithConfig(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_config_t *config)
+{
+    if (synth == NULL || config == NULL) {
+        return false;
+    }
+
+    uint8_t period_bins = VL53LX_decode_vcsel_period(config->vcsel_period);
+    uint32_t half_width = (uint32_t)config->vcsel_width * 64;
+    if (period_bins > VL53LX_HISTOGRAM_BUFFER_SIZE || config->fast_osc_frequency == 0 ||
+        config->gain_factor == 0 ||
+        half_width == 0 || half_width > MAX_PULSE_PHASE ||
+        2 * half_width >= (uint32_t)period_bins * PHASE_PER_BIN) {
+        return false;
+    }
+
+    memset(synth, 0, sizeof(*synth));
+    synth->config = *config;
+    synth->period_bins = period_bins;
+    synth->pll_period_mm = VL53LX_calc_pll_period_mm(config->fast_osc_frequency);
+    synth->rng = (config->seed != 0) ? config->seed : 1;
+
+    // Zero distance phase exactly as the driver derives it from phasecal
+    VL53LX_histogram_bin_data_t ref;
+    ref.VL53LX_p_005 = config->vcsel_period;
+    ref.phasecal_result__reference_phase = config->phasecal_reference_phase;
+    ref.phasecal_result__vcsel_start = config->phasecal_vcsel_start;
+    ref.cal_config__vcsel_start = config->cal_vcsel_start;
+    VL53LX_hist_calc_zero_distance_phase(&ref);
+    synth->zero_distance_phase = ref.zero_distance_phase;
+
+    // Ambient and crosstalk do not change between frames
+    float spads = (float)config->effective_spads / 256.0f;
+    for (uint8_t bin = 0; bin < period_bins; bin++) {
+        synth->background[bin] = config->ambient_events * spads;
+    }
+
+    float xtalk_events = config->xtalk_events * spads;
+    if (xtalk_events > 0.0f && config->xtalk_shape != NULL) {
+        const VL53LX_xtalk_histogram_shape_t *shape = config->xtalk_shape;
+        uint32_t area = 0;
+        for (uint8_t lb = 0; lb < shape->VL53LX_p_021 && lb < VL53LX_XTALK_HISTO_BINS; lb++) {
+            area += shape->bin_data[lb];
+        }
+        for (uint8_t lb = 0; area > 0 && lb < shape->VL53LX_p_021 && lb < VL53LX_XTALK_HISTO_BINS; lb++) {
+            uint8_t bin = (uint8_t)((shape->VL53LX_p_019 + lb) % period_bins);
+            synth->background[bin] += xtalk_events * (float)shape->bin_data[lb] / (float)area;
+        }
+    } else if (xtalk_events > 0.0f) {
+        synth_add_pulse(synth, synth->background, synth->zero_distance_phase, xtalk_events);
+    }
+
+    synth->initialized = true;
+
+    return true;
+}
+
+// xorshift32
+static uint32_t synth_rand(vl53lx_hist_synth_t *synth)
+{
+    uint32_t x = synth->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    synth->rng = x;
+    return x;
+}
+
+// Standard normal deviate, Box-Muller pairs
+static float synth_gauss(vl53lx_hist_synth_t *synth)
+{
+    if (synth->has_spare_gauss) {
+        synth->has_spare_gauss = false;
+        return synth->spare_gauss;
+    }
+
+    float u = (float)((synth_rand(synth) >> 8) + 1) * (1.0f / 16777216.0f);  // (0, 1]
+    float v = (float)(synth_rand(synth) >> 8) * (6.28318531f / 16777216.0f);
+    float r = sqrtf(-2.0f * logf(u));
+
+    synth->spare_gauss = r * sinf(v);
+    synth->has_spare_gauss = true;
+    return r * cosf(v);
+}
+
+// Counted events for an expected value: Poisson approximated by a normal
+static int32_t synth_count(vl53lx_hist_synth_t *synth, float expected)
+{
+    if (synth->config.enable_noise) {
+        expected += sqrtf(expected) * synth_gauss(synth);
+    }
+    if (expected < 0.0f) {
+        return 0;
+    }
+    if (expected > MAX_BIN_EVENTS) {
+        return (int32_t)MAX_BIN_EVENTS;
+    }
+    return (int32_t)(expected + 0.5f);
+}
+
+bool VL53LX_HistSynthFrame(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_target_t *targets,
+                           uint8_t count, VL53LX_histogram_bin_data_t *frame)
+{
+    if (synth == NULL || !synth->initialized || frame == NULL ||
+        count > VL53LX_HIST_SYNTH_MAX_TARGETS || (targets == NULL && count > 0)) {
+        return false;
+    }
+
+    const vl53lx_hist_synth_config_t *config = &synth->config;
+    float bins[VL53LX_HISTOGRAM_BUFFER_SIZE];
+    memcpy(bins, synth->background, sizeof(bins));
+
+    float spads = (float)config->effective_spads / 256.0f;
+    // The driver scales ranges by gain_factor, so render the uncorrected phase
+    float phase_per_mm = 32768.0f * 2048.0f / ((float)synth->pll_period_mm * (float)config->gain_factor);
+    uint32_t period_phase = (uint32_t)synth->period_bins * PHASE_PER_BIN;
+
+    for (uint8_t i = 0; i < count; i++) {
+        float distance_mm = targets[i].distance_mm;
+        if (distance_mm < MIN_DISTANCE_MM) {
+            distance_mm = MIN_DISTANCE_MM;
+        }
+
+        float scale = 1000.0f / distance_mm;
+        float events = config->signal_events_1m * spads * targets[i].reflectance_pct * 0.01f * scale * scale;
+        uint32_t phase = (uint32_t)synth->zero_distance_phase +
+                         (uint32_t)(distance_mm * phase_per_mm + 0.5f);
+
+        synth_add_pulse(synth, bins, phase % period_phase, events);
+    }
+
+    VL53LX_init_histogram_bin_data_struct(0, VL53LX_HISTOGRAM_BUFFER_SIZE, frame);
+
+    // The histogram repeats every VCSEL period
+    for (uint8_t bin = 0; bin < VL53LX_HISTOGRAM_BUFFER_SIZE; bin++) {
+        frame->bin_data[bin] = synth_count(synth, bins[bin % synth->period_bins]);
+    }
+
+    // Ambient as the device's ambient bins would have measured it
+    float ambient = config->ambient_events * spads;
+    frame->number_of_ambient_samples = AMBIENT_SAMPLES;
+    frame->ambient_events_sum = 0;
+    for (uint8_t i = 0; i < AMBIENT_SAMPLES; i++) {
+        frame->ambient_events_sum += synth_count(synth, ambient);
+    }
+    frame->VL53LX_p_028 = (frame->ambient_events_sum + AMBIENT_SAMPLES / 2) / AMBIENT_SAMPLES;
+
+    for (uint8_t i = 0; i < VL53LX_MAX_BIN_SEQUENCE_LENGTH; i++) {
+        frame->bin_seq[i] = i;
+        frame->bin_rep[i] = 1;
+    }
+
+    frame->cfg_device_state = VL53LX_DEVICESTATE_RANGING_DSS_AUTO;
+    frame->rd_device_state = VL53LX_DEVICESTATE_RANGING_OUTPUT_DATA;
+    frame->time_stamp = synth->frame_count;
+    frame->result__range_status = VL53LX_DEVICEERROR_RANGECOMPLETE;
+    frame->result__stream_count = (synth->frame_count < 256) ?
+                                  (uint8_t)synth->frame_count :
+                                  (uint8_t)(128 + (synth->frame_count - 256) % 128);
+    frame->result__dss_actual_effective_spads = config->effective_spads;
+    frame->phasecal_result__reference_phase = config->phasecal_reference_phase;
+    frame->phasecal_result__vcsel_start = config->phasecal_vcsel_start;
+    frame->cal_config__vcsel_start = config->cal_vcsel_start;
+    frame->vcsel_width = config->vcsel_width;
+    frame->VL53LX_p_005 = config->vcsel_period;
+    frame->VL53LX_p_015 = config->fast_osc_frequency;
+    frame->total_periods_elapsed = config->total_periods_elapsed;
+    frame->peak_duration_us = VL53LX_duration_maths(VL53LX_calc_pll_period_us(config->fast_osc_frequency),
+                                                    config->vcsel_width,
+                                                    VL53LX_RANGING_WINDOW_VCSEL_PERIODS,
+                                                    config->total_periods_elapsed + 1);
+    frame->zero_distance_phase = synth->zero_distance_phase;
+
+    synth->frame_count++;
+
+    return true;
+}
+
+uint32_t VL53LX_HistSynthSweep(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_sweep_t *sweep,
+                               vl53lx_hist_synth_cb_t callback, void *ctx)
+{
+    if (synth == NULL || !synth->initialized || sweep == NULL || callback == NULL ||
+        sweep->step_mm <= 0.0f) {
+        return 0;
+    }
+
+    VL53LX_histogram_bin_data_t frame;
+    vl53lx_hist_synth_target_t target = {
+        .reflectance_pct = sweep->reflectance_pct,
+    };
+    uint32_t frames = 0;
+
+    // Integer step index so long sweeps do not accumulate rounding
+    for (uint32_t step = 0; ; step++) {
+        target.distance_mm = sweep->start_mm + (float)step * sweep->step_mm;
+        if (target.distance_mm > sweep->stop_mm) {
+            break;
+        }
+
+        for (uint16_t i = 0; i < sweep->frames_per_step; i++) {
+            VL53LX_HistSynthFrame(synth, &target, 1, &frame);
+            callback(&frame, &target, ctx);
+            frames++;
+        }
+    }
+
+    return frames;
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file vl53lx_hist_synth.h
+ * @brief VL53LX Synthetic Histogram Generator
+ *
+ * Produces VL53LX_histogram_bin_data_t frames without a sensor, for
+ * throughput benchmarks and accuracy / dmax sweeps of the histogram
+ * pipeline:
+ * - Target and crosstalk pulses from VL53LX_hist_xtalk_shape_model()
+ * - Range to phase conversion from VL53LX_calc_pll_period_mm()
+ * - Inverse square signal fall-off scaled by reflectance and SPAD count
+ * - Flat ambient, optional shot noise from a seeded generator
+ * - Fixed-size state, no dynamic allocation
+ *
+ * Host test support only; not part of the ESP-IDF component.
+ */
+
+#ifndef VL53LX_HIST_SYNTH_H
+#define VL53LX_HIST_SYNTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vl53lx_hist_structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VL53LX_HIST_SYNTH_MAX_TARGETS   4   ///< Targets per frame
+
+/**
+ * @brief One simulated target
+ */
+typedef struct {
+    float distance_mm;                   ///< True distance (mm), wraps at the VCSEL period
+    float reflectance_pct;               ///< Reflectance (%)
+} vl53lx_hist_synth_target_t;
+
+/**
+ * @brief Generator configuration
+ *
+ * The timing fields default to the medium distance preset with a 33 ms
+ * timing budget, as read back from the device.
+ */
+typedef struct {
+    uint16_t fast_osc_frequency;         ///< Fast oscillator frequency, 4.12 MHz (default: 0xBCCC)
+    uint8_t vcsel_period;                ///< VCSEL period register, (reg + 1) * 2 bins (default: 0x05)
+    uint16_t vcsel_width;                ///< VCSEL pulse width, 4.4 bins (default: 0x28)
+    uint16_t phasecal_reference_phase;   ///< Phasecal reference phase, 5.11 bins (default: 0x0B40)
+    uint8_t phasecal_vcsel_start;        ///< Phasecal VCSEL start (default: 0x0B)
+    uint8_t cal_vcsel_start;             ///< Configured VCSEL start (default: 0x05)
+    uint32_t total_periods_elapsed;      ///< Integration length in VCSEL periods (default: 142)
+    uint16_t effective_spads;            ///< Effective SPAD count, 8.8 (default: 0x2400)
+    uint16_t gain_factor;                ///< Histogram ranging gain to undo, 5.11 (default: tuning default 1987)
+
+    float signal_events_1m;              ///< Pulse events per SPAD, 100% target at 1 m (default: 2000)
+    float ambient_events;                ///< Ambient events per bin per SPAD (default: 8)
+    float xtalk_events;                  ///< Crosstalk pulse events per SPAD, 0 = none (default: 0)
+    const VL53LX_xtalk_histogram_shape_t *xtalk_shape;  ///< Measured crosstalk shape, NULL = modelled pulse at zero distance
+
+    bool enable_noise;                   ///< Add shot noise (default: true)
+    uint32_t seed;                       ///< Noise generator seed, 0 is replaced by 1 (default: 1)
+} vl53lx_hist_synth_config_t;
+
+/**
+ * @brief Generator state structure
+ */
+typedef struct {
+    vl53lx_hist_synth_config_t config;   ///< Generator configuration
+    uint8_t period_bins;                 ///< Histogram bins per VCSEL period
+    uint32_t pll_period_mm;              ///< VL53LX_calc_pll_period_mm() of the oscillator
+    uint16_t zero_distance_phase;        ///< Phase of a target at 0 mm, 5.11 bins
+    float background[VL53LX_HISTOGRAM_BUFFER_SIZE];  ///< Ambient plus crosstalk per bin
+    uint32_t rng;                        ///< Noise generator state
+    float spare_gauss;                   ///< Second normal deviate of the last pair
+    bool has_spare_gauss;                ///< spare_gauss is valid
+    uint32_t frame_count;                ///< Frames generated since init
+    bool initialized;                    ///< Generator initialized flag
+} vl53lx_hist_synth_t;
+
+/**
+ * @brief Distance sweep description
+ */
+typedef struct {
+    float start_mm;                      ///< First distance (mm)
+    float stop_mm;                       ///< Last distance (mm), inclusive
+    float step_mm;                       ///< Distance step (mm), > 0
+    float reflectance_pct;               ///< Target reflectance (%)
+    uint16_t frames_per_step;            ///< Frames generated at each distance
+} vl53lx_hist_synth_sweep_t;
+
+/**
+ * @brief Sweep frame callback
+ *
+ * @param frame Generated frame, only valid during the call
+ * @param target True target of the frame
+ * @param ctx User context passed to VL53LX_HistSynthSweep()
+ */
+typedef void (*vl53lx_hist_synth_cb_t)(const VL53LX_histogram_bin_data_t *frame,
+                                       const vl53lx_hist_synth_target_t *target, void *ctx);
+
+/**
+ * @brief Get default generator configuration
+ *
+ * @return Default configuration structure
+ */
+vl53lx_hist_synth_config_t VL53LX_HistSynthGetDefaultConfig(void);
+
+/**
+ * @brief Initialize generator with default configuration
+ *
+ * @param synth Pointer to generator structure
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_HistSynthInit(vl53lx_hist_synth_t *synth);
+
+/**
+ * @brief Initialize generator with custom configuration
+ *
+ * Fails if the VCSEL period exceeds VL53LX_HISTOGRAM_BUFFER_SIZE bins or
+ * the pulse is wider than the crosstalk shape model.
+ *
+ * @param synth Pointer to generator structure
+ * @param config Pointer to configuration
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_HistSynthInitWithConfig(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_config_t *config);
+
+/**
+ * @brief Generate one frame
+ *
+ * Fills every field VL53LX_get_histogram_bin_data() fills, so the frame can
+ * go straight into the histogram post-processing. The stream count follows
+ * the device: 0..255, then 128..255.
+ *
+ * @param synth Pointer to generator structure
+ * @param targets Targets in the field of view, may be NULL if @p count is 0
+ * @param count Number of targets (max VL53LX_HIST_SYNTH_MAX_TARGETS)
+ * @param frame Output frame
+ * @return true if successful, false otherwise
+ */
+bool VL53LX_HistSynthFrame(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_target_t *targets,
+                           uint8_t count, VL53LX_histogram_bin_data_t *frame);
+
+/**
+ * @brief Generate frames for a single target over a distance range
+ *
+ * @param synth Pointer to generator structure
+ * @param sweep Sweep description
+ * @param callback Called for every frame
+ * @param ctx User context for @p callback
+ * @return Number of frames generated
+ */
+uint32_t VL53LX_HistSynthSweep(vl53lx_hist_synth_t *synth, const vl53lx_hist_synth_sweep_t *sweep,
+                               vl53lx_hist_synth_cb_t callback, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VL53LX_HIST_SYNTH_H
@@ -0,0 +1,246 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_align.c
+ * @brief VL53LX_Align on synthetic timestamped samples
+ *
+ * Sensor 0 samples every 33 ms a target at 600 +- 300 mm (0.5 Hz), sensor 1
+ * every 30 ms one at 900 +- 250 mm (1 Hz); periods and timestamps jitter.
+ * The error is the difference to the true distance at the snapshot time
+ * (for the latest-arrival pairing, at the time the pair is used).
+ * - Holding with no delay is no better than pairing the latest arrivals
+ * - Interpolating with a delay of one period brings the error near the
+ *   1 mm quantisation
+ * - Two producer threads and one consumer: no sample lost, reordered or
+ *   torn
+ * Prints the table and the structure size quoted in the API doc.
+ */
+
+#include "vl53lx_align.h"
+#include "host_test.h"
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define RUN_US          20000000u
+#define SETTLE_US       200000u
+#define STEP_US         100u
+#define OUTPUT_US       20000u
+#define STRESS_SAMPLES  2000000u
+
+typedef enum {
+    MODE_LATEST,                        // Latest arrivals paired, taken as current
+    MODE_HOLD,
+    MODE_INTERPOLATE,
+} align_mode_t;
+
+typedef struct {
+    double square_sum;
+    double max;
+    uint32_t count;
+    uint32_t interpolated;
+    uint64_t age_sum_us;
+} error_stats_t;
+
+static uint32_t rng;
+
+static double uniform(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return ((rng >> 8) & 0xFFFF) / 65535.0;
+}
+
+static double truth(int sensor, double t)
+{
+    return sensor == 0 ? 600.0 + 300.0 * sin(2.0 * M_PI * 0.5 * t) : 900.0 + 250.0 * sin(2.0 * M_PI * t + 1.0);
+}
+
+static void add_error(error_stats_t *e, double error)
+{
+    e->square_sum += error * error;
+    e->max = fabs(error) > e->max ? fabs(error) : e->max;
+    e->count++;
+}
+
+static double rms(const error_stats_t *e)
+{
+    return e->count > 0 ? sqrt(e->square_sum / e->count) : 0.0;
+}
+
+static void run(align_mode_t mode, uint32_t delay_us, double jitter_ms, error_stats_t errors[2])
+{
+    static vl53lx_align_t align;
+    static const uint32_t period_us[2] = { 33000, 30000 };
+    vl53lx_align_config_t config = VL53LX_AlignGetDefaultConfig();
+    config.delay_us = delay_us;
+    config.interpolate = mode == MODE_INTERPOLATE;
+    CHECK(VL53LX_AlignInitWithConfig(&align, &config));
+    CHECK(VL53LX_AlignAddSensor(&align) == 0);
+    CHECK(VL53LX_AlignAddSensor(&align) == 1);
+
+    rng = 7;
+    double next[2] = { 0.010, 0.013 };
+    double latest[2] = { 0.0, 0.0 };
+    bool have[2] = { false, false };
+    uint32_t next_pair_us = SETTLE_US;
+    memset(errors, 0, 2 * sizeof(errors[0]));
+
+    for (uint32_t t_us = 0; t_us < RUN_US; t_us += STEP_US) {
+        double t = t_us / 1e6;
+        for (int s = 0; s < 2; s++) {
+            if (t < next[s]) {
+                continue;
+            }
+            // Measured at the middle of the budget, the interrupt timestamp jitters
+            double measured = next[s] - period_us[s] / 2e6;
+            double timestamp = measured + (uniform() - 0.5) * 2.0 * jitter_ms / 1e3;
+            uint16_t distance = (uint16_t)lround(truth(s, measured));
+            // The pairing baseline does not take from the queues
+            if (mode != MODE_LATEST && timestamp >= 0.0) {
+                CHECK(VL53LX_AlignPush(&align, (uint8_t)s, (uint32_t)(timestamp * 1e6), distance, 0));
+            }
+            latest[s] = distance;
+            have[s] = true;
+            next[s] += period_us[s] / 1e6 + (uniform() - 0.5) * 2.0 * jitter_ms / 1e3;
+        }
+
+        if (mode == MODE_LATEST) {
+            if (t_us >= next_pair_us) {
+                next_pair_us = t_us + OUTPUT_US;
+                for (int s = 0; s < 2; s++) {
+                    if (have[s]) {
+                        add_error(&errors[s], latest[s] - truth(s, t));
+                    }
+                }
+            }
+            continue;
+        }
+
+        vl53lx_align_snapshot_t snapshot;
+        if (!VL53LX_AlignPoll(&align, t_us, &snapshot) || t_us < SETTLE_US) {
+            continue;
+        }
+        for (int s = 0; s < 2; s++) {
+            const vl53lx_align_value_t *v = &snapshot.values[s];
+            CHECK(v->source == VL53LX_ALIGN_INTERPOLATED || v->source == VL53LX_ALIGN_HELD);
+            add_error(&errors[s], v->distance_mm - truth(s, snapshot.timestamp_us / 1e6));
+            errors[s].interpolated += v->source == VL53LX_ALIGN_INTERPOLATED;
+            errors[s].age_sum_us += v->age_us;
+        }
+    }
+    CHECK(align.skipped == 0);
+    CHECK(align.channels[0].dropped == 0 && align.channels[1].dropped == 0);
+}
+
+static void report(const char *name, double jitter_ms, align_mode_t mode, const error_stats_t errors[2])
+{
+    printf("%-26s +-%.1f ms  %5.1f / %5.1f mm  %5.1f / %5.1f mm", name, jitter_ms, rms(&errors[0]), errors[0].max,
+           rms(&errors[1]), errors[1].max);
+    if (mode != MODE_LATEST) {
+        printf("  interpolated %3.0f%% / %3.0f%%, age %4.1f / %4.1f ms",
+               100.0 * errors[0].interpolated / errors[0].count, 100.0 * errors[1].interpolated / errors[1].count,
+               errors[0].age_sum_us / 1e3 / errors[0].count, errors[1].age_sum_us / 1e3 / errors[1].count);
+    }
+    printf("\n");
+}
+
+static void test_accuracy(void)
+{
+    error_stats_t latest[2];
+    error_stats_t hold[2];
+    error_stats_t short_delay[2];
+    error_stats_t full_delay[2];
+    error_stats_t jittery[2];
+
+    printf("mode                       jitter     sensor 0 rms/max   sensor 1 rms/max\n");
+    run(MODE_LATEST, 0, 0.5, latest);
+    report("latest arrivals", 0.5, MODE_LATEST, latest);
+    run(MODE_HOLD, 0, 0.5, hold);
+    report("hold, delay 0", 0.5, MODE_HOLD, hold);
+    run(MODE_INTERPOLATE, 40000, 0.5, short_delay);
+    report("interpolate, delay 40 ms", 0.5, MODE_INTERPOLATE, short_delay);
+    run(MODE_INTERPOLATE, 50000, 0.5, full_delay);
+    report("interpolate, delay 50 ms", 0.5, MODE_INTERPOLATE, full_delay);
+    run(MODE_INTERPOLATE, 50000, 2.0, jittery);
+    report("interpolate, delay 50 ms", 2.0, MODE_INTERPOLATE, jittery);
+
+    for (int s = 0; s < 2; s++) {
+        // Holding gives the latest values, but says how old they are
+        CHECK(fabs(rms(&hold[s]) - rms(&latest[s])) < 1.0);
+        CHECK(hold[s].interpolated == 0);
+        CHECK(rms(&short_delay[s]) < rms(&hold[s]) / 4.0);
+        CHECK(full_delay[s].interpolated == full_delay[s].count);
+        CHECK(rms(&full_delay[s]) < 1.0 && full_delay[s].max < 3.0);
+        CHECK(rms(&jittery[s]) < 2.0 && jittery[s].max < 5.0);
+    }
+}
+
+static vl53lx_align_t stress;
+
+static void *producer(void *arg)
+{
+    uint8_t sensor = (uint8_t)(intptr_t)arg;
+    for (uint32_t i = 1; i <= STRESS_SAMPLES;) {
+        if (VL53LX_AlignPush(&stress, sensor, i * 1000u, (uint16_t)(i * 7u), 0)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_producers(void)
+{
+    pthread_t threads[2];
+    uint32_t newest[2] = { 0, 0 };
+    uint32_t torn = 0;
+    uint32_t reordered = 0;
+
+    CHECK(VL53LX_AlignInit(&stress));
+    CHECK(VL53LX_AlignAddSensor(&stress) == 0);
+    CHECK(VL53LX_AlignAddSensor(&stress) == 1);
+    for (intptr_t s = 0; s < 2; s++) {
+        CHECK(pthread_create(&threads[s], NULL, producer, (void *)s) == 0);
+    }
+
+    while (stress.channels[0].received < STRESS_SAMPLES || stress.channels[1].received < STRESS_SAMPLES) {
+        vl53lx_align_snapshot_t snapshot;
+        VL53LX_AlignSnapshot(&stress, UINT32_MAX / 2, &snapshot);
+        for (int s = 0; s < 2; s++) {
+            const vl53lx_align_channel_t *channel = &stress.channels[s];
+            for (uint8_t h = 0; h < channel->history_count; h++) {
+                const vl53lx_align_sample_t *sample = &channel->history[h];
+                torn += (uint16_t)(sample->timestamp_us / 1000u * 7u) != sample->distance_mm;
+            }
+            if (channel->history_count > 0) {
+                uint32_t t = channel->history[channel->history_count - 1].timestamp_us;
+                reordered += t < newest[s];
+                newest[s] = t;
+            }
+        }
+        sched_yield();
+    }
+    for (int s = 0; s < 2; s++) {
+        pthread_join(threads[s], NULL);
+    }
+
+    printf("2 producers x %u samples: received %u / %u, out of order %u / %u, torn %u\n", STRESS_SAMPLES,
+           stress.channels[0].received, stress.channels[1].received, stress.channels[0].out_of_order,
+           stress.channels[1].out_of_order, torn);
+    CHECK(torn == 0 && reordered == 0);
+    CHECK(stress.channels[0].out_of_order == 0 && stress.channels[1].out_of_order == 0);
+    CHECK(stress.channels[0].received == STRESS_SAMPLES && stress.channels[1].received == STRESS_SAMPLES);
+    printf("sizeof: vl53lx_align_t %zu\n", sizeof(vl53lx_align_t));
+}
+
+int main(void)
+{
+    test_accuracy();
+    test_concurrent_producers();
+    return host_test_result();
+}
@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_bringup.c
+ * @brief VL53LX_BringupRun() on simulated sensors sharing one bus
+ *
+ * - 1 to 8 sensors come up at their addresses without a collision at the
+ *   default address, faster than the one-by-one sequence with fixed
+ *   10 ms waits, and faster again with NVM cache hits
+ * - A sensor that never boots fails with a timeout, is put back in reset
+ *   and the others still come up; the sensor keeping 0x29 is released last
+ * Prints the bring-up time of each case and the bus utilisation.
+ */
+
+#include "vl53lx_bringup.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <string.h>
+
+#define MAX_SENSORS     8
+#define FIRST_ADDRESS   0x30
+
+static VL53LX_Dev_t devs[MAX_SENSORS];
+static VL53LX_nvm_cache_t caches[MAX_SENSORS];
+static const uint32_t boot_us[MAX_SENSORS] = { 1050, 1180, 990, 1120, 1010, 1150, 1080, 1200 };
+
+static bool hal_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    (void)ctx;
+    sim_device_xshut(index, release);
+    return true;
+}
+
+static bool hal_bind(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address)
+{
+    (void)ctx;
+    (void)index;
+    dev->I2cHandle = sim_bus_handle(0);
+    dev->I2cDevAddr = address;
+    return true;
+}
+
+static const vl53lx_bringup_hal_t hal = { .set_xshut = hal_set_xshut, .bind = hal_bind };
+
+static void add_sensors(int n)
+{
+    sim_reset();
+    for (int i = 0; i < n; i++) {
+        sim_device_add(0, 100 + i, boot_us[i]);
+        memset(&devs[i], 0, sizeof(devs[i]));
+        devs[i].I2cHandle = sim_bus_handle(0);
+    }
+}
+
+// The sample's sequence: fixed 10 ms waits, addresses one by one, then DataInit one by one
+static uint64_t serial(int n)
+{
+    add_sensors(n);
+    uint64_t start_us = sim_now_us(0);
+    sim_advance_us(0, 10000);
+    for (int i = 0; i < n; i++) {
+        sim_device_xshut(i, true);
+        sim_advance_us(0, 10000);
+        devs[i].I2cDevAddr = SIM_DEFAULT_ADDRESS;
+        CHECK(VL53LX_SetDeviceAddress(&devs[i], (uint8_t)((FIRST_ADDRESS + i) << 1)) == VL53LX_ERROR_NONE);
+        devs[i].I2cDevAddr = FIRST_ADDRESS + i;
+    }
+    for (int i = 0; i < n; i++) {
+        CHECK(VL53LX_WaitDeviceBooted(&devs[i]) == VL53LX_ERROR_NONE);
+        CHECK(VL53LX_DataInit(&devs[i]) == VL53LX_ERROR_NONE);
+    }
+    return sim_now_us(0) - start_us;
+}
+
+static uint64_t parallel(int n, bool cache, vl53lx_bringup_t *bringup)
+{
+    add_sensors(n);
+    uint64_t start_us = sim_now_us(0);
+    CHECK(VL53LX_BringupInit(bringup, &hal));
+    for (int i = 0; i < n; i++) {
+        caches[i].hit = 0;
+        caches[i].updated = 0;
+        CHECK(VL53LX_BringupAddDevice(bringup, &devs[i], (uint8_t)(FIRST_ADDRESS + i), cache ? &caches[i] : NULL));
+    }
+    CHECK(VL53LX_BringupRun(bringup) == n);
+    CHECK(sim_bus_stats(0)->collisions == 0);
+    for (int i = 0; i < n; i++) {
+        CHECK(sim_device_address(i) == FIRST_ADDRESS + i);
+        CHECK(!cache || caches[i].hit || caches[i].updated);
+    }
+    return sim_now_us(0) - start_us;
+}
+
+static void test_faster_than_serial(void)
+{
+    static vl53lx_bringup_t bringup;
+    static const int counts[] = { 1, 2, 4, 8 };
+
+    printf(" N  one by one  bring-up  + NVM cache  bus busy\n");
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        int n = counts[k];
+        memset(caches, 0, sizeof(caches));
+        uint64_t serial_us = serial(n);
+        uint64_t parallel_us = parallel(n, false, &bringup);
+        double busy = (double)sim_bus_stats(0)->busy_us / (double)bringup.total_us;
+        parallel(n, true, &bringup);            // Fills the caches
+        uint64_t cached_us = parallel(n, true, &bringup);
+        for (int i = 0; i < n; i++) {
+            CHECK(caches[i].hit);
+        }
+        printf("%2d  %7.1f ms  %5.1f ms  %8.1f ms  %5.0f%%\n", n, serial_us / 1000.0, parallel_us / 1000.0,
+               cached_us / 1000.0, busy * 100.0);
+
+        CHECK(parallel_us < serial_us);
+        CHECK(cached_us < parallel_us);
+        // Boot waits hide behind DataInit once there is a second sensor
+        CHECK(n == 1 || busy > 0.85);
+    }
+}
+
+static void test_failed_sensor(void)
+{
+    vl53lx_bringup_t bringup;
+    add_sensors(3);
+    sim_device_never_boot(1);
+
+    CHECK(VL53LX_BringupInit(&bringup, &hal));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[0], SIM_DEFAULT_ADDRESS, NULL));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[1], 0x31, NULL));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[2], 0x32, NULL));
+    CHECK(!VL53LX_BringupAddDevice(&bringup, &devs[2], 0x31, NULL));   // Address taken
+
+    CHECK(VL53LX_BringupRun(&bringup) == 2);
+    CHECK(bringup.devices[1].state == VL53LX_BRINGUP_FAILED);
+    CHECK(bringup.devices[1].error == VL53LX_ERROR_TIME_OUT);
+    CHECK(bringup.devices[0].state == VL53LX_BRINGUP_READY);
+    CHECK(bringup.devices[2].state == VL53LX_BRINGUP_READY);
+    CHECK(sim_device_address(2) == 0x32);
+    CHECK(sim_bus_stats(0)->collisions == 0);
+
+    // The sensor keeping the default address came out of reset last
+    CHECK(bringup.devices[0].timing.release_us > bringup.devices[2].timing.release_us);
+    CHECK(bringup.devices[0].timing.release_us > bringup.devices[1].timing.release_us);
+}
+
+int main(void)
+{
+    test_faster_than_serial();
+    test_failed_sensor();
+    return host_test_result();
+}
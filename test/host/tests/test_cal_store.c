@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_cal_store.c
+ * @brief Calibration store with the file backend and the bring-up hook
+ *
+ * - A saved record is applied after a restart of the same sensor
+ * - A record saved in another distance mode, a corrupt record and the
+ *   record of another sensor are rejected; the first two are erased
+ * - VL53LX_BringupRun() with cal_storage applies each sensor's record
+ *   after DataInit and reports sensors without one
+ */
+
+#include "vl53lx_cal_store.h"
+#include "vl53lx_bringup.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SEED_A          21
+#define SEED_B          22
+#define OFFSET_A        17
+#define OFFSET_B        -9
+
+static char directory[] = "/tmp/vl53lx_cal_store_XXXXXX";
+static vl53lx_cal_storage_t storage;
+static VL53LX_Dev_t dev;
+
+// Power up a single sensor and init it in medium mode
+static void boot(uint32_t seed, VL53LX_DistanceModes mode)
+{
+    sim_single_device(&dev, seed);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetDistanceMode(&dev, mode) == VL53LX_ERROR_NONE);
+}
+
+static int16_t inner_offset(const VL53LX_Dev_t *d)
+{
+    return d->Data.LLData.customer.mm_config__inner_offset_mm;
+}
+
+// Stand-in for a calibration run
+static void calibrate(int16_t offset_mm)
+{
+    VL53LX_CalibrationData_t cal;
+    CHECK(VL53LX_GetCalibrationData(&dev, &cal) == VL53LX_ERROR_NONE);
+    cal.customer.mm_config__inner_offset_mm = offset_mm;
+    CHECK(VL53LX_SetCalibrationData(&dev, &cal) == VL53LX_ERROR_NONE);
+}
+
+static void record_path(uint32_t seed, char *path, size_t size)
+{
+    uint64_t uid;
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    boot(seed, VL53LX_DISTANCEMODE_MEDIUM);
+    CHECK(VL53LX_GetUID(&dev, &uid) == VL53LX_ERROR_NONE);
+    VL53LX_CalStoreMakeKey(uid, key);
+    snprintf(path, size, "%s/%s.bin", directory, key);
+}
+
+static void test_round_trip(void)
+{
+    boot(SEED_A, VL53LX_DISTANCEMODE_MEDIUM);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_NOT_FOUND);
+    calibrate(OFFSET_A);
+    CHECK(VL53LX_CalStoreSave(&dev, &storage) == VL53LX_CAL_STORE_OK);
+
+    boot(SEED_A, VL53LX_DISTANCEMODE_MEDIUM);
+    CHECK(inner_offset(&dev) != OFFSET_A);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_OK);
+    CHECK(inner_offset(&dev) == OFFSET_A);
+
+    VL53LX_CalibrationData_t cal;
+    CHECK(VL53LX_CalStoreLoad(&dev, &storage, &cal) == VL53LX_CAL_STORE_OK);
+    CHECK(cal.customer.mm_config__inner_offset_mm == OFFSET_A);
+}
+
+static void test_rejected_records(void)
+{
+    char path_a[160];
+    char path_b[160];
+    VL53LX_CalibrationData_t cal;
+
+    // Another distance mode: stale, erased
+    boot(SEED_A, VL53LX_DISTANCEMODE_LONG);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_STALE);
+    CHECK(VL53LX_CalStoreLoad(&dev, &storage, &cal) == VL53LX_CAL_STORE_NOT_FOUND);
+
+    // One flipped payload byte: corrupt, erased
+    boot(SEED_A, VL53LX_DISTANCEMODE_MEDIUM);
+    calibrate(OFFSET_A);
+    CHECK(VL53LX_CalStoreSave(&dev, &storage) == VL53LX_CAL_STORE_OK);
+    record_path(SEED_A, path_a, sizeof(path_a));
+    FILE *f = fopen(path_a, "r+b");
+    CHECK(f != NULL);
+    if (f != NULL) {
+        fseek(f, (long)sizeof(vl53lx_cal_record_header_t) + 8, SEEK_SET);
+        int c = fgetc(f);
+        fseek(f, (long)sizeof(vl53lx_cal_record_header_t) + 8, SEEK_SET);
+        fputc(c ^ 0x40, f);
+        fclose(f);
+    }
+    boot(SEED_A, VL53LX_DISTANCEMODE_MEDIUM);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_CORRUPT);
+    CHECK(VL53LX_CalStoreLoad(&dev, &storage, &cal) == VL53LX_CAL_STORE_NOT_FOUND);
+
+    // The record of sensor A under the key of sensor B: kept, not applied
+    calibrate(OFFSET_A);
+    CHECK(VL53LX_CalStoreSave(&dev, &storage) == VL53LX_CAL_STORE_OK);
+    record_path(SEED_B, path_b, sizeof(path_b));
+    CHECK(rename(path_a, path_b) == 0);
+    boot(SEED_B, VL53LX_DISTANCEMODE_MEDIUM);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_UID_MISMATCH);
+    CHECK(inner_offset(&dev) != OFFSET_A);
+    CHECK(VL53LX_CalStoreErase(&dev, &storage) == VL53LX_CAL_STORE_OK);
+}
+
+static bool hal_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    (void)ctx;
+    sim_device_xshut(index, release);
+    return true;
+}
+
+static bool hal_bind(void *ctx, uint8_t index, VL53LX_DEV d, uint8_t address)
+{
+    (void)ctx;
+    (void)index;
+    d->I2cHandle = sim_bus_handle(0);
+    d->I2cDevAddr = address;
+    return true;
+}
+
+static void test_bringup_applies(void)
+{
+    static VL53LX_Dev_t devs[2];
+
+    // Only sensor A has a record, saved in long mode
+    boot(SEED_A, VL53LX_DISTANCEMODE_LONG);
+    calibrate(OFFSET_A);
+    CHECK(VL53LX_CalStoreSave(&dev, &storage) == VL53LX_CAL_STORE_OK);
+
+    sim_reset();
+    sim_device_add(0, SEED_A, SIM_DEFAULT_BOOT_US);
+    sim_device_add(0, SEED_B, SIM_DEFAULT_BOOT_US);
+    memset(devs, 0, sizeof(devs));
+
+    vl53lx_bringup_hal_t hal = { .set_xshut = hal_set_xshut, .bind = hal_bind };
+    vl53lx_bringup_config_t config = VL53LX_BringupGetDefaultConfig();
+    config.distance_mode = VL53LX_DISTANCEMODE_LONG;
+    config.cal_storage = &storage;
+    vl53lx_bringup_t bringup;
+    CHECK(VL53LX_BringupInitWithConfig(&bringup, &hal, &config));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[0], 0x30, NULL));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[1], 0x31, NULL));
+    CHECK(VL53LX_BringupRun(&bringup) == 2);
+
+    CHECK(bringup.devices[0].cal_status == VL53LX_CAL_STORE_OK);
+    CHECK(bringup.devices[1].cal_status == VL53LX_CAL_STORE_NOT_FOUND);
+    CHECK(inner_offset(&devs[0]) == OFFSET_A);
+    CHECK(devs[0].Data.LLData.preset_mode == devs[1].Data.LLData.preset_mode);
+
+    // Calibrate the sensor without a record; the next bring-up applies both
+    VL53LX_Dev_t *saved = &devs[1];
+    VL53LX_CalibrationData_t cal;
+    CHECK(VL53LX_GetCalibrationData(saved, &cal) == VL53LX_ERROR_NONE);
+    cal.customer.mm_config__inner_offset_mm = OFFSET_B;
+    CHECK(VL53LX_SetCalibrationData(saved, &cal) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_CalStoreSave(saved, &storage) == VL53LX_CAL_STORE_OK);
+
+    sim_device_xshut(0, false);
+    sim_device_xshut(1, false);
+    memset(devs, 0, sizeof(devs));
+    CHECK(VL53LX_BringupInitWithConfig(&bringup, &hal, &config));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[0], 0x30, NULL));
+    CHECK(VL53LX_BringupAddDevice(&bringup, &devs[1], 0x31, NULL));
+    CHECK(VL53LX_BringupRun(&bringup) == 2);
+    CHECK(bringup.devices[0].cal_status == VL53LX_CAL_STORE_OK);
+    CHECK(bringup.devices[1].cal_status == VL53LX_CAL_STORE_OK);
+    CHECK(inner_offset(&devs[0]) == OFFSET_A);
+    CHECK(inner_offset(&devs[1]) == OFFSET_B);
+
+    CHECK(VL53LX_CalStoreErase(&devs[0], &storage) == VL53LX_CAL_STORE_OK);
+    CHECK(VL53LX_CalStoreErase(&devs[1], &storage) == VL53LX_CAL_STORE_OK);
+}
+
+int main(void)
+{
+    CHECK(mkdtemp(directory) != NULL);
+    CHECK(VL53LX_CalStorageInitFile(&storage, directory));
+
+    test_round_trip();
+    test_rejected_records();
+    test_bringup_applies();
+
+    rmdir(directory);
+    return host_test_result();
+}
@@ -0,0 +1,249 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_dmax_cache.c
+ * @brief VL53LX_dmax_calc_cached(): unchanged results and cache keying
+ *
+ * - With an exact key (ambient_quant_shift 0) the cached path returns the
+ *   same dmax as VL53LX_f_001() for every reflectance
+ * - A change of any calibration, configuration or timing input misses,
+ *   also an ambient event count that rounds to the same ambient rate
+ * - VL53LX_set_dmax_mode() invalidates the cache
+ * Prints ns per frame for the full evaluation, one reflectance and a hit.
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_dmax.h"
+#include "vl53lx_tuning_parm_defaults.h"
+#include "vl53lx_hist_synth.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <string.h>
+
+#define BENCH_FRAMES    1000000
+
+static VL53LX_dmax_calibration_data_t cal;
+static VL53LX_hist_gen3_dmax_config_t cfg;
+static VL53LX_hist_gen3_dmax_private_data_t priv;
+
+static void setup(void)
+{
+    cal.ref__actual_effective_spads = 0x5000;
+    cal.ref__peak_signal_count_rate_mcps = 0x0F00;
+    cal.ref__distance_mm = 600;
+    cal.ref_reflectance_pc = 0x0014;
+    cal.coverglass_transmission = 0x0100;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.signal_thresh_sigma = VL53LX_TUNINGPARM_DMAX_CFG_SIGNAL_THRESH_SIGMA_DEFAULT;
+    cfg.ambient_thresh_sigma = 0x70;
+    cfg.min_ambient_thresh_events = 16;
+    cfg.signal_total_events_limit = 100;
+    cfg.max_effective_spads = 0xA000;
+    cfg.dss_config__target_total_rate_mcps = 0x0A00;
+    cfg.dss_config__aperture_attenuation = 0x33;
+    static const uint16_t reflectance[VL53LX_MAX_AMBIENT_DMAX_VALUES] = {
+        VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_0_DEFAULT,
+        VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_1_DEFAULT,
+        VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_2_DEFAULT,
+        VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_3_DEFAULT,
+        VL53LX_TUNINGPARM_DMAX_CFG_REFLECTANCE_ARRAY_4_DEFAULT,
+    };
+    memcpy(cfg.target_reflectance_for_dmax_calc, reflectance, sizeof(reflectance));
+}
+
+static void make_bins(VL53LX_histogram_bin_data_t *bins, float ambient_events, uint8_t vcsel_period)
+{
+    vl53lx_hist_synth_t synth;
+    VL53LX_HistSynthInit(&synth);
+    vl53lx_hist_synth_config_t config = synth.config;
+    config.ambient_events = ambient_events;
+    config.vcsel_period = vcsel_period;
+    config.enable_noise = false;
+    VL53LX_HistSynthInitWithConfig(&synth, &config);
+    vl53lx_hist_synth_target_t target = { 1000.0f, 50.0f };
+    VL53LX_HistSynthFrame(&synth, &target, 1, bins);
+    bins->VL53LX_p_028 = bins->ambient_events_sum / 4;
+}
+
+static void reference(VL53LX_histogram_bin_data_t *bins, int16_t *dmax)
+{
+    for (uint8_t p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
+        VL53LX_f_001(cfg.target_reflectance_for_dmax_calc[p], &cal, &cfg, bins, &priv, &dmax[p]);
+    }
+}
+
+static void cached(VL53LX_dmax_cache_t *cache, VL53LX_histogram_bin_data_t *bins, int16_t *dmax)
+{
+    memset(dmax, 0, VL53LX_MAX_AMBIENT_DMAX_VALUES * sizeof(*dmax));
+    CHECK(VL53LX_dmax_calc_cached(cache, &cal, &cfg, bins, &priv, dmax) == VL53LX_ERROR_NONE);
+}
+
+static void init_cache(VL53LX_dmax_cache_t *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->reflectance_mask = VL53LX_DMAX_REFLECTANCE_MASK_ALL;
+    cache->cache_enable = 1;
+    cache->ambient_quant_shift = 0;
+    cache->refresh_period = 255;
+}
+
+// Cached results equal the uncached evaluation over a range of ambients
+static void test_unchanged_results(void)
+{
+    VL53LX_dmax_cache_t cache;
+    init_cache(&cache);
+
+    static const float ambients[] = { 1.0f, 8.0f, 8.0f, 40.0f, 8.0f, 120.0f };
+    for (size_t i = 0; i < sizeof(ambients) / sizeof(ambients[0]); i++) {
+        VL53LX_histogram_bin_data_t bins;
+        int16_t want[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+        int16_t got[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+        make_bins(&bins, ambients[i], 0x0B);
+        reference(&bins, want);
+        cached(&cache, &bins, got);
+        CHECK_MSG(memcmp(want, got, sizeof(want)) == 0, "ambient %.0f", (double)ambients[i]);
+        CHECK(want[1] > 0);
+    }
+    // Both repeats of 8 hit: 40 replaces the entry of 1, not the one of 8
+    CHECK(cache.hit_count == 2);
+}
+
+// Every input of the reflectance stage is part of the key
+static void test_key_covers_inputs(void)
+{
+    VL53LX_dmax_cache_t cache;
+    VL53LX_histogram_bin_data_t bins;
+    int16_t want[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+    int16_t got[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+
+    init_cache(&cache);
+    make_bins(&bins, 8.0f, 0x0B);
+    cached(&cache, &bins, got);
+    cached(&cache, &bins, got);
+    CHECK(cache.hit_count == 1 && cache.miss_count == 1);
+
+    // Calibration data (a dmax mode switch changes this)
+    cal.ref__distance_mm = 400;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 2);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+    cal.coverglass_transmission = 0x00C0;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 3);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+
+    // Tuning
+    cfg.signal_thresh_sigma = 0x18;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 4);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+    cfg.target_reflectance_for_dmax_calc[2] = 100;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 5);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+
+    // Timing: VCSEL width and integration length
+    bins.vcsel_width += 0x10;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 6);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+    bins.total_periods_elapsed += 20;
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 7);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+
+    // Ambient events: the rate keeps about one bit in three of the count
+    VL53LX_hist_gen3_dmax_private_data_t before;
+    VL53LX_dmax_calc_ambient_terms(&cal, &cfg, &bins, &before);
+    int32_t events = bins.VL53LX_p_028;
+    for (int32_t d = 1; d < 8; d++) {
+        bins.VL53LX_p_028 = events + (d & 1 ? (d + 1) / 2 : -d / 2);
+        VL53LX_dmax_calc_ambient_terms(&cal, &cfg, &bins, &priv);
+        if (priv.VL53LX_p_034 == before.VL53LX_p_034) {
+            break;
+        }
+    }
+    CHECK(bins.VL53LX_p_028 != events && priv.VL53LX_p_034 == before.VL53LX_p_034);
+    reference(&bins, want);
+    cached(&cache, &bins, got);
+    CHECK(cache.miss_count == 8);
+    CHECK(memcmp(want, got, sizeof(want)) == 0);
+
+    setup();
+}
+
+static double bench(VL53LX_dmax_cache_t *cache, VL53LX_histogram_bin_data_t *bins)
+{
+    int16_t dmax[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+    volatile int32_t sink = 0;
+    uint64_t start_ns = host_time_ns();
+    for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+        VL53LX_dmax_calc_cached(cache, &cal, &cfg, bins, &priv, dmax);
+        sink += dmax[1];
+    }
+    return (double)(host_time_ns() - start_ns) / BENCH_FRAMES;
+}
+
+// The dmax stage per frame as VL53LX_f_025() runs it
+static void test_speed(void)
+{
+    VL53LX_dmax_cache_t cache;
+    VL53LX_histogram_bin_data_t bins;
+    make_bins(&bins, 8.0f, 0x0B);
+
+    init_cache(&cache);
+    cache.cache_enable = 0;
+    double full_ns = bench(&cache, &bins);
+    cache.reflectance_mask = 1 << 1;
+    double one_ns = bench(&cache, &bins);
+    init_cache(&cache);
+    double hit_ns = bench(&cache, &bins);
+    // Recomputed every refresh_period lookups
+    CHECK(cache.miss_count == BENCH_FRAMES / 256 + 1);
+
+    printf("ns per frame: 5 reflectances %.0f, 1 reflectance %.0f, cache hit %.0f\n", full_ns, one_ns, hit_ns);
+    CHECK(hit_ns < full_ns);
+}
+
+// VL53LX_set_dmax_mode() drops the cached entries
+static void test_dmax_mode_invalidates(void)
+{
+    static VL53LX_Dev_t dev;
+    sim_single_device(&dev, 1);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_dmax_cache_config(&dev, VL53LX_DMAX_REFLECTANCE_MASK_ALL, 1, 0, 255) == VL53LX_ERROR_NONE);
+
+    VL53LX_dmax_cache_t *cache = &dev.Data.LLData.dmax_cache;
+    VL53LX_histogram_bin_data_t bins;
+    int16_t got[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+    make_bins(&bins, 8.0f, 0x0B);
+    cached(cache, &bins, got);
+    CHECK(cache->entry[0].valid);
+
+    CHECK(VL53LX_set_dmax_mode(&dev, VL53LX_DEVICEDMAXMODE__CUST_CAL_DATA) == VL53LX_ERROR_NONE);
+    for (uint8_t e = 0; e < VL53LX_DMAX_CACHE_ENTRIES; e++) {
+        CHECK(!cache->entry[e].valid);
+    }
+}
+
+int main(void)
+{
+    setup();
+    test_unchanged_results();
+    test_key_covers_inputs();
+    test_dmax_mode_invalidates();
+    test_speed();
+    return host_test_result();
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_hist_gate.c
+ * @brief Distance gate of the histogram pulse search
+ *
+ * Scene: a 50% target at 2 m and a faint decoy at 400 mm, long distance
+ * mode, through the simulated device and the full ranging chain. A
+ * tighter sigma limit makes the decoy fail the sigma check.
+ * - Decoy in the window, target outside: the gated pass has no valid
+ *   target, the ungated search runs again and the target is reported
+ * - Target in the window: the decoy is not characterised, the target is
+ *   reported in every frame
+ * - Detection rate and compute saved (pulses characterised, ns/frame)
+ *   against the ungated search
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <stdlib.h>
+
+#define FRAMES          60
+#define SETTLE_FRAMES   2               // The first frame of each timing has no wrap check
+#define TARGET_MM       2000.0f
+#define DECOY_MM        400.0f
+#define SIGMA_LIMIT     30              // VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM, default 180
+#define TOLERANCE_MM    30
+
+typedef struct {
+    uint32_t detected;                  // Frames with a valid range at the target, after the settle frames
+    uint32_t decoys;                    // Frames reporting the decoy
+    double ns_per_frame;                // Host CPU time of a frame
+    VL53LX_hist_gate_t gate;            // VL53LX_get_hist_gate_stats() after the run
+} run_t;
+
+static run_t run(uint8_t gate_enable, int16_t min_mm, int16_t max_mm)
+{
+    static VL53LX_Dev_t dev;
+    static sim_scene_t scene;
+    run_t result = { 0 };
+    int index = sim_single_device(&dev, 5);
+
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetDistanceMode(&dev, VL53LX_DISTANCEMODE_LONG) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetMeasurementTimingBudgetMicroSeconds(&dev, 33000) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_tuning_parm(&dev, VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM, SIGMA_LIMIT) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_hist_gate(&dev, gate_enable, min_mm, max_mm, 1) == VL53LX_ERROR_NONE);
+
+    vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+    base.seed = 5;
+    sim_scene_init(&scene, &dev, &base);
+    sim_device_set_source(index, sim_scene_frame, &scene);
+    vl53lx_hist_synth_target_t targets[2] = { { DECOY_MM, 0.06f }, { TARGET_MM, 50.0f } };
+    sim_scene_set_targets(&scene, targets, 2);
+    CHECK(VL53LX_StartMeasurement(&dev) == VL53LX_ERROR_NONE);
+
+    uint64_t ns = 0;
+    for (int k = 0; k < FRAMES; k++) {
+        VL53LX_MultiRangingData_t data;
+        uint64_t t0 = host_time_ns();
+        CHECK(sim_scene_range(&dev, index, &data) == VL53LX_ERROR_NONE);
+        ns += host_time_ns() - t0;
+
+        bool detected = false;
+        bool decoy = false;
+        for (uint8_t o = 0; o < data.NumberOfObjectsFound; o++) {
+            int16_t mm = data.RangeData[o].RangeMilliMeter;
+            if (abs(mm - (int)TARGET_MM) <= TOLERANCE_MM &&
+                data.RangeData[o].RangeStatus == VL53LX_RANGESTATUS_RANGE_VALID) {
+                detected = true;
+            }
+            if (abs(mm - (int)DECOY_MM) <= TOLERANCE_MM) {
+                decoy = true;
+            }
+        }
+        if (k >= SETTLE_FRAMES) {
+            result.detected += detected ? 1 : 0;
+        }
+        result.decoys += decoy ? 1 : 0;
+    }
+    VL53LX_StopMeasurement(&dev);
+
+    result.ns_per_frame = (double)ns / FRAMES;
+    CHECK(VL53LX_get_hist_gate_stats(&dev, &result.gate) == VL53LX_ERROR_NONE);
+    return result;
+}
+
+static void report(const char *name, const run_t *r)
+{
+    printf("%-22s detected %2u/%u, decoy %2u, pulses %3u found %3u characterised, %u reruns, %.0f ns/frame\n", name,
+           r->detected, FRAMES - SETTLE_FRAMES, r->decoys, r->gate.pulses_found, r->gate.pulses_characterised, r->gate.rerun_count,
+           r->ns_per_frame);
+}
+
+static void test_gate(void)
+{
+    run_t ungated = run(0, 0, 0);
+    run_t decoy_window = run(1, (int16_t)DECOY_MM - 100, (int16_t)DECOY_MM + 100);
+    run_t target_window = run(1, (int16_t)TARGET_MM - 100, (int16_t)TARGET_MM + 100);
+
+    report("ungated", &ungated);
+    report("decoy in window", &decoy_window);
+    report("target in window", &target_window);
+
+    CHECK(ungated.detected == FRAMES - SETTLE_FRAMES && ungated.decoys > 0);
+    CHECK(ungated.gate.pass_count == 0 && ungated.gate.pulses_characterised == 0);
+
+    // The decoy fails the sigma check, so each frame that dropped the target
+    // runs again and characterises both pulses a second time
+    CHECK(decoy_window.detected == FRAMES - SETTLE_FRAMES);
+    CHECK(decoy_window.gate.rerun_count > 0);
+    CHECK(decoy_window.gate.rerun_count == decoy_window.gate.pulses_skipped);
+    CHECK(decoy_window.gate.pulses_characterised ==
+          decoy_window.gate.pulses_found - decoy_window.gate.pulses_skipped + 2 * decoy_window.gate.rerun_count);
+
+    CHECK(target_window.detected == FRAMES - SETTLE_FRAMES && target_window.decoys == 0);
+    CHECK(target_window.gate.rerun_count == 0 && target_window.gate.fallback_count == 0);
+    CHECK(target_window.gate.pulses_skipped > 0);
+    CHECK(target_window.gate.pulses_characterised ==
+          target_window.gate.pulses_found - target_window.gate.pulses_skipped);
+    printf("compute saved with the target in the window: %.0f%% of the pulses, %.0f%% of the frame time\n",
+           100.0 * target_window.gate.pulses_skipped / target_window.gate.pulses_found,
+           100.0 * (1.0 - target_window.ns_per_frame / ungated.ns_per_frame));
+}
+
+int main(void)
+{
+    test_gate();
+    return host_test_result();
+}
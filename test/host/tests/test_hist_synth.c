@@ -0,0 +1,232 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_hist_synth.c
+ * @brief Synthetic histogram generator and driver accuracy sweep
+ *
+ * - Frames are reproducible for a seed, and the sweep visits every step
+ * - Unsupported timings are rejected
+ * - Accuracy sweep: frames rendered for the timing the driver programmed
+ *   go through the simulated device and the full ranging chain; the
+ *   reported range must match the rendered distance in medium and long
+ *   mode
+ * - Throughput: frames/s of the generator over millions of frames, with
+ *   and without shot noise
+ * - dmax curve: VL53LX_f_001() on rendered frames over an ambient sweep
+ *   for the default reflectance array; dmax falls with ambient and rises
+ *   with reflectance
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_preset_modes.h"
+#include "vl53lx_dmax.h"
+#include "vl53lx_hist_synth.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <math.h>
+#include <string.h>
+
+#define SETTLE_FRAMES   8               // Histogram merge spans the frames before a distance step
+#define MEASURE_FRAMES  4
+#define BENCH_FRAMES    2000000
+
+static void test_reproducible(void)
+{
+    static vl53lx_hist_synth_t a;
+    static vl53lx_hist_synth_t b;
+    static VL53LX_histogram_bin_data_t fa;
+    static VL53LX_histogram_bin_data_t fb;
+    vl53lx_hist_synth_target_t target = { 900.0f, 40.0f };
+
+    CHECK(VL53LX_HistSynthInit(&a));
+    CHECK(VL53LX_HistSynthInit(&b));
+    for (int k = 0; k < 3; k++) {
+        CHECK(VL53LX_HistSynthFrame(&a, &target, 1, &fa));
+        CHECK(VL53LX_HistSynthFrame(&b, &target, 1, &fb));
+        CHECK(memcmp(fa.bin_data, fb.bin_data, sizeof(fa.bin_data)) == 0);
+    }
+
+    vl53lx_hist_synth_config_t config = a.config;
+    config.seed = 2;
+    CHECK(VL53LX_HistSynthInitWithConfig(&b, &config));
+    CHECK(VL53LX_HistSynthFrame(&b, &target, 1, &fb));
+    CHECK(memcmp(fa.bin_data, fb.bin_data, sizeof(fa.bin_data)) != 0);
+}
+
+static void test_rejects_unsupported_timing(void)
+{
+    vl53lx_hist_synth_t synth;
+    vl53lx_hist_synth_config_t config = VL53LX_HistSynthGetDefaultConfig();
+    config.vcsel_period = 0x0C;          // 26 bins
+    CHECK(!VL53LX_HistSynthInitWithConfig(&synth, &config));
+}
+
+typedef struct {
+    uint32_t frames;
+    float last_mm;
+    bool ordered;
+} sweep_log_t;
+
+static void on_sweep_frame(const VL53LX_histogram_bin_data_t *frame, const vl53lx_hist_synth_target_t *target,
+                           void *ctx)
+{
+    sweep_log_t *log = ctx;
+    (void)frame;
+    if (log->frames > 0 && target->distance_mm < log->last_mm) {
+        log->ordered = false;
+    }
+    log->last_mm = target->distance_mm;
+    log->frames++;
+}
+
+static void test_sweep(void)
+{
+    static vl53lx_hist_synth_t synth;
+    CHECK(VL53LX_HistSynthInit(&synth));
+
+    vl53lx_hist_synth_sweep_t sweep = { 100.0f, 1000.0f, 100.0f, 17.0f, 3 };
+    sweep_log_t log = { 0, 0.0f, true };
+    CHECK(VL53LX_HistSynthSweep(&synth, &sweep, on_sweep_frame, &log) == 30);
+    CHECK(log.frames == 30 && log.ordered && log.last_mm == 1000.0f);
+}
+
+// Ranging error over a distance sweep through the full driver chain
+static void accuracy_sweep(VL53LX_DistanceModes mode, const char *name, float start_mm, float stop_mm,
+                           float step_mm, float max_error_mm)
+{
+    static VL53LX_Dev_t dev;
+    static sim_scene_t scene;
+    int index = sim_single_device(&dev, 5);
+
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetDistanceMode(&dev, mode) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetMeasurementTimingBudgetMicroSeconds(&dev, 33000) == VL53LX_ERROR_NONE);
+
+    vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+    base.seed = 5;
+    sim_scene_init(&scene, &dev, &base);
+    sim_device_set_source(index, sim_scene_frame, &scene);
+    CHECK(VL53LX_StartMeasurement(&dev) == VL53LX_ERROR_NONE);
+
+    double sum = 0.0;
+    float worst = 0.0f;
+    uint32_t samples = 0;
+    uint32_t invalid = 0;
+    for (float d = start_mm; d <= stop_mm; d += step_mm) {
+        vl53lx_hist_synth_target_t target = { d, 50.0f };
+        sim_scene_set_targets(&scene, &target, 1);
+        for (int k = 0; k < SETTLE_FRAMES + MEASURE_FRAMES; k++) {
+            VL53LX_MultiRangingData_t data;
+            CHECK(sim_scene_range(&dev, index, &data) == VL53LX_ERROR_NONE);
+            if (k < SETTLE_FRAMES) {
+                continue;
+            }
+            if (data.NumberOfObjectsFound == 0 || data.RangeData[0].RangeStatus != VL53LX_RANGESTATUS_RANGE_VALID) {
+                invalid++;
+                continue;
+            }
+            float error = fabsf((float)data.RangeData[0].RangeMilliMeter - d);
+            sum += error;
+            worst = error > worst ? error : worst;
+            samples++;
+        }
+    }
+    VL53LX_StopMeasurement(&dev);
+
+    printf("%s %.0f-%.0f mm: mean error %.1f mm, max %.0f mm, %u invalid of %u\n", name, (double)start_mm,
+           (double)stop_mm, samples > 0 ? sum / samples : 0.0, (double)worst, invalid, samples + invalid);
+    CHECK(invalid == 0);
+    CHECK(worst <= max_error_mm);
+}
+
+// Frames per second of the generator; the target moves every frame
+static double throughput(bool noise, uint64_t *checksum)
+{
+    static vl53lx_hist_synth_t synth;
+    static VL53LX_histogram_bin_data_t frame;
+    vl53lx_hist_synth_config_t config = VL53LX_HistSynthGetDefaultConfig();
+    config.enable_noise = noise;
+    CHECK(VL53LX_HistSynthInitWithConfig(&synth, &config));
+
+    vl53lx_hist_synth_target_t target = { 200.0f, 50.0f };
+    uint64_t start_ns = host_time_ns();
+    for (uint32_t n = 0; n < BENCH_FRAMES; n++) {
+        target.distance_mm = 200.0f + (float)(n % 1000);
+        VL53LX_HistSynthFrame(&synth, &target, 1, &frame);
+        *checksum += (uint64_t)frame.bin_data[n % VL53LX_HISTOGRAM_BUFFER_SIZE];
+    }
+    uint64_t elapsed_ns = host_time_ns() - start_ns;
+    CHECK(synth.frame_count == BENCH_FRAMES);
+    return elapsed_ns > 0 ? BENCH_FRAMES * 1e9 / (double)elapsed_ns : 0.0;
+}
+
+static void test_throughput(void)
+{
+    uint64_t checksum = 0;
+    double noise = throughput(true, &checksum);
+    double clean = throughput(false, &checksum);
+    printf("generator: %.2f M frames/s with shot noise, %.2f M frames/s without (%u frames, checksum %llu)\n",
+           noise / 1e6, clean / 1e6, BENCH_FRAMES, (unsigned long long)checksum);
+    CHECK(checksum > 0);
+}
+
+// Ambient dmax of the driver's default calibration and configuration
+static void test_dmax_curve(void)
+{
+    static const float ambients[] = { 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f, 128.0f };
+    const size_t count = sizeof(ambients) / sizeof(ambients[0]);
+    VL53LX_dmax_calibration_data_t cal;
+    VL53LX_hist_gen3_dmax_config_t cfg;
+    VL53LX_hist_gen3_dmax_private_data_t priv;
+    VL53LX_init_dmax_calibration_data_struct(&cal);
+    VL53LX_init_hist_gen3_dmax_config_struct(&cfg);
+
+    printf("dmax (mm) by ambient events per bin per SPAD, reflectance");
+    for (uint8_t p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
+        printf(" %u", cfg.target_reflectance_for_dmax_calc[p]);
+    }
+    printf("\n");
+
+    int16_t previous[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+    for (size_t a = 0; a < count; a++) {
+        static vl53lx_hist_synth_t synth;
+        static VL53LX_histogram_bin_data_t bins;
+        vl53lx_hist_synth_config_t config = VL53LX_HistSynthGetDefaultConfig();
+        config.ambient_events = ambients[a];
+        config.enable_noise = false;
+        CHECK(VL53LX_HistSynthInitWithConfig(&synth, &config));
+        CHECK(VL53LX_HistSynthFrame(&synth, NULL, 0, &bins));
+
+        int16_t dmax[VL53LX_MAX_AMBIENT_DMAX_VALUES];
+        printf("  %6.1f:", (double)ambients[a]);
+        for (uint8_t p = 0; p < VL53LX_MAX_AMBIENT_DMAX_VALUES; p++) {
+            CHECK(VL53LX_f_001(cfg.target_reflectance_for_dmax_calc[p], &cal, &cfg, &bins, &priv, &dmax[p]) ==
+                  VL53LX_ERROR_NONE);
+            printf(" %5d", dmax[p]);
+            CHECK_MSG(dmax[p] > 0, "ambient %.1f, reflectance %u", (double)ambients[a],
+                      cfg.target_reflectance_for_dmax_calc[p]);
+            CHECK(p == 0 || dmax[p] >= dmax[p - 1]);
+            CHECK_MSG(a == 0 || dmax[p] <= previous[p], "ambient %.1f, reflectance %u", (double)ambients[a],
+                      cfg.target_reflectance_for_dmax_calc[p]);
+        }
+        printf("\n");
+        memcpy(previous, dmax, sizeof(previous));
+    }
+}
+
+int main(void)
+{
+    test_reproducible();
+    test_rejects_unsupported_timing();
+    test_sweep();
+    accuracy_sweep(VL53LX_DISTANCEMODE_MEDIUM, "medium", 200.0f, 1400.0f, 100.0f, 20.0f);
+    accuracy_sweep(VL53LX_DISTANCEMODE_LONG, "long", 300.0f, 3500.0f, 200.0f, 30.0f);
+    test_throughput();
+    test_dmax_curve();
+    return host_test_result();
+}
@@ -0,0 +1,185 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_nvm_cache.c
+ * @brief VL53LX_DataInitWithNvmCache() with the calibration store records
+ *
+ * From VL53LX_CalStoreLoadNvmCache() to the end of DataInit:
+ * - No cache: one NVM session, the cache is filled
+ * - Cache hit: one short NVM session for the UID, the same LL data as the
+ *   full read, and the calibration store calls after DataInit need none
+ * - Cache hit with verified words: still one NVM session
+ * - A different sensor in the same slot with the same boot registers: the
+ *   UID differs and the cache is not used
+ * - A different sensor with other boot registers: full read without the
+ *   UID check
+ * Prints the transfers and bus time of each case.
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_cal_store.h"
+#include "vl53lx_register_map.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SEED            31
+#define OTHER_SEED      32
+#define SLOT            0
+
+static char directory[] = "/tmp/vl53lx_nvm_cache_XXXXXX";
+static vl53lx_cal_storage_t storage;
+static uint8_t write_log[64 * 1024];
+
+typedef struct {
+    uint32_t transfers;
+    uint64_t us;
+    uint32_t nvm_sessions;
+} cost_t;
+
+// NVM sessions in the write log: each one powers the NVM up
+static uint32_t count_nvm_sessions(void)
+{
+    uint32_t sessions = 0;
+    size_t length = sim_log_length();
+    for (size_t pos = 0; pos + 4 <= length;) {
+        uint16_t index = (uint16_t)(write_log[pos] << 8 | write_log[pos + 1]);
+        uint16_t count = (uint16_t)(write_log[pos + 2] << 8 | write_log[pos + 3]);
+        if (index == VL53LX_RANGING_CORE__NVM_CTRL__PDN && count == 1 && write_log[pos + 4] == 0x01) {
+            sessions++;
+        }
+        pos += 4u + count;
+    }
+    return sessions;
+}
+
+static void measure_start(void)
+{
+    sim_reset_stats();
+    sim_log_writes(write_log, sizeof(write_log));
+}
+
+static cost_t measure_end(uint64_t start_us)
+{
+    cost_t cost = { sim_bus_stats(0)->transfers, sim_now_us(0) - start_us, count_nvm_sessions() };
+    sim_log_writes(NULL, 0);
+    return cost;
+}
+
+// Power up, load the slot, wait for boot and DataInit with the cache.
+// module_id != 0 stands for a part whose boot copy of the NVM differs
+static cost_t boot(VL53LX_Dev_t *dev, uint32_t seed, VL53LX_nvm_cache_t *cache, uint8_t verify_words,
+                   uint8_t module_id)
+{
+    sim_single_device(dev, seed);
+    sim_device_regs(0)[VL53LX_IDENTIFICATION__MODULE_ID_LO] = module_id;
+    uint64_t start_us = sim_now_us(0);
+    measure_start();
+
+    memset(cache, 0, sizeof(*cache));
+    VL53LX_CalStoreLoadNvmCache(&storage, SLOT, cache);
+    cache->verify_words = verify_words;
+    cache->verify_seed = 5;
+    CHECK(VL53LX_WaitDeviceBooted(dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInitWithNvmCache(dev, cache) == VL53LX_ERROR_NONE);
+
+    return measure_end(start_us);
+}
+
+static void report(const char *name, cost_t cost)
+{
+    printf("%-30s %3u transfers %5.1f ms, %u NVM sessions\n", name, cost.transfers, cost.us / 1000.0,
+           cost.nvm_sessions);
+}
+
+static bool same_factory_data(const VL53LX_Dev_t *a, const VL53LX_Dev_t *b)
+{
+    const VL53LX_LLDriverData_t *x = &a->Data.LLData;
+    const VL53LX_LLDriverData_t *y = &b->Data.LLData;
+    return x->nvm_uid == y->nvm_uid &&
+           memcmp(&x->optical_centre, &y->optical_centre, sizeof(x->optical_centre)) == 0 &&
+           memcmp(&x->cal_peak_rate_map, &y->cal_peak_rate_map, sizeof(x->cal_peak_rate_map)) == 0 &&
+           memcmp(&x->add_off_cal_data, &y->add_off_cal_data, sizeof(x->add_off_cal_data)) == 0 &&
+           memcmp(&x->fmt_dmax_cal, &y->fmt_dmax_cal, sizeof(x->fmt_dmax_cal)) == 0;
+}
+
+static void test_cache(void)
+{
+    static VL53LX_Dev_t full;
+    static VL53LX_Dev_t dev;
+    VL53LX_nvm_cache_t cache;
+    uint64_t uid;
+
+    // No record yet: full read, the cache is filled and saved
+    cost_t miss = boot(&full, SEED, &cache, 0, 0);
+    report("no cache", miss);
+    CHECK(!cache.hit && cache.updated && cache.valid);
+    CHECK(miss.nvm_sessions == 1);
+    CHECK(VL53LX_GetUID(&full, &uid) == VL53LX_ERROR_NONE);
+    CHECK(full.Data.LLData.nvm_uid == uid);
+    CHECK(VL53LX_CalStoreSaveNvmCache(&storage, SLOT, &cache) == VL53LX_CAL_STORE_OK);
+
+    // Hit: only the UID read from the NVM, same decoded data
+    cost_t hit = boot(&dev, SEED, &cache, 0, 0);
+    report("cache hit", hit);
+    CHECK(cache.hit && !cache.updated);
+    CHECK(hit.nvm_sessions == 1);
+    CHECK(same_factory_data(&dev, &full));
+    CHECK(hit.transfers < miss.transfers && hit.us < miss.us);
+
+    // The calibration store uses the UID kept by DataInit
+    measure_start();
+    CHECK(VL53LX_CalStoreSave(&dev, &storage) == VL53LX_CAL_STORE_OK);
+    CHECK(VL53LX_CalStoreApply(&dev, &storage) == VL53LX_CAL_STORE_OK);
+    CHECK(measure_end(sim_now_us(0)).nvm_sessions == 0);
+    CHECK(VL53LX_CalStoreErase(&dev, &storage) == VL53LX_CAL_STORE_OK);
+
+    // Hit with two verified words: the same session, a little longer
+    cost_t verified = boot(&dev, SEED, &cache, 2, 0);
+    report("cache hit, 2 words verified", verified);
+    CHECK(cache.hit);
+    CHECK(verified.nvm_sessions == 1);
+    CHECK(same_factory_data(&dev, &full));
+    CHECK(verified.us > hit.us && verified.us < miss.us);
+
+    // Another sensor in the slot, same boot registers: the UID differs
+    cost_t swapped = boot(&dev, OTHER_SEED, &cache, 0, 0);
+    report("other sensor, same registers", swapped);
+    CHECK(!cache.hit && cache.updated);
+    CHECK(swapped.nvm_sessions == 2);
+    CHECK(VL53LX_GetUID(&dev, &uid) == VL53LX_ERROR_NONE);
+    CHECK(dev.Data.LLData.nvm_uid == uid && uid != full.Data.LLData.nvm_uid);
+    CHECK(cache.data.uid == uid);
+
+    // Back to the first sensor: the cache now holds the other one
+    CHECK(VL53LX_CalStoreSaveNvmCache(&storage, SLOT, &cache) == VL53LX_CAL_STORE_OK);
+    cost_t restored = boot(&dev, SEED, &cache, 0, 0);
+    CHECK(!cache.hit && cache.updated && same_factory_data(&dev, &full));
+    CHECK(restored.nvm_sessions == 2);
+
+    // Other boot registers: the fingerprint differs, full read at once
+    CHECK(VL53LX_CalStoreSaveNvmCache(&storage, SLOT, &cache) == VL53LX_CAL_STORE_OK);
+    cost_t other = boot(&dev, OTHER_SEED, &cache, 0, 0x5A);
+    report("other sensor, other registers", other);
+    CHECK(!cache.hit && cache.updated);
+    CHECK(other.nvm_sessions == 1);
+}
+
+int main(void)
+{
+    CHECK(mkdtemp(directory) != NULL);
+    CHECK(VL53LX_CalStorageInitFile(&storage, directory));
+
+    test_cache();
+
+    char key[VL53LX_CAL_STORE_KEY_SIZE];
+    snprintf(key, sizeof(key), "nvm%02X", SLOT);
+    storage.erase(storage.ctx, key);
+    rmdir(directory);
+    return host_test_result();
+}
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_offset_adaptive.c
+ * @brief VL53LX_PerformOffsetAdaptiveCalibration() on the simulated device
+ *
+ * - A quiet target stops early at the tolerance and the offset is the
+ *   difference between the calibration distance and the measured range
+ * - A budget too small for the tolerance reports the offset with
+ *   VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH and leaves the device alone
+ * - A failing read in the first (discarded) measurement or in a later one
+ *   is returned, the device is stopped and the offset is left alone
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_hist_map.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+#define TARGET_MM       620.0f
+#define CAL_MM          600
+
+static VL53LX_Dev_t dev;
+static sim_scene_t scene;
+static int sim_index;
+
+static void setup(void)
+{
+    sim_index = sim_single_device(&dev, 9);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+
+    vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+    base.seed = 9;
+    sim_scene_init(&scene, &dev, &base);
+    vl53lx_hist_synth_target_t target = { TARGET_MM, 50.0f };
+    sim_scene_set_targets(&scene, &target, 1);
+    sim_device_set_source(sim_index, sim_scene_frame, &scene);
+}
+
+static int16_t inner_offset(void)
+{
+    return dev.Data.LLData.customer.mm_config__inner_offset_mm;
+}
+
+static void test_stops_at_tolerance(void)
+{
+    VL53LX_AdaptiveOffsetCal_t cal = { 0 };
+    cal.ToleranceMilliMeter = 65536;     // 1 mm
+    cal.MinSamples = 10;
+    cal.MaxSamples = 200;
+
+    uint32_t starts = sim_device_starts(sim_index);
+    CHECK(VL53LX_PerformOffsetAdaptiveCalibration(&dev, CAL_MM, &cal) == VL53LX_ERROR_NONE);
+    printf("tolerance 1 mm: %u samples, %u measurements, precision %.2f mm, offset %d mm\n", cal.SampleCount,
+           cal.MeasurementCount, cal.PrecisionMilliMeter / 65536.0, cal.OffsetMilliMeter);
+
+    CHECK(cal.SampleCount >= cal.MinSamples && cal.SampleCount < cal.MaxSamples);
+    CHECK(cal.PrecisionMilliMeter <= cal.ToleranceMilliMeter);
+    CHECK(cal.OffsetMilliMeter >= CAL_MM - (int)TARGET_MM - 3 && cal.OffsetMilliMeter <= CAL_MM - (int)TARGET_MM + 3);
+    CHECK(inner_offset() == cal.OffsetMilliMeter);
+    CHECK(!sim_device_ranging(sim_index));
+    CHECK(sim_device_starts(sim_index) > starts);
+}
+
+static void test_budget_spent(void)
+{
+    VL53LX_AdaptiveOffsetCal_t cal = { 0 };
+    cal.ToleranceMilliMeter = 1;         // Out of reach
+    cal.MinSamples = 4;
+    cal.MaxSamples = 8;
+
+    int16_t before = inner_offset();
+    CHECK(VL53LX_PerformOffsetAdaptiveCalibration(&dev, CAL_MM, &cal) == VL53LX_WARNING_OFFSET_CAL_SIGMA_TOO_HIGH);
+    CHECK(cal.SampleCount == cal.MaxSamples);
+    CHECK(cal.OffsetMilliMeter >= CAL_MM - (int)TARGET_MM - 5 && cal.OffsetMilliMeter <= CAL_MM - (int)TARGET_MM + 5);
+    CHECK(inner_offset() == before);
+    CHECK(!sim_device_ranging(sim_index));
+}
+
+static void test_first_measurement_error(void)
+{
+    VL53LX_AdaptiveOffsetCal_t cal = { 0 };
+    cal.ToleranceMilliMeter = 65536;
+    cal.MinSamples = 10;
+    cal.MaxSamples = 200;
+
+    // The histogram read of the first, discarded measurement fails
+    int16_t before = inner_offset();
+    sim_device_fail_reads(sim_index, VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX, 1);
+    CHECK(VL53LX_PerformOffsetAdaptiveCalibration(&dev, CAL_MM, &cal) == VL53LX_ERROR_CONTROL_INTERFACE);
+    CHECK(cal.SampleCount == 0 && cal.MeasurementCount == 0);
+    CHECK(inner_offset() == before);
+    CHECK(!sim_device_ranging(sim_index));
+
+}
+
+// Frame source that fails the histogram read of one frame
+static uint32_t fail_frame;
+
+static void failing_source(void *ctx, int index, uint32_t frame, uint8_t *block)
+{
+    if (frame == fail_frame) {
+        sim_device_fail_reads(index, VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX, 1);
+    }
+    sim_scene_frame(ctx, index, frame, block);
+}
+
+static void test_later_measurement_error(void)
+{
+    VL53LX_AdaptiveOffsetCal_t cal = { 0 };
+    cal.ToleranceMilliMeter = 1;
+    cal.MinSamples = 10;
+    cal.MaxSamples = 200;
+
+    // The error is returned, not overwritten by the restart that follows
+    int16_t before = inner_offset();
+    fail_frame = 6;
+    sim_device_set_source(sim_index, failing_source, &scene);
+    CHECK(VL53LX_PerformOffsetAdaptiveCalibration(&dev, CAL_MM, &cal) == VL53LX_ERROR_CONTROL_INTERFACE);
+    CHECK(cal.MeasurementCount == fail_frame);
+    CHECK(inner_offset() == before);
+    CHECK(!sim_device_ranging(sim_index));
+    sim_device_set_source(sim_index, sim_scene_frame, &scene);
+}
+
+int main(void)
+{
+    setup();
+    test_stops_at_tolerance();
+    test_budget_spent();
+    test_first_measurement_error();
+    test_later_measurement_error();
+    return host_test_result();
+}
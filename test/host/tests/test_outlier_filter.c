@@ -0,0 +1,756 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_outlier_filter.c
+ * @brief VL53LX_Filter against a double-precision copy of the algorithm
+ *
+ * A random-walk distance with gaussian noise, 1% outliers and 5% invalid
+ * range statuses, for Q = 0.1 / 1 / 5, R = 1 / 4 / 10 and noise sigma
+ * 2 / 10 mm.
+ * - Float and fixed-point state stay within a few thousandths of a mm of
+ *   the double filter, outputs differ by at most 1 mm (rounding at .5)
+ * - Both modes accept and reject the same samples
+ * - VL53LX_FilterUpdateBatch() and the K-channel VL53LX_FilterBank give
+ *   bit-identical outputs and state to VL53LX_FilterUpdate(), for float
+ *   and fixed point, with and without the rate limit
+ * - VL53LX_FilterUpdateAdaptive(): R from sigma lowers the noise on dark
+ *   targets at a similar lag, the per-second rate limit lets fewer
+ *   outliers through at 100 Hz and keeps fast motion at 5 Hz and gaps
+ *   from resetting the filter, and a short interval still passes a small
+ *   change
+ * Prints the tables quoted in the API doc.
+ */
+
+#include "vl53lx_outlier_filter.h"
+#include "host_test.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES         1000000
+#define BENCH_ROUNDS    10
+#define CHANNELS        8
+#define CHANNEL_SAMPLES 200000
+#define BATCH           1000
+
+static uint16_t distances[SAMPLES];
+static uint8_t statuses[SAMPLES];
+
+// Per channel, and interleaved as the bank takes them
+static uint16_t channel_distances[CHANNELS][CHANNEL_SAMPLES];
+static uint8_t channel_statuses[CHANNELS][CHANNEL_SAMPLES];
+static uint16_t bank_distances[CHANNEL_SAMPLES][CHANNELS];
+static uint8_t bank_statuses[CHANNEL_SAMPLES][CHANNELS];
+static uint16_t single_outputs[CHANNELS][CHANNEL_SAMPLES];
+static bool single_valid[CHANNELS][CHANNEL_SAMPLES];
+static uint16_t batch_outputs[CHANNELS][CHANNEL_SAMPLES];
+static bool batch_valid[CHANNELS][CHANNEL_SAMPLES];
+static uint64_t rng = 88172645463325252ull;
+
+static uint32_t xorshift(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)rng;
+}
+
+static double gauss(void)
+{
+    double u = (xorshift() + 1.0) / 4294967297.0;
+    double v = (xorshift() + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+// Random walk between 30 and 4000 mm
+static void generate(double sigma_mm)
+{
+    double x = 1000.0;
+    double v = 0.0;
+    for (int i = 0; i < SAMPLES; i++) {
+        v = (v + gauss() * 2.0) * 0.98;
+        x += v;
+        if (x < 30.0 || x > 4000.0) {
+            x = x < 30.0 ? 30.0 : 4000.0;
+            v = -v;
+        }
+        double m = x + gauss() * sigma_mm;
+        if (xorshift() % 100 == 0) {
+            m += (xorshift() % 2 ? 1.0 : -1.0) * (double)(xorshift() % 2000);
+        }
+        m = m < 0.0 ? 0.0 : m > 65535.0 ? 65535.0 : m;
+        distances[i] = (uint16_t)lround(m);
+        statuses[i] = xorshift() % 20 == 0 ? (uint8_t)(1 + xorshift() % 7) : 0;
+    }
+}
+
+// VL53LX_FilterUpdate() in double precision
+typedef struct {
+    vl53lx_filter_config_t config;
+    uint16_t last_output;
+    uint8_t rejected_count;
+    uint8_t samples_since_reset;
+    double x;
+    double p;
+    bool initialized;
+} reference_t;
+
+static void reference_reset(reference_t *r)
+{
+    r->last_output = 0;
+    r->rejected_count = 0;
+    r->samples_since_reset = 0;
+    r->x = 0.0;
+    r->p = 1000.0;
+    r->initialized = false;
+}
+
+static bool reference_update(reference_t *r, uint16_t distance_mm, uint8_t range_status, uint16_t *output_mm)
+{
+    bool status_valid = true;
+    bool rate_valid = true;
+
+    if (r->config.enable_status_check && !((1 << range_status) & r->config.valid_status_mask)) {
+        status_valid = false;
+        if (++r->rejected_count >= 5) {
+            reference_reset(r);
+        }
+    }
+    if (r->config.enable_rate_limit && r->initialized) {
+        int limit = r->config.max_change_rate_mm * (r->samples_since_reset < 3 ? 3 : 1);
+        if (abs((int)distance_mm - (int)r->last_output) > limit) {
+            rate_valid = false;
+            if (++r->rejected_count >= 5) {
+                reference_reset(r);
+            }
+        }
+    }
+    bool valid = status_valid && rate_valid;
+    if (valid) {
+        r->rejected_count = 0;
+    }
+
+    if (!r->initialized) {
+        if (!valid) {
+            return false;
+        }
+        r->x = distance_mm;
+        r->p = r->config.kalman_measurement_noise;
+        r->initialized = true;
+    } else {
+        double p_pred = r->p + r->config.kalman_process_noise;
+        if (valid) {
+            double K = p_pred / (p_pred + r->config.kalman_measurement_noise);
+            r->x += K * (distance_mm - r->x);
+            r->p = (1.0 - K) * p_pred;
+        } else {
+            r->p = p_pred;
+        }
+    }
+
+    *output_mm = (uint16_t)(r->x + 0.5);
+    r->last_output = *output_mm;
+    if (valid && r->samples_since_reset < 255) {
+        r->samples_since_reset++;
+    }
+    return true;
+}
+
+typedef struct {
+    double state_error_mm;
+    uint32_t output_mismatches;
+    int output_error_max_mm;
+    uint32_t diverged;
+} compare_t;
+
+static void compare(const vl53lx_filter_config_t *config, compare_t *floating, compare_t *fixed)
+{
+    vl53lx_filter_t filters[2];
+    compare_t *results[2] = { floating, fixed };
+    vl53lx_filter_config_t fixed_config = *config;
+    fixed_config.fixed_point = true;
+    CHECK(VL53LX_FilterInitWithConfig(&filters[0], config));
+    CHECK(VL53LX_FilterInitWithConfig(&filters[1], &fixed_config));
+
+    reference_t reference;
+    reference.config = *config;
+    reference_reset(&reference);
+    memset(floating, 0, sizeof(*floating));
+    memset(fixed, 0, sizeof(*fixed));
+
+    for (int i = 0; i < SAMPLES; i++) {
+        uint16_t expected = 0;
+        bool expected_valid = reference_update(&reference, distances[i], statuses[i], &expected);
+        for (int k = 0; k < 2; k++) {
+            uint16_t output = 0;
+            bool valid = VL53LX_FilterUpdate(&filters[k], distances[i], statuses[i], &output);
+            if (valid != expected_valid || filters[k].kalman_initialized != reference.initialized) {
+                results[k]->diverged++;
+                continue;
+            }
+            if (!valid) {
+                continue;
+            }
+            double x = k == 0 ? filters[k].kalman_x : filters[k].kalman_x_q16 / 65536.0;
+            double error = fabs(x - reference.x);
+            results[k]->state_error_mm = error > results[k]->state_error_mm ? error : results[k]->state_error_mm;
+            int output_error = abs((int)output - (int)expected);
+            if (output_error > 0) {
+                results[k]->output_mismatches++;
+                if (output_error > results[k]->output_error_max_mm) {
+                    results[k]->output_error_max_mm = output_error;
+                }
+            }
+        }
+    }
+}
+
+static void test_against_double(void)
+{
+    static const float process_noise[] = { 0.1f, 1.0f, 5.0f };
+    static const float measurement_noise[] = { 1.0f, 4.0f, 10.0f };
+    static const double sigmas_mm[] = { 2.0, 10.0 };
+
+    printf("sigma  Q    R     float state / outputs off    fixed state / outputs off\n");
+    for (size_t g = 0; g < sizeof(sigmas_mm) / sizeof(sigmas_mm[0]); g++) {
+        generate(sigmas_mm[g]);
+        for (size_t a = 0; a < 3; a++) {
+            for (size_t b = 0; b < 3; b++) {
+                vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+                config.kalman_process_noise = process_noise[a];
+                config.kalman_measurement_noise = measurement_noise[b];
+                compare_t floating;
+                compare_t fixed;
+                compare(&config, &floating, &fixed);
+                printf("%4.0f  %3.1f  %4.1f  %.5f mm / %6.4f%%       %.5f mm / %6.4f%%\n", sigmas_mm[g],
+                       process_noise[a], measurement_noise[b], floating.state_error_mm,
+                       100.0 * floating.output_mismatches / SAMPLES, fixed.state_error_mm,
+                       100.0 * fixed.output_mismatches / SAMPLES);
+
+                CHECK(floating.diverged == 0 && fixed.diverged == 0);
+                CHECK(floating.state_error_mm < 0.002);
+                CHECK(fixed.state_error_mm < (process_noise[a] >= 1.0f ? 0.0001 : 0.002));
+                CHECK(floating.output_error_max_mm <= 1 && fixed.output_error_max_mm <= 1);
+                CHECK(floating.output_mismatches < SAMPLES / 2000 && fixed.output_mismatches < SAMPLES / 2000);
+            }
+        }
+    }
+}
+
+// Slow walks per channel with status errors, outliers and jumps
+static void generate_channels(void)
+{
+    uint32_t lcg = 3;
+#define NEXT() (lcg = lcg * 1103515245u + 12345u, lcg >> 8)
+    for (int c = 0; c < CHANNELS; c++) {
+        double x = 300.0 + 100.0 * c;
+        for (int i = 0; i < CHANNEL_SAMPLES; i++) {
+            x += ((int)(NEXT() % 21) - 10) * 0.5;
+            x = x < 30.0 ? 30.0 : x > 3500.0 ? 3500.0 : x;
+            uint32_t u = NEXT() % 1000;
+            int v = (int)x + (int)(NEXT() % 9) - 4;
+            uint8_t status = 0;
+            if (u < 40) {
+                status = (uint8_t)(1 + NEXT() % 12);
+            } else if (u < 60) {
+                v += (NEXT() & 1) ? 900 : -600;
+            } else if (u < 62) {
+                x = 100.0 + NEXT() % 3000;
+            }
+            v = v < 0 ? 0 : v > 8000 ? 8000 : v;
+            channel_distances[c][i] = bank_distances[i][c] = (uint16_t)v;
+            channel_statuses[c][i] = bank_statuses[i][c] = status;
+        }
+    }
+#undef NEXT
+}
+
+static bool same_state(const vl53lx_filter_bank_t *bank, uint8_t c, const vl53lx_filter_t *filter)
+{
+    bool kalman = bank->config.fixed_point
+                      ? bank->kalman_x_q16[c] == filter->kalman_x_q16 && bank->kalman_p_q20[c] == filter->kalman_p_q20
+                      : memcmp(&bank->kalman_x[c], &filter->kalman_x, sizeof(float)) == 0 &&
+                            memcmp(&bank->kalman_p[c], &filter->kalman_p, sizeof(float)) == 0;
+    return kalman && bank->last_output[c] == filter->last_output &&
+           bank->rejected_count[c] == filter->rejected_count &&
+           bank->samples_since_reset[c] == filter->samples_since_reset &&
+           (bank->kalman_initialized[c] != 0) == filter->kalman_initialized;
+}
+
+static double seconds_since(uint64_t start_ns)
+{
+    return (double)(host_time_ns() - start_ns) / 1e9;
+}
+
+// Msamples/s of the single, batch and bank updates, best of a few runs
+static void throughput(const vl53lx_filter_config_t *config, double rates[3])
+{
+    static vl53lx_filter_t filters[CHANNELS];
+    static vl53lx_filter_bank_t bank;
+    double best[3] = { 1e9, 1e9, 1e9 };
+    volatile uint32_t sink = 0;
+
+    for (int c = 0; c < CHANNELS; c++) {
+        CHECK(VL53LX_FilterInitWithConfig(&filters[c], config));
+    }
+    CHECK(VL53LX_FilterBankInit(&bank, config, CHANNELS));
+
+    for (int run = 0; run < 5; run++) {
+        uint64_t start_ns = host_time_ns();
+        for (int c = 0; c < CHANNELS; c++) {
+            VL53LX_FilterReset(&filters[c]);
+            for (int i = 0; i < CHANNEL_SAMPLES; i++) {
+                uint16_t output = 0;
+                VL53LX_FilterUpdate(&filters[c], channel_distances[c][i], channel_statuses[c][i], &output);
+                sink += output;
+            }
+        }
+        double single = seconds_since(start_ns);
+
+        start_ns = host_time_ns();
+        for (int c = 0; c < CHANNELS; c++) {
+            VL53LX_FilterReset(&filters[c]);
+            sink += VL53LX_FilterUpdateBatch(&filters[c], channel_distances[c], channel_statuses[c],
+                                             CHANNEL_SAMPLES, batch_outputs[c], NULL);
+        }
+        double batch = seconds_since(start_ns);
+
+        start_ns = host_time_ns();
+        VL53LX_FilterBankReset(&bank);
+        for (int i = 0; i < CHANNEL_SAMPLES; i++) {
+            uint16_t outputs[CHANNELS];
+            sink += VL53LX_FilterBankUpdate(&bank, bank_distances[i], bank_statuses[i], outputs, NULL);
+        }
+        double banked = seconds_since(start_ns);
+
+        best[0] = single < best[0] ? single : best[0];
+        best[1] = batch < best[1] ? batch : best[1];
+        best[2] = banked < best[2] ? banked : best[2];
+    }
+    for (int k = 0; k < 3; k++) {
+        rates[k] = (double)CHANNELS * CHANNEL_SAMPLES / best[k] / 1e6;
+    }
+}
+
+static void test_batch_and_bank(void)
+{
+    static vl53lx_filter_t single[CHANNELS];
+    static vl53lx_filter_t batched[CHANNELS];
+    static vl53lx_filter_bank_t bank;
+
+    generate_channels();
+    printf("config                                 single  batch  bank (Msamples/s, K=%d)\n", CHANNELS);
+    for (int k = 0; k < 6; k++) {
+        vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+        config.fixed_point = (k & 1) != 0;
+        config.enable_rate_limit = k / 2 != 1;
+        if (k >= 4) {
+            config.kalman_process_noise = 0.1f;
+            config.kalman_measurement_noise = 25.0f;
+            config.valid_status_mask = 0x07;
+        }
+
+        // Reference: one VL53LX_FilterUpdate() per sample, the last output held where not valid
+        uint32_t valid_count = 0;
+        memset(single, 0, sizeof(single));
+        memset(batched, 0, sizeof(batched));
+        for (int c = 0; c < CHANNELS; c++) {
+            CHECK(VL53LX_FilterInitWithConfig(&single[c], &config));
+            CHECK(VL53LX_FilterInitWithConfig(&batched[c], &config));
+            uint16_t output = 0;
+            for (int i = 0; i < CHANNEL_SAMPLES; i++) {
+                single_valid[c][i] = VL53LX_FilterUpdate(&single[c], channel_distances[c][i],
+                                                         channel_statuses[c][i], &output);
+                single_outputs[c][i] = output;
+                valid_count += single_valid[c][i];
+            }
+        }
+
+        uint32_t batch_mismatches = 0;
+        for (int c = 0; c < CHANNELS; c++) {
+            uint16_t held = 0;
+            for (int s = 0; s < CHANNEL_SAMPLES; s += BATCH) {
+                uint16_t outputs[BATCH];
+                for (int i = 0; i < BATCH; i++) {
+                    outputs[i] = held;
+                }
+                size_t n = VL53LX_FilterUpdateBatch(&batched[c], &channel_distances[c][s], &channel_statuses[c][s],
+                                                    BATCH, outputs, &batch_valid[c][s]);
+                size_t counted = 0;
+                for (int i = 0; i < BATCH; i++) {
+                    held = batch_valid[c][s + i] ? outputs[i] : held;
+                    counted += batch_valid[c][s + i];
+                    batch_mismatches += held != single_outputs[c][s + i] ||
+                                        batch_valid[c][s + i] != single_valid[c][s + i];
+                }
+                CHECK(n == counted);
+            }
+            batch_mismatches += memcmp(&batched[c], &single[c], sizeof(single[c])) != 0;
+        }
+
+        uint32_t bank_mismatches = 0;
+        uint16_t outputs[CHANNELS] = { 0 };
+        bool valid[CHANNELS];
+        CHECK(VL53LX_FilterBankInit(&bank, &config, CHANNELS));
+        for (int i = 0; i < CHANNEL_SAMPLES; i++) {
+            VL53LX_FilterBankUpdate(&bank, bank_distances[i], bank_statuses[i], outputs, valid);
+            for (int c = 0; c < CHANNELS; c++) {
+                bank_mismatches += outputs[c] != single_outputs[c][i] || valid[c] != single_valid[c][i];
+            }
+        }
+        for (uint8_t c = 0; c < CHANNELS; c++) {
+            bank_mismatches += !same_state(&bank, c, &single[c]);
+        }
+
+        double rates[3];
+        throughput(&config, rates);
+        printf("%-11s rate limit %-3s Q %.1f R %4.1f  %6.1f %6.1f %5.1f   %u of %u valid\n",
+               config.fixed_point ? "fixed point" : "float", config.enable_rate_limit ? "on" : "off",
+               config.kalman_process_noise, config.kalman_measurement_noise, rates[0], rates[1], rates[2],
+               valid_count, CHANNELS * CHANNEL_SAMPLES);
+        CHECK(valid_count > CHANNELS * CHANNEL_SAMPLES / 2);
+        CHECK_MSG(batch_mismatches == 0, "config %d: %u batch mismatches", k, batch_mismatches);
+        CHECK_MSG(bank_mismatches == 0, "config %d: %u bank mismatches", k, bank_mismatches);
+    }
+
+    // Channel count limits
+    vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+    CHECK(!VL53LX_FilterBankInit(&bank, &config, 0));
+    CHECK(!VL53LX_FilterBankInit(&bank, &config, VL53LX_FILTER_BANK_MAX_CHANNELS + 1));
+}
+
+// Flight trace for the adaptive update: hover, climb, dark hover, step, descent
+#define TRACE_SEEDS     10
+#define TRACE_MAX       4000
+
+typedef struct {
+    double t;
+    double truth_mm;
+    uint16_t distance_mm;
+    uint8_t status;
+    uint32_t sigma_q16;
+    uint32_t signal_q16;
+} trace_sample_t;
+
+typedef struct {
+    const char *name;
+    bool adaptive;
+    bool fixed_point;
+    float R;
+    float Q;
+} trace_filter_t;
+
+typedef struct {
+    double hover_rms_mm;
+    double dark_rms_mm;
+    double ramp_lag_ms;
+    double step_settle_ms;
+} trace_result_t;
+
+static trace_sample_t trace[TRACE_MAX];
+static int trace_length;
+static uint32_t lcg;
+
+static double lcg_uniform(void)
+{
+    lcg = lcg * 1103515245u + 12345u;
+    return ((lcg >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static double lcg_gauss(void)
+{
+    double u = lcg_uniform() + 1e-12;
+    double v = lcg_uniform();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+// Segments: hover white, climb 0.5 m/s, hover dark, step -400 mm, hover grey, descent 1 m/s, hover dark
+static const double segment_start[] = { 1.0, 5.3, 7.5, 11.0, 12.0, 15.3, 16.6 };
+static const double segment_end[] = { 5.0, 7.0, 11.0, 12.0, 15.0, 16.5, 20.0 };
+#define SEGMENTS        7
+
+static double trace_truth(double t)
+{
+    return t < 5.0 ? 800.0 : t < 7.0 ? 800.0 + 500.0 * (t - 5.0) : t < 11.0 ? 1800.0 : t < 15.0 ? 1400.0
+         : t < 16.5 ? 1400.0 - 1000.0 * (t - 15.0) : 400.0;
+}
+
+static double trace_reflectance(double t)
+{
+    return t < 5.0 ? 0.9 : t < 7.0 ? 0.6 : t < 11.0 ? 0.08 : t < 16.5 ? 0.3 : 0.05;
+}
+
+// Noise sigma = sqrt(1 + 300 / signal) mm, reported sigma with 20% lognormal error
+static void generate_trace(double period_s, uint32_t seed)
+{
+    lcg = seed;
+    trace_length = 0;
+    for (double t = 0.0; t < 20.0 && trace_length < TRACE_MAX; t += period_s + (lcg_uniform() - 0.5) * 0.002) {
+        double d = trace_truth(t - period_s / 2.0);
+        double signal = trace_reflectance(t) * 2.0e7 / (d * d + 1.0);
+        double sigma = sqrt(1.0 + 300.0 / signal);
+        double m = d + sigma * lcg_gauss();
+        uint8_t status = 0;
+        if (signal < 0.3 || lcg_uniform() < 0.03) {
+            status = lcg_uniform() < 0.5 ? 2 : 4;
+        }
+        trace_sample_t *sample = &trace[trace_length++];
+        sample->t = t;
+        sample->truth_mm = d;
+        sample->distance_mm = (uint16_t)lround(m < 0.0 ? 0.0 : m);
+        sample->status = status;
+        sample->sigma_q16 = (uint32_t)(sigma * exp(0.2 * lcg_gauss()) * 65536.0);
+        sample->signal_q16 = (uint32_t)(signal * 65536.0);
+    }
+}
+
+static trace_result_t run_trace(const trace_filter_t *f)
+{
+    double square[SEGMENTS] = { 0 };
+    double bias[SEGMENTS] = { 0 };
+    int count[SEGMENTS] = { 0 };
+    double settle_s = -1.0;
+    trace_result_t result = { 0 };
+
+    for (uint32_t seed = 1; seed <= TRACE_SEEDS; seed++) {
+        generate_trace(0.033, seed * 7919u);
+        vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+        config.fixed_point = f->fixed_point;
+        config.kalman_measurement_noise = f->R;
+        config.kalman_process_noise = f->Q;
+        vl53lx_filter_t filter;
+        CHECK(VL53LX_FilterInitWithConfig(&filter, &config));
+
+        memset(square, 0, sizeof(square));
+        memset(bias, 0, sizeof(bias));
+        memset(count, 0, sizeof(count));
+        settle_s = -1.0;
+        uint16_t output = 0;
+        for (int i = 0; i < trace_length; i++) {
+            const trace_sample_t *sample = &trace[i];
+            bool valid = f->adaptive ? VL53LX_FilterUpdateAdaptive(&filter, sample->distance_mm, sample->status,
+                                                                   sample->sigma_q16, sample->signal_q16,
+                                                                   (uint32_t)(sample->t * 1e6), &output)
+                                     : VL53LX_FilterUpdate(&filter, sample->distance_mm, sample->status, &output);
+            if (!valid) {
+                continue;
+            }
+            double error = output - sample->truth_mm;
+            for (int k = 0; k < SEGMENTS; k++) {
+                if (sample->t >= segment_start[k] && sample->t < segment_end[k]) {
+                    square[k] += error * error;
+                    bias[k] += error;
+                    count[k]++;
+                }
+            }
+            // 90% of the 400 mm step
+            if (sample->t >= 11.0 && sample->t < 12.0 && settle_s < 0.0 && error < 40.0) {
+                settle_s = sample->t - 11.0;
+            }
+        }
+
+        double rms[SEGMENTS];
+        for (int k = 0; k < SEGMENTS; k++) {
+            rms[k] = sqrt(square[k] / count[k]);
+            bias[k] /= count[k];
+        }
+        result.hover_rms_mm += sqrt((rms[0] * rms[0] + rms[4] * rms[4]) / 2.0) / TRACE_SEEDS;
+        result.dark_rms_mm += sqrt((rms[2] * rms[2] + rms[6] * rms[6]) / 2.0) / TRACE_SEEDS;
+        // Mean error over the ramps divided by their speed
+        result.ramp_lag_ms += (fabs(bias[1]) / 500.0 + fabs(bias[5]) / 1000.0) / 2.0 * 1e3 / TRACE_SEEDS;
+        result.step_settle_ms += settle_s * 1e3 / TRACE_SEEDS;
+    }
+    return result;
+}
+
+static void test_adaptive_noise(void)
+{
+    static const trace_filter_t filters[] = {
+        { "fixed R=4, Q=1 (default)", false, false, 4.0f, 1.0f },
+        { "fixed R=25, Q=16", false, false, 25.0f, 16.0f },
+        { "adaptive sigma^2, Q=16", true, false, 4.0f, 16.0f },
+        { "fixed R=25, Q=64", false, false, 25.0f, 64.0f },
+        { "adaptive sigma^2, Q=64", true, false, 4.0f, 64.0f },
+        { "adaptive sigma^2, Q=64, fixed point", true, true, 4.0f, 64.0f },
+    };
+    trace_result_t results[sizeof(filters) / sizeof(filters[0])];
+
+    printf("33 ms samples, %d seeds              hover rms  dark rms  ramp lag  step 90%%\n", TRACE_SEEDS);
+    for (size_t k = 0; k < sizeof(filters) / sizeof(filters[0]); k++) {
+        results[k] = run_trace(&filters[k]);
+        printf("%-36s %6.1f mm %6.1f mm %6.0f ms %6.0f ms\n", filters[k].name, results[k].hover_rms_mm,
+               results[k].dark_rms_mm, results[k].ramp_lag_ms, results[k].step_settle_ms);
+    }
+
+    // Adaptive R against a fixed R with the same Q: less noise on dark targets
+    CHECK(results[2].dark_rms_mm < results[1].dark_rms_mm);
+    CHECK(results[4].dark_rms_mm < results[3].dark_rms_mm * 0.8);
+    CHECK(results[4].hover_rms_mm < results[3].hover_rms_mm);
+    CHECK(fabs(results[5].dark_rms_mm - results[4].dark_rms_mm) < 0.1);
+    CHECK(fabs(results[5].ramp_lag_ms - results[4].ramp_lag_ms) < 1.0);
+}
+
+typedef double (*truth_fn_t)(double t);
+
+static double hover_truth(double t)
+{
+    (void)t;
+    return 1000.0;
+}
+
+static double descent_truth(double t)
+{
+    double x = t - 2.0;
+    return x < 0.0 ? 3500.0 : x < 1.0 ? 3500.0 - 3000.0 * x : 500.0;
+}
+
+static double climb_truth(double t)
+{
+    return 300.0 + 1000.0 * t;
+}
+
+typedef struct {
+    uint32_t outliers_passed;
+    uint32_t good_rejected;
+    uint32_t resets;
+    double rms_mm;
+} rate_result_t;
+
+// Constant R, so that only the rate limit differs; 0 mm/s is the fixed max_change_rate_mm
+static rate_result_t run_rate_limit(truth_fn_t truth_fn, double period_s, double outlier_rate, double gap_start,
+                                    double gap_end, double duration_s, uint32_t rate_mm_s)
+{
+    rate_result_t result = { 0 };
+    double square = 0.0;
+    uint32_t n = 0;
+
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        lcg = seed * 2654435761u;
+        vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+        config.adaptive_sigma_scale = 0.0f;
+        config.adaptive_noise_min = config.adaptive_noise_max = 4.0f;
+        config.max_change_rate_mm_s = rate_mm_s;
+        vl53lx_filter_t filter;
+        CHECK(VL53LX_FilterInitWithConfig(&filter, &config));
+
+        uint16_t output = 0;
+        for (double t = 0.0; t < duration_s; t += period_s) {
+            if (t >= gap_start && t < gap_end) {
+                continue;
+            }
+            double truth = truth_fn(t);
+            double m = truth + 3.0 * lcg_gauss();
+            bool outlier = false;
+            if (lcg_uniform() < outlier_rate) {
+                m += (lcg_uniform() < 0.5 ? -1.0 : 1.0) * (150.0 + 300.0 * lcg_uniform());
+                outlier = true;
+            }
+            uint8_t before = filter.samples_since_reset;
+            bool was_initialized = filter.kalman_initialized;
+            bool valid = VL53LX_FilterUpdateAdaptive(&filter, (uint16_t)lround(m), 0, 3u << 16, 10u << 16,
+                                                     (uint32_t)(t * 1e6), &output);
+            if (was_initialized && (!filter.kalman_initialized || (filter.samples_since_reset == 0 && before > 0))) {
+                result.resets++;
+            }
+            result.good_rejected += !outlier && filter.rejected_count > 0;
+            if (valid && t > 0.5) {
+                double error = output - truth;
+                result.outliers_passed += outlier && filter.rejected_count == 0;
+                square += error * error;
+                n++;
+            }
+        }
+    }
+    result.rms_mm = sqrt(square / n);
+    return result;
+}
+
+static void print_rate_limit(const char *name, const rate_result_t *per_sample, const rate_result_t *per_second)
+{
+    printf("%-40s %4u / %4u  %4u / %4u  %3u / %3u  %6.1f / %6.1f mm\n", name, per_sample->outliers_passed,
+           per_second->outliers_passed, per_sample->good_rejected, per_second->good_rejected, per_sample->resets,
+           per_second->resets, per_sample->rms_mm, per_second->rms_mm);
+}
+
+static void test_rate_limit_per_second(void)
+{
+    printf("20 seeds, 500 mm/sample / 15000 mm/s       outliers in  good rejected  resets  rms\n");
+    rate_result_t hover[2];
+    rate_result_t descent[2];
+    rate_result_t gap[2];
+    for (int k = 0; k < 2; k++) {
+        uint32_t rate_mm_s = k == 0 ? 0 : 15000;
+        hover[k] = run_rate_limit(hover_truth, 0.010, 0.02, 0.0, 0.0, 10.0, rate_mm_s);
+        descent[k] = run_rate_limit(descent_truth, 0.200, 0.0, 0.0, 0.0, 6.0, rate_mm_s);
+        gap[k] = run_rate_limit(climb_truth, 0.033, 0.0, 1.0, 1.7, 3.0, rate_mm_s);
+    }
+    print_rate_limit("hover, 100 Hz, 2% outliers 150-450 mm", &hover[0], &hover[1]);
+    print_rate_limit("3 m/s descent, 5 Hz (200 ms budget)", &descent[0], &descent[1]);
+    print_rate_limit("1 m/s climb, 30 Hz, 700 ms gap", &gap[0], &gap[1]);
+
+    CHECK(hover[1].outliers_passed * 10 < hover[0].outliers_passed);
+    CHECK(hover[1].rms_mm < hover[0].rms_mm / 4.0);
+    CHECK(descent[0].resets > 0 && descent[1].resets == 0 && descent[1].good_rejected == 0);
+    CHECK(gap[0].resets > 0 && gap[1].resets == 0);
+}
+
+static void test_rate_limit_short_interval(void)
+{
+    vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+    vl53lx_filter_t filter;
+    uint16_t output = 0;
+    CHECK(VL53LX_FilterInitWithConfig(&filter, &config));
+
+    // 15000 mm/s over 10 us is 0.15 mm: rounded up to 1 mm instead of 0
+    uint32_t t_us = 1000000;
+    CHECK(VL53LX_FilterUpdateAdaptive(&filter, 1000, 0, 2u << 16, 10u << 16, t_us, &output));
+    for (int i = 0; i < 8; i++) {
+        t_us += 10;
+        CHECK(VL53LX_FilterUpdateAdaptive(&filter, (uint16_t)(1000 + (i & 1)), 0, 2u << 16, 10u << 16, t_us,
+                                          &output));
+        CHECK(filter.rejected_count == 0);
+    }
+    CHECK(filter.samples_since_reset == 9);
+
+    // A real jump within the same 10 us is still rejected
+    uint16_t held = output;
+    t_us += 10;
+    CHECK(VL53LX_FilterUpdateAdaptive(&filter, 1100, 0, 2u << 16, 10u << 16, t_us, &output));
+    CHECK(filter.rejected_count == 1 && output == held);
+}
+
+static void test_speed(void)
+{
+    for (int k = 0; k < 2; k++) {
+        vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+        config.fixed_point = k == 1;
+        vl53lx_filter_t filter;
+        CHECK(VL53LX_FilterInitWithConfig(&filter, &config));
+
+        volatile uint32_t sink = 0;
+        uint64_t start_ns = host_time_ns();
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            for (int i = 0; i < SAMPLES; i++) {
+                uint16_t output = 0;
+                VL53LX_FilterUpdate(&filter, distances[i], statuses[i], &output);
+                sink += output;
+            }
+        }
+        double ns = (double)(host_time_ns() - start_ns) / ((double)BENCH_ROUNDS * SAMPLES);
+        printf("VL53LX_FilterUpdate %-11s %.1f ns/update\n", k == 1 ? "fixed point" : "float", ns);
+    }
+}
+
+int main(void)
+{
+    test_against_double();
+    test_speed();
+    test_batch_and_bank();
+    test_adaptive_noise();
+    test_rate_limit_per_second();
+    test_rate_limit_short_interval();
+    return host_test_result();
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_scratch.c
+ * @brief Scratch arena registration across VL53LX_DataInit()
+ *
+ * - An arena registered before DataInit is kept by DataInit and used for
+ *   the ranging frames; the device's own arena stays untouched
+ * - A second DataInit keeps the registration as well
+ * - NULL returns to the per-device arena
+ * - An arena smaller than VL53LX_SCRATCH_SIZE_BYTES is rejected
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_scratch.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+static VL53LX_Dev_t dev;
+static sim_scene_t scene;
+static int sim_index;
+static VL53LX_scratch_buffer_t shared_buffer;
+static VL53LX_scratch_t shared;
+
+static void range_frames(uint32_t frames)
+{
+    CHECK(VL53LX_StartMeasurement(&dev) == VL53LX_ERROR_NONE);
+    for (uint32_t k = 0; k < frames; k++) {
+        VL53LX_MultiRangingData_t data;
+        CHECK(sim_scene_range(&dev, sim_index, &data) == VL53LX_ERROR_NONE);
+        // The first frames carry no wrap check yet (status 6); the range is right
+        CHECK(data.NumberOfObjectsFound == 1);
+        CHECK(data.RangeData[0].RangeMilliMeter > 590 && data.RangeData[0].RangeMilliMeter < 610);
+    }
+    CHECK(VL53LX_StopMeasurement(&dev) == VL53LX_ERROR_NONE);
+}
+
+static void test_register_before_data_init(void)
+{
+    VL53LX_LLDriverData_t *pdev = &dev.Data.LLData;
+
+    CHECK(VL53LX_set_scratch_arena(&dev, &shared) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_get_scratch(&dev) == &shared);
+
+    range_frames(4);
+    CHECK(shared.peak_bytes > 0 && shared.used_bytes == 0 && shared.fail_count == 0);
+    CHECK(pdev->scratch.peak_bytes == 0);
+
+    // Re-initialization keeps it too
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_get_scratch(&dev) == &shared);
+
+    uint16_t size = 0;
+    uint16_t peak = 0;
+    uint16_t fails = 0;
+    CHECK(VL53LX_get_scratch_usage(&dev, &size, &peak, &fails) == VL53LX_ERROR_NONE);
+    CHECK(size == sizeof(shared_buffer) && peak == shared.peak_bytes && fails == 0);
+    printf("scratch arena: %u bytes, peak %u\n", size, peak);
+}
+
+static void test_unregister(void)
+{
+    VL53LX_LLDriverData_t *pdev = &dev.Data.LLData;
+
+    CHECK(VL53LX_set_scratch_arena(&dev, NULL) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_get_scratch(&dev) == &(pdev->scratch));
+    range_frames(2);
+    CHECK(pdev->scratch.peak_bytes == shared.peak_bytes);
+}
+
+static void test_too_small(void)
+{
+    VL53LX_scratch_t small;
+    VL53LX_scratch_init(&small, shared_buffer.words, (uint16_t)(VL53LX_SCRATCH_SIZE_BYTES - 8));
+
+    CHECK(VL53LX_set_scratch_arena(&dev, &shared) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_scratch_arena(&dev, &small) == VL53LX_ERROR_BUFFER_TOO_SMALL);
+    CHECK(VL53LX_get_scratch(&dev) == &shared);
+}
+
+int main(void)
+{
+    sim_index = sim_single_device(&dev, 3);
+    VL53LX_scratch_init(&shared, shared_buffer.words, sizeof(shared_buffer));
+
+    vl53lx_hist_synth_t defaults;
+    VL53LX_HistSynthInit(&defaults);
+    sim_scene_init(&scene, &dev, &defaults.config);
+    vl53lx_hist_synth_target_t target = { 600.0f, 50.0f };
+    sim_scene_set_targets(&scene, &target, 1);
+    sim_device_set_source(sim_index, sim_scene_frame, &scene);
+
+    test_register_before_data_init();
+    test_unregister();
+    test_too_small();
+    return host_test_result();
+}
@@ -0,0 +1,198 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_snapshot.c
+ * @brief VL53LX_GetStateSnapshot() / VL53LX_RestoreStateSnapshot() round trip
+ *
+ * - A restored device takes the same snapshot as the configured one,
+ *   writes the same registers on VL53LX_StartMeasurement() and ends up
+ *   with the same configuration registers
+ * - A scratch arena registered before the restore is kept
+ * - dmax cache, distance gate and UWR settings are saved, their cache
+ *   entries, statistics and confirmation counts are not
+ * - A damaged or truncated snapshot is rejected
+ * Prints the transfers and bus time of DataInit + configuration and of the
+ * restore.
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_scratch.h"
+#include "vl53lx_snapshot.h"
+#include "vl53lx_register_map.h"
+#include "sim_device.h"
+#include "host_test.h"
+#include <string.h>
+
+#define SEED            41
+#define OFFSET_MM       -12
+#define BUDGET_US       50000
+#define CONFIG_SIZE \
+    (VL53LX_SYSTEM_CONTROL_I2C_INDEX - VL53LX_STATIC_NVM_MANAGED_I2C_INDEX)
+
+static VL53LX_Dev_t cold;
+static VL53LX_Dev_t warm;
+static uint8_t snapshot[4096];
+static uint32_t snapshot_size;
+static uint8_t write_log[16 * 1024];
+static uint8_t cold_start_log[16 * 1024];
+static size_t cold_start_length;
+static uint8_t cold_config[CONFIG_SIZE];
+static VL53LX_scratch_buffer_t shared_buffer;
+static VL53LX_scratch_t shared;
+
+typedef struct {
+    uint32_t transfers;
+    uint64_t us;
+} cost_t;
+
+static void measure_start(void)
+{
+    sim_reset_stats();
+    sim_log_writes(write_log, sizeof(write_log));
+}
+
+static cost_t measure_end(uint64_t start_us)
+{
+    cost_t cost = { sim_bus_stats(0)->transfers, sim_now_us(0) - start_us };
+    return cost;
+}
+
+// Write log of VL53LX_StartMeasurement(), the device is stopped again
+static size_t start_log(VL53LX_Dev_t *dev)
+{
+    sim_log_writes(write_log, sizeof(write_log));
+    CHECK(VL53LX_StartMeasurement(dev) == VL53LX_ERROR_NONE);
+    size_t length = sim_log_length();
+    sim_log_writes(NULL, 0);
+    CHECK(sim_log_dropped() == 0);
+    CHECK(VL53LX_StopMeasurement(dev) == VL53LX_ERROR_NONE);
+    return length;
+}
+
+static void test_round_trip(void)
+{
+    // Cold start: DataInit, distance mode, timing budget, calibration
+    sim_single_device(&cold, SEED);
+    CHECK(VL53LX_WaitDeviceBooted(&cold) == VL53LX_ERROR_NONE);
+    uint64_t start_us = sim_now_us(0);
+    measure_start();
+    CHECK(VL53LX_DataInit(&cold) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetDistanceMode(&cold, VL53LX_DISTANCEMODE_LONG) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetMeasurementTimingBudgetMicroSeconds(&cold, BUDGET_US) == VL53LX_ERROR_NONE);
+    VL53LX_CalibrationData_t cal;
+    CHECK(VL53LX_GetCalibrationData(&cold, &cal) == VL53LX_ERROR_NONE);
+    cal.customer.mm_config__inner_offset_mm = OFFSET_MM;
+    CHECK(VL53LX_SetCalibrationData(&cold, &cal) == VL53LX_ERROR_NONE);
+    cost_t init = measure_end(start_us);
+    sim_log_writes(NULL, 0);
+
+    CHECK(VL53LX_GetStateSnapshot(&cold, snapshot, sizeof(snapshot), &snapshot_size) == VL53LX_ERROR_NONE);
+    CHECK(snapshot_size == VL53LX_GetStateSnapshotSize());
+    cold_start_length = start_log(&cold);
+    memcpy(cold_start_log, write_log, cold_start_length);
+    memcpy(cold_config, sim_device_regs(0) + VL53LX_STATIC_NVM_MANAGED_I2C_INDEX, CONFIG_SIZE);
+
+    // Warm start of the same sensor, with a shared arena registered first
+    sim_single_device(&warm, SEED);
+    VL53LX_scratch_init(&shared, shared_buffer.words, sizeof(shared_buffer));
+    CHECK(VL53LX_set_scratch_arena(&warm, &shared) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_WaitDeviceBooted(&warm) == VL53LX_ERROR_NONE);
+    start_us = sim_now_us(0);
+    measure_start();
+    CHECK(VL53LX_RestoreStateSnapshot(&warm, snapshot, snapshot_size) == VL53LX_ERROR_NONE);
+    cost_t restore = measure_end(start_us);
+    sim_log_writes(NULL, 0);
+
+    printf("DataInit + configuration: %3u transfers %5.1f ms\n", init.transfers, init.us / 1000.0);
+    printf("restore:                  %3u transfers %5.1f ms (%u byte snapshot)\n", restore.transfers,
+           restore.us / 1000.0, snapshot_size);
+    CHECK(restore.transfers < init.transfers && restore.us < init.us);
+
+    CHECK(VL53LX_get_scratch(&warm) == &shared);
+    CHECK(warm.Data.LLData.nvm_uid == cold.Data.LLData.nvm_uid);
+    CHECK(warm.Data.LLData.customer.mm_config__inner_offset_mm == OFFSET_MM);
+
+    static uint8_t again[sizeof(snapshot)];
+    uint32_t again_size = 0;
+    CHECK(VL53LX_GetStateSnapshot(&warm, again, sizeof(again), &again_size) == VL53LX_ERROR_NONE);
+    CHECK(again_size == snapshot_size && memcmp(again, snapshot, snapshot_size) == 0);
+
+    size_t warm_start_length = start_log(&warm);
+    CHECK(warm_start_length == cold_start_length && memcmp(write_log, cold_start_log, cold_start_length) == 0);
+    CHECK(memcmp(sim_device_regs(0) + VL53LX_STATIC_NVM_MANAGED_I2C_INDEX, cold_config, CONFIG_SIZE) == 0);
+}
+
+static void test_runtime_state(void)
+{
+    static uint8_t clean[sizeof(snapshot)];
+    static uint8_t used[sizeof(snapshot)];
+    uint32_t size = 0;
+    VL53LX_LLDriverData_t *pdev = &warm.Data.LLData;
+
+    CHECK(VL53LX_set_dmax_cache_config(&warm, 0x03, 1, 2, 16) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_hist_gate(&warm, 1, 300, 900, 2) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_uwr_confirmation(&warm, 3, 40) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_GetStateSnapshot(&warm, clean, sizeof(clean), &size) == VL53LX_ERROR_NONE);
+
+    // As after some ranging
+    pdev->dmax_cache.entry[0].valid = 1;
+    pdev->dmax_cache.entry[0].ambient_dmax_mm[0] = 1234;
+    pdev->dmax_cache.next_entry = 1;
+    pdev->dmax_cache.hit_count = 10;
+    pdev->dmax_cache.miss_count = 2;
+    pdev->hist_gate.pass_count = 12;
+    pdev->hist_gate.fallback_count = 1;
+    pdev->hist_gate.pulses_found = 20;
+    pdev->hist_gate.pulses_skipped = 5;
+    pdev->uwr.confirm_count[0] = 2;
+    CHECK(VL53LX_GetStateSnapshot(&warm, used, sizeof(used), &size) == VL53LX_ERROR_NONE);
+    CHECK(memcmp(used, clean, size) == 0);
+
+    CHECK(VL53LX_RestoreStateSnapshot(&warm, used, size) == VL53LX_ERROR_NONE);
+    CHECK(pdev->dmax_cache.cache_enable == 1 && pdev->dmax_cache.reflectance_mask == 0x03);
+    CHECK(pdev->dmax_cache.ambient_quant_shift == 2 && pdev->dmax_cache.refresh_period == 16);
+    CHECK(!pdev->dmax_cache.entry[0].valid && pdev->dmax_cache.next_entry == 0);
+    CHECK(pdev->dmax_cache.hit_count == 0 && pdev->dmax_cache.miss_count == 0);
+    CHECK(pdev->hist_gate.gate_enable == 1 && pdev->hist_gate.margin_bins == 2);
+    CHECK(pdev->hist_gate.min_range_mm == 300 && pdev->hist_gate.max_range_mm == 900);
+    CHECK(pdev->hist_gate.pass_count == 0 && pdev->hist_gate.pulses_found == 0);
+    CHECK(pdev->uwr.confirm_depth == 3 && pdev->uwr.hysteresis_mm == 40);
+    CHECK(pdev->uwr.confirm_count[0] == 0);
+}
+
+static void test_rejected(void)
+{
+    static uint8_t before[sizeof(snapshot)];
+    static uint8_t damaged[sizeof(snapshot)];
+    uint32_t size = 0;
+
+    CHECK(VL53LX_GetStateSnapshot(&warm, before, sizeof(before), &size) == VL53LX_ERROR_NONE);
+
+    CHECK(VL53LX_GetStateSnapshot(&warm, damaged, 16, &size) == VL53LX_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(damaged, snapshot, snapshot_size);
+    damaged[snapshot_size - 1] ^= 0x01;
+    CHECK(VL53LX_RestoreStateSnapshot(&warm, damaged, snapshot_size) == VL53LX_ERROR_INVALID_PARAMS);
+    CHECK(VL53LX_RestoreStateSnapshot(&warm, snapshot, snapshot_size - 1) == VL53LX_ERROR_INVALID_PARAMS);
+
+    memcpy(damaged, snapshot, snapshot_size);
+    damaged[0] ^= 0xFF;
+    CHECK(VL53LX_RestoreStateSnapshot(&warm, damaged, snapshot_size) == VL53LX_ERROR_INVALID_PARAMS);
+
+    // The device state is untouched by the rejected blobs
+    CHECK(VL53LX_get_scratch(&warm) == &shared);
+    CHECK(VL53LX_GetStateSnapshot(&warm, damaged, sizeof(damaged), &size) == VL53LX_ERROR_NONE);
+    CHECK(memcmp(damaged, before, snapshot_size) == 0);
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_runtime_state();
+    test_rejected();
+    return host_test_result();
+}
@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_stagger.c
+ * @brief Staggered VL53LX_TofArray on simulated sensors sharing one bus
+ *
+ * Event-driven stand-in for the service task: the clock jumps to the next
+ * start due or the next frame end, frame ends raise the ISR bits. Every
+ * sensor has its own measurement time around the 33 ms timing budget.
+ * - Back-to-back starts: emission windows of the sensors overlap
+ * - Automatic period: no overlap planned nor seen, phase errors stay small
+ *   and the per-sensor rate is one sample per period
+ * - A fixed period shorter than N windows: readouts are spread over it
+ * Prints the table quoted in the API doc.
+ */
+
+#include "vl53lx_tof_array.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+#define MAX_SENSORS     8
+#define FIRST_ADDRESS   0x30
+#define RUN_US          3000000u
+#define SETTLE_US       200000u             // Not counted in the emission overlap
+#define GRID_US         50u
+#define MAX_WINDOWS     200
+
+static VL53LX_Dev_t devs[MAX_SENSORS];
+static sim_scene_t scenes[MAX_SENSORS];
+static vl53lx_tof_array_t array;
+
+// Emission windows, start to data ready
+static uint64_t window_start[MAX_SENSORS][MAX_WINDOWS];
+static uint64_t window_end[MAX_SENSORS][MAX_WINDOWS];
+static uint32_t windows[MAX_SENSORS];
+
+typedef struct {
+    uint32_t period_us;
+    double rate_hz;                         // Per sensor
+    double overlap;                         // Share of time with two or more sensors emitting
+    double phase_error_mean_ms;
+    double phase_error_max_ms;
+    double latency_mean_ms;
+    double latency_max_ms;
+    double bus_busy;
+    uint32_t skipped;
+    uint32_t errors;
+} run_result_t;
+
+static bool hal_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    (void)ctx;
+    sim_device_xshut(index, release);
+    return true;
+}
+
+static bool hal_bind(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address)
+{
+    (void)ctx;
+    (void)index;
+    dev->I2cHandle = sim_bus_handle(0);
+    dev->I2cDevAddr = address;
+    return true;
+}
+
+static const vl53lx_bringup_hal_t hal = { .set_xshut = hal_set_xshut, .bind = hal_bind };
+
+static void start_array(int n, bool staggered, uint32_t period_us)
+{
+    sim_reset();
+    vl53lx_tof_array_config_t config = VL53LX_TofArrayGetDefaultConfig();
+    config.staggered = staggered;
+    config.stagger.frame_period_us = period_us;
+    CHECK(VL53LX_TofArrayInitWithConfig(&array, &config));
+
+    for (int i = 0; i < n; i++) {
+        sim_device_add(0, 100 + i, SIM_DEFAULT_BOOT_US);
+        memset(&devs[i], 0, sizeof(devs[i]));
+        devs[i].I2cHandle = sim_bus_handle(0);
+        vl53lx_tof_sensor_config_t sensor = VL53LX_TofArrayGetDefaultSensorConfig();
+        sensor.address = (uint8_t)(FIRST_ADDRESS + i);
+        sensor.int_gpio = 4;
+        CHECK(VL53LX_TofArrayAddSensor(&array, &sensor, &devs[i]) == i);
+    }
+    CHECK(VL53LX_TofArrayBringupWithHal(&array, &hal) == n);
+
+    for (int i = 0; i < n; i++) {
+        vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+        base.seed = 100 + i;
+        sim_scene_init(&scenes[i], &devs[i], &base);
+        vl53lx_hist_synth_target_t target = { 500.0f, 50.0f };
+        sim_scene_set_targets(&scenes[i], &target, 1);
+        sim_device_set_source(i, sim_scene_frame, &scenes[i]);
+        // Timing budget within +-0.5 ms, as the oscillators of different parts
+        sim_device_set_measure_us(i, 33000u + (uint32_t)((i * 997) % 1000) - 500u);
+        windows[i] = 0;
+    }
+}
+
+static double emission_overlap(int n, uint64_t from_us, uint64_t to_us)
+{
+    uint32_t next[MAX_SENSORS] = { 0 };
+    uint64_t overlapped = 0;
+    uint64_t total = 0;
+
+    for (uint64_t t = from_us; t < to_us; t += GRID_US) {
+        int emitting = 0;
+        for (int i = 0; i < n; i++) {
+            while (next[i] < windows[i] && window_end[i][next[i]] <= t) {
+                next[i]++;
+            }
+            if (next[i] < windows[i] && window_start[i][next[i]] <= t) {
+                emitting++;
+            }
+        }
+        total++;
+        overlapped += emitting >= 2;
+    }
+    return total > 0 ? (double)overlapped / (double)total : 0.0;
+}
+
+static run_result_t run(int n, bool staggered, uint32_t period_us)
+{
+    run_result_t result;
+    memset(&result, 0, sizeof(result));
+    start_array(n, staggered, period_us);
+
+    uint64_t start_us = sim_now_us(0);
+    uint64_t end_us = start_us + RUN_US;
+    sim_reset_stats();
+    CHECK(VL53LX_TofArrayStartRanging(&array) == n);
+
+    while (sim_now_us(0) < end_us) {
+        uint32_t until_us = VL53LX_TofArrayRunDue(&array);
+        uint64_t next_us = until_us != VL53LX_STAGGER_NONE ? sim_now_us(0) + until_us : UINT64_MAX;
+        for (int i = 0; i < n; i++) {
+            if (sim_device_ready_at(i) < next_us) {
+                next_us = sim_device_ready_at(i);
+            }
+        }
+        if (next_us == UINT64_MAX) {
+            break;
+        }
+        if (next_us > sim_now_us(0)) {
+            sim_advance_to(0, next_us);
+        }
+
+        // ISR: frames that have ended
+        uint32_t mask = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t ready_at = sim_device_ready_at(i);
+            if (ready_at > sim_now_us(0)) {
+                continue;
+            }
+            mask |= 1u << i;
+            array.sensors[i].ready_us = (uint32_t)ready_at;
+            if (windows[i] < MAX_WINDOWS) {
+                window_start[i][windows[i]] = sim_device_last_start(i);
+                window_end[i][windows[i]] = ready_at;
+                windows[i]++;
+            }
+        }
+        VL53LX_TofArrayService(&array, mask);
+    }
+
+    uint64_t elapsed_us = sim_now_us(0) - start_us;
+    uint32_t samples = 0;
+    uint32_t starts = 0;
+    uint64_t latency_sum_us = 0;
+    uint64_t phase_error_sum_us = 0;
+    for (int i = 0; i < n; i++) {
+        const vl53lx_tof_sensor_t *sensor = &array.sensors[i];
+        samples += sensor->stats.samples;
+        result.errors += sensor->stats.errors;
+        latency_sum_us += sensor->stats.latency_sum_us;
+        if (sensor->stats.latency_max_us / 1000.0 > result.latency_max_ms) {
+            result.latency_max_ms = sensor->stats.latency_max_us / 1000.0;
+        }
+        if (staggered) {
+            const vl53lx_stagger_slot_t *slot = &array.stagger.slots[sensor->slot];
+            starts += slot->starts;
+            phase_error_sum_us += slot->phase_error_sum_us;
+            result.skipped += slot->skipped_frames;
+            if (slot->phase_error_max_us / 1000.0 > result.phase_error_max_ms) {
+                result.phase_error_max_ms = slot->phase_error_max_us / 1000.0;
+            }
+        }
+    }
+
+    result.period_us = staggered ? array.stagger.period_us : 0;
+    result.rate_hz = samples / (double)n / (elapsed_us / 1e6);
+    result.overlap = emission_overlap(n, start_us + SETTLE_US, end_us);
+    result.phase_error_mean_ms = starts > 0 ? phase_error_sum_us / (double)starts / 1000.0 : 0.0;
+    result.latency_mean_ms = samples > 0 ? latency_sum_us / (double)samples / 1000.0 : 0.0;
+    result.bus_busy = sim_bus_stats(0)->busy_us / (double)elapsed_us;
+
+    printf("%d  %-10s %6.0f ms  %5.1f Hz  %5.1f%%  ", n, !staggered ? "together" : period_us == 0 ? "auto" : "fixed",
+           result.period_us / 1000.0, result.rate_hz, result.overlap * 100.0);
+    if (staggered) {
+        printf("%4.2f / %4.2f ms  ", result.phase_error_mean_ms, result.phase_error_max_ms);
+    } else {
+        printf("      -         ");
+    }
+    printf("%4.2f / %4.2f ms  %5.1f%%", result.latency_mean_ms, result.latency_max_ms, result.bus_busy * 100.0);
+    if (staggered) {
+        printf("  bus idle margin %.1f ms, %u skipped", array.stagger.bus_idle_margin_us / 1000.0, result.skipped);
+    }
+    printf("\n");
+
+    VL53LX_TofArrayStopRanging(&array);
+    return result;
+}
+
+static void test_schedules(void)
+{
+    static const int counts[] = { 2, 4, 8 };
+
+    printf("N  start      period     rate      overlap phase error      latency          bus\n");
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        int n = counts[k];
+
+        run_result_t together = run(n, false, 0);
+        CHECK(together.errors == 0);
+        CHECK(together.overlap > 0.5);
+        CHECK(together.rate_hz > 25.0);
+
+        run_result_t automatic = run(n, true, 0);
+        CHECK(automatic.errors == 0);
+        CHECK(array.stagger.emission_margin_us >= 0 && array.stagger.bus_idle_margin_us >= 0);
+        CHECK(automatic.overlap == 0.0);
+        CHECK(automatic.phase_error_max_ms < 2.0);
+        CHECK(automatic.bus_busy < together.bus_busy);
+        double expected_hz = 1e6 / automatic.period_us;
+        CHECK(automatic.rate_hz > expected_hz * 0.95 && automatic.rate_hz < expected_hz * 1.05);
+    }
+
+    // Eight sensors in 80 ms: overlapping emission, readouts spread over the frame
+    run_result_t fixed = run(8, true, 80000);
+    CHECK(fixed.errors == 0);
+    CHECK(fixed.period_us == 80000);
+    CHECK(fixed.rate_hz > 1e6 / 80000 * 0.95);
+    CHECK(fixed.latency_max_ms < 3.0);
+
+    // Eight sensors in 40 ms: the bus windows no longer fit
+    run_result_t tight = run(8, true, 40000);
+    CHECK(tight.errors == 0);
+    CHECK(array.stagger.bus_idle_margin_us < 0);
+}
+
+int main(void)
+{
+    test_schedules();
+    return host_test_result();
+}
@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_tof_array.c
+ * @brief VL53LX_TofArray on simulated sensors sharing one bus
+ *
+ * The service task is replaced by a loop that wakes every millisecond and
+ * raises the ISR bit of a sensor when its frame completes.
+ * - 1 to 8 sensors interrupting at once: latency of the first and last
+ *   sensor served and bus time of one frame
+ * - A sensor without an INT pin is polled on its own period while another
+ *   sensor interrupts, and gets as many samples with a short latency
+ * - A missed edge is recovered by the poll after poll_timeout_ms
+ * Prints the latency table and the size of the array structures.
+ */
+
+#include "vl53lx_tof_array.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+#define MAX_SENSORS     8
+#define FIRST_ADDRESS   0x30
+#define INT_GPIO        4                   // Any pin number: the test raises the ISR bits itself
+#define TICK_US         1000
+
+static VL53LX_Dev_t devs[MAX_SENSORS];
+static sim_scene_t scenes[MAX_SENSORS];
+static vl53lx_tof_array_t array;
+static uint64_t signaled_at[MAX_SENSORS];   // Frame end already raised by the ISR
+static bool drop_edges[MAX_SENSORS];
+
+typedef struct {
+    uint32_t count;
+    uint32_t latency_us[MAX_SENSORS];
+} sample_log_t;
+
+static sample_log_t sample_log;
+
+static void on_sample(void *ctx, const vl53lx_tof_sample_t *sample)
+{
+    sample_log_t *log = ctx;
+    log->count++;
+    log->latency_us[sample->index] = sample->latency_us;
+}
+
+static bool hal_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    (void)ctx;
+    sim_device_xshut(index, release);
+    return true;
+}
+
+static bool hal_bind(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address)
+{
+    (void)ctx;
+    (void)index;
+    dev->I2cHandle = sim_bus_handle(0);
+    dev->I2cDevAddr = address;
+    return true;
+}
+
+static const vl53lx_bringup_hal_t hal = { .set_xshut = hal_set_xshut, .bind = hal_bind };
+
+// n sensors up and ranging, the first no_int ones without an INT pin
+static void start_array(int n, int no_int)
+{
+    sim_reset();
+    vl53lx_tof_array_config_t config = VL53LX_TofArrayGetDefaultConfig();
+    config.on_sample = on_sample;
+    config.ctx = &sample_log;
+    CHECK(VL53LX_TofArrayInitWithConfig(&array, &config));
+
+    for (int i = 0; i < n; i++) {
+        sim_device_add(0, 60 + i, SIM_DEFAULT_BOOT_US);
+        memset(&devs[i], 0, sizeof(devs[i]));
+        devs[i].I2cHandle = sim_bus_handle(0);
+        vl53lx_tof_sensor_config_t sensor = VL53LX_TofArrayGetDefaultSensorConfig();
+        sensor.address = (uint8_t)(FIRST_ADDRESS + i);
+        sensor.int_gpio = i < no_int ? VL53LX_TOF_ARRAY_NO_GPIO : INT_GPIO;
+        CHECK(VL53LX_TofArrayAddSensor(&array, &sensor, &devs[i]) == i);
+        signaled_at[i] = 0;
+        drop_edges[i] = false;
+    }
+    CHECK(VL53LX_TofArrayBringupWithHal(&array, &hal) == n);
+    for (int i = 0; i < n; i++) {
+        vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+        base.seed = 60 + i;
+        sim_scene_init(&scenes[i], &devs[i], &base);
+        vl53lx_hist_synth_target_t target = { 400.0f + 100.0f * i, 50.0f };
+        sim_scene_set_targets(&scenes[i], &target, 1);
+        sim_device_set_source(i, sim_scene_frame, &scenes[i]);
+    }
+    memset(&sample_log, 0, sizeof(sample_log));
+    CHECK(VL53LX_TofArrayStartRanging(&array) == n);
+}
+
+// ISR stand-in: bits of the sensors with an INT pin whose frame has completed
+static uint32_t raise_edges(void)
+{
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < array.count; i++) {
+        uint64_t ready_at = sim_device_ready_at(i);
+        if (array.sensors[i].config.int_gpio == VL53LX_TOF_ARRAY_NO_GPIO || ready_at > sim_now_us(0) ||
+            ready_at == signaled_at[i]) {
+            continue;
+        }
+        signaled_at[i] = ready_at;
+        if (!drop_edges[i]) {
+            array.sensors[i].ready_us = (uint32_t)ready_at;
+            bits |= 1u << i;
+        }
+    }
+    return bits;
+}
+
+// Service task stand-in, woken every tick
+static void run_for(uint32_t duration_us)
+{
+    uint64_t end_us = sim_now_us(0) + duration_us;
+    while (sim_now_us(0) < end_us) {
+        sim_advance_us(0, TICK_US);
+        VL53LX_TofArrayService(&array, VL53LX_TofArrayCollectReady(&array, raise_edges()));
+    }
+}
+
+static void test_latency(void)
+{
+    static const int counts[] = { 1, 2, 4, 8 };
+
+    printf(" N  first sensor  last sensor  bus time per frame\n");
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        int n = counts[k];
+        start_array(n, 0);
+
+        // Every frame complete, all interrupts at the same time
+        uint64_t last_ready = 0;
+        for (int i = 0; i < n; i++) {
+            if (sim_device_ready_at(i) > last_ready) {
+                last_ready = sim_device_ready_at(i);
+            }
+        }
+        sim_advance_to(0, last_ready);
+        uint32_t mask = 0;
+        for (int i = 0; i < n; i++) {
+            array.sensors[i].ready_us = (uint32_t)sim_now_us(0);
+            mask |= 1u << i;
+        }
+        sim_reset_stats();
+        CHECK(VL53LX_TofArrayService(&array, mask) == n);
+        uint32_t first_us = sample_log.latency_us[0];
+        uint32_t last_us = sample_log.latency_us[n - 1];
+        printf("%2d  %9.1f ms  %8.1f ms  %14.1f ms\n", n, first_us / 1000.0, last_us / 1000.0,
+               sim_bus_stats(0)->busy_us / 1000.0);
+
+        // Served in index order, one readout and restart each
+        CHECK(sample_log.count == (uint32_t)n);
+        for (int i = 1; i < n; i++) {
+            CHECK(sample_log.latency_us[i] > sample_log.latency_us[i - 1]);
+        }
+        CHECK(n == 1 || (last_us - first_us) / (uint32_t)(n - 1) < 5000);
+        CHECK(sim_bus_stats(0)->busy_us < (uint64_t)n * 5000);
+        VL53LX_TofArrayStopRanging(&array);
+    }
+}
+
+static void test_poll_without_int(void)
+{
+    // Sensor 0 has no INT pin, sensor 1 interrupts every frame
+    start_array(2, 1);
+    CHECK(array.poll_mask == 1u);
+    run_for(1000000);
+
+    const vl53lx_tof_sensor_stats_t *polled = &array.sensors[0].stats;
+    const vl53lx_tof_sensor_stats_t *notified = &array.sensors[1].stats;
+    printf("polled sensor: %u samples, max latency %.1f ms; interrupting sensor: %u samples\n", polled->samples,
+           polled->latency_max_us / 1000.0, notified->samples);
+    CHECK(notified->samples >= 25);
+    CHECK(polled->samples + 1 >= notified->samples);
+    // The poll reads the data ready flag, the time is that of the poll
+    CHECK(polled->latency_max_us < 5000);
+    CHECK(polled->errors == 0 && notified->errors == 0);
+    VL53LX_TofArrayStopRanging(&array);
+}
+
+static void test_missed_edge(void)
+{
+    start_array(2, 0);
+    drop_edges[1] = true;
+    run_for(100000);
+    uint32_t before = array.sensors[1].stats.samples;
+    CHECK(before == 0);
+    CHECK(array.sensors[0].stats.samples >= 2);
+
+    // poll_timeout_ms without any interrupt: sensor 0 is stopped too
+    drop_edges[0] = true;
+    run_for(array.config.poll_timeout_ms * 1000u + 2 * TICK_US);
+    CHECK(array.sensors[1].stats.samples > before);
+    VL53LX_TofArrayStopRanging(&array);
+}
+
+static void test_add_sensor(void)
+{
+    vl53lx_tof_sensor_config_t sensor = VL53LX_TofArrayGetDefaultSensorConfig();
+    CHECK(VL53LX_TofArrayInit(&array));
+    CHECK(VL53LX_TofArrayAddSensor(&array, &sensor, NULL) == -1);
+    CHECK(VL53LX_TofArrayAddSensor(&array, &sensor, &devs[0]) == 0);
+    CHECK(VL53LX_TofArrayAddSensor(&array, &sensor, &devs[1]) == -1);   // Address taken
+
+    printf("sizeof: vl53lx_tof_array_t %zu, vl53lx_tof_sensor_t %zu, VL53LX_Dev_t %zu\n", sizeof(vl53lx_tof_array_t),
+           sizeof(vl53lx_tof_sensor_t), sizeof(VL53LX_Dev_t));
+    CHECK(sizeof(vl53lx_tof_array_t) < sizeof(VL53LX_Dev_t));
+}
+
+int main(void)
+{
+    test_add_sensor();
+    test_latency();
+    test_poll_without_int();
+    test_missed_edge();
+    return host_test_result();
+}
@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_tof_multibus.c
+ * @brief VL53LX_TofMultiBus on simulated sensors over two buses
+ *
+ * The two service tasks are replaced by a loop that serves the bus whose
+ * virtual clock is behind, so the transfers of the buses overlap in time.
+ * - Back-to-back sensors: two buses double the throughput of a saturated
+ *   bus, and sixteen sensors over two buses fill both
+ * - Mixed timing budgets: VL53LX_TofMultiBusAssign() balances the expected
+ *   load where a split by AddSensor order does not
+ * - The same address is used once per bus
+ * Prints the throughput tables and the structure sizes quoted in the API doc.
+ */
+
+#include "vl53lx_tof_multibus.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+#define MAX_SENSORS     16
+#define RUN_US          2000000u
+
+static VL53LX_Dev_t devs[MAX_SENSORS];
+static sim_scene_t scenes[MAX_SENSORS];
+static vl53lx_tof_multibus_t multibus;
+static int sim_index[VL53LX_TOF_MULTIBUS_MAX_BUSES][VL53LX_TOF_ARRAY_MAX_SENSORS];
+static const uint8_t bus_ids[VL53LX_TOF_MULTIBUS_MAX_BUSES] = { 0, 1 };
+
+static bool hal_set_xshut(void *ctx, uint8_t index, bool release)
+{
+    uint8_t bus = *(const uint8_t *)ctx;
+    // The bring-up of a bus reads the clock of that bus
+    sim_select_bus(bus);
+    sim_device_xshut(sim_index[bus][index], release);
+    return true;
+}
+
+static bool hal_bind(void *ctx, uint8_t index, VL53LX_DEV dev, uint8_t address)
+{
+    (void)index;
+    dev->I2cHandle = sim_bus_handle(*(const uint8_t *)ctx);
+    dev->I2cDevAddr = address;
+    return true;
+}
+
+// n sensors with the given budgets, pinned to a bus or auto-assigned
+static void setup(uint8_t bus_count, int n, const uint32_t *budgets_us, const int *pins)
+{
+    sim_reset();
+    vl53lx_tof_multibus_config_t config = VL53LX_TofMultiBusGetDefaultConfig();
+    config.bus_count = bus_count;
+    CHECK(VL53LX_TofMultiBusInitWithConfig(&multibus, &config));
+
+    for (int i = 0; i < n; i++) {
+        memset(&devs[i], 0, sizeof(devs[i]));
+        vl53lx_tof_sensor_config_t sensor = VL53LX_TofArrayGetDefaultSensorConfig();
+        sensor.address = (uint8_t)(0x30 + i % VL53LX_TOF_ARRAY_MAX_SENSORS);
+        sensor.int_gpio = 4;
+        sensor.timing_budget_us = budgets_us[i];
+        CHECK(VL53LX_TofMultiBusAddSensor(&multibus, &sensor, &devs[i],
+                                          pins != NULL ? pins[i] : VL53LX_TOF_MULTIBUS_AUTO) == i);
+    }
+    CHECK(VL53LX_TofMultiBusAssign(&multibus));
+
+    // Simulated devices on the bus each sensor was given
+    for (uint8_t b = 0; b < bus_count; b++) {
+        for (uint8_t i = 0; i < multibus.buses[b].array.count; i++) {
+            sim_index[b][i] = sim_device_add(b, 100u + multibus.buses[b].sensor_index[i], SIM_DEFAULT_BOOT_US);
+            multibus.buses[b].array.sensors[i].dev->I2cHandle = sim_bus_handle(b);
+        }
+    }
+    vl53lx_bringup_hal_t hals[VL53LX_TOF_MULTIBUS_MAX_BUSES];
+    for (uint8_t b = 0; b < VL53LX_TOF_MULTIBUS_MAX_BUSES; b++) {
+        hals[b] = (vl53lx_bringup_hal_t){ .set_xshut = hal_set_xshut, .bind = hal_bind, .ctx = (void *)&bus_ids[b] };
+    }
+    CHECK(VL53LX_TofMultiBusBringupWithHal(&multibus, hals) == n);
+
+    for (uint8_t b = 0; b < bus_count; b++) {
+        for (uint8_t i = 0; i < multibus.buses[b].array.count; i++) {
+            int s = multibus.buses[b].sensor_index[i];
+            int d = sim_index[b][i];
+            vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+            base.seed = 100u + s;
+            sim_scene_init(&scenes[s], &devs[s], &base);
+            vl53lx_hist_synth_target_t target = { 500.0f, 50.0f };
+            sim_scene_set_targets(&scenes[s], &target, 1);
+            sim_device_set_source(d, sim_scene_frame, &scenes[s]);
+            sim_device_set_measure_us(d, budgets_us[s]);
+        }
+    }
+}
+
+// Both service tasks for RUN_US of each bus clock
+static void run(vl53lx_tof_multibus_stats_t *stats)
+{
+    uint8_t bus_count = multibus.config.bus_count;
+    uint64_t end_us[VL53LX_TOF_MULTIBUS_MAX_BUSES];
+
+    for (uint8_t b = 0; b < bus_count; b++) {
+        sim_select_bus(b);
+        CHECK(VL53LX_TofArrayStartRanging(&multibus.buses[b].array) == multibus.buses[b].array.count);
+        end_us[b] = sim_now_us(b) + RUN_US;
+    }
+
+    for (;;) {
+        int b = -1;
+        for (uint8_t k = 0; k < bus_count; k++) {
+            if (sim_now_us(k) < end_us[k] && (b < 0 || sim_now_us(k) < sim_now_us((uint8_t)b))) {
+                b = k;
+            }
+        }
+        if (b < 0) {
+            break;
+        }
+
+        vl53lx_tof_array_t *array = &multibus.buses[b].array;
+        uint64_t next_us = UINT64_MAX;
+        for (uint8_t i = 0; i < array->count; i++) {
+            if (sim_device_ready_at(sim_index[b][i]) < next_us) {
+                next_us = sim_device_ready_at(sim_index[b][i]);
+            }
+        }
+        if (next_us == UINT64_MAX) {
+            sim_advance_to((uint8_t)b, end_us[b]);
+            continue;
+        }
+        sim_advance_to((uint8_t)b, next_us);
+        sim_select_bus((uint8_t)b);
+
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < array->count; i++) {
+            uint64_t ready_at = sim_device_ready_at(sim_index[b][i]);
+            if (ready_at <= sim_now_us((uint8_t)b)) {
+                mask |= 1u << i;
+                array->sensors[i].ready_us = (uint32_t)ready_at;
+            }
+        }
+        VL53LX_TofArrayService(array, mask);
+    }
+
+    VL53LX_TofMultiBusGetStats(&multibus, RUN_US, stats);
+    for (uint8_t b = 0; b < bus_count; b++) {
+        VL53LX_TofArrayStopRanging(&multibus.buses[b].array);
+    }
+}
+
+static uint32_t throughput(uint8_t bus_count, int n, uint32_t budget_us)
+{
+    uint32_t budgets_us[MAX_SENSORS];
+    vl53lx_tof_multibus_stats_t stats;
+
+    for (int i = 0; i < n; i++) {
+        budgets_us[i] = budget_us;
+    }
+    setup(bus_count, n, budgets_us, NULL);
+    run(&stats);
+    CHECK(stats.errors == 0);
+    return stats.samples_per_second;
+}
+
+static void test_throughput(void)
+{
+    static const uint32_t budgets_us[] = { 8000, 10000, 15000, 20000, 33000 };
+
+    printf("budget  8 on 1 bus  8 on 2 buses  ratio  16 on 2 buses\n");
+    for (size_t k = 0; k < sizeof(budgets_us) / sizeof(budgets_us[0]); k++) {
+        uint32_t one = throughput(1, 8, budgets_us[k]);
+        uint32_t two = throughput(2, 8, budgets_us[k]);
+        uint32_t sixteen = throughput(2, 16, budgets_us[k]);
+        double ratio = (double)two / (double)one;
+        printf("%2u ms  %6u S/s  %8u S/s  %5.2f  %9u S/s\n", budgets_us[k] / 1000, one, two, ratio, sixteen);
+
+        // A saturated bus: the second one doubles the rate
+        if (budgets_us[k] <= 10000) {
+            CHECK(ratio > 1.9);
+        }
+        CHECK(two + 5 >= one);
+        CHECK(sixteen >= two);
+    }
+}
+
+static void test_balance(void)
+{
+    // Four 8 ms and four 33 ms sensors
+    static const uint32_t budgets_us[] = { 8000, 8000, 8000, 8000, 33000, 33000, 33000, 33000 };
+    static const int halves[] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    vl53lx_tof_multibus_stats_t split;
+    vl53lx_tof_multibus_stats_t balanced;
+
+    setup(2, 8, budgets_us, halves);
+    run(&split);
+    setup(2, 8, budgets_us, NULL);
+    run(&balanced);
+
+    printf("split by order: bus loads %u / %u permille, %u S/s\n", split.bus[0].load_permille,
+           split.bus[1].load_permille, split.samples_per_second);
+    printf("assigned:       bus loads %u / %u permille, %u S/s\n", balanced.bus[0].load_permille,
+           balanced.bus[1].load_permille, balanced.samples_per_second);
+    CHECK(balanced.bus[0].load_permille == balanced.bus[1].load_permille);
+    CHECK(balanced.samples_per_second > split.samples_per_second);
+    CHECK(split.errors == 0 && balanced.errors == 0);
+}
+
+static void test_addresses(void)
+{
+    vl53lx_tof_sensor_config_t sensor = VL53LX_TofArrayGetDefaultSensorConfig();
+    sensor.address = 0x30;
+    CHECK(VL53LX_TofMultiBusInit(&multibus));
+    CHECK(VL53LX_TofMultiBusAddSensor(&multibus, &sensor, NULL, VL53LX_TOF_MULTIBUS_AUTO) == -1);
+    CHECK(VL53LX_TofMultiBusAddSensor(&multibus, &sensor, &devs[0], VL53LX_TOF_MULTIBUS_AUTO) == 0);
+    CHECK(VL53LX_TofMultiBusAddSensor(&multibus, &sensor, &devs[1], VL53LX_TOF_MULTIBUS_AUTO) == 1);
+    CHECK(VL53LX_TofMultiBusAddSensor(&multibus, &sensor, &devs[2], VL53LX_TOF_MULTIBUS_AUTO) == 2);
+    // A third sensor at 0x30 fits on neither bus
+    CHECK(!VL53LX_TofMultiBusAssign(&multibus));
+    CHECK(multibus.sensors[0].bus != multibus.sensors[1].bus);
+    CHECK(multibus.sensors[2].bus == -1);
+
+    printf("sizeof: vl53lx_tof_multibus_t %zu, VL53LX_Dev_t %zu\n", sizeof(vl53lx_tof_multibus_t),
+           sizeof(VL53LX_Dev_t));
+    CHECK(sizeof(vl53lx_tof_multibus_t) < sizeof(VL53LX_Dev_t));
+}
+
+int main(void)
+{
+    test_addresses();
+    test_throughput();
+    test_balance();
+    return host_test_result();
+}
@@ -0,0 +1,258 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_tracker.c
+ * @brief VL53LX_TrackerUpdate() on a synthetic crossing-target scene
+ *
+ * A static target and a target sweeping back and forth through it, with
+ * range noise, 10% dropouts per target, random clutter and returns with
+ * an invalid status. The tracks must keep their IDs through every
+ * crossing, never be lost, and follow range and velocity closely.
+ * Also reports the update time per frame.
+ */
+
+#include "vl53lx_target_tracker.h"
+#include "host_test.h"
+#include <math.h>
+#include <string.h>
+
+#define FRAMES          3000
+#define FRAME_MS        30
+#define WARMUP          10
+#define STATIC_MM       1500.0f
+#define SWEEP_MIN_MM    400.0f
+#define SWEEP_MAX_MM    2600.0f
+#define SWEEP_MM_S      600.0f
+#define NOISE_MM        5.0f
+
+static uint32_t rng = 12345;
+
+static float uniform(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (float)(rng >> 8) / 16777216.0f;
+}
+
+static float gaussian(void)
+{
+    float u = uniform() + 1e-7f;
+    float v = uniform();
+    return sqrtf(-2.0f * logf(u)) * cosf(6.2831853f * v);
+}
+
+typedef struct {
+    float range_mm;
+    float velocity_mm_s;
+    float signal_mcps;
+} truth_t;
+
+static void sweep(uint32_t k, truth_t *t)
+{
+    float span = SWEEP_MAX_MM - SWEEP_MIN_MM;
+    float travel = fmodf((float)k * FRAME_MS * SWEEP_MM_S / 1000.0f, 2.0f * span);
+    if (travel < span) {
+        t->range_mm = SWEEP_MAX_MM - travel;
+        t->velocity_mm_s = -SWEEP_MM_S;
+    } else {
+        t->range_mm = SWEEP_MIN_MM + (travel - span);
+        t->velocity_mm_s = SWEEP_MM_S;
+    }
+    t->signal_mcps = 6.0f;
+}
+
+static void add_target(VL53LX_MultiRangingData_t *data, float range_mm, float signal_mcps, uint8_t status)
+{
+    VL53LX_TargetRangeData_t *t = &data->RangeData[data->NumberOfObjectsFound++];
+    memset(t, 0, sizeof(*t));
+    t->RangeMilliMeter = (int16_t)lroundf(range_mm);
+    t->SignalRateRtnMegaCps = (FixPoint1616_t)(signal_mcps * 65536.0f);
+    t->RangeStatus = status;
+}
+
+// Device order: nearest first
+static void sort_targets(VL53LX_MultiRangingData_t *data)
+{
+    for (uint8_t i = 1; i < data->NumberOfObjectsFound; i++) {
+        for (uint8_t j = i; j > 0 && data->RangeData[j].RangeMilliMeter < data->RangeData[j - 1].RangeMilliMeter; j--) {
+            VL53LX_TargetRangeData_t tmp = data->RangeData[j];
+            data->RangeData[j] = data->RangeData[j - 1];
+            data->RangeData[j - 1] = tmp;
+        }
+    }
+}
+
+static const vl53lx_track_t *find_track(const vl53lx_track_t *tracks, uint8_t count, uint16_t id)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (tracks[i].id == id) {
+            return &tracks[i];
+        }
+    }
+    return NULL;
+}
+
+static void test_crossing_scene(void)
+{
+    static VL53LX_MultiRangingData_t frames[FRAMES];
+    static truth_t truth[FRAMES][2];
+
+    for (uint32_t k = 0; k < FRAMES; k++) {
+        VL53LX_MultiRangingData_t *data = &frames[k];
+        memset(data, 0, sizeof(*data));
+        data->StreamCount = (uint8_t)k;
+
+        truth[k][0] = (truth_t){ STATIC_MM, 0.0f, 1.5f };
+        sweep(k, &truth[k][1]);
+        for (uint8_t i = 0; i < 2; i++) {
+            if (uniform() >= 0.1f) {
+                add_target(data, truth[k][i].range_mm + NOISE_MM * gaussian(), truth[k][i].signal_mcps,
+                           VL53LX_RANGESTATUS_RANGE_VALID);
+            }
+        }
+        if (uniform() < 0.05f) {
+            add_target(data, 200.0f + 3000.0f * uniform(), 0.5f + 4.0f * uniform(), VL53LX_RANGESTATUS_RANGE_VALID);
+        }
+        if (uniform() < 0.1f && data->NumberOfObjectsFound < VL53LX_MAX_RANGE_RESULTS) {
+            add_target(data, 3000.0f * uniform(), 20.0f * uniform(), VL53LX_RANGESTATUS_SIGMA_FAIL);
+        }
+        sort_targets(data);
+    }
+
+    vl53lx_tracker_t tracker;
+    CHECK(VL53LX_TrackerInit(&tracker));
+
+    uint16_t id[2] = { 0, 0 };
+    uint32_t lost = 0;
+    uint32_t switches = 0;
+    uint32_t misassociations = 0;
+    uint32_t wrong[2] = { 0, 0 };
+    uint32_t samples = 0;
+    uint32_t velocity_samples = 0;
+    double range_error = 0.0;
+    double velocity_error = 0.0;
+    float max_error = 0.0f;
+    uint64_t elapsed_ns = 0;
+
+    for (uint32_t k = 0; k < FRAMES; k++) {
+        uint64_t t0 = host_time_ns();
+        VL53LX_TrackerUpdate(&tracker, &frames[k], k * FRAME_MS);
+        elapsed_ns += host_time_ns() - t0;
+
+        vl53lx_track_t tracks[VL53LX_TRACKER_MAX_TRACKS];
+        uint8_t count = VL53LX_TrackerGetTracks(&tracker, tracks, VL53LX_TRACKER_MAX_TRACKS);
+
+        if (k == WARMUP) {
+            // Bind each truth to the confirmed track nearest to it
+            for (uint8_t i = 0; i < 2; i++) {
+                float best = 1e9f;
+                for (uint8_t j = 0; j < count; j++) {
+                    float d = fabsf(tracks[j].range_mm - truth[k][i].range_mm);
+                    if (d < best) {
+                        best = d;
+                        id[i] = tracks[j].id;
+                    }
+                }
+            }
+            CHECK(id[0] != 0 && id[1] != 0 && id[0] != id[1]);
+        }
+        if (k < WARMUP) {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < 2; i++) {
+            const vl53lx_track_t *track = find_track(tracks, count, id[i]);
+            if (track == NULL) {
+                lost++;
+                continue;
+            }
+            // A switch: the track follows the other target for several frames
+            // once they are apart; a single frame is a mis-association
+            float error = track->range_mm - truth[k][i].range_mm;
+            float other = track->range_mm - truth[k][1 - i].range_mm;
+            float separation = fabsf(truth[k][0].range_mm - truth[k][1].range_mm);
+            if (separation > 200.0f && fabsf(other) < fabsf(error)) {
+                wrong[i]++;
+                misassociations += wrong[i] == 1;
+                switches += wrong[i] == 3;
+            } else {
+                wrong[i] = 0;
+            }
+            if (fabsf(error) > max_error) {
+                max_error = fabsf(error);
+            }
+            range_error += fabs(error);
+            samples++;
+
+            // Skip the frames right after a turn of the sweep
+            bool turning = false;
+            for (uint32_t b = 1; b <= 10 && b <= k; b++) {
+                turning |= truth[k - b][i].velocity_mm_s != truth[k][i].velocity_mm_s;
+            }
+            if (!turning) {
+                velocity_error += fabs(track->velocity_mm_s - truth[k][i].velocity_mm_s);
+                velocity_samples++;
+            }
+        }
+    }
+
+    double mean_range = samples > 0 ? range_error / samples : 0.0;
+    double mean_velocity = velocity_samples > 0 ? velocity_error / velocity_samples : 0.0;
+    printf("crossing scene, %u frames: range error %.1f mm (max %.0f), velocity error %.1f mm/s, "
+           "%u lost, %u ID switches, %u single-frame mis-associations, %.0f ns/frame\n",
+           FRAMES, mean_range, (double)max_error, mean_velocity, lost, switches, misassociations,
+           (double)elapsed_ns / FRAMES);
+
+    CHECK(lost == 0);
+    CHECK(switches == 0);
+    CHECK(mean_range < 10.0);
+    CHECK(max_error < 200.0f);
+    CHECK(mean_velocity < 100.0);
+}
+
+// Tentative tracks die on their first miss, confirmed ones after max_misses
+static void test_birth_and_death(void)
+{
+    vl53lx_tracker_t tracker;
+    CHECK(VL53LX_TrackerInit(&tracker));
+    uint8_t confirm_hits = tracker.config.confirm_hits;
+    uint8_t max_misses = tracker.config.max_misses;
+
+    VL53LX_MultiRangingData_t empty;
+    VL53LX_MultiRangingData_t one;
+    memset(&empty, 0, sizeof(empty));
+    memset(&one, 0, sizeof(one));
+    add_target(&one, 800.0f, 2.0f, VL53LX_RANGESTATUS_RANGE_VALID);
+
+    uint32_t t = 0;
+    CHECK(VL53LX_TrackerUpdate(&tracker, &one, t += FRAME_MS) == 0);
+    CHECK(VL53LX_TrackerUpdate(&tracker, &empty, t += FRAME_MS) == 0);
+    CHECK(tracker.tracks[0].state == VL53LX_TRACK_FREE);
+
+    for (uint8_t i = 1; i < confirm_hits; i++) {
+        CHECK(VL53LX_TrackerUpdate(&tracker, &one, t += FRAME_MS) == 0);
+    }
+    CHECK(VL53LX_TrackerUpdate(&tracker, &one, t += FRAME_MS) == 1);
+
+    for (uint8_t i = 1; i < max_misses; i++) {
+        CHECK(VL53LX_TrackerUpdate(&tracker, &empty, t += FRAME_MS) == 1);
+    }
+    CHECK(VL53LX_TrackerUpdate(&tracker, &empty, t += FRAME_MS) == 0);
+
+    // Invalid statuses are not detections
+    VL53LX_MultiRangingData_t invalid;
+    memset(&invalid, 0, sizeof(invalid));
+    add_target(&invalid, 800.0f, 2.0f, VL53LX_RANGESTATUS_SIGMA_FAIL);
+    for (uint8_t i = 0; i <= confirm_hits; i++) {
+        CHECK(VL53LX_TrackerUpdate(&tracker, &invalid, t += FRAME_MS) == 0);
+    }
+}
+
+int main(void)
+{
+    test_crossing_scene();
+    test_birth_and_death();
+    return host_test_result();
+}
@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_tuning.c
+ * @brief Bare driver tuning settings (BDTable) per device
+ *
+ * - VL53LX_SetTuningParameter() and VL53LX_LoadTuningProfile() change one
+ *   device only, also across a DataInit of the other device
+ * - NULL restores the default profile
+ * - DataInit loads the default profile: a value set before it is dropped
+ * - LL tuning parameter table: profile round trip and ns per lookup
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_preset_setup.h"
+#include "sim_device.h"
+#include "host_test.h"
+
+static VL53LX_Dev_t front;
+static VL53LX_Dev_t bottom;
+
+static int32_t tuning(VL53LX_Dev_t *dev, uint16_t id)
+{
+    int32_t value = 0;
+    CHECK(VL53LX_GetTuningParameter(dev, id, &value) == VL53LX_ERROR_NONE);
+    return value;
+}
+
+static void init(VL53LX_Dev_t *dev, uint32_t seed)
+{
+    sim_single_device(dev, seed);
+    CHECK(VL53LX_WaitDeviceBooted(dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(dev) == VL53LX_ERROR_NONE);
+}
+
+static void test_per_device(void)
+{
+    static const int32_t bottom_profile[VL53LX_TUNING_MAX_TUNABLE_KEY] = {
+        TUNING_VERSION,
+        -10,
+        TUNING_SINGLE_TARGET_XTALK_TARGET_DISTANCE_MM,
+        TUNING_SINGLE_TARGET_XTALK_SAMPLE_NUMBER,
+        TUNING_MIN_AMBIENT_DMAX_VALID,
+        30,
+        TUNING_XTALK_FULL_ROI_TARGET_DISTANCE_MM,
+        TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT,
+        TUNING_XTALK_FULL_ROI_BIN_SUM_MARGIN,
+        TUNING_XTALK_FULL_ROI_DEFAULT_OFFSET,
+        TUNING_ZERO_DISTANCE_OFFSET_NON_LINEAR_FACTOR_DEFAULT,
+    };
+
+    init(&front, 1);
+    init(&bottom, 2);
+    CHECK(VL53LX_SetTuningParameter(&front, VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT, 5) ==
+          VL53LX_ERROR_NONE);
+    CHECK(VL53LX_LoadTuningProfile(&bottom, bottom_profile) == VL53LX_ERROR_NONE);
+
+    CHECK(tuning(&front, VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT) == 5);
+    CHECK(tuning(&front, VL53LX_TUNING_PROXY_MIN) == TUNING_PROXY_MIN);
+    CHECK(tuning(&front, VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER) ==
+          TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER);
+    CHECK(tuning(&bottom, VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT) ==
+          TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT);
+    CHECK(tuning(&bottom, VL53LX_TUNING_PROXY_MIN) == -10);
+    CHECK(tuning(&bottom, VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER) == 30);
+
+    // A DataInit of one device leaves the other alone
+    init(&front, 1);
+    CHECK(tuning(&front, VL53LX_TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT) ==
+          TUNING_SIMPLE_OFFSET_CALIBRATION_REPEAT);
+    CHECK(tuning(&bottom, VL53LX_TUNING_PROXY_MIN) == -10);
+    CHECK(tuning(&bottom, VL53LX_TUNING_MAX_SIMPLE_OFFSET_CALIBRATION_SAMPLE_NUMBER) == 30);
+
+    CHECK(VL53LX_LoadTuningProfile(&bottom, NULL) == VL53LX_ERROR_NONE);
+    CHECK(tuning(&bottom, VL53LX_TUNING_PROXY_MIN) == TUNING_PROXY_MIN);
+
+    CHECK(VL53LX_SetTuningParameter(&front, VL53LX_TUNING_MAX_TUNABLE_KEY, 1) == VL53LX_ERROR_INVALID_PARAMS);
+}
+
+static void test_set_before_data_init(void)
+{
+    static VL53LX_Dev_t dev;
+    sim_single_device(&dev, 3);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_SetTuningParameter(&dev, VL53LX_TUNING_PROXY_MIN, -10) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    CHECK(tuning(&dev, VL53LX_TUNING_PROXY_MIN) == TUNING_PROXY_MIN);
+}
+
+#define TABLE_KEYS \
+    (VL53LX_TUNINGPARMS_LLD_PUBLIC_MAX_ADDRESS - VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS + 1)
+#define BENCH_CALLS 1000000
+
+// The keys the ranging loop reads each frame
+static const VL53LX_TuningParms frame_keys[] = {
+    VL53LX_TUNINGPARM_HIST_MERGE,
+    VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE,
+    VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD,
+    VL53LX_TUNINGPARM_HIST_SIGMA_THRESH_MM,
+};
+#define FRAME_KEYS (sizeof(frame_keys) / sizeof(frame_keys[0]))
+
+static void test_table_speed(void)
+{
+    static int32_t values[TABLE_KEYS];
+    static int32_t again[TABLE_KEYS];
+    init(&front, 1);
+
+    // Every key of the public page reads back what was written
+    CHECK(VL53LX_get_tuning_parm_profile(&front, NULL, values, TABLE_KEYS) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_tuning_parm_profile(&front, NULL, values, TABLE_KEYS) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_get_tuning_parm_profile(&front, NULL, again, TABLE_KEYS) == VL53LX_ERROR_NONE);
+    for (uint16_t i = 0; i < TABLE_KEYS; i++) {
+        CHECK_MSG(values[i] == again[i], "key 0x%04X", VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS + i);
+    }
+
+    int32_t value = 0;
+    int64_t sum = 0;
+    uint64_t t0 = host_time_ns();
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        CHECK(VL53LX_get_tuning_parm(&front, frame_keys[n % FRAME_KEYS], &value) == VL53LX_ERROR_NONE);
+        sum += value;
+    }
+    double get_ns = (double)(host_time_ns() - t0) / BENCH_CALLS;
+
+    t0 = host_time_ns();
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        VL53LX_TuningParms key = frame_keys[n % FRAME_KEYS];
+        CHECK(VL53LX_set_tuning_parm(&front, key, values[key - VL53LX_TUNINGPARMS_LLD_PUBLIC_MIN_ADDRESS]) ==
+              VL53LX_ERROR_NONE);
+    }
+    double set_ns = (double)(host_time_ns() - t0) / BENCH_CALLS;
+
+    t0 = host_time_ns();
+    for (uint32_t n = 0; n < BENCH_CALLS / TABLE_KEYS; n++) {
+        CHECK(VL53LX_get_tuning_parm_profile(&front, NULL, again, TABLE_KEYS) == VL53LX_ERROR_NONE);
+    }
+    double profile_ns = (double)(host_time_ns() - t0) / (BENCH_CALLS / TABLE_KEYS);
+
+    printf("ns per call: get %.1f, set %.1f; %u-key profile get %.0f (sum %lld)\n", get_ns, set_ns,
+           (unsigned)TABLE_KEYS, profile_ns, (long long)sum);
+}
+
+int main(void)
+{
+    test_per_device();
+    test_set_before_data_init();
+    test_table_speed();
+    return host_test_result();
+}
@@ -0,0 +1,291 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_uwr.c
+ * @brief Table-driven wrap resolution (vl53lx_uwr.c)
+ *
+ * - The tuning derived medium and long tables give the same offsets as the
+ *   if/else chain SetTargetData() used before, on a stream that wraps from
+ *   255 to 128, also after the zones are tuned to overlap mid-stream
+ * - Custom short range table from VL53LX_set_uwr_zones(), NULL restores
+ *   the (empty) tuning table
+ * - Four timing sequences stay in step across the stream count wrap
+ * - VL53LX_set_uwr_confirmation(): confirmation count per target, and
+ *   hysteresis at the zone edges
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_uwr.h"
+#include "sim_device.h"
+#include "host_test.h"
+
+#define STREAM_FRAMES   20000
+
+static VL53LX_Dev_t dev;
+
+static VL53LX_LLDriverData_t *init(void)
+{
+    sim_single_device(&dev, 1);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+    return &dev.Data.LLData;
+}
+
+// Stream counts as the device reports them: 0..255, then 128..255
+static uint8_t next_stream_count(uint8_t count)
+{
+    return (count == 255) ? 128 : (uint8_t)(count + 1);
+}
+
+// The SetTargetData() chain before the zone tables
+static uint8_t chain(const VL53LX_tuning_parm_storage_t *tp, VL53LX_DevicePresetModes preset_mode,
+                     uint8_t stream_count, int16_t diff, int16_t *offset)
+{
+    uint8_t seq = stream_count % 2;
+
+    if (preset_mode == VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE) {
+        if (diff > tp->tp_uwr_med_z_1_min && diff < tp->tp_uwr_med_z_1_max && seq == 1) {
+            *offset = tp->tp_uwr_med_corr_z_1_rangeb;
+        } else if (diff < -tp->tp_uwr_med_z_1_min && diff > -tp->tp_uwr_med_z_1_max && seq == 0) {
+            *offset = tp->tp_uwr_med_corr_z_1_rangea;
+        } else if (diff > tp->tp_uwr_med_z_2_min && diff < tp->tp_uwr_med_z_2_max && seq == 0) {
+            *offset = tp->tp_uwr_med_corr_z_2_rangea;
+        } else if (diff < -tp->tp_uwr_med_z_2_min && diff > -tp->tp_uwr_med_z_2_max && seq == 1) {
+            *offset = tp->tp_uwr_med_corr_z_2_rangeb;
+        } else if (diff > tp->tp_uwr_med_z_3_min && diff < tp->tp_uwr_med_z_3_max && seq == 1) {
+            *offset = tp->tp_uwr_med_corr_z_3_rangeb;
+        } else if (diff < -tp->tp_uwr_med_z_3_min && diff > -tp->tp_uwr_med_z_3_max && seq == 0) {
+            *offset = tp->tp_uwr_med_corr_z_3_rangea;
+        } else if (diff > tp->tp_uwr_med_z_4_min && diff < tp->tp_uwr_med_z_4_max && seq == 0) {
+            *offset = tp->tp_uwr_med_corr_z_4_rangea;
+        } else if (diff < -tp->tp_uwr_med_z_4_min && diff > -tp->tp_uwr_med_z_4_max && seq == 1) {
+            *offset = tp->tp_uwr_med_corr_z_4_rangeb;
+        } else if (diff < tp->tp_uwr_med_z_5_max && diff > tp->tp_uwr_med_z_5_min) {
+            *offset = tp->tp_uwr_med_corr_z_5_rangea;
+        } else {
+            return 0;
+        }
+        return 1;
+    }
+
+    if (preset_mode == VL53LX_DEVICEPRESETMODE_HISTOGRAM_LONG_RANGE) {
+        if (diff > tp->tp_uwr_lng_z_1_min && diff < tp->tp_uwr_lng_z_1_max && seq == 0) {
+            *offset = tp->tp_uwr_lng_corr_z_1_rangea;
+        } else if (diff < -tp->tp_uwr_lng_z_1_min && diff > -tp->tp_uwr_lng_z_1_max && seq == 1) {
+            *offset = tp->tp_uwr_lng_corr_z_1_rangeb;
+        } else if (diff > tp->tp_uwr_lng_z_2_min && diff < tp->tp_uwr_lng_z_2_max && seq == 1) {
+            *offset = tp->tp_uwr_lng_corr_z_2_rangeb;
+        } else if (diff < -tp->tp_uwr_lng_z_2_min && diff > -tp->tp_uwr_lng_z_2_max && seq == 0) {
+            *offset = tp->tp_uwr_lng_corr_z_2_rangea;
+        } else if (diff < tp->tp_uwr_lng_z_3_max && diff > tp->tp_uwr_lng_z_3_min) {
+            *offset = tp->tp_uwr_lng_corr_z_3_rangea;
+        } else {
+            return 0;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint8_t resolve(VL53LX_LLDriverData_t *pdev, VL53LX_DevicePresetModes preset_mode, uint8_t stream_count,
+                       uint8_t target, int16_t diff, uint8_t previous_extended, int16_t *offset)
+{
+    return VL53LX_uwr_resolve(&pdev->uwr, &pdev->tuning_parms, preset_mode, stream_count, target, diff,
+                              previous_extended, offset);
+}
+
+// Range differences: random, plus every zone edge of the tuning table
+static int16_t stream_diff(const VL53LX_tuning_parm_storage_t *tp, uint32_t frame, uint32_t *rng)
+{
+    const int16_t edges[] = {
+        tp->tp_uwr_med_z_1_min, tp->tp_uwr_med_z_1_max, tp->tp_uwr_med_z_2_min, tp->tp_uwr_med_z_2_max,
+        tp->tp_uwr_med_z_3_min, tp->tp_uwr_med_z_3_max, tp->tp_uwr_med_z_4_min, tp->tp_uwr_med_z_4_max,
+        tp->tp_uwr_med_z_5_min, tp->tp_uwr_med_z_5_max, tp->tp_uwr_lng_z_1_min, tp->tp_uwr_lng_z_1_max,
+        tp->tp_uwr_lng_z_2_min, tp->tp_uwr_lng_z_2_max, tp->tp_uwr_lng_z_3_min, tp->tp_uwr_lng_z_3_max,
+    };
+    *rng = *rng * 1664525u + 1013904223u;
+    if (frame % 4 == 0) {
+        int16_t edge = edges[(*rng >> 8) % (sizeof(edges) / sizeof(edges[0]))];
+        int16_t step = (int16_t)((*rng >> 16) % 3) - 1;
+        return (*rng & 0x80000000u) ? (int16_t)(-edge + step) : (int16_t)(edge + step);
+    }
+    return (int16_t)((int32_t)((*rng >> 8) % 10001) - 5000);
+}
+
+static void test_default_tables_match_chain(void)
+{
+    static const VL53LX_DevicePresetModes modes[] = {
+        VL53LX_DEVICEPRESETMODE_HISTOGRAM_SHORT_RANGE,
+        VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE,
+        VL53LX_DEVICEPRESETMODE_HISTOGRAM_LONG_RANGE,
+    };
+    VL53LX_LLDriverData_t *pdev = init();
+    const VL53LX_tuning_parm_storage_t *tp = &pdev->tuning_parms;
+    uint32_t rng = 1;
+    uint32_t extended = 0;
+    uint32_t mismatches = 0;
+    uint8_t stream_count = 0;
+
+    for (uint32_t frame = 0; frame < STREAM_FRAMES; frame++) {
+        if (frame == STREAM_FRAMES / 2) {
+            // Overlapping zones in one sequence: the earlier rule must still win
+            CHECK(VL53LX_set_tuning_parm(&dev, VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_3_MAX,
+                                         tp->tp_uwr_med_z_1_min + 500) == VL53LX_ERROR_NONE);
+            CHECK(VL53LX_set_tuning_parm(&dev, VL53LX_TUNINGPARM_UWR_LONG_ZONE_3_MAX,
+                                         tp->tp_uwr_lng_z_1_min + 500) == VL53LX_ERROR_NONE);
+        }
+        int16_t diff = stream_diff(tp, frame, &rng);
+        for (uint8_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            int16_t want = 0;
+            int16_t got = 0;
+            uint8_t want_hit = chain(tp, modes[m], stream_count, diff, &want);
+            uint8_t hit = resolve(pdev, modes[m], stream_count, 0, diff, 0, &got);
+            if (hit != want_hit || (hit && got != want)) {
+                mismatches++;
+            }
+            extended += hit;
+        }
+        stream_count = next_stream_count(stream_count);
+    }
+
+    printf("default tables: %u frames, %u extended, %u mismatches\n", STREAM_FRAMES, extended, mismatches);
+    CHECK(mismatches == 0);
+    CHECK(extended > STREAM_FRAMES / 10);
+}
+
+static void test_short_range_table(void)
+{
+    static const VL53LX_uwr_rule_t short_rules[] = {
+        { -1400, -900, 1400, 0 },
+        { 900, 1400, 1400, 1 },
+    };
+    const VL53LX_DevicePresetModes mode = VL53LX_DEVICEPRESETMODE_HISTOGRAM_SHORT_RANGE;
+    VL53LX_LLDriverData_t *pdev = init();
+    int16_t offset = 0;
+
+    CHECK(resolve(pdev, mode, 1, 0, 1000, 0, &offset) == 0);
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, short_rules, 2, 2) == VL53LX_ERROR_NONE);
+
+    CHECK(resolve(pdev, mode, 1, 0, 1000, 0, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 0, 0, 1000, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 0, 0, -1000, 0, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 1, 0, -1000, 0, &offset) == 0);
+    // Rule windows exclude their bounds
+    CHECK(resolve(pdev, mode, 1, 0, 900, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 1, 0, 901, 0, &offset) == 1);
+    CHECK(resolve(pdev, mode, 1, 0, 1399, 0, &offset) == 1);
+    CHECK(resolve(pdev, mode, 1, 0, 1400, 0, &offset) == 0);
+
+    // A custom table survives a tuning change; the medium table follows it
+    CHECK(VL53LX_set_tuning_parm(&dev, VL53LX_TUNINGPARM_UWR_MEDIUM_ZONE_1_MIN, 10) == VL53LX_ERROR_NONE);
+    CHECK(resolve(pdev, mode, 1, 0, 1000, 0, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE, 1, 0, 11, 0, &offset) == 1);
+    CHECK(offset == pdev->tuning_parms.tp_uwr_med_corr_z_1_rangeb);
+
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, NULL, 0, 0) == VL53LX_ERROR_NONE);
+    CHECK(resolve(pdev, mode, 1, 0, 1000, 0, &offset) == 0);
+
+    CHECK(VL53LX_set_uwr_zones(&dev, VL53LX_DEVICEPRESETMODE_NONE, short_rules, 2, 2) ==
+          VL53LX_ERROR_INVALID_PARAMS);
+}
+
+static void test_four_sequences(void)
+{
+    static const VL53LX_uwr_rule_t rules[] = {
+        { 500, 1500, 1000, 0 },
+        { 500, 1500, 1100, 1 },
+        { 500, 1500, 1200, 2 },
+        { 500, 1500, 1300, 3 },
+        { -1500, -500, 900, VL53LX_UWR_SEQUENCE_ANY },
+    };
+    const VL53LX_DevicePresetModes mode = VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE;
+    VL53LX_LLDriverData_t *pdev = init();
+    int16_t offset = 0;
+    uint8_t stream_count = 0;
+
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, rules, 5, 3) == VL53LX_ERROR_INVALID_PARAMS);
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, rules, 5, 4) == VL53LX_ERROR_NONE);
+
+    // Three laps, two of them across the 255 -> 128 wrap
+    for (uint32_t frame = 0; frame < 256 + 2 * 128; frame++) {
+        CHECK(resolve(pdev, mode, stream_count, 0, 1000, 0, &offset) == 1);
+        CHECK_MSG(offset == 1000 + 100 * (stream_count % 4), "stream count %u", stream_count);
+        CHECK(resolve(pdev, mode, stream_count, 0, -1000, 0, &offset) == 1 && offset == 900);
+        stream_count = next_stream_count(stream_count);
+    }
+}
+
+static void test_confirmation(void)
+{
+    const VL53LX_DevicePresetModes mode = VL53LX_DEVICEPRESETMODE_HISTOGRAM_MEDIUM_RANGE;
+    VL53LX_LLDriverData_t *pdev = init();
+    int16_t hit = (int16_t)(pdev->tuning_parms.tp_uwr_med_z_5_min + 1);
+    int16_t miss = (int16_t)(pdev->tuning_parms.tp_uwr_med_z_5_min);
+    int16_t offset = 0;
+
+    CHECK(VL53LX_set_uwr_confirmation(&dev, 0, 0) == VL53LX_ERROR_INVALID_PARAMS);
+    CHECK(VL53LX_set_uwr_confirmation(&dev, 1, -1) == VL53LX_ERROR_INVALID_PARAMS);
+    CHECK(VL53LX_set_uwr_confirmation(&dev, 3, 0) == VL53LX_ERROR_NONE);
+
+    CHECK(resolve(pdev, mode, 0, 0, hit, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 1, 0, hit, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 0, 1, hit, 0, &offset) == 0);         // Target 1 counts on its own
+    CHECK(resolve(pdev, mode, 0, 0, hit, 0, &offset) == 1);
+    CHECK(offset == pdev->tuning_parms.tp_uwr_med_corr_z_5_rangea);
+    CHECK(resolve(pdev, mode, 1, 0, hit, 0, &offset) == 1);
+
+    // A miss starts the count again
+    CHECK(resolve(pdev, mode, 0, 0, miss, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 1, 0, hit, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 0, 0, hit, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 1, 0, hit, 0, &offset) == 1);
+
+    // So does a new table
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, NULL, 0, 0) == VL53LX_ERROR_NONE);
+    CHECK(resolve(pdev, mode, 0, 0, hit, 0, &offset) == 0);
+}
+
+static void test_hysteresis(void)
+{
+    static const VL53LX_uwr_rule_t rules[] = {
+        { 900, 1400, 1400, VL53LX_UWR_SEQUENCE_ANY },
+        { 1500, 2000, 2000, VL53LX_UWR_SEQUENCE_ANY },
+    };
+    const VL53LX_DevicePresetModes mode = VL53LX_DEVICEPRESETMODE_HISTOGRAM_SHORT_RANGE;
+    VL53LX_LLDriverData_t *pdev = init();
+    int16_t offset = 0;
+
+    CHECK(VL53LX_set_uwr_zones(&dev, mode, rules, 2, 1) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_set_uwr_confirmation(&dev, 1, 20) == VL53LX_ERROR_NONE);
+
+    // Zones 901..1399 and 1501..1999; the margin only applies while extended
+    CHECK(resolve(pdev, mode, 0, 0, 890, 0, &offset) == 0);
+    CHECK(resolve(pdev, mode, 0, 0, 890, 1, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 0, 0, 881, 1, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 0, 0, 880, 1, &offset) == 0);
+    CHECK(resolve(pdev, mode, 0, 0, 2019, 1, &offset) == 1 && offset == 2000);
+    CHECK(resolve(pdev, mode, 0, 0, 2020, 1, &offset) == 0);
+
+    // Between two zones the nearer one wins, a tie goes to the lower zone
+    CHECK(resolve(pdev, mode, 0, 0, 1410, 1, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 0, 0, 1490, 1, &offset) == 1 && offset == 2000);
+    CHECK(resolve(pdev, mode, 0, 0, 1450, 1, &offset) == 0);
+    CHECK(VL53LX_set_uwr_confirmation(&dev, 1, 60) == VL53LX_ERROR_NONE);
+    CHECK(resolve(pdev, mode, 0, 0, 1450, 1, &offset) == 1 && offset == 1400);
+    CHECK(resolve(pdev, mode, 0, 0, 1450, 0, &offset) == 0);
+}
+
+int main(void)
+{
+    test_default_tables_match_chain();
+    test_short_range_table();
+    test_four_sequences();
+    test_confirmation();
+    test_hysteresis();
+    return host_test_result();
+}
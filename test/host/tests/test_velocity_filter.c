@@ -0,0 +1,374 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_velocity_filter.c
+ * @brief VL53LX_VelocityFilter against the 1D filter on synthetic flights
+ *
+ * Hover at 500 mm, ramp up 1.5 m, hover, step -400 mm, hover, ramp down
+ * 1.1 m; 3 mm noise and +-1 ms sample jitter, 20 seeds.
+ * - The constant-velocity filter follows ramps without lag, also with 20%
+ *   invalid samples, at about the hover noise of 1D Q=16
+ * - Two gated outliers on the same side do not restart the filter, a
+ *   step does after the third sample; a sample inside the gate ends the run
+ * - Gaps longer than max_dt_us and older timestamps restart the filter,
+ *   also when the difference does not fit int32; a wrapping clock does not
+ * Prints the comparison tables and ns per update quoted in the API doc.
+ */
+
+#include "vl53lx_outlier_filter.h"
+#include "vl53lx_velocity_filter.h"
+#include "host_test.h"
+#include <math.h>
+
+#define SEEDS           20
+#define BENCH_UPDATES   10000000
+
+typedef enum {
+    FILTER_1D,
+    FILTER_VELOCITY,
+} filter_kind_t;
+
+typedef struct {
+    const char *name;
+    filter_kind_t kind;
+    float q;                            // 1D Q, or velocity process noise
+    float r;
+} flight_filter_t;
+
+typedef struct {
+    double hover_rms_mm;
+    double ramp_lag_ms;
+    double ramp_rms_mm;
+    double step_settle_ms;
+    double velocity_rms_mm_s;
+} flight_result_t;
+
+static uint32_t rng;
+
+static double uniform(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return ((rng >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static double gauss(void)
+{
+    double u = uniform() + 1e-12;
+    double v = uniform();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+// Flight phases for ramps at speed_mm_s
+static double speed_mm_s;
+static double ramp_up_start;
+static double ramp_up_end;
+static double step_at;
+static double ramp_down_start;
+static double ramp_down_end;
+static double flight_end;
+
+static void set_speed(double speed)
+{
+    speed_mm_s = speed;
+    ramp_up_start = 3.0;
+    ramp_up_end = ramp_up_start + 1500.0 / speed;
+    step_at = ramp_up_end + 3.0;
+    ramp_down_start = step_at + 3.0;
+    ramp_down_end = ramp_down_start + 1100.0 / speed;
+    flight_end = ramp_down_end + 2.0;
+}
+
+static double flight_truth(double t, double *velocity)
+{
+    *velocity = 0.0;
+    if (t < ramp_up_start) {
+        return 500.0;
+    }
+    if (t < ramp_up_end) {
+        *velocity = speed_mm_s;
+        return 500.0 + speed_mm_s * (t - ramp_up_start);
+    }
+    if (t < step_at) {
+        return 2000.0;
+    }
+    if (t < ramp_down_start) {
+        return 1600.0;
+    }
+    if (t < ramp_down_end) {
+        *velocity = -speed_mm_s;
+        return 1600.0 - speed_mm_s * (t - ramp_down_start);
+    }
+    return 500.0;
+}
+
+static flight_result_t fly(const flight_filter_t *f, double period_s, double invalid_rate, uint32_t seed)
+{
+    vl53lx_filter_t filter_1d;
+    vl53lx_velocity_filter_t filter_cv;
+    if (f->kind == FILTER_1D) {
+        vl53lx_filter_config_t config = VL53LX_FilterGetDefaultConfig();
+        config.kalman_process_noise = f->q;
+        config.kalman_measurement_noise = f->r;
+        CHECK(VL53LX_FilterInitWithConfig(&filter_1d, &config));
+    } else {
+        vl53lx_velocity_filter_config_t config = VL53LX_VelocityFilterGetDefaultConfig();
+        config.process_noise = f->q;
+        config.measurement_noise = f->r;
+        CHECK(VL53LX_VelocityFilterInitWithConfig(&filter_cv, &config));
+    }
+
+    double hover_square = 0.0;
+    double ramp_square = 0.0;
+    double ramp_lag = 0.0;
+    double velocity_square = 0.0;
+    uint32_t hover_n = 0;
+    uint32_t ramp_n = 0;
+    uint32_t velocity_n = 0;
+    double settle_s = -1.0;
+
+    rng = seed;
+    for (double t = 0.0; t < flight_end; t += period_s + (uniform() - 0.5) * 0.002) {
+        double truth_velocity;
+        double truth = flight_truth(t, &truth_velocity);
+        uint16_t distance = (uint16_t)lround(truth + 3.0 * gauss());
+        uint8_t status = uniform() < invalid_rate ? 4 : 0;
+        uint16_t output = 0;
+        float velocity = 0.0f;
+        bool valid = f->kind == FILTER_1D
+                         ? VL53LX_FilterUpdate(&filter_1d, distance, status, &output)
+                         : VL53LX_VelocityFilterUpdate(&filter_cv, distance, status, (uint32_t)(t * 1e6), &output,
+                                                       &velocity);
+        if (!valid) {
+            continue;
+        }
+
+        double error = output - truth;
+        // Hover: settled parts only
+        if ((t > 1.0 && t < ramp_up_start) || (t > ramp_up_end + 1.0 && t < step_at) ||
+            (t > step_at + 1.5 && t < ramp_down_start) || t > ramp_down_end + 1.0) {
+            hover_square += error * error;
+            hover_n++;
+        }
+        if ((t > ramp_up_start + 0.5 && t < ramp_up_end) || (t > ramp_down_start + 0.5 && t < ramp_down_end)) {
+            ramp_lag -= truth_velocity > 0.0 ? error : -error;
+            ramp_square += error * error;
+            ramp_n++;
+            if (f->kind == FILTER_VELOCITY) {
+                velocity_square += (velocity - truth_velocity) * (velocity - truth_velocity);
+                velocity_n++;
+            }
+        }
+        // 90% of the 400 mm step
+        if (t >= step_at && t < step_at + 1.5 && settle_s < 0.0 && error < 40.0) {
+            settle_s = t - step_at;
+        }
+    }
+
+    flight_result_t result = {
+        .hover_rms_mm = sqrt(hover_square / hover_n),
+        .ramp_lag_ms = ramp_lag / ramp_n / speed_mm_s * 1e3,
+        .ramp_rms_mm = sqrt(ramp_square / ramp_n),
+        .step_settle_ms = settle_s * 1e3,
+        .velocity_rms_mm_s = velocity_n > 0 ? sqrt(velocity_square / velocity_n) : 0.0,
+    };
+    return result;
+}
+
+static flight_result_t fly_seeds(const flight_filter_t *f, double period_s, double invalid_rate)
+{
+    flight_result_t mean = { 0 };
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        flight_result_t r = fly(f, period_s, invalid_rate, seed * 7919u);
+        mean.hover_rms_mm += r.hover_rms_mm / SEEDS;
+        mean.ramp_lag_ms += r.ramp_lag_ms / SEEDS;
+        mean.ramp_rms_mm += r.ramp_rms_mm / SEEDS;
+        mean.step_settle_ms += r.step_settle_ms / SEEDS;
+        mean.velocity_rms_mm_s += r.velocity_rms_mm_s / SEEDS;
+    }
+    return mean;
+}
+
+static void print_flight(const flight_filter_t *f, const flight_result_t *r)
+{
+    // No "-0 ms" for a lag that rounds to zero
+    double lag_ms = fabs(r->ramp_lag_ms) < 0.5 ? 0.0 : r->ramp_lag_ms;
+    printf("%-38s %5.1f mm %5.0f ms %6.1f mm %5.0f ms", f->name, r->hover_rms_mm, lag_ms, r->ramp_rms_mm,
+           r->step_settle_ms);
+    if (f->kind == FILTER_VELOCITY) {
+        printf(" %4.0f mm/s", r->velocity_rms_mm_s);
+    }
+    printf("\n");
+}
+
+static void test_flights(void)
+{
+    static const flight_filter_t filters[] = {
+        { "1D Q=1 R=4 (default)", FILTER_1D, 1.0f, 4.0f },
+        { "1D Q=16 R=4", FILTER_1D, 16.0f, 4.0f },
+        { "velocity q=(1000 mm/s^2)^2", FILTER_VELOCITY, 1.0e6f, 4.0f },
+        { "velocity q=(2000 mm/s^2)^2 (default)", FILTER_VELOCITY, 4.0e6f, 4.0f },
+    };
+    flight_result_t fast[4];
+    flight_result_t slow[4];
+
+    printf("33 ms samples, 1 m/s                      hover  ramp lag  ramp rms  step 90%%  velocity rms\n");
+    set_speed(1000.0);
+    for (int k = 0; k < 4; k++) {
+        fast[k] = fly_seeds(&filters[k], 0.033, 0.0);
+        print_flight(&filters[k], &fast[k]);
+    }
+    flight_result_t invalid_1d = fly_seeds(&filters[1], 0.033, 0.2);
+    flight_result_t invalid_cv = fly_seeds(&filters[3], 0.033, 0.2);
+    printf("20%% invalid: ramp rms 1D Q=16 %.1f mm, velocity %.1f mm\n", invalid_1d.ramp_rms_mm,
+           invalid_cv.ramp_rms_mm);
+
+    printf("100 ms samples, 2 m/s\n");
+    set_speed(2000.0);
+    for (int k = 0; k < 4; k++) {
+        if (k == 2) {
+            continue;
+        }
+        slow[k] = fly_seeds(&filters[k], 0.100, 0.0);
+        print_flight(&filters[k], &slow[k]);
+    }
+
+    // No lag on ramps, ramp error down to the noise
+    CHECK(fabs(fast[3].ramp_lag_ms) < 2.0 && fabs(slow[3].ramp_lag_ms) < 2.0);
+    CHECK(fast[3].ramp_rms_mm < fast[1].ramp_rms_mm / 2.0);
+    CHECK(slow[3].ramp_rms_mm < slow[1].ramp_rms_mm / 10.0);
+    CHECK(fast[3].hover_rms_mm < fast[1].hover_rms_mm * 1.2);
+    CHECK(invalid_cv.ramp_rms_mm < invalid_1d.ramp_rms_mm / 4.0);
+    // A step is taken within a few samples
+    CHECK(fast[3].step_settle_ms < 4 * 33.0 && slow[3].step_settle_ms < 4 * 100.0);
+}
+
+static vl53lx_velocity_filter_t hover_filter(uint32_t *t_us)
+{
+    vl53lx_velocity_filter_t filter;
+    uint16_t output = 0;
+    CHECK(VL53LX_VelocityFilterInit(&filter));
+    for (int i = 0; i < 30; i++) {
+        *t_us += 33000;
+        CHECK(VL53LX_VelocityFilterUpdate(&filter, (uint16_t)(1000 + (i % 3) - 1), 0, *t_us, &output, NULL));
+    }
+    return filter;
+}
+
+static void test_outlier_pair(void)
+{
+    uint32_t t_us = 0;
+    vl53lx_velocity_filter_t filter = hover_filter(&t_us);
+    uint16_t output = 0;
+    float velocity = 0.0f;
+
+    // Two multipath readings on the same side, then back to the hover
+    static const uint16_t readings[] = { 1300, 1250, 1000, 1001, 999 };
+    for (size_t i = 0; i < sizeof(readings) / sizeof(readings[0]); i++) {
+        t_us += 33000;
+        CHECK(VL53LX_VelocityFilterUpdate(&filter, readings[i], 0, t_us, &output, &velocity));
+        CHECK_MSG(fabsf(velocity) < 100.0f && output > 990 && output < 1010, "sample %zu: %u mm, %.0f mm/s", i,
+                  output, velocity);
+    }
+    CHECK(filter.rejected_count == 0);
+
+    // Three on one line: a step, taken at the third with no speed
+    static const uint16_t step[] = { 600, 601, 599 };
+    for (size_t i = 0; i < sizeof(step) / sizeof(step[0]); i++) {
+        t_us += 33000;
+        CHECK(VL53LX_VelocityFilterUpdate(&filter, step[i], 0, t_us, &output, &velocity));
+    }
+    printf("step to 600 mm: %u mm, %.0f mm/s after the third sample\n", output, velocity);
+    CHECK(output >= 595 && output <= 605);
+    CHECK(fabsf(velocity) < 100.0f);
+}
+
+static void test_outliers_apart(void)
+{
+    uint32_t t_us = 0;
+    vl53lx_velocity_filter_t filter = hover_filter(&t_us);
+    uint16_t output = 0;
+    float velocity = 0.0f;
+
+    // Two outliers, good samples, then one more at the same distance: the
+    // good samples end the run, so the third is an outlier on its own
+    static const uint16_t readings[] = { 1300, 1300, 1000, 1001, 999, 1000, 1001, 1300, 1000, 999 };
+    for (size_t i = 0; i < sizeof(readings) / sizeof(readings[0]); i++) {
+        t_us += 33000;
+        CHECK(VL53LX_VelocityFilterUpdate(&filter, readings[i], 0, t_us, &output, &velocity));
+        CHECK_MSG(fabsf(velocity) < 100.0f && output > 990 && output < 1010, "sample %zu: %u mm, %.0f mm/s", i,
+                  output, velocity);
+        if (readings[i] == 1000) {
+            CHECK(filter.rejected_count == 0 && filter.rejected_run == 0);
+        }
+    }
+}
+
+static void test_timestamps(void)
+{
+    uint16_t output = 0;
+    float velocity = 0.0f;
+
+    // A gap that does not fit int32: restart, not prediction from the old state
+    uint32_t t_us = 0;
+    vl53lx_velocity_filter_t filter = hover_filter(&t_us);
+    t_us += 0x90000000u;
+    CHECK(VL53LX_VelocityFilterUpdate(&filter, 700, 0, t_us, &output, &velocity));
+    CHECK(output == 700 && velocity == 0.0f && filter.last_timestamp_us == t_us);
+
+    // An older timestamp restarts as well
+    filter = hover_filter(&t_us);
+    CHECK(VL53LX_VelocityFilterUpdate(&filter, 700, 0, t_us - 1000, &output, &velocity));
+    CHECK(output == 700 && filter.last_timestamp_us == t_us - 1000);
+
+    // The same timestamp only corrects
+    filter = hover_filter(&t_us);
+    CHECK(VL53LX_VelocityFilterUpdate(&filter, 1001, 0, t_us, &output, &velocity));
+    CHECK(filter.last_timestamp_us == t_us && output >= 999 && output <= 1001);
+
+    // A clock wrapping through zero keeps the state
+    t_us = UINT32_MAX - 10u * 33000u;
+    filter = hover_filter(&t_us);
+    CHECK(t_us < 1000000);
+    CHECK(filter.p11 < VL53LX_VelocityFilterGetDefaultConfig().initial_velocity_noise / 10.0f);
+    CHECK(output >= 999 && output <= 1001);
+}
+
+static void test_speed(void)
+{
+    vl53lx_velocity_filter_t velocity_filter;
+    vl53lx_filter_t filter;
+    volatile uint32_t sink = 0;
+    uint16_t output = 0;
+    float velocity = 0.0f;
+    CHECK(VL53LX_VelocityFilterInit(&velocity_filter));
+    CHECK(VL53LX_FilterInit(&filter));
+
+    uint64_t start_ns = host_time_ns();
+    for (uint32_t i = 0; i < BENCH_UPDATES; i++) {
+        VL53LX_VelocityFilterUpdate(&velocity_filter, (uint16_t)(1000 + (i & 7)), i % 50 ? 0 : 4, i * 33000u,
+                                    &output, &velocity);
+        sink += output;
+    }
+    double velocity_ns = (double)(host_time_ns() - start_ns) / BENCH_UPDATES;
+
+    start_ns = host_time_ns();
+    for (uint32_t i = 0; i < BENCH_UPDATES; i++) {
+        VL53LX_FilterUpdate(&filter, (uint16_t)(1000 + (i & 7)), i % 50 ? 0 : 4, &output);
+        sink += output;
+    }
+    double filter_ns = (double)(host_time_ns() - start_ns) / BENCH_UPDATES;
+    printf("ns per update: velocity filter %.1f, 1D filter %.1f\n", velocity_ns, filter_ns);
+}
+
+int main(void)
+{
+    test_flights();
+    test_outlier_pair();
+    test_outliers_apart();
+    test_timestamps();
+    test_speed();
+    return host_test_result();
+}
@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file test_xtalk_stream.c
+ * @brief VL53LX_PerformXTalkStreamingCalibration() on the simulated device
+ *
+ * - Cover glass crosstalk without a target converges before the sample
+ *   limit, on A/B pairs only
+ * - Before the first pair of a pass there is no anchor: the reported
+ *   offset and shape deltas are 0
+ * - The extracted plane offset is the one of the full-length calibration
+ * - Accuracy against the injected crosstalk: the plane offset of each
+ *   pass (single histogram and merged) from the same scene without shot
+ *   noise over MAX_SAMPLES histograms, over ACCURACY_SEEDS noise seeds
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_calibration.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include "host_test.h"
+#include <string.h>
+
+#define XTALK_EVENTS        400.0f
+#define MAX_SAMPLES         60
+#define ACCURACY_SEEDS      6
+#define ACCURACY_SAMPLES    24          // min_samples of the accuracy runs
+#define ACCURACY_PCT        0.4         // Of the noise-free plane offset, per pass
+#define DEFAULT_PCT         1.0         // Same, default stop rule
+
+static VL53LX_Dev_t dev;
+static sim_scene_t scene;
+static int sim_index;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t first_deltas;              // Non-zero deltas reported before the first pair
+    uint32_t odd_converged;             // Convergence reported on a single histogram
+    uint8_t last_samples[2];
+    uint8_t converged[2];
+} progress_log_t;
+
+static void on_progress(void *ctx, const VL53LX_xtalk_stream_progress_t *p)
+{
+    progress_log_t *log = ctx;
+    log->calls++;
+    if (p->stable_count <= 1 && p->sample_count <= 2 &&
+        (p->plane_offset_delta_kcps != 0 || p->shape_delta != 0)) {
+        log->first_deltas++;
+    }
+    if (p->converged && (p->sample_count & 1) != 0) {
+        log->odd_converged++;
+    }
+    if (p->pass < 2) {
+        log->last_samples[p->pass] = p->sample_count;
+        log->converged[p->pass] |= p->converged;
+    }
+}
+
+static void setup(uint32_t seed, bool noise)
+{
+    sim_index = sim_single_device(&dev, seed);
+    CHECK(VL53LX_WaitDeviceBooted(&dev) == VL53LX_ERROR_NONE);
+    CHECK(VL53LX_DataInit(&dev) == VL53LX_ERROR_NONE);
+
+    vl53lx_hist_synth_config_t base = VL53LX_HistSynthGetDefaultConfig();
+    base.seed = seed;
+    base.xtalk_events = XTALK_EVENTS;
+    base.enable_noise = noise;
+    sim_scene_init(&scene, &dev, &base);
+    sim_scene_set_targets(&scene, NULL, 0);
+    sim_device_set_source(sim_index, sim_scene_frame, &scene);
+}
+
+static void test_converges(void)
+{
+    VL53LX_xtalk_stream_config_t cfg;
+    progress_log_t log;
+    memset(&log, 0, sizeof(log));
+    VL53LX_get_xtalk_stream_default_config(&cfg);
+    cfg.max_samples = MAX_SAMPLES;
+    cfg.progress_cb = on_progress;
+    cfg.progress_ctx = &log;
+
+    CHECK(VL53LX_PerformXTalkStreamingCalibration(&dev, &cfg) == VL53LX_ERROR_NONE);
+    uint32_t stream_kcps = dev.Data.LLData.xtalk_cal.algo__crosstalk_compensation_plane_offset_kcps;
+    printf("streaming: %u callbacks, pass samples %u/%u, plane offset %u kcps\n", log.calls,
+           log.last_samples[0], log.last_samples[1], stream_kcps);
+
+    CHECK(log.calls > 0);
+    CHECK(log.first_deltas == 0);
+    CHECK(log.odd_converged == 0);
+    CHECK(log.converged[0] && log.last_samples[0] < MAX_SAMPLES);
+    CHECK(log.converged[1] && log.last_samples[1] < MAX_SAMPLES);
+    CHECK(stream_kcps > 0);
+    CHECK(!sim_device_ranging(sim_index));
+
+    // Same scene, full length: the converged estimate is within the tolerance
+    CHECK(VL53LX_PerformXTalkCalibration(&dev) == VL53LX_ERROR_NONE);
+    uint32_t full_kcps = dev.Data.LLData.xtalk_cal.algo__crosstalk_compensation_plane_offset_kcps;
+    uint32_t diff = stream_kcps > full_kcps ? stream_kcps - full_kcps : full_kcps - stream_kcps;
+    printf("full length: plane offset %u kcps\n", full_kcps);
+    CHECK(diff <= full_kcps / 10 + cfg.plane_offset_tolerance_kcps);
+}
+
+// Plane offset of pass 0 (one histogram) and pass 1 (merged histograms)
+static void pass_offsets(uint32_t offsets[2])
+{
+    int32_t merge_size = 0;
+    CHECK(VL53LX_get_tuning_parm(&dev, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, &merge_size) == VL53LX_ERROR_NONE);
+    offsets[0] = dev.Data.LLData.xtalk_cal.algo__xtalk_cpo_HistoMerge_kcps[0];
+    offsets[1] = dev.Data.LLData.xtalk_cal.algo__xtalk_cpo_HistoMerge_kcps[merge_size - 1];
+}
+
+static double error_pct(uint32_t value, uint32_t reference)
+{
+    double e = 100.0 * ((double)value - (double)reference) / (double)reference;
+    return e < 0.0 ? -e : e;
+}
+
+// Worst error of both passes over the noise seeds; every pass must converge
+static double worst_error(const VL53LX_xtalk_stream_config_t *base, const uint32_t reference[2],
+                          uint32_t *histograms)
+{
+    double worst = 0.0;
+    *histograms = 0;
+    for (uint32_t seed = 1; seed <= ACCURACY_SEEDS; seed++) {
+        VL53LX_xtalk_stream_config_t cfg = *base;
+        progress_log_t log;
+        memset(&log, 0, sizeof(log));
+        cfg.progress_cb = on_progress;
+        cfg.progress_ctx = &log;
+        setup(seed, true);
+        CHECK(VL53LX_PerformXTalkStreamingCalibration(&dev, &cfg) == VL53LX_ERROR_NONE);
+        CHECK_MSG(log.converged[0] && log.converged[1], "seed %u did not converge", seed);
+
+        uint32_t offsets[2];
+        pass_offsets(offsets);
+        for (int pass = 0; pass < 2; pass++) {
+            double e = error_pct(offsets[pass], reference[pass]);
+            worst = e > worst ? e : worst;
+        }
+        *histograms += log.last_samples[0] + log.last_samples[1];
+    }
+    return worst;
+}
+
+static void test_accuracy(void)
+{
+    VL53LX_xtalk_stream_config_t cfg;
+    VL53LX_get_xtalk_stream_default_config(&cfg);
+
+    // Injected crosstalk as the driver measures it: no shot noise, no early stop
+    uint32_t reference[2];
+    cfg.max_samples = MAX_SAMPLES;
+    cfg.min_samples = MAX_SAMPLES;
+    setup(1, false);
+    CHECK(VL53LX_PerformXTalkStreamingCalibration(&dev, &cfg) == VL53LX_ERROR_NONE);
+    pass_offsets(reference);
+    printf("noise-free reference: pass 0 %u kcps, pass 1 %u kcps\n", reference[0], reference[1]);
+    CHECK(reference[0] > 0 && reference[1] > reference[0]);
+
+    uint32_t histograms;
+    VL53LX_get_xtalk_stream_default_config(&cfg);
+    cfg.max_samples = MAX_SAMPLES;
+    double worst = worst_error(&cfg, reference, &histograms);
+    printf("default stop rule: worst error %.2f%%, %.1f histograms per pass\n", worst,
+           (double)histograms / (2 * ACCURACY_SEEDS));
+    CHECK(worst <= DEFAULT_PCT);
+
+    cfg.min_samples = ACCURACY_SAMPLES;
+    worst = worst_error(&cfg, reference, &histograms);
+    printf("min_samples %u: worst error %.2f%%, %.1f histograms per pass\n", ACCURACY_SAMPLES, worst,
+           (double)histograms / (2 * ACCURACY_SEEDS));
+    CHECK(worst <= ACCURACY_PCT);
+}
+
+int main(void)
+{
+    setup(3, true);
+    test_converges();
+    test_accuracy();
+    return host_test_result();
+}
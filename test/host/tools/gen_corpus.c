@@ -0,0 +1,258 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2024 StampFly ToF Driver Contributors
+ */
+
+/**
+ * @file gen_corpus.c
+ * @brief Record a replay corpus from a synthetic scene
+ *
+ * Runs the ranging loop on the simulated device with sim_scene frames and
+ * writes every result block the device reported. The checked-in corpora
+ * were produced with:
+ *
+ *   gen_corpus medium_scene corpus/medium_scene.txt
+ *   gen_corpus long_xtalk corpus/long_xtalk.txt
+ *   gen_corpus merge_resets corpus/merge_resets.txt
+ *
+ * Directives are written between the frames for replay to apply; they do
+ * not change the recorded blocks, which depend on the scene only.
+ *
+ * Not run by ctest; the corpora are inputs, the golden files are outputs.
+ */
+
+#include "vl53lx_api.h"
+#include "vl53lx_api_core.h"
+#include "vl53lx_hist_map.h"
+#include "sim_device.h"
+#include "sim_scene.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_FRAMES      1024
+#define BLOCK_SIZE      VL53LX_HISTOGRAM_BIN_DATA_I2C_SIZE_BYTES
+
+typedef struct {
+    uint16_t frames;                     // Frames in this segment
+    uint8_t count;                       // Targets
+    float start_mm[2];                   // Distance at the first frame
+    float stop_mm[2];                    // Distance at the last frame
+    float reflectance_pct[2];            // Reflectance
+    float ambient_events;                // Ambient events per bin per SPAD
+} segment_t;
+
+typedef struct {
+    uint16_t frame;                      // Written before this frame
+    bool restart;                        // Stop and start ranging, else set a tuning parameter
+    VL53LX_TuningParms parm;
+    int32_t value;
+    const char *comment;
+} directive_t;
+
+typedef struct {
+    const char *name;
+    const char *description;
+    VL53LX_DistanceModes distance_mode;
+    uint32_t budget_us;
+    uint32_t measure_us;
+    uint32_t seed;
+    float xtalk_events;
+    const segment_t *segments;
+    uint8_t segment_count;
+    const directive_t *directives;
+    uint8_t directive_count;
+} scenario_t;
+
+static const segment_t medium_segments[] = {
+    {  60, 1, {  800.0f }, {  800.0f }, { 50.0f }, 8.0f },             // Hover
+    {  60, 1, {  800.0f }, {  300.0f }, { 50.0f }, 8.0f },             // Descent
+    {  60, 2, {  400.0f, 1200.0f }, {  400.0f, 1200.0f }, { 60.0f, 40.0f }, 8.0f },  // Two targets
+    {  60, 1, {  300.0f }, { 1400.0f }, { 50.0f }, 1.0f },             // Climb in the dark
+    {  60, 1, { 1200.0f }, { 1200.0f }, { 20.0f }, 40.0f },            // Bright ambient
+};
+
+static const segment_t long_segments[] = {
+    {  80, 1, { 2500.0f }, { 2500.0f }, { 50.0f }, 8.0f },             // Far hover
+    {  60, 1, { 2500.0f }, {  600.0f }, { 50.0f }, 8.0f },             // Descent
+    {  60, 0, { 0.0f }, { 0.0f }, { 0.0f }, 8.0f },                    // Crosstalk only
+};
+
+// Abrupt scene changes trigger the merge reset on the histogram difference
+static const segment_t merge_segments[] = {
+    {  40, 1, {  800.0f }, {  800.0f }, { 50.0f }, 8.0f },             // Hover
+    {  40, 1, {  300.0f }, {  300.0f }, { 60.0f }, 8.0f },             // Jump down
+    {  40, 1, { 1500.0f }, { 1500.0f }, { 30.0f }, 1.0f },             // Jump up in the dark
+    {  40, 1, {  600.0f }, {  600.0f }, { 50.0f }, 40.0f },            // Jump into bright ambient
+    {  40, 1, {  600.0f }, { 1200.0f }, { 50.0f }, 8.0f },             // Climb
+    {  40, 2, {  500.0f, 1000.0f }, {  500.0f, 1000.0f }, { 60.0f, 40.0f }, 8.0f },  // Two targets
+};
+
+// Merge size changes, forced resets (threshold 0) and stream count resets
+static const directive_t merge_directives[] = {
+    {  50, false, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, 3, "HIST_MERGE_MAX_SIZE" },
+    {  90, false, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, 6, "HIST_MERGE_MAX_SIZE" },
+    { 110, false, VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD, 0, "RESET_MERGE_THRESHOLD" },
+    { 120, false, VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD, 15000, "RESET_MERGE_THRESHOLD" },
+    { 150, true, 0, 0, NULL },
+    { 176, false, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, 2, "HIST_MERGE_MAX_SIZE" },
+    { 200, false, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, 5, "HIST_MERGE_MAX_SIZE" },
+    { 215, false, VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD, 0, "RESET_MERGE_THRESHOLD" },
+    { 219, false, VL53LX_TUNINGPARM_RESET_MERGE_THRESHOLD, 15000, "RESET_MERGE_THRESHOLD" },
+    { 230, true, 0, 0, NULL },
+    { 231, false, VL53LX_TUNINGPARM_HIST_MERGE_MAX_SIZE, 6, "HIST_MERGE_MAX_SIZE" },
+};
+
+static const scenario_t scenarios[] = {
+    {
+        "medium_scene",
+        "Medium mode: hover, descent, two targets, dark and bright ambient",
+        VL53LX_DISTANCEMODE_MEDIUM, 33000, 33000, 7, 0.0f,
+        medium_segments, sizeof(medium_segments) / sizeof(medium_segments[0]), NULL, 0,
+    },
+    {
+        "long_xtalk",
+        "Long mode with cover glass crosstalk: far hover, descent, no target",
+        VL53LX_DISTANCEMODE_LONG, 33000, 33000, 11, 400.0f,
+        long_segments, sizeof(long_segments) / sizeof(long_segments[0]), NULL, 0,
+    },
+    {
+        "merge_resets",
+        "Medium mode histogram merge: scene jumps, merge size changes, forced resets, restarts",
+        VL53LX_DISTANCEMODE_MEDIUM, 33000, 33000, 13, 0.0f,
+        merge_segments, sizeof(merge_segments) / sizeof(merge_segments[0]),
+        merge_directives, sizeof(merge_directives) / sizeof(merge_directives[0]),
+    },
+};
+
+typedef struct {
+    sim_scene_t scene;
+    uint8_t blocks[MAX_FRAMES][BLOCK_SIZE];
+    uint32_t count;
+} recorder_t;
+
+static recorder_t recorder;
+
+static void record_frame(void *ctx, int index, uint32_t frame, uint8_t *block)
+{
+    recorder_t *rec = ctx;
+    sim_scene_frame(&rec->scene, index, frame, block);
+    if (rec->count < MAX_FRAMES) {
+        memcpy(rec->blocks[rec->count++], block, BLOCK_SIZE);
+    }
+}
+
+static int run(const scenario_t *sc, FILE *out)
+{
+    static VL53LX_Dev_t dev;
+    int index = sim_single_device(&dev, sc->seed);
+    sim_device_set_measure_us(index, sc->measure_us);
+
+    if (VL53LX_WaitDeviceBooted(&dev) != VL53LX_ERROR_NONE ||
+        VL53LX_DataInit(&dev) != VL53LX_ERROR_NONE ||
+        VL53LX_SetDistanceMode(&dev, sc->distance_mode) != VL53LX_ERROR_NONE ||
+        VL53LX_SetMeasurementTimingBudgetMicroSeconds(&dev, sc->budget_us) != VL53LX_ERROR_NONE) {
+        fprintf(stderr, "%s: initialization failed\n", sc->name);
+        return 1;
+    }
+
+    vl53lx_hist_synth_t defaults;
+    VL53LX_HistSynthInit(&defaults);
+    vl53lx_hist_synth_config_t base = defaults.config;
+    base.seed = sc->seed;
+    base.xtalk_events = sc->xtalk_events;
+    memset(&recorder, 0, sizeof(recorder));
+    sim_scene_init(&recorder.scene, &dev, &base);
+    sim_device_set_source(index, record_frame, &recorder);
+
+    if (VL53LX_StartMeasurement(&dev) != VL53LX_ERROR_NONE) {
+        return 1;
+    }
+
+    for (uint8_t s = 0; s < sc->segment_count; s++) {
+        const segment_t *seg = &sc->segments[s];
+        sim_scene_set_ambient(&recorder.scene, seg->ambient_events);
+        for (uint16_t f = 0; f < seg->frames; f++) {
+            float t = (seg->frames > 1) ? (float)f / (float)(seg->frames - 1) : 0.0f;
+            vl53lx_hist_synth_target_t targets[2];
+            for (uint8_t i = 0; i < seg->count; i++) {
+                targets[i].distance_mm = seg->start_mm[i] + (seg->stop_mm[i] - seg->start_mm[i]) * t;
+                targets[i].reflectance_pct = seg->reflectance_pct[i];
+            }
+            sim_scene_set_targets(&recorder.scene, targets, seg->count);
+
+            sim_advance_to(0, sim_device_ready_at(index));
+            uint8_t ready = 0;
+            VL53LX_MultiRangingData_t data;
+            if (VL53LX_GetMeasurementDataReady(&dev, &ready) != VL53LX_ERROR_NONE || !ready ||
+                VL53LX_GetMultiRangingData(&dev, &data) != VL53LX_ERROR_NONE ||
+                VL53LX_ClearInterruptAndStartMeasurement(&dev) != VL53LX_ERROR_NONE) {
+                fprintf(stderr, "%s: ranging failed at segment %u frame %u\n", sc->name, s, f);
+                return 1;
+            }
+            if (out == NULL) {
+                printf("%3u %u:", data.StreamCount, data.NumberOfObjectsFound);
+                for (uint8_t i = 0; i < data.NumberOfObjectsFound; i++) {
+                    printf(" [%u %d]", data.RangeData[i].RangeStatus, data.RangeData[i].RangeMilliMeter);
+                }
+                printf("\n");
+            }
+        }
+    }
+    VL53LX_StopMeasurement(&dev);
+
+    if (out != NULL) {
+        fprintf(out, "# %s\n", sc->description);
+        fprintf(out, "# Recorded with tools/gen_corpus.c; one result block per line from\n");
+        fprintf(out, "# RESULT__INTERRUPT_STATUS (0x%04X), %u bytes. Bytes 0 (GPH ID) and 3\n",
+                VL53LX_HISTOGRAM_BIN_DATA_I2C_INDEX, BLOCK_SIZE);
+        fprintf(out, "# (stream count) are regenerated by the simulated device on replay.\n");
+        fprintf(out, "config distance_mode %u\n", sc->distance_mode);
+        fprintf(out, "config budget_us %u\n", sc->budget_us);
+        fprintf(out, "config measure_us %u\n", sc->measure_us);
+        fprintf(out, "config seed %u\n", sc->seed);
+        for (uint32_t i = 0; i < recorder.count; i++) {
+            for (uint8_t d = 0; d < sc->directive_count; d++) {
+                const directive_t *dir = &sc->directives[d];
+                if (dir->frame != i) {
+                    continue;
+                }
+                if (dir->restart) {
+                    fprintf(out, "restart\n");
+                } else {
+                    fprintf(out, "# %s\ntuning 0x%04X %d\n", dir->comment, dir->parm, dir->value);
+                }
+            }
+            fprintf(out, "frame ");
+            for (uint32_t b = 0; b < BLOCK_SIZE; b++) {
+                fprintf(out, "%02x", recorder.blocks[i][b]);
+            }
+            fprintf(out, "\n");
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <scenario> [corpus.txt]\n", argv[0]);
+        return 2;
+    }
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (strcmp(argv[1], scenarios[i].name) != 0) {
+            continue;
+        }
+        FILE *out = NULL;
+        if (argc > 2 && (out = fopen(argv[2], "w")) == NULL) {
+            fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        int result = run(&scenarios[i], out);
+        if (out != NULL) {
+            fclose(out);
+        }
+        return result;
+    }
+    fprintf(stderr, "unknown scenario %s\n", argv[1]);
+    return 2;
+}